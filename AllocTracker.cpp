@@ -0,0 +1,206 @@
+#include <Arduino.h>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "AllocTracker.h"
+
+static uint32_t minLargestFreeBlock = UINT32_MAX;
+
+void allocTrackerSampleHeap() {
+    const uint32_t largest = ESP.getMaxAllocHeap();
+    if (largest < minLargestFreeBlock) {
+        minLargestFreeBlock = largest;
+    }
+}
+
+#if ALLOC_TRACKING
+
+#include "ConfigValue.h"
+
+static constexpr ConfigDescriptor allocTrapDescriptor = ConfigDescriptor::fromInt("debug.allocTrap", "Abort on an allocation inside the control loop (0 = record, 1 = trap)", 0, 0, 1);
+ConfigValue allocTrap(allocTrapDescriptor);
+
+struct AllocTaskSlot {
+    std::atomic<uintptr_t> handle;  // 0 = free, 1 = before the scheduler started
+    char name[ALLOC_TRACKER_TASK_NAME_LEN];
+    std::atomic<uint32_t> allocations;
+    std::atomic<uint32_t> bytes;
+};
+
+static AllocTaskSlot taskSlots[ALLOC_TRACKER_MAX_TASKS];
+static std::atomic<uint32_t> allocations(0);
+static std::atomic<uint32_t> hotAllocations(0);
+static std::atomic<uintptr_t> hotTask(0);
+static std::atomic<uint32_t> regionAllocations(0);
+static uint32_t hotRegions = 0;
+static uint32_t hotRegionsWithAllocations = 0;
+static uint32_t maxHotAllocationsPerRegion = 0;
+static volatile uint32_t lastHotSize = 0;
+static volatile uintptr_t lastHotCaller = 0;
+static bool trap = false;
+
+static uintptr_t currentTask() {
+    const uintptr_t handle = (uintptr_t)xTaskGetCurrentTaskHandle();
+    return handle != 0 ? handle : 1;
+}
+
+static AllocTaskSlot *findTaskSlot(uintptr_t handle) {
+    for (size_t i = 0; i < ALLOC_TRACKER_MAX_TASKS; ++i) {
+        AllocTaskSlot &slot = taskSlots[i];
+        uintptr_t h = slot.handle.load(std::memory_order_acquire);
+        if (h == handle) {
+            return &slot;
+        }
+        if (h == 0) {
+            // Names are filled in before the handle is published
+            const char *name = handle == 1 ? "startup" : pcTaskGetName((TaskHandle_t)handle);
+            char buffer[ALLOC_TRACKER_TASK_NAME_LEN];
+            std::strncpy(buffer, name ? name : "?", sizeof(buffer) - 1);
+            buffer[sizeof(buffer) - 1] = '\0';
+            uintptr_t expected = 0;
+            if (slot.handle.compare_exchange_strong(expected, ~(uintptr_t)0)) {
+                std::memcpy(slot.name, buffer, sizeof(buffer));
+                slot.handle.store(handle, std::memory_order_release);
+                return &slot;
+            }
+            if (expected == handle) {
+                return &slot;
+            }
+        }
+    }
+    return nullptr;
+}
+
+// Must not allocate
+static void noteAllocation(size_t size, void *caller) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    const uintptr_t task = currentTask();
+    if (AllocTaskSlot *slot = findTaskSlot(task)) {
+        slot->allocations.fetch_add(1, std::memory_order_relaxed);
+        slot->bytes.fetch_add((uint32_t)size, std::memory_order_relaxed);
+    }
+    if (hotTask.load(std::memory_order_relaxed) == task) {
+        hotAllocations.fetch_add(1, std::memory_order_relaxed);
+        regionAllocations.fetch_add(1, std::memory_order_relaxed);
+        lastHotSize = (uint32_t)size;
+        lastHotCaller = (uintptr_t)caller;
+        if (trap) {
+            abort();
+        }
+    }
+}
+
+void allocHotBegin() {
+    trap = allocTrap.getInt() != 0;
+    regionAllocations.store(0, std::memory_order_relaxed);
+    hotTask.store(currentTask(), std::memory_order_relaxed);
+}
+
+void allocHotEnd() {
+    hotTask.store(0, std::memory_order_relaxed);
+    const uint32_t n = regionAllocations.load(std::memory_order_relaxed);
+    hotRegions++;
+    if (n > 0) {
+        hotRegionsWithAllocations++;
+        if (n > maxHotAllocationsPerRegion) {
+            maxHotAllocationsPerRegion = n;
+        }
+    }
+}
+
+#ifdef CONFIG_HEAP_USE_HOOKS
+// The heap component calls these for malloc and everything built on it,
+// including operator new
+extern "C" void esp_heap_trace_alloc_hook(void *ptr, size_t size, uint32_t caps) {
+    if (ptr) {
+        noteAllocation(size, __builtin_return_address(0));
+    }
+}
+
+extern "C" void esp_heap_trace_free_hook(void *ptr) {
+}
+
+#define COUNT_NEW(size)
+#else
+#define COUNT_NEW(size) noteAllocation(size, __builtin_return_address(0))
+#endif
+
+void *operator new(size_t size) {
+    COUNT_NEW(size);
+    void *p = std::malloc(size ? size : 1);
+    if (!p) {
+        abort();
+    }
+    return p;
+}
+
+void *operator new[](size_t size) {
+    COUNT_NEW(size);
+    void *p = std::malloc(size ? size : 1);
+    if (!p) {
+        abort();
+    }
+    return p;
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    COUNT_NEW(size);
+    return std::malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    COUNT_NEW(size);
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+    std::free(p);
+}
+
+#endif // ALLOC_TRACKING
+
+void allocTrackerGetStats(AllocStats &stats) {
+    std::memset(&stats, 0, sizeof(stats));
+#if ALLOC_TRACKING
+    stats.tracking = true;
+    stats.allocations = allocations.load(std::memory_order_relaxed);
+    stats.hotAllocations = hotAllocations.load(std::memory_order_relaxed);
+    stats.hotRegions = hotRegions;
+    stats.hotRegionsWithAllocations = hotRegionsWithAllocations;
+    stats.maxHotAllocationsPerRegion = maxHotAllocationsPerRegion;
+    stats.lastHotSize = lastHotSize;
+    stats.lastHotCaller = lastHotCaller;
+    for (size_t i = 0; i < ALLOC_TRACKER_MAX_TASKS; ++i) {
+        const AllocTaskSlot &slot = taskSlots[i];
+        const uintptr_t h = slot.handle.load(std::memory_order_acquire);
+        if (h == 0 || h == ~(uintptr_t)0) {
+            continue;
+        }
+        AllocTaskStats &t = stats.tasks[stats.numTasks++];
+        std::memcpy(t.name, slot.name, sizeof(t.name));
+        t.allocations = slot.allocations.load(std::memory_order_relaxed);
+        t.bytes = slot.bytes.load(std::memory_order_relaxed);
+    }
+#endif
+    stats.freeHeap = ESP.getFreeHeap();
+    stats.minFreeHeap = ESP.getMinFreeHeap();
+    stats.largestFreeBlock = ESP.getMaxAllocHeap();
+    if (stats.largestFreeBlock < minLargestFreeBlock) {
+        minLargestFreeBlock = stats.largestFreeBlock;
+    }
+    stats.minLargestFreeBlock = minLargestFreeBlock;
+}
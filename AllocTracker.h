@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Set to 1 to count allocations per task and per control tick. Without heap
+// hooks (CONFIG_HEAP_USE_HOOKS) only operator new is seen, not malloc.
+#ifndef ALLOC_TRACKING
+#define ALLOC_TRACKING 0
+#endif
+
+#define ALLOC_TRACKER_MAX_TASKS 8
+#define ALLOC_TRACKER_TASK_NAME_LEN 16
+
+struct AllocTaskStats {
+    char name[ALLOC_TRACKER_TASK_NAME_LEN];
+    uint32_t allocations;
+    uint32_t bytes;
+};
+
+struct AllocStats {
+    bool tracking;
+
+    uint32_t allocations;           // Everything seen since boot
+    uint32_t hotAllocations;        // Inside a hot region since boot
+    uint32_t hotRegions;            // Hot regions entered
+    uint32_t hotRegionsWithAllocations;
+    uint32_t maxHotAllocationsPerRegion;
+    uint32_t lastHotSize;           // Size of the last hot allocation
+    uintptr_t lastHotCaller;        // Return address of the last hot operator new
+
+    size_t numTasks;
+    AllocTaskStats tasks[ALLOC_TRACKER_MAX_TASKS];
+
+    uint32_t freeHeap;
+    uint32_t minFreeHeap;
+    uint32_t largestFreeBlock;
+    uint32_t minLargestFreeBlock;
+};
+
+// Samples the heap watermarks. Takes the heap lock, so call it from a slow
+// path, never inside a hot region.
+void allocTrackerSampleHeap();
+
+void allocTrackerGetStats(AllocStats &stats);
+
+#if ALLOC_TRACKING
+// Allocations made by the calling task between begin and end count as hot.
+// With debug.allocTrap set a hot allocation aborts with a backtrace.
+void allocHotBegin();
+void allocHotEnd();
+#else
+inline void allocHotBegin() {}
+inline void allocHotEnd() {}
+#endif
+
+class AllocHotRegion {
+public:
+    AllocHotRegion() {
+        allocHotBegin();
+    }
+    ~AllocHotRegion() {
+        allocHotEnd();
+    }
+};
@@ -0,0 +1,289 @@
+#include "AttitudeEstimator.h"
+#include "MPU.h"
+
+static Quaternion madgwickUpdate(float deltat, const MPUData &data, const Quaternion &orientation, const float gyroMeasureError, const bool useAccel)
+{
+    // Read the previous state
+    float SEq_1 = orientation.w;
+    float SEq_2 = orientation.x;
+    float SEq_3 = orientation.y;
+    float SEq_4 = orientation.z;
+    
+    // Axulirary variables to avoid reapeated calcualtions
+    const float halfSEq_1 = 0.5f * SEq_1;
+    const float halfSEq_2 = 0.5f * SEq_2;
+    const float halfSEq_3 = 0.5f * SEq_3;
+    const float halfSEq_4 = 0.5f * SEq_4;
+    const float twoSEq_1 = 2.0f * SEq_1;
+    const float twoSEq_2 = 2.0f * SEq_2;
+    const float twoSEq_3 = 2.0f * SEq_3;
+    
+    float SEqHatDot_1 = 0.0f;
+    float SEqHatDot_2 = 0.0f;
+    float SEqHatDot_3 = 0.0f;
+    float SEqHatDot_4 = 0.0f;
+    float normSq;
+    float recipNorm;
+    if (useAccel) {
+        // Normalise the accelerometer measurement
+        float a_x = data.accelX;
+        float a_y = data.accelY;
+        float a_z = data.accelZ;
+        normSq = a_x * a_x + a_y * a_y + a_z * a_z;
+        if (normSq == 0.0f) return orientation; // Return unchanged orientation
+        recipNorm = fastRsqrt(normSq);
+        a_x *= recipNorm;
+        a_y *= recipNorm;
+        a_z *= recipNorm;
+        
+        // Compute the objective function and Jacobian
+        const float f_1 = twoSEq_2 * SEq_4 - twoSEq_1 * SEq_3 - a_x;
+        const float f_2 = twoSEq_1 * SEq_2 + twoSEq_3 * SEq_4 - a_y;
+        const float f_3 = 1.0f - twoSEq_2 * SEq_2 - twoSEq_3 * SEq_3 - a_z;
+        const float J_11or24 = twoSEq_3; // J_11 negated in matrix multiplication
+        const float J_12or23 = 2.0f * SEq_4; // J_12 negated in matrix multiplication
+        const float J_13or22 = twoSEq_1;
+        const float J_14or21 = twoSEq_2;
+        const float J_32 = 2.0f * J_14or21; // negated in matrix multiplication
+        const float J_33 = 2.0f * J_11or24; // negated in matrix multiplication
+        
+        // Compute the gradient (matrix multiplication)
+        SEqHatDot_1 = J_14or21 * f_2 - J_11or24 * f_1;
+        SEqHatDot_2 = J_12or23 * f_1 + J_13or22 * f_2 - J_32 * f_3;
+        SEqHatDot_3 = J_12or23 * f_2 - J_33 * f_3 - J_13or22 * f_1;
+        SEqHatDot_4 = J_14or21 * f_1 + J_11or24 * f_2;
+        
+        // Normalise the gradient
+        normSq = SEqHatDot_1 * SEqHatDot_1 + SEqHatDot_2 * SEqHatDot_2 + SEqHatDot_3 * SEqHatDot_3 + SEqHatDot_4 * SEqHatDot_4;
+        if (normSq == 0.0f) return orientation; // Return unchanged orientation
+        recipNorm = fastRsqrt(normSq);
+        SEqHatDot_1 *= recipNorm;
+        SEqHatDot_2 *= recipNorm;
+        SEqHatDot_3 *= recipNorm;
+        SEqHatDot_4 *= recipNorm;
+    }
+    
+    // Compute the quaternion derrivative measured by gyroscopes
+    const float w_x = data.gyroX;
+    const float w_y = data.gyroY;
+    const float w_z = data.gyroZ;
+    const float SEqDot_omega_1 = -halfSEq_2 * w_x - halfSEq_3 * w_y - halfSEq_4 * w_z;
+    const float SEqDot_omega_2 = halfSEq_1 * w_x + halfSEq_3 * w_z - halfSEq_4 * w_y;
+    const float SEqDot_omega_3 = halfSEq_1 * w_y - halfSEq_2 * w_z + halfSEq_4 * w_x;
+    const float SEqDot_omega_4 = halfSEq_1 * w_z + halfSEq_2 * w_y - halfSEq_3 * w_x;
+    
+    // Compute then integrate the estimated quaternion derrivative
+    // const float beta = sqrtf(3.0f / 4.0f) * gyroMeasError;
+    const float beta = 0.8660254038f * gyroMeasureError;
+    SEq_1 += (SEqDot_omega_1 - (beta * SEqHatDot_1)) * deltat;
+    SEq_2 += (SEqDot_omega_2 - (beta * SEqHatDot_2)) * deltat;
+    SEq_3 += (SEqDot_omega_3 - (beta * SEqHatDot_3)) * deltat;
+    SEq_4 += (SEqDot_omega_4 - (beta * SEqHatDot_4)) * deltat;
+    
+    // Normalise quaternion
+    normSq = SEq_1 * SEq_1 + SEq_2 * SEq_2 + SEq_3 * SEq_3 + SEq_4 * SEq_4;
+    if (normSq == 0.0f) return orientation; // Return unchanged orientation
+    recipNorm = fastRsqrt(normSq);
+    SEq_1 *= recipNorm;
+    SEq_2 *= recipNorm;
+    SEq_3 *= recipNorm;
+    SEq_4 *= recipNorm;
+
+    return Quaternion(SEq_1, SEq_2, SEq_3, SEq_4);
+}
+
+
+// q + 0.5 * q * (0, w) * dt, normalized
+static Quaternion integrateGyro(const Quaternion &q, float wx, float wy, float wz, float dt)
+{
+    const float h = 0.5f * dt;
+    Quaternion r(
+        q.w + (-q.x * wx - q.y * wy - q.z * wz) * h,
+        q.x + (q.w * wx + q.y * wz - q.z * wy) * h,
+        q.y + (q.w * wy - q.x * wz + q.z * wx) * h,
+        q.z + (q.w * wz + q.x * wy - q.y * wx) * h);
+    r.normalize();
+    return r;
+}
+
+// Gravity direction in the body frame, as seen by an accelerometer at rest
+static Vector predictedGravity(const Quaternion &q)
+{
+    return Vector(
+        2.0f * (q.x * q.z - q.w * q.y),
+        2.0f * (q.w * q.x + q.y * q.z),
+        q.w * q.w - q.x * q.x - q.y * q.y + q.z * q.z);
+}
+
+//
+// Madgwick
+//
+
+static constexpr ConfigDescriptor madgwickGyroErrorDescriptor = ConfigDescriptor::fromFloat("MPU.madgwick.gyroError", "Madgwick gyro measurement error (rad/s), beta = 0.866 times this; higher trusts the accelerometer more", 0.1f, 0.0f);
+
+MadgwickEstimator::MadgwickEstimator()
+    : gyroMeasureError(madgwickGyroErrorDescriptor)
+{
+}
+
+void MadgwickEstimator::reset(const Quaternion &newOrientation)
+{
+    orientation = newOrientation;
+}
+
+void MadgwickEstimator::update(float dt, const MPUData &data, bool useAccel)
+{
+    orientation = madgwickUpdate(dt, data, orientation, gyroMeasureError.getFloat(), useAccel);
+}
+
+//
+// Mahony
+//
+
+static constexpr ConfigDescriptor mahonyKpDescriptor = ConfigDescriptor::fromFloat("MPU.mahony.kp", "Mahony proportional gain on the accelerometer error", 1.0f, 0.0f);
+static constexpr ConfigDescriptor mahonyKiDescriptor = ConfigDescriptor::fromFloat("MPU.mahony.ki", "Mahony integral gain on the accelerometer error (gyro bias)", 0.05f, 0.0f);
+
+MahonyEstimator::MahonyEstimator()
+    : kp(mahonyKpDescriptor)
+    , ki(mahonyKiDescriptor)
+    , integralX(0.0f), integralY(0.0f), integralZ(0.0f)
+{
+}
+
+void MahonyEstimator::reset(const Quaternion &newOrientation)
+{
+    orientation = newOrientation;
+    integralX = 0.0f;
+    integralY = 0.0f;
+    integralZ = 0.0f;
+}
+
+void MahonyEstimator::update(float dt, const MPUData &data, bool useAccel)
+{
+    float wx = data.gyroX;
+    float wy = data.gyroY;
+    float wz = data.gyroZ;
+    const float normSq = data.accelX * data.accelX + data.accelY * data.accelY + data.accelZ * data.accelZ;
+    if (useAccel && normSq > 0.0f) {
+        const float recipNorm = fastRsqrt(normSq);
+        const float ax = data.accelX * recipNorm;
+        const float ay = data.accelY * recipNorm;
+        const float az = data.accelZ * recipNorm;
+        // Error is the cross product between measured and predicted gravity
+        const Vector v = predictedGravity(orientation);
+        const float ex = ay * v.z - az * v.y;
+        const float ey = az * v.x - ax * v.z;
+        const float ez = ax * v.y - ay * v.x;
+        const float kiValue = ki.getFloat();
+        if (kiValue > 0.0f) {
+            integralX += kiValue * ex * dt;
+            integralY += kiValue * ey * dt;
+            integralZ += kiValue * ez * dt;
+        } else {
+            integralX = 0.0f;
+            integralY = 0.0f;
+            integralZ = 0.0f;
+        }
+        const float kpValue = kp.getFloat();
+        wx += kpValue * ex;
+        wy += kpValue * ey;
+        wz += kpValue * ez;
+    }
+    wx += integralX;
+    wy += integralY;
+    wz += integralZ;
+    orientation = integrateGyro(orientation, wx, wy, wz, dt);
+}
+
+//
+// EKF
+//
+
+static constexpr ConfigDescriptor ekfGyroNoiseDescriptor = ConfigDescriptor::fromFloat("MPU.ekf.gyroNoise", "EKF gyro noise density (rad/s)", 0.02f, 0.0f);
+static constexpr ConfigDescriptor ekfBiasNoiseDescriptor = ConfigDescriptor::fromFloat("MPU.ekf.biasNoise", "EKF gyro bias random walk (rad/s^2)", 0.0005f, 0.0f);
+static constexpr ConfigDescriptor ekfAccelNoiseDescriptor = ConfigDescriptor::fromFloat("MPU.ekf.accelNoise", "EKF accelerometer noise (g)", 0.1f, 0.0f);
+
+EKFEstimator::EKFEstimator()
+    : gyroNoise(ekfGyroNoiseDescriptor)
+    , biasNoise(ekfBiasNoiseDescriptor)
+    , accelNoise(ekfAccelNoiseDescriptor)
+{
+    reset(Quaternion());
+}
+
+void EKFEstimator::reset(const Quaternion &newOrientation)
+{
+    orientation = newOrientation;
+    bias = Vector3f::zero();
+    covariance = Matrix<float, 6, 6>::zero();
+    for (size_t i = 0; i < 3; ++i) {
+        covariance(i, i) = 0.01f;
+        covariance(i + 3, i + 3) = 0.0001f;
+    }
+}
+
+void EKFEstimator::update(float dt, const MPUData &data, bool useAccel)
+{
+    //
+    // Predict
+    //
+    const float wx = data.gyroX - bias[0];
+    const float wy = data.gyroY - bias[1];
+    const float wz = data.gyroZ - bias[2];
+    orientation = integrateGyro(orientation, wx, wy, wz, dt);
+
+    // Error state transition: [I - [w]x dt, -I dt; 0, I]
+    auto F = Matrix<float, 6, 6>::identity();
+    F(0, 1) = wz * dt;  F(0, 2) = -wy * dt;
+    F(1, 0) = -wz * dt; F(1, 2) = wx * dt;
+    F(2, 0) = wy * dt;  F(2, 1) = -wx * dt;
+    F(0, 3) = -dt; F(1, 4) = -dt; F(2, 5) = -dt;
+    covariance = F * covariance * F.transpose();
+    const float gn = gyroNoise.getFloat();
+    const float bn = biasNoise.getFloat();
+    for (size_t i = 0; i < 3; ++i) {
+        covariance(i, i) += gn * gn * dt;
+        covariance(i + 3, i + 3) += bn * bn * dt;
+    }
+
+    //
+    // Correct with gravity
+    //
+    const float normSq = data.accelX * data.accelX + data.accelY * data.accelY + data.accelZ * data.accelZ;
+    if (!useAccel || normSq <= 0.0f) {
+        return;
+    }
+    const float recipNorm = fastRsqrt(normSq);
+    const Vector h = predictedGravity(orientation);
+    Vector3f innovation;
+    innovation[0] = data.accelX * recipNorm - h.x;
+    innovation[1] = data.accelY * recipNorm - h.y;
+    innovation[2] = data.accelZ * recipNorm - h.z;
+
+    // H = [[h]x, 0]
+    auto H = Matrix<float, 3, 6>::zero();
+    H(0, 1) = -h.z; H(0, 2) = h.y;
+    H(1, 0) = h.z;  H(1, 2) = -h.x;
+    H(2, 0) = -h.y; H(2, 1) = h.x;
+
+    const auto PHt = covariance * H.transpose();
+    auto S = H * PHt;
+    const float an = accelNoise.getFloat();
+    for (size_t i = 0; i < 3; ++i) {
+        S(i, i) += an * an;
+    }
+    Matrix3f Sinv;
+    if (!matrixInverse(S, Sinv)) {
+        return;
+    }
+    const auto K = PHt * Sinv;
+    const auto dx = K * innovation;
+    covariance = (Matrix<float, 6, 6>::identity() - K * H) * covariance;
+
+    // Fold the error state back into the nominal state
+    orientation = orientation * Quaternion(1.0f, 0.5f * dx[0], 0.5f * dx[1], 0.5f * dx[2]);
+    orientation.normalize();
+    bias[0] += dx[3];
+    bias[1] += dx[4];
+    bias[2] += dx[5];
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "ConfigValue.h"
+#include "Geometry.h"
+#include "Matrix.h"
+
+struct MPUData;
+
+enum EstimatorType {
+    ET_Madgwick = 0,
+    ET_Mahony   = 1,
+    ET_EKF      = 2,
+};
+
+class AttitudeEstimator {
+protected:
+    Quaternion orientation;
+public:
+    virtual ~AttitudeEstimator() {}
+
+    // Restarts the filter from the given orientation, e.g. when switching estimators.
+    virtual void reset(const Quaternion &newOrientation) = 0;
+
+    // Propagates with the gyro and, when useAccel is true, corrects with the
+    // accelerometer. Callers pass useAccel = false while the accelerometer is
+    // not a trustworthy gravity reference (e.g. under thrust).
+    virtual void update(float dt, const MPUData &data, bool useAccel) = 0;
+
+    virtual const char *getName() const = 0;
+
+    // Approximate floating point operations per update, so that the cost
+    // of each estimator can be compared against the loop budget.
+    virtual int getCost() const = 0;
+
+    inline Quaternion getOrientation() const {
+        return orientation;
+    }
+};
+
+class MadgwickEstimator : public AttitudeEstimator {
+    ConfigValue gyroMeasureError;
+public:
+    MadgwickEstimator();
+    void reset(const Quaternion &newOrientation) override;
+    void update(float dt, const MPUData &data, bool useAccel) override;
+    const char *getName() const override { return "Madgwick"; }
+    int getCost() const override { return 130; }
+};
+
+class MahonyEstimator : public AttitudeEstimator {
+    ConfigValue kp;
+    ConfigValue ki;
+    float integralX, integralY, integralZ;
+public:
+    MahonyEstimator();
+    void reset(const Quaternion &newOrientation) override;
+    void update(float dt, const MPUData &data, bool useAccel) override;
+    const char *getName() const override { return "Mahony"; }
+    int getCost() const override { return 80; }
+};
+
+// Multiplicative EKF over a 3-state attitude error and a 3-state gyro bias
+class EKFEstimator : public AttitudeEstimator {
+    ConfigValue gyroNoise;
+    ConfigValue biasNoise;
+    ConfigValue accelNoise;
+    Vector3f bias;
+    Matrix<float, 6, 6> covariance;
+public:
+    EKFEstimator();
+    void reset(const Quaternion &newOrientation) override;
+    void update(float dt, const MPUData &data, bool useAccel) override;
+    const char *getName() const override { return "EKF"; }
+    int getCost() const override { return 1700; }
+    inline Vector getGyroBias() const {
+        return Vector(bias[0], bias[1], bias[2]);
+    }
+};
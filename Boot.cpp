@@ -0,0 +1,53 @@
+#include <Arduino.h>
+#include <atomic>
+
+#include "Boot.h"
+#include "DeferredLog.h"
+
+static const char *const phaseNames[] = {
+    "storage",
+    "motors",
+    "sensors",
+    "rc",
+    "tasks",
+    "firstAttitude",
+    "wifi",
+    "network",
+};
+static_assert(sizeof(phaseNames) / sizeof(phaseNames[0]) == BP_Count, "phaseNames must be indexed by BootPhase");
+
+struct PhaseSlot {
+    std::atomic<uint32_t> startMicros;
+    std::atomic<uint32_t> endMicros;
+    std::atomic<int32_t> core;
+};
+
+static PhaseSlot phases[BP_Count];
+
+void bootPhaseBegin(BootPhase phase) {
+    phases[phase].startMicros.store(micros(), std::memory_order_relaxed);
+}
+
+void bootPhaseEnd(BootPhase phase) {
+    PhaseSlot &slot = phases[phase];
+    // micros() is never 0 by the time anything here has run
+    const uint32_t end = micros();
+    const uint32_t start = slot.startMicros.load(std::memory_order_relaxed);
+    const int32_t core = (int32_t)xPortGetCoreID();
+    slot.core.store(core, std::memory_order_relaxed);
+    slot.endMicros.store(end, std::memory_order_release);
+    // The flight task ends BP_FirstAttitude
+    DLOG_I("Boot", "%s took %u us, done at %u us on core %d", phaseNames[phase],
+        (unsigned)(end - start), (unsigned)end, (int)core);
+}
+
+void bootGetPhases(BootPhaseTiming *out) {
+    for (size_t i = 0; i < BP_Count; ++i) {
+        const PhaseSlot &slot = phases[i];
+        BootPhaseTiming &t = out[i];
+        t.name = phaseNames[i];
+        t.endMicros = slot.endMicros.load(std::memory_order_acquire);
+        t.startMicros = slot.startMicros.load(std::memory_order_relaxed);
+        t.core = t.endMicros != 0 ? slot.core.load(std::memory_order_relaxed) : -1;
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Boot profile. setup() brings up storage and config, then splits: core 1
+// starts the motors, the IMU and RC and then the flight tasks, while a
+// short-lived task on core 0 starts WiFi and the servers. Each phase's
+// start and end, in microseconds since the app started, are logged and
+// served at /boot.json. Time spent in the ROM and second stage bootloaders
+// comes before zero and is not counted.
+
+enum BootPhase {
+    BP_Storage          = 0,    // EEPROM, SPIFFS, config file
+    BP_Motors           = 1,
+    BP_Sensors          = 2,    // I2C, IMU, gyro analyzer
+    BP_RC               = 3,
+    BP_Tasks            = 4,    // Control loop and flight tasks
+    BP_FirstAttitude    = 5,    // Starting the tasks to the first estimated attitude
+    BP_WiFi             = 6,    // Access point or station, mDNS
+    BP_Network          = 7,    // OTA, web server, MAVLink, network task
+    BP_Count
+};
+
+struct BootPhaseTiming {
+    const char *name;
+    uint32_t startMicros;
+    uint32_t endMicros;     // 0 until the phase is done
+    int32_t core;
+};
+
+// Any task; phases may overlap
+void bootPhaseBegin(BootPhase phase);
+void bootPhaseEnd(BootPhase phase);
+
+// Fills BP_Count entries
+void bootGetPhases(BootPhaseTiming *phases);
@@ -1,8 +1,23 @@
 #pragma once
 
-#include <vector>
+#include <cstddef>
 
 #include "ConfigValue.h"
+#include "DeferredLog.h"
+
+#define AIRFRAME_MAX_MOTORS 6
+
+// Keys motor<n>.x, motor<n>.y and motor<n>.direction; declare with MOTOR_CONFIG
+struct MotorConfigDescriptors {
+    ConfigDescriptor x;
+    ConfigDescriptor y;
+    ConfigDescriptor direction;
+};
+
+#define MOTOR_CONFIG(n) MotorConfigDescriptors { \
+    ConfigDescriptor::fromFloat("motor" #n ".x", "The X position of the motor relative to the center of mass", 0.0f), \
+    ConfigDescriptor::fromFloat("motor" #n ".y", "The Y position of the motor relative to the center of mass", 0.0f), \
+    ConfigDescriptor::fromInt("motor" #n ".direction", "The direction of the motor (1 for CCW, -1 for CW)", 1, -1, 1) }
 
 class MotorConfig {
 public:
@@ -10,15 +25,21 @@ public:
     ConfigValue y;          // Y position relative to COM
     ConfigValue direction;  // +1 for CCW, -1 for CW
 
-    MotorConfig(int index)
-        : x("motor" + String(index) + ".x", "The X position of the motor relative to the center of mass", Value::fromFloat(0.0f))
-        , y("motor" + String(index) + ".y", "The Y position of the motor relative to the center of mass", Value::fromFloat(0.0f))
-        , direction("motor" + String(index) + ".direction", "The direction of the motor (1 for CCW, -1 for CW)", Value::fromInt(1))
+    explicit MotorConfig(const MotorConfigDescriptors &descriptors)
+        : x(descriptors.x)
+        , y(descriptors.y)
+        , direction(descriptors.direction)
         {
     }
 };
 
 class AirframeConfig {
+    static constexpr ConfigDescriptor numMotorsDescriptor = ConfigDescriptor::fromInt("numMotors", "The number of motors on this airframe", 4, 0, AIRFRAME_MAX_MOTORS);
+    static constexpr MotorConfigDescriptors motorDescriptors[AIRFRAME_MAX_MOTORS] = {
+        MOTOR_CONFIG(1), MOTOR_CONFIG(2), MOTOR_CONFIG(3), MOTOR_CONFIG(4), MOTOR_CONFIG(5), MOTOR_CONFIG(6)
+    };
+    static constexpr ConfigDescriptor comXDescriptor = ConfigDescriptor::fromFloat("com.x", "The X position of the center of mass", 0.0f);
+    static constexpr ConfigDescriptor comYDescriptor = ConfigDescriptor::fromFloat("com.y", "The Y position of the center of mass", 0.0f);
 public:
     ConfigValue numMotors;
     MotorConfig motor1;
@@ -31,42 +52,35 @@ public:
     ConfigValue comY;
 
     AirframeConfig()
-        : numMotors("numMotors", "The number of motors on this airframe", Value::fromInt(4))
-        , motor1(1)
-        , motor2(2)
-        , motor3(3)
-        , motor4(4)
-        , motor5(5)
-        , motor6(6)
-        , comX("com.x", "The X position of the center of mass", Value::fromFloat(0.0f))
-        , comY("com.y", "The Y position of the center of mass", Value::fromFloat(0.0f))
+        : numMotors(numMotorsDescriptor)
+        , motor1(motorDescriptors[0])
+        , motor2(motorDescriptors[1])
+        , motor3(motorDescriptors[2])
+        , motor4(motorDescriptors[3])
+        , motor5(motorDescriptors[4])
+        , motor6(motorDescriptors[5])
+        , comX(comXDescriptor)
+        , comY(comYDescriptor)
         {
     }
 
-    inline std::vector<MotorConfig*> getMotorConfigs() {
-        std::vector<MotorConfig*> motors;
+    // Fills motors with the configured motors and returns how many there
+    // are. Called from the control loop, so it must not allocate.
+    inline size_t getMotorConfigs(MotorConfig *motors[AIRFRAME_MAX_MOTORS]) {
         int num = numMotors.getInt();
         if (num <= 0) {
-            ESP_LOGW("Config", "No motors configured");
-            return motors;
+            DLOG_W("Config", "No motors configured");
+            return 0;
         }
-        if (num > 8) {
-            ESP_LOGW("Config", "Number of motors exceeds maximum supported (8), clamping to 8");
-            num = 8;
+        if (num > AIRFRAME_MAX_MOTORS) {
+            DLOG_W("Config", "Number of motors exceeds maximum supported (%d), clamping to %d", AIRFRAME_MAX_MOTORS, AIRFRAME_MAX_MOTORS);
+            num = AIRFRAME_MAX_MOTORS;
         }
-        motors.reserve(num);
-        for (int i = 1; i <= num; ++i) {
-            switch (i) {
-                case 1: motors.push_back(&motor1); break;
-                case 2: motors.push_back(&motor2); break;
-                case 3: motors.push_back(&motor3); break;
-                case 4: motors.push_back(&motor4); break;
-                case 5: motors.push_back(&motor5); break;
-                case 6: motors.push_back(&motor6); break;
-                default: ESP_LOGW("Config", "Unexpected motor index %d, skipping", i);
-            }
+        MotorConfig *all[AIRFRAME_MAX_MOTORS] = { &motor1, &motor2, &motor3, &motor4, &motor5, &motor6 };
+        for (int i = 0; i < num; ++i) {
+            motors[i] = all[i];
         }
-        return motors;
+        return (size_t)num;
     }
 };
 
@@ -3,72 +3,303 @@
 #include "ConfigValue.h"
 
 #include <Arduino.h>
-#include <vector>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
 
 using namespace std;
 
 static void configValuesSave();
 
-static vector<ConfigValue*> registry;
+// Once the tasks run, values change on the flight and web tasks but the
+// file is only written from the persistence task
+static atomic<bool> savesDeferred(false);
+static atomic<bool> saveRequested(false);
+static atomic<uint32_t> generation(1);
 
-static ConfigValue* findConfig(const String &name) {
-    for (auto *value : registry) {
-        if (value->getName() == name) {
-            return value;
+static void requestSave() {
+    if (savesDeferred.load(memory_order_relaxed)) {
+        saveRequested.store(true, memory_order_release);
+    }
+    else {
+        configValuesSave();
+    }
+}
+
+// Stamping and bumping are one critical section, so two tasks changing
+// values at once get distinct generations, and a reader that sees a
+// generation also sees every stamp up to it
+static portMUX_TYPE generationLock = portMUX_INITIALIZER_UNLOCKED;
+
+// Marks values changed by configValuesApplyJson until they are stamped.
+// Above any generation, so readers skip them meanwhile.
+static constexpr uint32_t UNSTAMPED = UINT32_MAX;
+
+static void noteChanged(uint32_t &changedGeneration) {
+    portENTER_CRITICAL(&generationLock);
+    const uint32_t stamp = generation.load(memory_order_relaxed) + 1;
+    changedGeneration = stamp;
+    generation.store(stamp, memory_order_release);
+    portEXIT_CRITICAL(&generationLock);
+    requestSave();
+}
+
+uint32_t configValuesGetGeneration() {
+    return generation.load(memory_order_acquire);
+}
+
+void configValuesDeferSaves(bool defer) {
+    savesDeferred = defer;
+    if (!defer) {
+        configValuesSaveIfRequested();
+    }
+}
+
+bool configValuesSaveIfRequested() {
+    if (!saveRequested.exchange(false, memory_order_acquire)) {
+        return false;
+    }
+    configValuesSave();
+    return true;
+}
+
+// Intrusive list in construction order, so registering needs no heap
+struct ConfigRegistry {
+    static ConfigValue *head;
+    static ConfigValue *tail;
+
+    static ConfigValue* find(const char *name) {
+        for (ConfigValue *value = head; value != nullptr; value = value->next) {
+            if (strcmp(value->getName(), name) == 0) {
+                return value;
+            }
+        }
+        return nullptr;
+    }
+
+    static void add(ConfigValue *value) {
+        if (find(value->getName()) != nullptr) {
+            ESP_LOGE("Config", "Duplicate config name: %s", value->getName());
+            return;
+        }
+        ESP_LOGD("Config", "Registering config: %s = %s", value->getName(), value->getValue().toString().c_str());
+        if (tail) {
+            tail->next = value;
+        }
+        else {
+            head = value;
+        }
+        tail = value;
+    }
+
+    template <typename F>
+    static void forEach(F f) {
+        for (const ConfigValue *value = head; value != nullptr; value = value->getNext()) {
+            f(*value);
         }
     }
-    return nullptr;
+};
+
+// Constant-initialized, so they are valid before any ConfigValue constructor runs
+ConfigValue *ConfigRegistry::head = nullptr;
+ConfigValue *ConfigRegistry::tail = nullptr;
+
+static ConfigValue* findConfig(const String &name) {
+    return ConfigRegistry::find(name.c_str());
 }
 
-static void registerConfig(ConfigValue *value) {
-    if (findConfig(value->getName()) != nullptr) {
-        ESP_LOGE("Config", "Duplicate config name: %s", value->getName().c_str());
-        return;
+ConfigValue::ConfigValue(const ConfigDescriptor &descriptor)
+    : descriptor(descriptor), value(descriptor.defaultValue), next(nullptr), changedGeneration(0) {
+    if (descriptor.minValue.getType() != value.getType() || descriptor.maxValue.getType() != value.getType()) {
+        ESP_LOGE("Config", "Range type does not match value type for %s", descriptor.name);
+    }
+    ConfigRegistry::add(this);
+}
+
+// Values can be set from the flight task, so these go through the deferred
+// log with the numbers formatted there rather than as Strings
+static void logOutOfRange(const char *name, const Value &v, const char *bound, const Value &limit) {
+    if (v.isInt()) {
+        DLOG_W("Config", "%s = %d is %s %d", name, (int)v.getInt(), bound, (int)limit.getInt());
+    }
+    else {
+        DLOG_W("Config", "%s = %g is %s %g", name, v.getFloat(), bound, limit.getFloat());
     }
-    ESP_LOGD("Config", "Registering config: %s = %s", value->getName().c_str(), value->getValue().toString().c_str());
-    registry.push_back(value);
 }
 
-ConfigValue::ConfigValue(const String &name, const String &descriptionHtml, Value defaultValue)
-    : name(name), descriptionHtml(descriptionHtml), defaultValue(defaultValue), value(defaultValue) {
-    registerConfig(this);
-    if (defaultValue.getType() != value.getType()) {
-        ESP_LOGE("Config", "Default value type %d does not match value type %d", defaultValue.getType(), value.getType());
+static void logChange(const char *name, const Value &value, const Value &oldValue) {
+    if (value.isInt()) {
+        DLOG_I("Config", "Config set %s = %d (was %d)", name, (int)value.getInt(), (int)oldValue.getInt());
+    }
+    else {
+        DLOG_I("Config", "Config set %s = %g (was %g)", name, value.getFloat(), oldValue.getFloat());
     }
 }
 
+Value ConfigValue::clamp(const Value &v) const {
+    if (v < descriptor.minValue) {
+        logOutOfRange(descriptor.name, v, "below the minimum", descriptor.minValue);
+        return descriptor.minValue;
+    }
+    if (descriptor.maxValue < v) {
+        logOutOfRange(descriptor.name, v, "above the maximum", descriptor.maxValue);
+        return descriptor.maxValue;
+    }
+    return v;
+}
+
 void ConfigValue::setValue(const Value &newValue) {
-    if (newValue.getType() != defaultValue.getType()) {
-        ESP_LOGW("Config", "Attempt to set value of type %d, expected %d", newValue.getType(), defaultValue.getType());
+    if (newValue.getType() != value.getType()) {
+        DLOG_W("Config", "Attempt to set %s to a value of type %d, expected %d", getName(), (int)newValue.getType(), (int)value.getType());
         return;
     }
     const auto oldValue = value;
-    value = newValue;
+    value = clamp(newValue);
     if (value != oldValue) {
-        ESP_LOGI("Config", "Config set %s = %s (was %s)", name.c_str(), value.toString().c_str(), oldValue.toString().c_str());
-        configValuesSave();
+        logChange(getName(), value, oldValue);
+        noteChanged(changedGeneration);
     }
 }
 
 void ConfigValue::setValueString(const String &newValueString) {
     const auto oldValue = value;
-    value.setToString(newValueString);
+    Value parsed = value;
+    parsed.setToString(newValueString);
+    value = clamp(parsed);
     if (value != oldValue) {
-        ESP_LOGI("Config", "Config set %s = %s (was %s) (from \"%s\")", name.c_str(), value.toString().c_str(), oldValue.toString().c_str(), newValueString.c_str());
-        configValuesSave();
+        logChange(getName(), value, oldValue);
+        noteChanged(changedGeneration);
+    }
+}
+
+void configValuesIterate(const std::function<void(const char *, const Value &)> &callback) {
+    ConfigRegistry::forEach([&callback](const ConfigValue &value) {
+        callback(value.getName(), value.getValue());
+    });
+}
+
+void configDefaultValuesIterate(const std::function<void(const char *, const Value &)> &callback) {
+    ConfigRegistry::forEach([&callback](const ConfigValue &value) {
+        callback(value.getName(), value.getDefaultValue());
+    });
+}
+
+size_t configValuesCount() {
+    size_t count = 0;
+    ConfigRegistry::forEach([&count](const ConfigValue &) {
+        count++;
+    });
+    return count;
+}
+
+const ConfigValue *configValuesFirst() {
+    return ConfigRegistry::head;
+}
+
+static bool isUnbounded(const Value &v, bool isMin) {
+    if (v.isInt()) {
+        return v.getInt() == (isMin ? numeric_limits<int32_t>::min() : numeric_limits<int32_t>::max());
+    }
+    return v.getFloat() == (isMin ? numeric_limits<float>::lowest() : numeric_limits<float>::max());
+}
+
+static int printValue(char *out, size_t size, const Value &v) {
+    if (v.isInt()) {
+        return snprintf(out, size, "%d", (int)v.getInt());
+    }
+    return snprintf(out, size, "%g", (double)v.getFloat());
+}
+
+uint32_t configValuesChangedSince(uint32_t since, const std::function<void(const char *, const Value &, uint32_t)> &callback) {
+    const uint32_t now = configValuesGetGeneration();
+    if (now == since) {
+        return now;
     }
+    ConfigRegistry::forEach([&](const ConfigValue &value) {
+        const uint32_t changedAt = value.getChangedGeneration();
+        if (changedAt > since && changedAt <= now) {
+            callback(value.getName(), value.getValue(), changedAt);
+        }
+    });
+    return now;
 }
 
-void configValuesIterate(const std::function<void(const String &, const Value &)> &callback) {
-    for (const auto *value : registry) {
-        callback(value->getName(), value->getValue());
+void configValuesWriteJson(String &out) {
+    char number[24];
+    const char *head = "{";
+    ConfigRegistry::forEach([&](const ConfigValue &value) {
+        out += head;
+        out += '"';
+        out += value.getName();
+        out += "\":";
+        printValue(number, sizeof(number), value.getValue());
+        out += number;
+        head = ",";
+    });
+    out += (*head == '{') ? "{}" : "}";
+}
+
+// Renders one entry into the cursor's pending buffer
+static void renderSchemaEntry(ConfigSchemaCursor &cursor, const ConfigDescriptor &d, bool first) {
+    char *out = cursor.pending;
+    const size_t size = sizeof(cursor.pending);
+    size_t n = (size_t)snprintf(out, size, "%s{\"name\":\"%s\",\"type\":\"%s\",\"default\":",
+        first ? "" : ",", d.name, d.defaultValue.isInt() ? "int" : "float");
+    n += printValue(out + n, size - n, d.defaultValue);
+    n += snprintf(out + n, size - n, ",\"min\":");
+    n += isUnbounded(d.minValue, true) ? snprintf(out + n, size - n, "null") : printValue(out + n, size - n, d.minValue);
+    n += snprintf(out + n, size - n, ",\"max\":");
+    n += isUnbounded(d.maxValue, false) ? snprintf(out + n, size - n, "null") : printValue(out + n, size - n, d.maxValue);
+    n += snprintf(out + n, size - n, ",\"description\":\"");
+    // Leave room for the closing quote and brace
+    for (const char *c = d.descriptionHtml; *c && n + 4 < size; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out[n++] = '\\';
+        }
+        if ((unsigned char)*c >= 0x20) {
+            out[n++] = *c;
+        }
     }
+    out[n++] = '"';
+    out[n++] = '}';
+    cursor.pendingLength = n;
+    cursor.pendingOffset = 0;
 }
 
-void configDefaultValuesIterate(const std::function<void(const String &, const Value &)> &callback) {
-    for (const auto *value : registry) {
-        callback(value->getName(), value->getDefaultValue());
+size_t configSchemaRead(ConfigSchemaCursor &cursor, uint8_t *buffer, size_t maxLength) {
+    static const char header[] = "{\"values\":[";
+    static const char footer[] = "]}";
+    size_t written = 0;
+    while (written < maxLength) {
+        if (cursor.pendingOffset == cursor.pendingLength) {
+            if (!cursor.started) {
+                cursor.started = true;
+                cursor.next = ConfigRegistry::head;
+                memcpy(cursor.pending, header, sizeof(header) - 1);
+                cursor.pendingLength = sizeof(header) - 1;
+                cursor.pendingOffset = 0;
+            }
+            else if (cursor.next != nullptr) {
+                renderSchemaEntry(cursor, cursor.next->getDescriptor(), cursor.next == ConfigRegistry::head);
+                cursor.next = cursor.next->getNext();
+            }
+            else if (!cursor.ended) {
+                cursor.ended = true;
+                memcpy(cursor.pending, footer, sizeof(footer) - 1);
+                cursor.pendingLength = sizeof(footer) - 1;
+                cursor.pendingOffset = 0;
+            }
+            else {
+                break;
+            }
+        }
+        const size_t chunk = min(cursor.pendingLength - cursor.pendingOffset, maxLength - written);
+        memcpy(buffer + written, cursor.pending + cursor.pendingOffset, chunk);
+        cursor.pendingOffset += chunk;
+        written += chunk;
     }
+    return written;
 }
 
 bool configValueSetString(const String &name, const String &valueString) {
@@ -79,6 +310,17 @@ bool configValueSetString(const String &name, const String &valueString) {
     return false;
 }
 
+bool configValueSet(const char *name, const Value &newValue) {
+    if (auto *value = ConfigRegistry::find(name)) {
+        if (newValue.getType() != value->getValue().getType()) {
+            return false;
+        }
+        value->setValue(newValue);
+        return true;
+    }
+    return false;
+}
+
 bool configValueRestore(const String &name) {
     if (auto *value = findConfig(name)) {
         value->setValue(value->getDefaultValue());
@@ -124,37 +366,46 @@ enum JSONParseState {
     JS_InKey,
     JS_NeedColon,
     JS_NeedValue,
-    JS_InValue
+    JS_InValue,
+    JS_NeedSeparator,
+    JS_Done
 };
 
-void configValuesLoad() {
-    // listDir(SPIFFS, "/", 0);
-    const char *path = "/config.json";
-
-    File file = SPIFFS.open(path);
-    if (!file || file.isDirectory()) {
-        Serial.println("! Failed to open config.json for reading");
-        return;
-    }
+static inline bool isJSONSpace(int ch) {
+    return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+}
 
+// Parses a flat JSON object of "key": number pairs. nextChar returns the
+// next character, or a value <= 0 at the end. onPair gets each key and the
+// text of its value; onUnexpected gets characters that do not fit. Either
+// returns false to stop. Returns true if the object was closed.
+template <typename NextChar, typename OnPair, typename OnUnexpected>
+static bool parseConfigJson(NextChar nextChar, OnPair onPair, OnUnexpected onUnexpected) {
     JSONParseState state = JS_NeedObject;
     String key;
     String valueString;
-    while (file.available()) {
-        const auto ch = file.read();
-        if (ch <= 0)
-            break;
+    for (int ch = nextChar(); ch > 0; ch = nextChar()) {
+        bool ok = true;
         switch (state) {
             case JS_NeedObject:
                 if (ch == '{') {
                     state = JS_NeedKey;
                 }
+                else if (!isJSONSpace(ch)) {
+                    ok = onUnexpected(ch);
+                }
                 break;
             case JS_NeedKey:
                 if (ch == '"') {
                     state = JS_InKey;
                     key = "";
                 }
+                else if (ch == '}') {
+                    state = JS_Done;
+                }
+                else if (!isJSONSpace(ch)) {
+                    ok = onUnexpected(ch);
+                }
                 break;
             case JS_InKey:
                 if (ch == '"') {
@@ -168,33 +419,181 @@ void configValuesLoad() {
                 if (ch == ':') {
                     state = JS_NeedValue;
                 }
+                else if (!isJSONSpace(ch)) {
+                    ok = onUnexpected(ch);
+                }
                 break;
             case JS_NeedValue:
                 if ((ch >= '0' && ch <= '9') || (ch == '-')) {
                     state = JS_InValue;
                     valueString = (char)ch;
                 }
+                else if (!isJSONSpace(ch)) {
+                    ok = onUnexpected(ch);
+                }
                 break;
             case JS_InValue:
-                if (isdigit(ch) || ch == '.' || ch == '-' || ch == 'e' || ch == 'E') {
+                if (isdigit(ch) || ch == '.' || ch == '-' || ch == '+' || ch == 'e' || ch == 'E') {
                     valueString += (char)ch;
-                } else if (ch == ',' || ch == '}' || ch == '\n') {
-                    ConfigValue *config = findConfig(key);
-                    if (!config) {
-                        ESP_LOGE("Config", "Unknown config key: %s", key.c_str());
-                    }
-                    else {
-                        ESP_LOGD("Config", "Loaded config: %s = %s", key.c_str(), valueString.c_str());
-                        config->value.setToString(valueString);
-                    }
-                    state = (ch == ',') ? JS_NeedKey : JS_NeedObject;
-                } else {
-                    ESP_LOGW("Config", "Unexpected character in value: %c", ch);
+                }
+                else if (ch == ',' || ch == '}' || isJSONSpace(ch)) {
+                    ok = onPair(key, valueString);
+                    state = (ch == ',') ? JS_NeedKey : (ch == '}') ? JS_Done : JS_NeedSeparator;
+                }
+                else {
+                    ok = onUnexpected(ch);
+                }
+                break;
+            case JS_NeedSeparator:
+                if (ch == ',') {
+                    state = JS_NeedKey;
+                }
+                else if (ch == '}') {
+                    state = JS_Done;
+                }
+                else if (!isJSONSpace(ch)) {
+                    ok = onUnexpected(ch);
+                }
+                break;
+            case JS_Done:
+                if (!isJSONSpace(ch)) {
+                    ok = onUnexpected(ch);
                 }
                 break;
         }
+        if (!ok) {
+            return false;
+        }
+    }
+    return state == JS_Done;
+}
+
+// Parses the whole of text as a value of the given type
+static bool parseValueString(const String &text, ValueType type, Value &out) {
+    const char *begin = text.c_str();
+    char *end = nullptr;
+    if (type == VT_Int) {
+        const long v = strtol(begin, &end, 10);
+        if (end == begin || *end != '\0' || v < numeric_limits<int32_t>::min() || v > numeric_limits<int32_t>::max()) {
+            return false;
+        }
+        out = Value::fromInt((int32_t)v);
+    }
+    else {
+        const float v = strtof(begin, &end);
+        if (end == begin || *end != '\0' || !isfinite(v)) {
+            return false;
+        }
+        out = Value::fromFloat(v);
+    }
+    return true;
+}
+
+void configValuesLoad() {
+    // listDir(SPIFFS, "/", 0);
+    const char *path = "/config.json";
+
+    File file = SPIFFS.open(path);
+    if (!file || file.isDirectory()) {
+        Serial.println("! Failed to open config.json for reading");
+        return;
     }
+
+    parseConfigJson(
+        [&file]() -> int {
+            return file.available() ? file.read() : -1;
+        },
+        [](const String &key, const String &valueString) {
+            ConfigValue *config = findConfig(key);
+            Value loaded = Value::fromInt(0);
+            if (!config) {
+                ESP_LOGE("Config", "Unknown config key: %s", key.c_str());
+            }
+            else if (!parseValueString(valueString, config->value.getType(), loaded)) {
+                ESP_LOGE("Config", "Invalid value for %s: %s", key.c_str(), valueString.c_str());
+            }
+            else {
+                ESP_LOGD("Config", "Loaded config: %s = %s", key.c_str(), valueString.c_str());
+                config->value = config->clamp(loaded);
+            }
+            return true;
+        },
+        [](int ch) {
+            ESP_LOGW("Config", "Unexpected character in config.json: %c", ch);
+            return true;
+        });
     file.close();
+    generation.fetch_add(1, memory_order_release);
+}
+
+bool configValuesApplyJson(const char *json, size_t length, size_t &changed, String &error) {
+    changed = 0;
+    size_t pos = 0;
+    auto nextChar = [json, length, &pos]() -> int {
+        return pos < length ? (unsigned char)json[pos++] : -1;
+    };
+    auto onUnexpected = [&error, &pos](int ch) {
+        error = "Unexpected character '" + String((char)ch) + "' at " + String((unsigned)(pos - 1));
+        return false;
+    };
+
+    // Check everything before changing anything
+    const bool complete = parseConfigJson(nextChar,
+        [&error](const String &key, const String &valueString) {
+            const ConfigValue *config = findConfig(key);
+            if (!config) {
+                error = "Unknown config key: " + key;
+                return false;
+            }
+            Value v = Value::fromInt(0);
+            if (!parseValueString(valueString, config->getValue().getType(), v)) {
+                error = "Invalid value for " + key + ": " + valueString;
+                return false;
+            }
+            const ConfigDescriptor &d = config->getDescriptor();
+            if (v < d.minValue || d.maxValue < v) {
+                error = key + " = " + valueString + " is outside " + d.minValue.toString() + " to " + d.maxValue.toString();
+                return false;
+            }
+            return true;
+        },
+        onUnexpected);
+    if (!complete) {
+        if (error.length() == 0) {
+            error = "Incomplete JSON object";
+        }
+        return false;
+    }
+
+    pos = 0;
+    parseConfigJson(nextChar,
+        [&changed](const String &key, const String &valueString) {
+            ConfigValue *config = findConfig(key);
+            Value v = config->value;
+            parseValueString(valueString, v.getType(), v);
+            if (v != config->value) {
+                ESP_LOGI("Config", "Config set %s = %s (was %s)", config->getName(), v.toString().c_str(), config->value.toString().c_str());
+                config->value = v;
+                config->changedGeneration = UNSTAMPED;
+                changed++;
+            }
+            return true;
+        },
+        onUnexpected);
+    if (changed > 0) {
+        // One generation for the whole object
+        portENTER_CRITICAL(&generationLock);
+        const uint32_t stamp = generation.load(memory_order_relaxed) + 1;
+        for (ConfigValue *config = ConfigRegistry::head; config; config = config->next) {
+            if (config->changedGeneration == UNSTAMPED) {
+                config->changedGeneration = stamp;
+            }
+        }
+        generation.store(stamp, memory_order_release);
+        portEXIT_CRITICAL(&generationLock);
+        requestSave();
+    }
+    return true;
 }
 
 static void configValuesSave() {
@@ -212,8 +611,8 @@ static void configValuesSave() {
     }
     file.print("{");
     const char *head = "\n  ";
-    configValuesIterate([&file, &head](const String &name, const Value &value) {
-        file.printf("%s\"%s\": %s", head, name.c_str(), value.toString().c_str());
+    configValuesIterate([&file, &head](const char *name, const Value &value) {
+        file.printf("%s\"%s\": %s", head, name, value.toString().c_str());
         head = ",\n  ";
     });
     const auto ok = file.printf("\n}\n") == 3;
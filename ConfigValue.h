@@ -1,30 +1,64 @@
 #pragma once
 
 #include <Arduino.h>
+#include <cstdint>
 #include <functional>
+#include <limits>
 #include "Value.h"
 
-class ConfigValue {
-    String name;
-    String descriptionHtml;
+// Everything about a config value that never changes. Declare descriptors
+// constexpr so the names, descriptions and defaults stay in flash; only the
+// current Value of each ConfigValue lives in RAM.
+struct ConfigDescriptor {
+    const char *name;
+    const char *descriptionHtml;
     Value defaultValue;
+    Value minValue;
+    Value maxValue;
+
+    constexpr static ConfigDescriptor fromInt(const char *name, const char *descriptionHtml, std::int32_t defaultValue,
+        std::int32_t minValue = std::numeric_limits<std::int32_t>::min(),
+        std::int32_t maxValue = std::numeric_limits<std::int32_t>::max()) {
+        return ConfigDescriptor{ name, descriptionHtml, Value::fromInt(defaultValue), Value::fromInt(minValue), Value::fromInt(maxValue) };
+    }
+    constexpr static ConfigDescriptor fromFloat(const char *name, const char *descriptionHtml, float defaultValue,
+        float minValue = std::numeric_limits<float>::lowest(),
+        float maxValue = std::numeric_limits<float>::max()) {
+        return ConfigDescriptor{ name, descriptionHtml, Value::fromFloat(defaultValue), Value::fromFloat(minValue), Value::fromFloat(maxValue) };
+    }
+};
+
+class ConfigValue {
+    const ConfigDescriptor &descriptor;
     Value value;
+    ConfigValue *next;  // Registry, in construction order
+    uint32_t changedGeneration; // Generation of the last change, 0 if never
 
     friend void configValuesLoad();
+    friend bool configValuesApplyJson(const char *json, size_t length, size_t &changed, String &error);
+    friend struct ConfigRegistry;
+
+    Value clamp(const Value &v) const;
 public:
-    ConfigValue(const String &name, const String &descriptionHtml, Value defaultValue);
-    inline const String &getName() const {
-        return name;
+    // The descriptor must outlive the value; in practice it is a constexpr
+    // global
+    explicit ConfigValue(const ConfigDescriptor &descriptor);
+    inline const char *getName() const {
+        return descriptor.name;
     }
-    inline const String &getDescriptionHtml() const {
-        return descriptionHtml;
+    inline const char *getDescriptionHtml() const {
+        return descriptor.descriptionHtml;
+    }
+    inline const ConfigDescriptor &getDescriptor() const {
+        return descriptor;
     }
     inline Value getDefaultValue() const {
-        return defaultValue;
+        return descriptor.defaultValue;
     }
     inline Value getValue() const {
         return value;
     }
+    // Values outside the descriptor's range are clamped
     void setValue(const Value &newValue);
     void setValueString(const String &newValueString);
     inline int32_t getInt() const {
@@ -42,11 +76,58 @@ public:
     inline String toString(int decimalPlaces = -1) const {
         return value.toString(decimalPlaces);
     }
-    
+    inline uint32_t getChangedGeneration() const {
+        return changedGeneration;
+    }
+    inline const ConfigValue *getNext() const {
+        return next;
+    }
+
+};
+
+#define CONFIG_SCHEMA_ENTRY_MAX 512
+
+// Position in the schema JSON while it is streamed. Entries are rendered one
+// at a time straight from the descriptors, so a response needs no String.
+struct ConfigSchemaCursor {
+    const ConfigValue *next;
+    bool started;
+    bool ended;                 // The closing brackets are pending or sent
+    size_t pendingLength;
+    size_t pendingOffset;
+    char pending[CONFIG_SCHEMA_ENTRY_MAX];
+
+    ConfigSchemaCursor() : next(nullptr), started(false), ended(false), pendingLength(0), pendingOffset(0) {}
 };
 
 void configValuesLoad();
-void configValuesIterate(const std::function<void(const String &, const Value &)> &callback);
-void configDefaultValuesIterate(const std::function<void(const String &, const Value &)> &callback);
+size_t configValuesCount();
+// Registry order, for protocols that address values by index
+const ConfigValue *configValuesFirst();
+void configValuesIterate(const std::function<void(const char *, const Value &)> &callback);
+void configDefaultValuesIterate(const std::function<void(const char *, const Value &)> &callback);
+// Bumped on every change, so cached copies of the values can be checked
+uint32_t configValuesGetGeneration();
+// Change events: calls back for every value changed after generation since,
+// with its name, value and the generation of its change. Returns the
+// generation to pass next time. Changes still being made are left for
+// the next call, so none are missed.
+uint32_t configValuesChangedSince(uint32_t since, const std::function<void(const char *, const Value &, uint32_t)> &callback);
+// Appends the current values as one flat JSON object
+void configValuesWriteJson(String &out);
 bool configValueSetString(const String &name, const String &valueString);
+// The value must have the config's type; it is clamped to the range
+bool configValueSet(const char *name, const Value &value);
+// Applies a flat JSON object of name: number pairs as one change. Nothing is
+// applied unless every name is known and every value parses and is in
+// range. On success the generation is bumped and the file saved once.
+bool configValuesApplyJson(const char *json, size_t length, size_t &changed, String &error);
 bool configValueRestore(const String &name);
+// While deferred, changes only mark the file dirty and
+// configValuesSaveIfRequested writes it
+void configValuesDeferSaves(bool defer);
+bool configValuesSaveIfRequested();
+// Writes up to maxLength bytes of {"values":[{"name","type","default","min",
+// "max","description"},...]} and returns how many were written, 0 once done.
+// min and max are null when unbounded.
+size_t configSchemaRead(ConfigSchemaCursor &cursor, uint8_t *buffer, size_t maxLength);
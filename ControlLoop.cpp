@@ -1,111 +1,231 @@
 #include <Arduino.h>
+#include "AllocTracker.h"
+#include "Boot.h"
+#include "ControlLoop.h"
+#include "DeferredLog.h"
+#include "Failsafe.h"
+#include "History.h"
+#include "Latency.h"
 #include "Geometry.h"
 #include "MPU.h"
 #include "State.h"
 #include "PID.h"
 #include "Motors.h"
 #include "StateMachine.h"
+#include "RadioController.h"
 
-#define CONTROL_LOOP_HZ 100
-#define CONTROL_LOOP_INTERVAL_MICROS (1000000 / CONTROL_LOOP_HZ)
+// The rate loop runs on every tick at the IMU rate
+#define DEFAULT_CONTROL_LOOP_HZ 1000
+#define FLIGHT_STATE_HZ 100
+#define LOOP_CALIBRATION_TICKS 2000
 
-static const float deg2rad = 0.017453292519943295769236907684886f;
-static const float rad2deg = 57.295779513082320876798154814105f;
-static const float piOver2 = 1.5707963267948966192313216916398f;
+enum ControlMode {
+    CM_Angle    = 0,
+    CM_Acro     = 1,
+};
 
-static unsigned long nextControlLoopMicros = 0;
 static int loopCounter = 0;
+static bool attitudeReported = false;
+// Loop time: advances one period per tick, counting missed ticks
+static uint64_t loopClockMicros = 0;
+static float loopHz = 0.0f;
+static uint32_t loopIntervalMicros = 0;
+static int32_t appliedAngleDivisor = 0;
 
-static const float dDefaultFilter = 0.1f;
-static const float dDefaultLimit = 0.2f;
-static const float iDefaultLimit = 0.2f;
-static const float defaultLimit = 1.0f;
+static constexpr float dDefaultFilter = 0.1f;
+static constexpr float dDefaultLimit = 0.2f;
+static constexpr float iDefaultLimit = 0.2f;
+static constexpr float defaultLimit = 1.0f;
+// Fastest pitch/roll rate the angle loop will ask for (rad/s)
+static constexpr float angleRateLimit = 4.0f;
 
-PID pitchPID("pitchPID", 1.0f / (piOver2), 0.0f, 0.0f,
+static constexpr ConfigDescriptor controlLoopHzDescriptor = ConfigDescriptor::fromInt("control.loopHz", "Rate loop frequency (Hz, 100-2000)", DEFAULT_CONTROL_LOOP_HZ, CONTROL_LOOP_MIN_HZ, CONTROL_LOOP_MAX_HZ);
+ConfigValue controlLoopHz(controlLoopHzDescriptor);
+static constexpr ConfigDescriptor controlLoopMarginDescriptor = ConfigDescriptor::fromFloat("control.loopHz.margin", "Fraction of each tick left free when calibrating the loop rate (0-0.9)", 0.3f, 0.0f, 0.9f);
+ConfigValue controlLoopMargin(controlLoopMarginDescriptor);
+static constexpr ConfigDescriptor controlModeDescriptor = ConfigDescriptor::fromInt("control.mode", "Flight mode (0 = angle, 1 = acro)", CM_Angle, CM_Angle, CM_Acro);
+ConfigValue controlMode(controlModeDescriptor);
+static constexpr ConfigDescriptor angleLoopDivisorDescriptor = ConfigDescriptor::fromInt("control.angleDivisor", "Run the angle loop once every this many rate loop ticks", 4, 1);
+ConfigValue angleLoopDivisor(angleLoopDivisorDescriptor);
+static constexpr ConfigDescriptor acroRateDegreesDescriptor = ConfigDescriptor::fromFloat("control.acroRate", "Full-stick pitch and roll rate in acro mode (degrees/s)", 360.0f);
+ConfigValue acroRateDegrees(acroRateDegreesDescriptor);
+static constexpr ConfigDescriptor yawRateDegreesDescriptor = ConfigDescriptor::fromFloat("control.yawRate", "Full-stick yaw rate (degrees/s)", 180.0f);
+ConfigValue yawRateDegrees(yawRateDegreesDescriptor);
+
+static constexpr FilterConfigDescriptors dtermFilterDescriptors = FILTER_CONFIG("dtermFilter", LPT_Off, 30.0f);
+FilterConfig dtermFilterConfig(dtermFilterDescriptors);
+// Outer loop: angle error (rad) to rate setpoint (rad/s)
+static constexpr PIDConfigDescriptors pitchAnglePIDDescriptors = PID_CONFIG("pitchAnglePID", 4.0f, 0.0f, 0.0f,
+    dDefaultFilter, iDefaultLimit, dDefaultLimit, angleRateLimit);
+static constexpr PIDConfigDescriptors rollAnglePIDDescriptors = PID_CONFIG("rollAnglePID", 4.0f, 0.0f, 0.0f,
+    dDefaultFilter, iDefaultLimit, dDefaultLimit, angleRateLimit);
+PID pitchAnglePID(pitchAnglePIDDescriptors);
+PID rollAnglePID(rollAnglePIDDescriptors);
+// Inner loop: rate error (rad/s) to normalized torque
+static constexpr PIDConfigDescriptors pitchRatePIDDescriptors = PID_CONFIG("pitchRatePID", 0.15f, 0.1f, 0.0f,
+    dDefaultFilter, iDefaultLimit, dDefaultLimit, defaultLimit);
+static constexpr PIDConfigDescriptors rollRatePIDDescriptors = PID_CONFIG("rollRatePID", 0.15f, 0.1f, 0.0f,
     dDefaultFilter, iDefaultLimit, dDefaultLimit, defaultLimit);
-PID rollPID("rollPID", 1.0f / (piOver2), 0.0f, 0.0f,
+static constexpr PIDConfigDescriptors yawRatePIDDescriptors = PID_CONFIG("yawRatePID", 0.3f, 0.1f, 0.0f,
     dDefaultFilter, iDefaultLimit, dDefaultLimit, defaultLimit);
+PID pitchRatePID(pitchRatePIDDescriptors, &dtermFilterConfig);
+PID rollRatePID(rollRatePIDDescriptors, &dtermFilterConfig);
+PID yawRatePID(yawRatePIDDescriptors, &dtermFilterConfig);
 MotorMixer motorMixer;
+// Config generation the mix was built at; none yet
+static uint32_t mixGeneration = UINT32_MAX;
 
-static Quaternion combineCommands(const Quaternion& qYaw, const Quaternion& qPitch, const Quaternion& qRoll) {
-    // Typical order: yaw * pitch * roll
-    return qYaw * qPitch * qRoll;
-}
+static MPU *controlMPU = nullptr;
+static const MPUSample *currentSample = nullptr;
+static Quaternion currentOrientation;
+static Vector currentRates;
+static Vector rateSetpoint;
+
+// What the angle and rate loops track this tick
+struct PilotCommand {
+    float pitchRadians;
+    float rollRadians;
+    float yaw;          // -1 to 1
+    float throttle;     // 0 to 1
+    bool level;         // Self-level regardless of control.mode
+};
+static PilotCommand command = { 0.0f, 0.0f, 0.0f, 0.0f, false };
+
+// Loop rate calibration. The web server only moves the status from idle or
+// finished to requested; everything else happens on the control path.
+static volatile int32_t calStatus = LRC_Idle;
+static volatile bool calApply = false;
+static LoopRateCalibration calResult = { LRC_Idle, 0, 0, 0.0f, 0.0f, false };
+static bool calibratingLoop = false;
+static uint32_t calTicks = 0;
+static uint32_t calMaxReleaseMicros = 0;
 
 static Quaternion getOrientationError(const Quaternion &current, const Quaternion &target) {
     return current * target.inverse();
 }
 
-void controlLoop(MPU &mpu) {
-    unsigned long nowMicros = micros();
-    if (nextControlLoopMicros == 0) {
-        nextControlLoopMicros = nowMicros + CONTROL_LOOP_INTERVAL_MICROS;
+static bool isControlActive(const State &state) {
+    return state.flightStatus == FS_Flying
+        || state.flightStatus == FS_Disarming
+        || state.flightStatus == FS_ArmingWaitingForNoInput
+        || state.flightStatus == FS_Failsafe;
+}
+
+static uint32_t loopClockMillis() {
+    return (uint32_t)(loopClockMicros / 1000);
+}
+
+//
+// Read sensor data
+//
+static void sensorStage() {
+    MPU &mpu = *controlMPU;
+    const bool mpuOk = mpu.update(*currentSample);
+    currentOrientation = mpu.getOrientation();
+    currentRates = mpu.getRates();
+    stateUpdateOrientation(currentOrientation, currentRates, mpuOk);
+    if (mpuOk && !attitudeReported && mpu.hasAttitude()) {
+        attitudeReported = true;
+        bootPhaseEnd(BP_FirstAttitude);
+    }
+}
+
+//
+// Run state machine
+//
+static void flightStateStage() {
+    flightState.update(loopClockMillis());
+}
+
+//
+// Pick the sticks or, after RC loss, the failsafe descent
+//
+static void commandStage() {
+    const State &state = getState();
+    if (state.flightStatus == FS_Failsafe) {
+        command.pitchRadians = 0.0f;
+        command.rollRadians = 0.0f;
+        command.yaw = 0.0f;
+        command.throttle = failsafeGetThrottle(flightState.getMillisInState(loopClockMillis()));
+        command.level = true;
         return;
     }
-    if (nowMicros < nextControlLoopMicros) {
+    command.pitchRadians = state.rcPitchRadians;
+    command.rollRadians = state.rcRollRadians;
+    command.yaw = state.rcYaw;
+    command.throttle = state.rcThrottle;
+    command.level = false;
+}
+
+//
+// Outer loop: turn stick angles into pitch and roll rate setpoints
+//
+static void angleStage() {
+    const State &state = getState();
+    if ((!isControlActive(state) && !calibratingLoop) || (controlMode.getInt() == CM_Acro && !command.level)) {
         return;
     }
-    nextControlLoopMicros += CONTROL_LOOP_INTERVAL_MICROS;
-    if (nextControlLoopMicros <= nowMicros) {
-        nextControlLoopMicros = nowMicros + CONTROL_LOOP_INTERVAL_MICROS;
+    const float pitchCommandRad = command.pitchRadians;
+    const float rollCommandRad = command.rollRadians;
+    // Yaw is rate controlled, so the setpoint is pitch * roll
+    const auto qCmd = Quaternion::fromEulerXY(pitchCommandRad, rollCommandRad);
+    const auto qError = getOrientationError(currentOrientation, qCmd);
+    const Vector error = qError.toRotationVector();
+    stateUpdateControlErrors(error.x, error.y);
+
+    rateSetpoint.x = pitchAnglePID.updateError(error.x);
+    rateSetpoint.y = rollAnglePID.updateError(error.y);
+}
+
+//
+// Inner loop: track rate setpoints on the gyro and drive the motors
+//
+static void rateStage() {
+    latencyMark(LM_Consumed);
+    const State &state = getState();
+    // While calibrating the loop rate the whole control path runs disarmed,
+    // but the motors are still held at zero
+    const bool active = isControlActive(state);
+    if (!active && !calibratingLoop) {
+        motorsSendCommands(
+            0.0f,
+            0.0f,
+            0.0f,
+            0.0f,
+            0.0f,
+            0.0f);
+        return;
     }
-    
-    //
-    // Read sensor data
-    //
-    const bool mpuOk = mpu.update();
-    const auto currentOrientation = mpu.getOrientation();
-    const Vector orientEuler = currentOrientation.toEulerAngles();
-    stateUpdateOrientation(orientEuler.x, orientEuler.y, orientEuler.z, mpuOk);
+
+    if (controlMode.getInt() == CM_Acro && !command.level) {
+        const float acroRate = acroRateDegrees.getFloat() * DEG_TO_RAD_F;
+        const float pitchMax = rcGetPitchMaxRadians();
+        const float rollMax = rcGetRollMaxRadians();
+        rateSetpoint.x = pitchMax > 0.0f ? command.pitchRadians / pitchMax * acroRate : 0.0f;
+        rateSetpoint.y = rollMax > 0.0f ? command.rollRadians / rollMax * acroRate : 0.0f;
+    }
+    rateSetpoint.z = command.yaw * yawRateDegrees.getFloat() * DEG_TO_RAD_F;
+
+    const float pitchOutput = pitchRatePID.updateError(currentRates.x - rateSetpoint.x);
+    const float rollOutput = rollRatePID.updateError(currentRates.y - rateSetpoint.y);
+    const float yawOutput = yawRatePID.updateError(currentRates.z - rateSetpoint.z);
 
     //
-    // Run state machine
+    // Mix outputs into motor commands
     //
-    flightState.update();
-
-    const State stateBeforeCommands = getState();
-    if (stateBeforeCommands.flightStatus == FS_Flying
-        || stateBeforeCommands.flightStatus == FS_Disarming
-        || stateBeforeCommands.flightStatus == FS_ArmingWaitingForNoInput) {
-        //
-        // Compute control errors
-        //
-        const float pitchCommandRad = stateBeforeCommands.rcPitchRadians;
-        const float rollCommandRad = stateBeforeCommands.rcRollRadians;
-        const Quaternion qYaw;
-        const auto qPitch = Quaternion::fromEulerAngles(Vector(pitchCommandRad, 0.0f, 0.0f));
-        const auto qRoll = Quaternion::fromEulerAngles(Vector(0.0f, rollCommandRad, 0.0f));
-        const auto qCmd = combineCommands(qYaw, qPitch, qRoll);
-        const auto qError = getOrientationError(currentOrientation, qCmd);
-        const Vector errorEuler = qError.toEulerAngles();
-        stateUpdateControlErrors(errorEuler.x, errorEuler.y);
-
-        //
-        // Compute PID outputs
-        //
-        // Serial.printf("%.3f,%.3f,%.3f\n", orientEuler.x * rad2deg, pitchCommandDeg, errorEuler.x * rad2deg);
-        const float pitchOutput = pitchPID.updateError(errorEuler.x);
-        const float rollOutput = rollPID.updateError(errorEuler.y);
-
-        //
-        // Mix outputs into motor commands
-        //
+    // The mix only changes with the airframe config
+    const uint32_t generation = configValuesGetGeneration();
+    if (generation != mixGeneration) {
         motorMixer.updateMotorMix();
-        MixValues mixValues;
-        mixValues.thrust = stateBeforeCommands.rcThrottle;
-        mixValues.pitch = pitchOutput;
-        mixValues.roll = rollOutput;
-        mixValues.yaw = stateBeforeCommands.rcYaw;
-        motorMixer.mix(mixValues);
-        motorsSendCommands(
-            motorMixer.getMotorCommand(0),
-            motorMixer.getMotorCommand(1),
-            motorMixer.getMotorCommand(2),
-            motorMixer.getMotorCommand(3),
-            motorMixer.getMotorCommand(4),
-            motorMixer.getMotorCommand(5));
-    }
-    else {
+        mixGeneration = generation;
+    }
+    MixValues mixValues;
+    mixValues.thrust = command.throttle;
+    mixValues.pitch = pitchOutput;
+    mixValues.roll = rollOutput;
+    mixValues.yaw = yawOutput;
+    motorMixer.mix(mixValues);
+    if (!active) {
         motorsSendCommands(
             0.0f,
             0.0f,
@@ -113,7 +233,206 @@ void controlLoop(MPU &mpu) {
             0.0f,
             0.0f,
             0.0f);
+        return;
     }
+    motorsSendCommands(
+        motorMixer.getMotorCommand(0),
+        motorMixer.getMotorCommand(1),
+        motorMixer.getMotorCommand(2),
+        motorMixer.getMotorCommand(3),
+        motorMixer.getMotorCommand(4),
+        motorMixer.getMotorCommand(5));
+}
+
+// One sample per tick for /history
+static void recordHistory() {
+    const State &state = getState();
+    const float values[HC_Recorded] = {
+        currentRates.x, currentRates.y, currentRates.z,
+        rateSetpoint.x, rateSetpoint.y, rateSetpoint.z,
+        command.throttle,
+        state.motor1Command, state.motor2Command, state.motor3Command,
+        state.motor4Command, state.motor5Command, state.motor6Command,
+    };
+    historyWrite((uint32_t)loopClockMicros, values, currentOrientation);
+}
+
+// Table order is execution order within a tick
+static SchedulerStage stages[] = {
+    SchedulerStage("sensor", sensorStage, 1),
+    SchedulerStage("flightState", flightStateStage, DEFAULT_CONTROL_LOOP_HZ / FLIGHT_STATE_HZ),
+    SchedulerStage("command", commandStage, 1),
+    SchedulerStage("angle", angleStage, 4),
+    SchedulerStage("rate", rateStage, 1),
+};
+static const size_t flightStateStageIndex = 1;
+static const size_t angleStageIndex = 3;
+static Scheduler scheduler(stages, sizeof(stages) / sizeof(stages[0]));
+
+const Scheduler &controlLoopGetScheduler() {
+    return scheduler;
+}
+
+float controlLoopGetRateHz() {
+    return loopHz;
+}
+
+// Picks up changes to control.loopHz and control.angleDivisor. Filters are
+// redesigned by their banks when they see the new sample rate.
+static void applyLoopRate(MPU &mpu) {
+    int32_t hz = controlLoopHz.getInt();
+    if (hz < CONTROL_LOOP_MIN_HZ) hz = CONTROL_LOOP_MIN_HZ;
+    if (hz > CONTROL_LOOP_MAX_HZ) hz = CONTROL_LOOP_MAX_HZ;
+    int32_t angleDivisor = angleLoopDivisor.getInt();
+    if (angleDivisor < 1) angleDivisor = 1;
+    if ((float)hz == loopHz && angleDivisor == appliedAngleDivisor) {
+        return;
+    }
+    loopHz = (float)hz;
+    loopIntervalMicros = 1000000 / hz;
+    appliedAngleDivisor = angleDivisor;
+    const float angleHz = loopHz / (float)angleDivisor;
+    const int32_t flightStateDivisor = hz / FLIGHT_STATE_HZ;
+
+    mpu.setSampleRate(loopHz);
+    pitchRatePID.setSampleRate(loopHz);
+    rollRatePID.setSampleRate(loopHz);
+    yawRatePID.setSampleRate(loopHz);
+    pitchAnglePID.setSampleRate(angleHz);
+    rollAnglePID.setSampleRate(angleHz);
+
+    scheduler.getStage(flightStateStageIndex).divisor = flightStateDivisor > 0 ? (uint32_t)flightStateDivisor : 1;
+    scheduler.getStage(angleStageIndex).divisor = (uint32_t)angleDivisor;
+    scheduler.setTickInterval(loopIntervalMicros);
+    scheduler.resetStats();
+    DLOG_I("Control", "Loop rate %d Hz (%u us), angle loop %.1f Hz", hz, (unsigned)loopIntervalMicros, angleHz);
+}
+
+bool controlLoopBeginRateCalibration(bool apply) {
+    if (getState().flightStatus != FS_Disarmed) {
+        return false;
+    }
+    if (calStatus == LRC_Requested || calStatus == LRC_Running) {
+        return false;
+    }
+    calApply = apply;
+    calStatus = LRC_Requested;
+    return true;
+}
+
+LoopRateCalibration controlLoopGetRateCalibration() {
+    LoopRateCalibration result = calResult;
+    result.status = calStatus;
+    return result;
+}
+
+static void endRateCalibration(int32_t status) {
+    calibratingLoop = false;
+    scheduler.setRunAll(false);
+    // The control path ran on zero sticks; start the next flight clean
+    pitchAnglePID.resetErrorIntegral();
+    rollAnglePID.resetErrorIntegral();
+    pitchRatePID.resetErrorIntegral();
+    rollRatePID.resetErrorIntegral();
+    yawRatePID.resetErrorIntegral();
+    calStatus = status;
+}
+
+// Runs before each tick
+static void startRateCalibration() {
+    if (calStatus != LRC_Requested) {
+        return;
+    }
+    if (getState().flightStatus != FS_Disarmed) {
+        calStatus = LRC_Aborted;
+        return;
+    }
+    calibratingLoop = true;
+    calTicks = 0;
+    calMaxReleaseMicros = 0;
+    scheduler.setRunAll(true);
+    scheduler.resetStats();
+    calStatus = LRC_Running;
+}
+
+// Runs after each tick. releaseMicros is how long ago the tick timer fired.
+static void updateRateCalibration(uint32_t releaseMicros) {
+    if (!calibratingLoop) {
+        return;
+    }
+    if (releaseMicros > calMaxReleaseMicros) {
+        calMaxReleaseMicros = releaseMicros;
+    }
+    if (getState().flightStatus != FS_Disarmed) {
+        DLOG_W("Control", "Loop rate calibration aborted, vehicle is no longer disarmed");
+        endRateCalibration(LRC_Aborted);
+        return;
+    }
+    calTicks++;
+    if (calTicks < LOOP_CALIBRATION_TICKS) {
+        return;
+    }
+
+    // From the timer firing to the motors being written: the bus read, the
+    // hand-off between tasks and the tick itself
+    const uint32_t worstMicros = calMaxReleaseMicros;
+    float margin = controlLoopMargin.getFloat();
+    if (margin < 0.0f) margin = 0.0f;
+    if (margin > 0.9f) margin = 0.9f;
+    int32_t recommendedHz = worstMicros > 0
+        ? (int32_t)(1.0e6f * (1.0f - margin) / (float)worstMicros)
+        : CONTROL_LOOP_MAX_HZ;
+    // Round down to a multiple of 50 Hz
+    recommendedHz -= recommendedHz % 50;
+    if (recommendedHz > CONTROL_LOOP_MAX_HZ) recommendedHz = CONTROL_LOOP_MAX_HZ;
+    if (recommendedHz < CONTROL_LOOP_MIN_HZ) {
+        DLOG_W("Control", "Worst tick of %u us cannot keep the margin even at %d Hz", (unsigned)worstMicros, CONTROL_LOOP_MIN_HZ);
+        recommendedHz = CONTROL_LOOP_MIN_HZ;
+    }
+
+    calResult.ticks = calTicks;
+    calResult.worstTickMicros = worstMicros;
+    calResult.measuredAtHz = loopHz;
+    calResult.recommendedHz = (float)recommendedHz;
+    calResult.applied = calApply;
+    DLOG_I("Control", "Loop rate calibration: worst tick %u us, recommend %d Hz", (unsigned)worstMicros, recommendedHz);
+    endRateCalibration(LRC_Done);
+    if (calApply) {
+        // The file is written later by the persistence task
+        controlLoopHz.setValue(Value::fromInt(recommendedHz));
+    }
+}
+
+void controlLoopBegin(MPU &mpu) {
+    controlMPU = &mpu;
+    applyLoopRate(mpu);
+}
+
+uint32_t controlLoopGetIntervalMicros() {
+    return loopIntervalMicros;
+}
+
+uint64_t controlLoopGetClockMicros() {
+    return loopClockMicros;
+}
+
+void controlLoopTick(const MPUSample &sample, uint32_t releasedAtMicros, uint32_t missedTicks) {
+    // PRD.md: no dynamic memory in the flight loop, including the rate
+    // changes and calibration around the stages
+    AllocHotRegion hot;
+    for (uint32_t i = 0; i < missedTicks; ++i) {
+        scheduler.countOverrun();
+    }
+    applyLoopRate(*controlMPU);
+    loopClockMicros += (uint64_t)loopIntervalMicros * (1 + missedTicks);
+    rcApplyLatestFrame(loopClockMicros);
+
+    currentSample = &sample;
+    startRateCalibration();
+    scheduler.runTick();
+    recordHistory();
+    updateRateCalibration(micros() - releasedAtMicros);
+    currentSample = nullptr;
 
     loopCounter++;
 }
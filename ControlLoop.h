@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+
+#include "MPU.h"
+#include "Scheduler.h"
+
+#define CONTROL_LOOP_MIN_HZ 100
+#define CONTROL_LOOP_MAX_HZ 2000
+
+enum LoopRateCalibrationStatus {
+    LRC_Idle        = 0,
+    LRC_Requested   = 1,
+    LRC_Running     = 2,
+    LRC_Done        = 3,
+    LRC_Aborted     = 4,
+};
+
+struct LoopRateCalibration {
+    int32_t status;
+    uint32_t ticks;             // Ticks measured
+    uint32_t worstTickMicros;   // Worst tick with every stage running
+    float measuredAtHz;         // Loop rate during the measurement
+    float recommendedHz;        // Highest rate that keeps the safety margin
+    bool applied;               // Whether control.loopHz was set to it
+};
+
+// Applies the configured loop rate. Call once before the first tick.
+void controlLoopBegin(MPU &mpu);
+
+// Runs one control tick on a sample from MPU::acquire. releasedAtMicros is
+// when the tick timer fired; missedTicks counts timer periods that passed
+// without a tick and are recorded as overruns.
+void controlLoopTick(const MPUSample &sample, uint32_t releasedAtMicros, uint32_t missedTicks);
+
+// Tick period for the current control.loopHz; the tick timer follows it
+uint32_t controlLoopGetIntervalMicros();
+
+// Loop time: the sum of tick periods so far, including missed ticks. Flight
+// state and RC timeouts run on it rather than the wall clock.
+uint64_t controlLoopGetClockMicros();
+
+const Scheduler &controlLoopGetScheduler();
+float controlLoopGetRateHz();
+
+// Measures the worst-case tick cost while disarmed and recommends the highest
+// loop rate that leaves control.loopHz.margin of the tick free. When apply is
+// set the recommendation is written to control.loopHz. Returns false if the
+// vehicle is not disarmed or a calibration is already running.
+bool controlLoopBeginRateCalibration(bool apply);
+LoopRateCalibration controlLoopGetRateCalibration();
@@ -0,0 +1,345 @@
+#include <Arduino.h>
+#include <FS.h>
+#include <SPIFFS.h>
+#include <atomic>
+#include <cstdio>
+
+#include "DeferredLog.h"
+#include "ConfigValue.h"
+
+// Lines allowed per format in each window before repeats are suppressed
+#define DEFERRED_LOG_BURST 5
+#define DEFERRED_LOG_WINDOW_MILLIS 1000
+#define DEFERRED_LOG_LIMITER_SLOTS 16
+#define DEFERRED_LOG_FILE "/flybot.log"
+#define DEFERRED_LOG_FILE_OLD "/flybot.log.1"
+#define DEFERRED_LOG_FILE_MAX_BYTES (64 * 1024)
+
+static constexpr ConfigDescriptor logLevelDescriptor = ConfigDescriptor::fromInt("log.level", "Most verbose deferred log level shown (0 = error, 1 = warning, 2 = info)", DLL_Info, DLL_Error, DLL_Info);
+ConfigValue logLevel(logLevelDescriptor);
+static constexpr ConfigDescriptor logToFileDescriptor = ConfigDescriptor::fromInt("log.file", "Append the deferred log to " DEFERRED_LOG_FILE " (0 = off, 1 = on)", 0, 0, 1);
+ConfigValue logToFile(logToFileDescriptor);
+
+//
+// Multi-producer, single-consumer ring. Each slot's sequence is stored
+// relative to its index so the zero-initialized ring is already valid and
+// logging works during static construction.
+//
+struct LogRecord {
+    std::atomic<uint32_t> sequence;
+    uint32_t micros;
+    const char *tag;
+    const char *format;
+    uint8_t level;
+    uint8_t numArgs;
+    DeferredLogArg args[DEFERRED_LOG_MAX_ARGS];
+};
+
+static LogRecord ring[DEFERRED_LOG_RING_SIZE];
+static std::atomic<uint32_t> ringHead(0);
+static uint32_t ringTail = 0;
+
+static std::atomic<uint32_t> written(0);
+static std::atomic<uint32_t> dropped(0);
+static uint32_t suppressed = 0;
+static uint32_t filtered = 0;
+static uint32_t output = 0;
+static uint32_t highWater = 0;
+static std::atomic<uint32_t> fileDropped(0);
+
+static DeferredLogSink sinks[DEFERRED_LOG_MAX_SINKS];
+static std::atomic<uint32_t> numSinks(0);
+
+void deferredLogWrite(DeferredLogLevel level, const char *tag, const char *format,
+    const DeferredLogArg *args, size_t numArgs) {
+    uint32_t pos = ringHead.load(std::memory_order_relaxed);
+    LogRecord *r;
+    for (;;) {
+        r = &ring[pos & (DEFERRED_LOG_RING_SIZE - 1)];
+        const uint32_t base = pos & (DEFERRED_LOG_RING_SIZE - 1);
+        const uint32_t seq = r->sequence.load(std::memory_order_acquire) + base;
+        const int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            if (ringHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else {
+            pos = ringHead.load(std::memory_order_relaxed);
+        }
+    }
+    r->micros = micros();
+    r->tag = tag;
+    r->format = format;
+    r->level = (uint8_t)level;
+    r->numArgs = (uint8_t)(numArgs < DEFERRED_LOG_MAX_ARGS ? numArgs : DEFERRED_LOG_MAX_ARGS);
+    for (size_t i = 0; i < r->numArgs; ++i) {
+        r->args[i] = args[i];
+    }
+    const uint32_t base = pos & (DEFERRED_LOG_RING_SIZE - 1);
+    r->sequence.store(pos + 1 - base, std::memory_order_release);
+    written.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool deferredLogAddSink(DeferredLogSink sink) {
+    const uint32_t n = numSinks.load(std::memory_order_relaxed);
+    if (n >= DEFERRED_LOG_MAX_SINKS) {
+        return false;
+    }
+    sinks[n] = sink;
+    numSinks.store(n + 1, std::memory_order_release);
+    return true;
+}
+
+void deferredLogGetStats(DeferredLogStats &stats) {
+    stats.written = written.load(std::memory_order_relaxed);
+    stats.dropped = dropped.load(std::memory_order_relaxed);
+    stats.suppressed = suppressed;
+    stats.filtered = filtered;
+    stats.output = output;
+    stats.highWater = highWater;
+    stats.fileDropped = fileDropped.load(std::memory_order_relaxed);
+}
+
+//
+// Everything below runs on the logger task
+//
+
+// Formats one record. Each conversion in the format is handed to snprintf
+// on its own with the argument type it asks for.
+static size_t formatRecord(const LogRecord &r, char *line, size_t size) {
+    static const char levelChars[] = { 'E', 'W', 'I' };
+    int n = snprintf(line, size, "%c (%u) %s: ",
+        r.level < sizeof(levelChars) ? levelChars[r.level] : '?',
+        (unsigned)(r.micros / 1000), r.tag);
+    size_t len = n > 0 ? (size_t)n : 0;
+    size_t argIndex = 0;
+    const char *f = r.format;
+    while (*f && len + 1 < size) {
+        if (*f != '%') {
+            line[len++] = *f++;
+            continue;
+        }
+        if (f[1] == '%') {
+            line[len++] = '%';
+            f += 2;
+            continue;
+        }
+        // Copy flags, width and precision; drop length modifiers since every
+        // argument is 32 bits
+        char spec[16];
+        size_t specLen = 0;
+        spec[specLen++] = *f++;
+        while (*f && std::strchr("-+ #0123456789.lhzjt", *f)) {
+            if (!std::strchr("lhzjt", *f) && specLen < sizeof(spec) - 2) {
+                spec[specLen++] = *f;
+            }
+            f++;
+        }
+        const char conv = *f;
+        if (!conv) {
+            break;
+        }
+        f++;
+        spec[specLen++] = conv;
+        spec[specLen] = '\0';
+        const DeferredLogArg a = argIndex < r.numArgs ? r.args[argIndex] : DeferredLogArg();
+        argIndex++;
+        const size_t room = size - len;
+        switch (conv) {
+        case 'd': case 'i': case 'c':
+            n = snprintf(line + len, room, spec, (int)a.i);
+            break;
+        case 'u': case 'x': case 'X': case 'o':
+            n = snprintf(line + len, room, spec, (unsigned)a.u);
+            break;
+        case 'f': case 'F': case 'g': case 'G': case 'e': case 'E':
+            n = snprintf(line + len, room, spec, (double)a.f);
+            break;
+        case 's':
+            n = snprintf(line + len, room, spec, a.s ? a.s : "(null)");
+            break;
+        case 'p':
+            n = snprintf(line + len, room, spec, (const void *)a.s);
+            break;
+        default:
+            n = 0;
+            break;
+        }
+        if (n > 0) {
+            len += (size_t)n < room ? (size_t)n : room - 1;
+        }
+    }
+    line[len] = '\0';
+    return len;
+}
+
+static void emit(DeferredLogLevel level, const char *line) {
+    const uint32_t n = numSinks.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < n; ++i) {
+        sinks[i](level, line);
+    }
+    output++;
+}
+
+struct LimiterSlot {
+    const char *format;
+    const char *tag;
+    uint8_t level;
+    uint32_t windowStartMillis;
+    uint32_t count;
+    uint32_t suppressed;
+};
+
+static LimiterSlot limiter[DEFERRED_LOG_LIMITER_SLOTS];
+
+static void flushSuppressed(LimiterSlot &slot) {
+    if (slot.suppressed == 0) {
+        return;
+    }
+    char line[DEFERRED_LOG_LINE_LEN];
+    snprintf(line, sizeof(line), "%c (%u) %s: %u repeats of \"%.40s\" suppressed",
+        slot.level == DLL_Error ? 'E' : slot.level == DLL_Warn ? 'W' : 'I',
+        (unsigned)millis(), slot.tag, (unsigned)slot.suppressed, slot.format);
+    emit((DeferredLogLevel)slot.level, line);
+    slot.suppressed = 0;
+}
+
+// Returns true if the line for this record may be output
+static bool admit(const LogRecord &r, uint32_t nowMillis) {
+    LimiterSlot *slot = nullptr;
+    LimiterSlot *oldest = &limiter[0];
+    for (size_t i = 0; i < DEFERRED_LOG_LIMITER_SLOTS; ++i) {
+        if (limiter[i].format == r.format) {
+            slot = &limiter[i];
+            break;
+        }
+        // Prefer a free slot, then the one whose window started first
+        if (oldest->format && (!limiter[i].format || limiter[i].windowStartMillis < oldest->windowStartMillis)) {
+            oldest = &limiter[i];
+        }
+    }
+    if (!slot) {
+        slot = oldest;
+        flushSuppressed(*slot);
+        slot->format = r.format;
+        slot->tag = r.tag;
+        slot->level = r.level;
+        slot->windowStartMillis = nowMillis;
+        slot->count = 0;
+    }
+    if (nowMillis - slot->windowStartMillis >= DEFERRED_LOG_WINDOW_MILLIS) {
+        flushSuppressed(*slot);
+        slot->windowStartMillis = nowMillis;
+        slot->count = 0;
+    }
+    slot->count++;
+    if (slot->count > DEFERRED_LOG_BURST) {
+        slot->suppressed++;
+        suppressed++;
+        return false;
+    }
+    return true;
+}
+
+void deferredLogDrain() {
+    const int32_t maxLevel = logLevel.getInt();
+    const uint32_t nowMillis = millis();
+    const uint32_t pending = ringHead.load(std::memory_order_relaxed) - ringTail;
+    if (pending > highWater) {
+        highWater = pending;
+    }
+    char line[DEFERRED_LOG_LINE_LEN];
+    for (;;) {
+        LogRecord &r = ring[ringTail & (DEFERRED_LOG_RING_SIZE - 1)];
+        const uint32_t base = ringTail & (DEFERRED_LOG_RING_SIZE - 1);
+        const uint32_t seq = r.sequence.load(std::memory_order_acquire) + base;
+        if ((int32_t)(seq - (ringTail + 1)) < 0) {
+            break;
+        }
+        const bool show = (int32_t)r.level <= maxLevel;
+        if (show && admit(r, nowMillis)) {
+            formatRecord(r, line, sizeof(line));
+            emit((DeferredLogLevel)r.level, line);
+        }
+        else if (!show) {
+            filtered++;
+        }
+        r.sequence.store(ringTail + DEFERRED_LOG_RING_SIZE - base, std::memory_order_release);
+        ringTail++;
+    }
+    // Report repeats that stopped without another line to carry them
+    for (size_t i = 0; i < DEFERRED_LOG_LIMITER_SLOTS; ++i) {
+        LimiterSlot &slot = limiter[i];
+        if (slot.suppressed > 0 && nowMillis - slot.windowStartMillis >= DEFERRED_LOG_WINDOW_MILLIS) {
+            flushSuppressed(slot);
+            slot.windowStartMillis = nowMillis;
+            slot.count = 0;
+        }
+    }
+}
+
+// Lines carry their level letter already
+static void serialSink(DeferredLogLevel /*level*/, const char *line) {
+    Serial.println(line);
+}
+
+// File lines wait here for the persistence task: the logger task fills one
+// half while the other is written out
+static char fileBuffers[2][DEFERRED_LOG_FILE_BUFFER];
+static size_t fileLengths[2] = { 0, 0 };
+static uint32_t fileFilling = 0;
+static portMUX_TYPE fileLock = portMUX_INITIALIZER_UNLOCKED;
+
+static void fileSink(DeferredLogLevel /*level*/, const char *line) {
+    if (!logToFile.getInt()) {
+        return;
+    }
+    const size_t length = strlen(line);
+    portENTER_CRITICAL(&fileLock);
+    size_t &used = fileLengths[fileFilling];
+    if (used + length + 1 <= DEFERRED_LOG_FILE_BUFFER) {
+        char *buffer = fileBuffers[fileFilling];
+        memcpy(buffer + used, line, length);
+        buffer[used + length] = '\n';
+        used += length + 1;
+    }
+    else {
+        fileDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    portEXIT_CRITICAL(&fileLock);
+}
+
+void deferredLogFlushFile() {
+    portENTER_CRITICAL(&fileLock);
+    const uint32_t full = fileFilling;
+    const size_t length = fileLengths[full];
+    if (length > 0) {
+        fileFilling = full ^ 1;
+    }
+    portEXIT_CRITICAL(&fileLock);
+    if (length == 0) {
+        return;
+    }
+    File file = SPIFFS.open(DEFERRED_LOG_FILE, FILE_APPEND);
+    if (file) {
+        file.write((const uint8_t *)fileBuffers[full], length);
+        const size_t size = file.size();
+        file.close();
+        if (size > DEFERRED_LOG_FILE_MAX_BYTES) {
+            SPIFFS.remove(DEFERRED_LOG_FILE_OLD);
+            SPIFFS.rename(DEFERRED_LOG_FILE, DEFERRED_LOG_FILE_OLD);
+        }
+    }
+    // Only this task empties a half, and the logger task no longer fills it
+    fileLengths[full] = 0;
+}
+
+void deferredLogBegin() {
+    deferredLogAddSink(serialSink);
+    deferredLogAddSink(fileSink);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Logging for the flight path. Callers only copy the format pointer, a
+// timestamp and up to four 32-bit arguments into a lock-free ring; a low
+// priority task formats the records, rate-limits repeats and writes them to
+// the sinks. Lines for the log file wait in RAM for the persistence task. Formats and string arguments must have static storage (string
+// literals, names from static tables).
+
+#define DEFERRED_LOG_MAX_ARGS 4
+// Must be a power of two
+#define DEFERRED_LOG_RING_SIZE 64
+#define DEFERRED_LOG_MAX_SINKS 4
+#define DEFERRED_LOG_LINE_LEN 160
+// Each of the two halves of the file line buffer
+#define DEFERRED_LOG_FILE_BUFFER 2048
+
+enum DeferredLogLevel {
+    DLL_Error   = 0,
+    DLL_Warn    = 1,
+    DLL_Info    = 2,
+};
+
+union DeferredLogArg {
+    int32_t i;
+    uint32_t u;
+    float f;
+    const char *s;
+};
+
+struct DeferredLogStats {
+    uint32_t written;       // Records accepted into the ring
+    uint32_t dropped;       // Records lost because the ring was full
+    uint32_t suppressed;    // Lines withheld by the repeat limiter
+    uint32_t filtered;      // Lines below log.level
+    uint32_t output;        // Lines handed to the sinks
+    uint32_t highWater;     // Most records ever waiting in the ring
+    uint32_t fileDropped;   // File lines lost while the file buffer was full
+};
+
+// Receives each formatted line on the logger task
+typedef void (*DeferredLogSink)(DeferredLogLevel level, const char *line);
+
+// Adds the serial and file sinks
+void deferredLogBegin();
+// Log task: formats what is waiting in the ring and hands it to the sinks
+void deferredLogDrain();
+// Persistence task: appends the buffered file lines to the log file. Only
+// call while disarmed; flash writes stall both cores.
+void deferredLogFlushFile();
+bool deferredLogAddSink(DeferredLogSink sink);
+void deferredLogGetStats(DeferredLogStats &stats);
+
+// Never blocks or allocates; drops the record when the ring is full
+void deferredLogWrite(DeferredLogLevel level, const char *tag, const char *format,
+    const DeferredLogArg *args, size_t numArgs);
+
+// Overloads on the fundamental types so int32_t and uint32_t resolve on both
+// targets (they are long on the ESP32 toolchain and int on most hosts)
+inline DeferredLogArg deferredLogArg(int v) { DeferredLogArg a; a.i = (int32_t)v; return a; }
+inline DeferredLogArg deferredLogArg(unsigned v) { DeferredLogArg a; a.u = (uint32_t)v; return a; }
+inline DeferredLogArg deferredLogArg(long v) { DeferredLogArg a; a.i = (int32_t)v; return a; }
+inline DeferredLogArg deferredLogArg(unsigned long v) { DeferredLogArg a; a.u = (uint32_t)v; return a; }
+inline DeferredLogArg deferredLogArg(float v) { DeferredLogArg a; a.f = v; return a; }
+inline DeferredLogArg deferredLogArg(double v) { DeferredLogArg a; a.f = (float)v; return a; }
+inline DeferredLogArg deferredLogArg(const char *v) { DeferredLogArg a; a.s = v; return a; }
+
+template <typename... Args>
+inline void deferredLog(DeferredLogLevel level, const char *tag, const char *format, Args... args) {
+    static_assert(sizeof...(Args) <= DEFERRED_LOG_MAX_ARGS, "too many deferred log arguments");
+    const DeferredLogArg packed[sizeof...(Args) > 0 ? sizeof...(Args) : 1] = { deferredLogArg(args)... };
+    deferredLogWrite(level, tag, format, packed, sizeof...(Args));
+}
+
+#define DLOG_E(tag, format, ...) deferredLog(DLL_Error, tag, format, ##__VA_ARGS__)
+#define DLOG_W(tag, format, ...) deferredLog(DLL_Warn, tag, format, ##__VA_ARGS__)
+#define DLOG_I(tag, format, ...) deferredLog(DLL_Info, tag, format, ##__VA_ARGS__)
@@ -0,0 +1,34 @@
+#include <cmath>
+
+#include "Failsafe.h"
+#include "ConfigValue.h"
+#include "DeferredLog.h"
+#include "RadioController.h"
+
+static constexpr ConfigDescriptor failsafeDescentMillisDescriptor = ConfigDescriptor::fromInt("rc.failsafe.descentMs", "Time to ramp the throttle to zero after RC loss, then disarm (ms)", 5000, 0);
+ConfigValue failsafeDescentMillis(failsafeDescentMillisDescriptor);
+static constexpr ConfigDescriptor failsafeCurveDescriptor = ConfigDescriptor::fromFloat("rc.failsafe.curve", "Shape of the failsafe throttle ramp (1 = linear, above 1 holds throttle longer before dropping)", 2.0f, 0.1f, 10.0f);
+ConfigValue failsafeCurve(failsafeCurveDescriptor);
+
+static float startThrottle = 0.0f;
+
+void failsafeBegin() {
+    startThrottle = rcGetLastGoodThrottle();
+    DLOG_W("Failsafe", "RC lost, descending from throttle %.3f over %d ms", startThrottle, failsafeDescentMillis.getInt());
+}
+
+float failsafeGetThrottle(uint32_t millisInState) {
+    const int32_t descentMillis = failsafeDescentMillis.getInt();
+    if (descentMillis <= 0 || millisInState >= (uint32_t)descentMillis) {
+        return 0.0f;
+    }
+    float curve = failsafeCurve.getFloat();
+    if (curve < 0.1f) curve = 0.1f;
+    const float x = (float)millisInState / (float)descentMillis;
+    return startThrottle * (1.0f - std::pow(x, curve));
+}
+
+bool failsafeDescentComplete(uint32_t millisInState) {
+    const int32_t descentMillis = failsafeDescentMillis.getInt();
+    return descentMillis <= 0 || millisInState >= (uint32_t)descentMillis;
+}
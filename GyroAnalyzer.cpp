@@ -0,0 +1,292 @@
+#include <Arduino.h>
+#include <atomic>
+#include <cmath>
+
+#include "GyroAnalyzer.h"
+#include "ConfigValue.h"
+#include "FastMath.h"
+
+// Must be a power of two
+#define GYRO_RING_SIZE 512
+
+static constexpr ConfigDescriptor dynNotchEnabledDescriptor = ConfigDescriptor::fromInt("dynNotch.enabled", "Track the dominant gyro vibration with a notch per axis (0 = off, 1 = on)", 0, 0, 1);
+ConfigValue dynNotchEnabled(dynNotchEnabledDescriptor);
+static constexpr ConfigDescriptor dynNotchQDescriptor = ConfigDescriptor::fromFloat("dynNotch.q", "Dynamic notch quality factor", 4.0f, 0.5f);
+ConfigValue dynNotchQ(dynNotchQDescriptor);
+static constexpr ConfigDescriptor dynNotchMinHzDescriptor = ConfigDescriptor::fromFloat("dynNotch.minHz", "Lowest frequency the dynamic notch will track (Hz)", 80.0f);
+ConfigValue dynNotchMinHz(dynNotchMinHzDescriptor);
+static constexpr ConfigDescriptor dynNotchMaxHzDescriptor = ConfigDescriptor::fromFloat("dynNotch.maxHz", "Highest frequency the dynamic notch will track (Hz)", 400.0f);
+ConfigValue dynNotchMaxHz(dynNotchMaxHzDescriptor);
+static constexpr ConfigDescriptor dynNotchSlewDescriptor = ConfigDescriptor::fromFloat("dynNotch.slew", "Fraction of the way to a new peak the notch moves per tick (0-1)", 0.02f, 0.0f, 1.0f);
+ConfigValue dynNotchSlew(dynNotchSlewDescriptor);
+
+//
+// Control path -> analyzer: single producer, single consumer ring
+//
+struct GyroSample {
+    float v[3];
+};
+static GyroSample ring[GYRO_RING_SIZE];
+static std::atomic<uint32_t> ringHead(0);
+static std::atomic<uint32_t> ringTail(0);
+static std::atomic<float> ringSampleHz(0.0f);
+static std::atomic<uint32_t> droppedSamples(0);
+
+//
+// Analyzer task state
+//
+static float history[3][GYRO_FFT_SIZE];
+static uint32_t historyPos = 0;
+static uint32_t newSamples = 0;
+static float work[GYRO_FFT_SIZE];
+static float window[GYRO_FFT_SIZE];
+static float twiddleCos[GYRO_FFT_BINS];
+static float twiddleSin[GYRO_FFT_BINS];
+static uint16_t bitReverse[GYRO_FFT_BINS];
+
+//
+// Analyzer -> readers. The spectrum is guarded by a sequence lock: the
+// writer makes the counter odd while it writes, readers retry on change.
+//
+static GyroSpectrum published;
+static std::atomic<uint32_t> publishLock(0);
+static std::atomic<float> peakTargetHz[3];
+
+void gyroAnalyzerPush(const float *gyro, float sampleHz) {
+    const uint32_t head = ringHead.load(std::memory_order_relaxed);
+    const uint32_t tail = ringTail.load(std::memory_order_acquire);
+    if (head - tail >= GYRO_RING_SIZE) {
+        droppedSamples.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    GyroSample &s = ring[head & (GYRO_RING_SIZE - 1)];
+    s.v[0] = gyro[0];
+    s.v[1] = gyro[1];
+    s.v[2] = gyro[2];
+    ringSampleHz.store(sampleHz, std::memory_order_relaxed);
+    ringHead.store(head + 1, std::memory_order_release);
+}
+
+// In-place radix-2 complex FFT of m points stored as interleaved re, im
+static void fftComplex(float *data, size_t m) {
+    for (size_t i = 0; i < m; ++i) {
+        const size_t j = bitReverse[i];
+        if (j > i) {
+            const float re = data[2 * i];
+            const float im = data[2 * i + 1];
+            data[2 * i] = data[2 * j];
+            data[2 * i + 1] = data[2 * j + 1];
+            data[2 * j] = re;
+            data[2 * j + 1] = im;
+        }
+    }
+    for (size_t len = 2; len <= m; len <<= 1) {
+        const size_t half = len >> 1;
+        // W_len^k == W_N^(k * N / len)
+        const size_t stride = GYRO_FFT_SIZE / len;
+        for (size_t i = 0; i < m; i += len) {
+            for (size_t k = 0; k < half; ++k) {
+                const float wr = twiddleCos[k * stride];
+                const float wi = -twiddleSin[k * stride];
+                float *a = &data[2 * (i + k)];
+                float *b = &data[2 * (i + k + half)];
+                const float tr = b[0] * wr - b[1] * wi;
+                const float ti = b[0] * wi + b[1] * wr;
+                b[0] = a[0] - tr;
+                b[1] = a[1] - ti;
+                a[0] += tr;
+                a[1] += ti;
+            }
+        }
+    }
+}
+
+// Real FFT of work[0..N) via an N/2 point complex FFT, writing the
+// amplitude of bins [0, N/2) to magnitude
+static void realFFTMagnitude(float *magnitude) {
+    const size_t m = GYRO_FFT_BINS;
+    fftComplex(work, m);
+    // Hann window has a coherent gain of 1/2
+    const float scale = 4.0f / GYRO_FFT_SIZE;
+    for (size_t k = 0; k < m; ++k) {
+        const size_t kc = (m - k) & (m - 1);
+        const float zr = work[2 * k];
+        const float zi = work[2 * k + 1];
+        const float cr = work[2 * kc];
+        const float ci = -work[2 * kc + 1];
+        // Even and odd halves of the split
+        const float er = 0.5f * (zr + cr);
+        const float ei = 0.5f * (zi + ci);
+        const float or_ = 0.5f * (zi - ci);
+        const float oi = -0.5f * (zr - cr);
+        const float wr = twiddleCos[k];
+        const float wi = -twiddleSin[k];
+        const float xr = er + wr * or_ - wi * oi;
+        const float xi = ei + wr * oi + wi * or_;
+        magnitude[k] = fastSqrt(xr * xr + xi * xi) * scale;
+    }
+}
+
+static float findPeak(const float *magnitude, float binHz) {
+    const float minHz = dynNotchMinHz.getFloat();
+    const float maxHz = dynNotchMaxHz.getFloat();
+    size_t first = (size_t)(minHz / binHz);
+    size_t last = (size_t)(maxHz / binHz);
+    if (first < 1) first = 1;
+    if (last > GYRO_FFT_BINS - 2) last = GYRO_FFT_BINS - 2;
+    if (first > last) {
+        return 0.0f;
+    }
+    size_t peakBin = first;
+    float sum = 0.0f;
+    for (size_t k = first; k <= last; ++k) {
+        sum += magnitude[k];
+        if (magnitude[k] > magnitude[peakBin]) {
+            peakBin = k;
+        }
+    }
+    // Only a peak that stands well clear of the band average is worth
+    // notching. It must also be a local maximum: at a band edge the largest
+    // bin can be the skirt of a tone outside the band, and interpolating
+    // that extrapolates to a frequency with nothing there.
+    const float mean = sum / (float)(last - first + 1);
+    const float c = magnitude[peakBin];
+    const float l = magnitude[peakBin - 1];
+    const float r = magnitude[peakBin + 1];
+    if (c <= 3.0f * mean || l >= c || r >= c) {
+        return 0.0f;
+    }
+    // Parabolic interpolation between neighboring bins
+    const float denom = l - 2.0f * c + r;
+    const float delta = denom != 0.0f ? 0.5f * (l - r) / denom : 0.0f;
+    return ((float)peakBin + delta) * binHz;
+}
+
+static void analyze(float sampleHz) {
+    const float binHz = sampleHz / GYRO_FFT_SIZE;
+    publishLock.fetch_add(1, std::memory_order_acq_rel);
+    published.binHz = binHz;
+    for (size_t axis = 0; axis < 3; ++axis) {
+        const float *h = history[axis];
+        float mean = 0.0f;
+        for (size_t n = 0; n < GYRO_FFT_SIZE; ++n) {
+            mean += h[n];
+        }
+        mean *= 1.0f / GYRO_FFT_SIZE;
+        // Oldest sample first
+        for (size_t n = 0; n < GYRO_FFT_SIZE; ++n) {
+            work[n] = (h[(historyPos + n) & (GYRO_FFT_SIZE - 1)] - mean) * window[n];
+        }
+        realFFTMagnitude(published.magnitude[axis]);
+        const float peakHz = findPeak(published.magnitude[axis], binHz);
+        published.peakHz[axis] = peakHz;
+        peakTargetHz[axis].store(peakHz, std::memory_order_relaxed);
+    }
+    published.droppedSamples = droppedSamples.load(std::memory_order_relaxed);
+    published.sequence++;
+    publishLock.fetch_add(1, std::memory_order_release);
+}
+
+static void drainRing() {
+    uint32_t tail = ringTail.load(std::memory_order_relaxed);
+    const uint32_t head = ringHead.load(std::memory_order_acquire);
+    while (tail != head) {
+        const GyroSample &s = ring[tail & (GYRO_RING_SIZE - 1)];
+        history[0][historyPos] = s.v[0];
+        history[1][historyPos] = s.v[1];
+        history[2][historyPos] = s.v[2];
+        historyPos = (historyPos + 1) & (GYRO_FFT_SIZE - 1);
+        tail++;
+        ringTail.store(tail, std::memory_order_release);
+        // 50% overlap between analyses
+        newSamples++;
+        if (newSamples >= GYRO_FFT_SIZE / 2) {
+            newSamples = 0;
+            const float sampleHz = ringSampleHz.load(std::memory_order_relaxed);
+            if (sampleHz > 0.0f) {
+                analyze(sampleHz);
+            }
+        }
+    }
+}
+
+static void gyroAnalyzerTask(void *) {
+    for (;;) {
+        drainRing();
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+}
+
+void gyroAnalyzerBegin() {
+    for (size_t n = 0; n < GYRO_FFT_SIZE; ++n) {
+        window[n] = 0.5f - 0.5f * std::cos(TWO_PI_F * n / GYRO_FFT_SIZE);
+    }
+    for (size_t k = 0; k < GYRO_FFT_BINS; ++k) {
+        twiddleCos[k] = std::cos(TWO_PI_F * k / GYRO_FFT_SIZE);
+        twiddleSin[k] = std::sin(TWO_PI_F * k / GYRO_FFT_SIZE);
+    }
+    size_t bits = 0;
+    while ((1u << bits) < GYRO_FFT_BINS) {
+        bits++;
+    }
+    for (size_t i = 0; i < GYRO_FFT_BINS; ++i) {
+        size_t r = 0;
+        for (size_t b = 0; b < bits; ++b) {
+            if (i & (1u << b)) {
+                r |= 1u << (bits - 1 - b);
+            }
+        }
+        bitReverse[i] = (uint16_t)r;
+    }
+    for (size_t axis = 0; axis < 3; ++axis) {
+        peakTargetHz[axis].store(0.0f);
+    }
+    xTaskCreatePinnedToCore(gyroAnalyzerTask, "gyroAnalyzer", 4096, nullptr, 1, nullptr, 1);
+}
+
+void gyroAnalyzerTuneNotches(NotchBank<3> &notches, float sampleHz) {
+    static float tunedSampleHz = 0.0f;
+    if (!dynNotchEnabled.getInt()) {
+        for (size_t axis = 0; axis < 3; ++axis) {
+            if (notches.getCenter(axis) != 0.0f) {
+                notches.disable(axis);
+            }
+        }
+        return;
+    }
+    const bool rateChanged = sampleHz != tunedSampleHz;
+    tunedSampleHz = sampleHz;
+    const float q = dynNotchQ.getFloat();
+    const float slew = dynNotchSlew.getFloat();
+    for (size_t axis = 0; axis < 3; ++axis) {
+        const float target = peakTargetHz[axis].load(std::memory_order_relaxed);
+        const float current = notches.getCenter(axis);
+        if (target <= 0.0f || target >= 0.45f * sampleHz) {
+            // No clear peak: hold the notch where it is
+            if (rateChanged && current > 0.0f) {
+                notches.disable(axis);
+            }
+            continue;
+        }
+        const float next = current > 0.0f ? current + slew * (target - current) : target;
+        if (rateChanged || std::fabs(next - current) > 0.01f) {
+            notches.setCenter(axis, next, q, sampleHz);
+        }
+    }
+}
+
+bool gyroAnalyzerGetSpectrum(GyroSpectrum &spectrum) {
+    for (;;) {
+        const uint32_t before = publishLock.load(std::memory_order_acquire);
+        if (before & 1) {
+            // The analyzer may be preempted mid-write on this core; let it finish
+            vTaskDelay(1);
+            continue;
+        }
+        spectrum = published;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (publishLock.load(std::memory_order_relaxed) == before) {
+            return spectrum.sequence != 0;
+        }
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Filters.h"
+
+#define GYRO_FFT_SIZE 256
+#define GYRO_FFT_BINS (GYRO_FFT_SIZE / 2)
+
+// Faster control loops feed the analyzer decimated samples
+#define GYRO_ANALYZER_MAX_HZ 1000
+
+struct GyroSpectrum {
+    float binHz;
+    float peakHz[3];                    // 0 when no dominant peak was found
+    float magnitude[3][GYRO_FFT_BINS];  // Amplitude in rad/s per bin
+    uint32_t droppedSamples;            // Samples lost because the ring was full
+    uint32_t sequence;                  // Increments with every analysis
+};
+
+// Starts the analyzer task on core 1
+void gyroAnalyzerBegin();
+
+// Called from the control path for every gyro sample. Never blocks; samples
+// are dropped when the analyzer falls behind.
+void gyroAnalyzerPush(const float *gyro, float sampleHz);
+
+// Slews the notch centers toward the analyzer's peaks. Cheap enough to call
+// every control tick.
+void gyroAnalyzerTuneNotches(NotchBank<3> &notches, float sampleHz);
+
+// Copies the latest spectrum. Returns false if no analysis has run yet.
+bool gyroAnalyzerGetSpectrum(GyroSpectrum &spectrum);
@@ -0,0 +1,206 @@
+#include <Arduino.h>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#include "ConfigValue.h"
+#include "History.h"
+
+struct ChannelInfo {
+    const char *name;
+    float scale;        // Stored value per unit
+};
+
+// Indexed by HistoryChannel. Rates keep 0.001 rad/s up to 32 rad/s, the
+// rest 0.0001 up to 3.2. Pitch and roll come from the stored quaternion.
+static const ChannelInfo channels[] = {
+    { "pitchRate", 1000.0f },
+    { "rollRate", 1000.0f },
+    { "yawRate", 1000.0f },
+    { "pitchRateSetpoint", 1000.0f },
+    { "rollRateSetpoint", 1000.0f },
+    { "yawRateSetpoint", 1000.0f },
+    { "throttle", 10000.0f },
+    { "motor1", 10000.0f },
+    { "motor2", 10000.0f },
+    { "motor3", 10000.0f },
+    { "motor4", 10000.0f },
+    { "motor5", 10000.0f },
+    { "motor6", 10000.0f },
+    { "pitch", 0.0f },
+    { "roll", 0.0f },
+};
+static_assert(sizeof(channels) / sizeof(channels[0]) == HC_Count, "channels must be indexed by HistoryChannel");
+
+static constexpr ConfigDescriptor historySamplesDescriptor = ConfigDescriptor::fromInt("history.samples", "Loop ticks kept for /history, rounded down to a power of two; 38 bytes each, takes effect after a reboot", 2048, 0, HISTORY_SAMPLES_MAX);
+ConfigValue historySamples(historySamplesDescriptor);
+
+// Set once by historyBegin; capacity 0 means off
+static uint32_t capacity = 0;
+static uint32_t *times = nullptr;
+static int16_t *values[HC_Recorded];
+// Attitude quaternion w, x, y, z, each component stored per unit
+static constexpr float QUATERNION_SCALE = 32767.0f;
+static int16_t *attitude[4];
+// Samples ever written. Sample n is in slot n & (capacity - 1) until the
+// writer starts on n + capacity.
+static std::atomic<uint32_t> written(0);
+
+static int16_t quantize(float value, float scale) {
+    float q = value * scale;
+    if (q != q) {
+        return 0;
+    }
+    if (q > 32767.0f) q = 32767.0f;
+    if (q < -32767.0f) q = -32767.0f;
+    return (int16_t)(q < 0.0f ? q - 0.5f : q + 0.5f);
+}
+
+void historyBegin() {
+    uint32_t samples = 0;
+    for (uint32_t n = 1; n <= (uint32_t)historySamples.getInt(); n <<= 1) {
+        samples = n;
+    }
+    if (samples == 0) {
+        ESP_LOGI("History", "Off");
+        return;
+    }
+    const size_t bytes = samples * (sizeof(uint32_t) + (HC_Recorded + 4) * sizeof(int16_t));
+    uint8_t *block = (uint8_t *)malloc(bytes);
+    if (block == nullptr) {
+        ESP_LOGE("History", "Could not allocate %u bytes for %u samples", (unsigned)bytes, (unsigned)samples);
+        return;
+    }
+    times = (uint32_t *)block;
+    int16_t *next = (int16_t *)(times + samples);
+    for (size_t c = 0; c < HC_Recorded; ++c) {
+        values[c] = next;
+        next += samples;
+    }
+    for (size_t c = 0; c < 4; ++c) {
+        attitude[c] = next;
+        next += samples;
+    }
+    capacity = samples;
+    ESP_LOGI("History", "%u samples, %u bytes", (unsigned)samples, (unsigned)bytes);
+}
+
+void historyWrite(uint32_t timeMicros, const float (&v)[HC_Recorded], const Quaternion &q) {
+    if (capacity == 0) {
+        return;
+    }
+    const uint32_t n = written.load(std::memory_order_relaxed);
+    const uint32_t slot = n & (capacity - 1);
+    times[slot] = timeMicros;
+    for (size_t c = 0; c < HC_Recorded; ++c) {
+        values[c][slot] = quantize(v[c], channels[c].scale);
+    }
+    attitude[0][slot] = quantize(q.w, QUATERNION_SCALE);
+    attitude[1][slot] = quantize(q.x, QUATERNION_SCALE);
+    attitude[2][slot] = quantize(q.y, QUATERNION_SCALE);
+    attitude[3][slot] = quantize(q.z, QUATERNION_SCALE);
+    written.store(n + 1, std::memory_order_release);
+}
+
+const char *historyChannelName(HistoryChannel channel) {
+    return channels[channel].name;
+}
+
+HistoryChannel historyFindChannel(const char *name, size_t length) {
+    for (size_t c = 0; c < HC_Count; ++c) {
+        if (strlen(channels[c].name) == length && strncmp(channels[c].name, name, length) == 0) {
+            return (HistoryChannel)c;
+        }
+    }
+    return HC_Count;
+}
+
+void historySelect(uint32_t windowMicros, HistoryWindow &window) {
+    const uint32_t end = written.load(std::memory_order_acquire);
+    const uint32_t usable = capacity > HISTORY_READ_MARGIN ? capacity - HISTORY_READ_MARGIN : 0;
+    uint32_t count = end < usable ? end : usable;
+    if (windowMicros > 0 && count > 0) {
+        // Times only increase, so search for the oldest sample in the window
+        const uint32_t mask = capacity - 1;
+        const uint32_t newest = times[(end - 1) & mask];
+        uint32_t lo = 0;
+        uint32_t hi = count - 1;
+        while (lo < hi) {
+            const uint32_t mid = lo + (hi - lo) / 2;
+            if (newest - times[(end - count + mid) & mask] <= windowMicros) {
+                hi = mid;
+            }
+            else {
+                lo = mid + 1;
+            }
+        }
+        count -= lo;
+    }
+    window.first = end - count;
+    window.count = count;
+}
+
+size_t historyBucketCount(const HistoryWindow &window, size_t maxBuckets) {
+    return window.count < maxBuckets ? window.count : maxBuckets;
+}
+
+static uint32_t bucketStart(const HistoryWindow &window, size_t buckets, size_t bucket) {
+    return window.first + (uint32_t)((uint64_t)window.count * bucket / buckets);
+}
+
+void historyBucketTimes(const HistoryWindow &window, size_t buckets, uint32_t *out) {
+    const uint32_t mask = capacity - 1;
+    for (size_t b = 0; b < buckets; ++b) {
+        out[b] = times[bucketStart(window, buckets, b) & mask];
+    }
+}
+
+// Pitch or roll of the sample in slot
+static float attitudeAngle(HistoryChannel channel, uint32_t slot) {
+    Quaternion q(attitude[0][slot], attitude[1][slot], attitude[2][slot], attitude[3][slot]);
+    q.normalize();
+    const Vector euler = q.toEulerAngles();
+    return channel == HC_Pitch ? euler.x : euler.y;
+}
+
+void historyDecimate(const HistoryWindow &window, HistoryChannel channel, size_t buckets, float *min, float *max) {
+    const uint32_t mask = capacity - 1;
+    if (channel >= HC_Recorded) {
+        for (size_t b = 0; b < buckets; ++b) {
+            const uint32_t end = bucketStart(window, buckets, b + 1);
+            float lo = INFINITY;
+            float hi = -INFINITY;
+            for (uint32_t n = bucketStart(window, buckets, b); n != end; ++n) {
+                const float v = attitudeAngle(channel, n & mask);
+                lo = v < lo ? v : lo;
+                hi = v > hi ? v : hi;
+            }
+            min[b] = lo;
+            max[b] = hi;
+        }
+        return;
+    }
+    const int16_t *data = values[channel];
+    const float unit = 1.0f / channels[channel].scale;
+    for (size_t b = 0; b < buckets; ++b) {
+        const uint32_t end = bucketStart(window, buckets, b + 1);
+        int16_t lo = INT16_MAX;
+        int16_t hi = INT16_MIN;
+        for (uint32_t n = bucketStart(window, buckets, b); n != end; ++n) {
+            const int16_t v = data[n & mask];
+            lo = v < lo ? v : lo;
+            hi = v > hi ? v : hi;
+        }
+        min[b] = lo * unit;
+        max[b] = hi * unit;
+    }
+}
+
+bool historyIntact(const HistoryWindow &window) {
+    if (window.count == 0) {
+        return true;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // The writer may already be overwriting sample first + capacity's slot
+    return written.load(std::memory_order_relaxed) - window.first < capacity;
+}
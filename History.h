@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Geometry.h"
+
+// Flight loop history for tuning plots. The flight task appends one sample
+// per tick, each channel quantized to 16 bits in its own array, without
+// locks. Readers work on a window of sequence numbers and check afterwards
+// that the writer has not lapped them. /history serves a window decimated
+// into min/max buckets, so steps and spikes survive the decimation. Pitch
+// and roll are kept as the attitude quaternion and converted when read.
+
+// history.samples is rounded down to a power of two
+#define HISTORY_SAMPLES_MAX 8192
+#define HISTORY_BUCKETS_MAX 500
+#define HISTORY_DEFAULT_BUCKETS 250
+// Oldest samples a reader leaves alone, so the writer has room while it reads
+#define HISTORY_READ_MARGIN 256
+
+enum HistoryChannel {
+    HC_PitchRate            = 0,    // Filtered gyro, rad/s
+    HC_RollRate             = 1,
+    HC_YawRate              = 2,
+    HC_PitchRateSetpoint    = 3,    // rad/s
+    HC_RollRateSetpoint     = 4,
+    HC_YawRateSetpoint      = 5,
+    HC_Throttle             = 6,    // Commanded, 0-1
+    HC_Motor1               = 7,    // 0-1
+    HC_Motor2               = 8,
+    HC_Motor3               = 9,
+    HC_Motor4               = 10,
+    HC_Motor5               = 11,
+    HC_Motor6               = 12,
+    HC_Recorded,                    // Channels historyWrite takes as values
+    HC_Pitch = HC_Recorded,         // Estimated attitude, rad
+    HC_Roll,
+    HC_Count
+};
+
+// Consecutive samples by sequence number
+struct HistoryWindow {
+    uint32_t first;
+    uint32_t count;
+};
+
+// Allocates the ring; call before the flight task starts
+void historyBegin();
+// Flight task, once per tick
+void historyWrite(uint32_t timeMicros, const float (&values)[HC_Recorded], const Quaternion &attitude);
+
+const char *historyChannelName(HistoryChannel channel);
+// Returns HC_Count if there is no channel of that name
+HistoryChannel historyFindChannel(const char *name, size_t length);
+
+// The newest samples spanning at most windowMicros, or all of them for 0
+void historySelect(uint32_t windowMicros, HistoryWindow &window);
+// Up to maxBuckets, but no more than the window has samples
+size_t historyBucketCount(const HistoryWindow &window, size_t maxBuckets);
+// Splits the window into equal runs of samples and writes the time of each
+// run's first sample, or the least and greatest value of a channel in each
+void historyBucketTimes(const HistoryWindow &window, size_t buckets, uint32_t *times);
+void historyDecimate(const HistoryWindow &window, HistoryChannel channel, size_t buckets, float *min, float *max);
+// Call after reading: false if part of the window was overwritten meanwhile
+bool historyIntact(const HistoryWindow &window);
@@ -0,0 +1,93 @@
+#include <Arduino.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include "Latency.h"
+
+static const char *const segmentNames[LATENCY_SEGMENTS] = {
+    "rcToFlight",       // Decoded -> Applied
+    "flightToRate",     // Applied -> Consumed
+    "rateToMotors",     // Consumed -> Commanded
+    "motorsToOutput",   // Commanded -> Output
+    "total",            // Decoded -> Output
+};
+
+// Flight task only
+static uint32_t marks[LM_Count];
+static uint32_t marked = 0;     // Bit per mark stamped for the current frame
+static bool tracking = false;
+
+// Written by the flight task, read by the web server
+static uint32_t rings[LATENCY_SEGMENTS][LATENCY_WINDOW];
+static std::atomic<uint32_t> samples(0);
+static std::atomic<uint32_t> superseded(0);
+static std::atomic<uint32_t> lastTotalMicros(0);
+
+void latencyBeginFrame(uint32_t decodedMicros) {
+    if (tracking) {
+        superseded.fetch_add(1, std::memory_order_relaxed);
+    }
+    tracking = true;
+    marks[LM_Decoded] = decodedMicros;
+    marks[LM_Applied] = micros();
+    marked = (1u << LM_Decoded) | (1u << LM_Applied);
+}
+
+static void complete() {
+    // A boundary the frame skipped (no rate loop while calibrating ESCs)
+    // takes the time of the one before it
+    for (size_t i = 1; i < LM_Count; ++i) {
+        if (!(marked & (1u << i))) {
+            marks[i] = marks[i - 1];
+        }
+    }
+    const uint32_t n = samples.load(std::memory_order_relaxed);
+    const size_t slot = n % LATENCY_WINDOW;
+    for (size_t i = 0; i + 1 < LM_Count; ++i) {
+        rings[i][slot] = marks[i + 1] - marks[i];
+    }
+    const uint32_t total = marks[LM_Output] - marks[LM_Decoded];
+    rings[LATENCY_SEGMENTS - 1][slot] = total;
+    lastTotalMicros.store(total, std::memory_order_relaxed);
+    samples.store(n + 1, std::memory_order_release);
+    tracking = false;
+}
+
+void latencyMark(LatencyMark mark) {
+    if (!tracking || (marked & (1u << mark))) {
+        return;
+    }
+    marks[mark] = micros();
+    marked |= 1u << mark;
+    if (mark == LM_Output) {
+        complete();
+    }
+}
+
+uint32_t latencyGetLastMicros() {
+    return lastTotalMicros.load(std::memory_order_relaxed);
+}
+
+void latencyGetStats(LatencyStats &stats) {
+    static uint32_t sorted[LATENCY_WINDOW];
+    const uint32_t n = samples.load(std::memory_order_acquire);
+    const size_t count = n < LATENCY_WINDOW ? n : LATENCY_WINDOW;
+    stats.samples = n;
+    stats.superseded = superseded.load(std::memory_order_relaxed);
+    stats.window = count;
+    for (size_t i = 0; i < LATENCY_SEGMENTS; ++i) {
+        LatencySegmentStats &s = stats.segments[i];
+        s.name = segmentNames[i];
+        s.p50Micros = s.p99Micros = s.maxMicros = s.lastMicros = 0;
+        if (count == 0) {
+            continue;
+        }
+        std::memcpy(sorted, rings[i], count * sizeof(sorted[0]));
+        s.lastMicros = rings[i][(n - 1) % LATENCY_WINDOW];
+        std::sort(sorted, sorted + count);
+        s.p50Micros = sorted[(count - 1) / 2];
+        s.p99Micros = sorted[(count - 1) * 99 / 100];
+        s.maxMicros = sorted[count - 1];
+    }
+}
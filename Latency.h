@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Stick-to-motor latency. Each RC frame is timestamped at every boundary
+// on its way to the ESC outputs; the flight task records the segments into
+// fixed rings and the web server reads rolling percentiles from them.
+//
+// The output mark is the LEDC duty register write. The ESC sees the new
+// pulse at the start of the next PWM period, up to motorsGetPwmPeriodMicros
+// later.
+
+// Samples kept per segment
+#define LATENCY_WINDOW 128
+
+enum LatencyMark {
+    LM_Decoded      = 0,    // SBUS frame complete in rcUpdate
+    LM_Applied      = 1,    // Published to the state by the flight task
+    LM_Consumed     = 2,    // Read by the rate loop
+    LM_Commanded    = 3,    // motorsSendCommands entered
+    LM_Output       = 4,    // LEDC duty written
+    LM_Count
+};
+
+// Segments between consecutive marks, then the whole pipeline
+#define LATENCY_SEGMENTS LM_Count
+
+struct LatencySegmentStats {
+    const char *name;
+    uint32_t p50Micros;
+    uint32_t p99Micros;
+    uint32_t maxMicros;
+    uint32_t lastMicros;
+};
+
+struct LatencyStats {
+    uint32_t samples;       // Frames that reached the outputs
+    uint32_t superseded;    // Frames replaced by a newer one before reaching them
+    size_t window;          // Samples behind the percentiles
+    LatencySegmentStats segments[LATENCY_SEGMENTS];
+};
+
+// Flight task: starts tracking a frame decoded at decodedMicros
+void latencyBeginFrame(uint32_t decodedMicros);
+// Flight task: stamps the current frame at a boundary. LM_Output completes it.
+void latencyMark(LatencyMark mark);
+
+// Last end-to-end latency, for telemetry
+uint32_t latencyGetLastMicros();
+
+// Sorts copies of the rings; call from a slow path
+void latencyGetStats(LatencyStats &stats);
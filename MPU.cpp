@@ -1,26 +1,66 @@
+#include <cmath>
+
 #include "MPU.h"
+#include "DeferredLog.h"
+#include "GyroAnalyzer.h"
 
 static bool isCalibrating = false;
 static uint32_t calCount = 0;
 static MPUData calData;
 static const uint32_t numCalCount = 300;
 
+static constexpr LinearCalDescriptors accelXCalDescriptors = LINEAR_CAL("MPU.accelX", "Accelerometer X calibration");
+static constexpr LinearCalDescriptors accelYCalDescriptors = LINEAR_CAL("MPU.accelY", "Accelerometer Y calibration");
+static constexpr LinearCalDescriptors accelZCalDescriptors = LINEAR_CAL("MPU.accelZ", "Accelerometer Z calibration");
+static constexpr LinearCalDescriptors gyroXCalDescriptors = LINEAR_CAL("MPU.gyroX", "Gyro X calibration");
+static constexpr LinearCalDescriptors gyroYCalDescriptors = LINEAR_CAL("MPU.gyroY", "Gyro Y calibration");
+static constexpr LinearCalDescriptors gyroZCalDescriptors = LINEAR_CAL("MPU.gyroZ", "Gyro Z calibration");
+static constexpr ConfigDescriptor estimatorTypeDescriptor = ConfigDescriptor::fromInt("MPU.estimator", "Attitude estimator (0 = Madgwick, 1 = Mahony, 2 = EKF)", ET_Madgwick, ET_Madgwick, ET_EKF);
+static constexpr ConfigDescriptor accelRejectMinDescriptor = ConfigDescriptor::fromFloat("MPU.accelReject.min", "Ignore the accelerometer below this magnitude (g)", 0.85f, 0.0f);
+static constexpr ConfigDescriptor accelRejectMaxDescriptor = ConfigDescriptor::fromFloat("MPU.accelReject.max", "Ignore the accelerometer above this magnitude (g)", 1.15f, 0.0f);
+static constexpr FilterConfigDescriptors gyroFilterDescriptors = FILTER_CONFIG("gyroFilter", LPT_PT1, 40.0f);
 
 MPU::MPU()
-    : accelXCal("MPU.accelX", "Accelerometer X calibration")
-    , accelYCal("MPU.accelY", "Accelerometer Y calibration")
-    , accelZCal("MPU.accelZ", "Accelerometer Z calibration")
-    , gyroXCal("MPU.gyroX", "Gyro X calibration")
-    , gyroYCal("MPU.gyroY", "Gyro Y calibration")
-    , gyroZCal("MPU.gyroZ", "Gyro Z calibration")
+    : accelXCal(accelXCalDescriptors)
+    , accelYCal(accelYCalDescriptors)
+    , accelZCal(accelZCalDescriptors)
+    , gyroXCal(gyroXCalDescriptors)
+    , gyroYCal(gyroYCalDescriptors)
+    , gyroZCal(gyroZCalDescriptors)
+    , estimatorType(estimatorTypeDescriptor)
+    , accelRejectMin(accelRejectMinDescriptor)
+    , accelRejectMax(accelRejectMaxDescriptor)
+    , estimator(&madgwick)
+    , gyroFilterConfig(gyroFilterDescriptors)
+    , sampleHz(100.0f)
+    , analyzerDecimation(1)
+    , analyzerCount(0)
+    , analyzerSum{ 0.0f, 0.0f, 0.0f }
 {
 }
 
-bool MPU::readCalibrated(MPUData &data)
-{
-    if (!readUncalibrated(data)) {
-        return false;
+void MPU::setSampleRate(float hz) {
+    if (hz == sampleHz) {
+        return;
     }
+    sampleHz = hz;
+    analyzerDecimation = (uint32_t)ceilf(hz / GYRO_ANALYZER_MAX_HZ);
+    if (analyzerDecimation < 1) {
+        analyzerDecimation = 1;
+    }
+    analyzerCount = 0;
+    analyzerSum[0] = analyzerSum[1] = analyzerSum[2] = 0.0f;
+}
+
+bool MPU::acquire(MPUSample &sample)
+{
+    sample.ok = readUncalibrated(sample.data);
+    sample.micros = micros();
+    return sample.ok;
+}
+
+void MPU::calibrate(MPUData &data)
+{
     if (isCalibrating) {
         calData.accelX += data.accelX;
         calData.accelY += data.accelY;
@@ -39,7 +79,6 @@ bool MPU::readCalibrated(MPUData &data)
     data.gyroX = gyroXCal.apply(data.gyroX);
     data.gyroY = gyroYCal.apply(data.gyroY);
     data.gyroZ = gyroZCal.apply(data.gyroZ);
-    return true;
 }
 
 void MPU::endCalibration()
@@ -61,98 +100,63 @@ void MPU::endCalibration()
     gyroZCal.set(1.0f, -gz);
 }
 
-static Quaternion madgwickUpdate(float deltat, const MPUData &data, const Quaternion &orientation, const float gyroMeasureError)
+void MPU::selectEstimator()
 {
-    // Read the previous state
-    float SEq_1 = orientation.w;
-    float SEq_2 = orientation.x;
-    float SEq_3 = orientation.y;
-    float SEq_4 = orientation.z;
-    
-    // Axulirary variables to avoid reapeated calcualtions
-    const float halfSEq_1 = 0.5f * SEq_1;
-    const float halfSEq_2 = 0.5f * SEq_2;
-    const float halfSEq_3 = 0.5f * SEq_3;
-    const float halfSEq_4 = 0.5f * SEq_4;
-    const float twoSEq_1 = 2.0f * SEq_1;
-    const float twoSEq_2 = 2.0f * SEq_2;
-    const float twoSEq_3 = 2.0f * SEq_3;
-    
-    // Normalise the accelerometer measurement
-    float a_x = data.accelX;
-    float a_y = data.accelY;
-    float a_z = data.accelZ;
-    float norm = sqrtf(a_x * a_x + a_y * a_y + a_z * a_z);
-    if (norm == 0.0f) return orientation; // Return unchanged orientation
-    a_x /= norm;
-    a_y /= norm;
-    a_z /= norm;
-    
-    // Compute the objective function and Jacobian
-    const float f_1 = twoSEq_2 * SEq_4 - twoSEq_1 * SEq_3 - a_x;
-    const float f_2 = twoSEq_1 * SEq_2 + twoSEq_3 * SEq_4 - a_y;
-    const float f_3 = 1.0f - twoSEq_2 * SEq_2 - twoSEq_3 * SEq_3 - a_z;
-    const float J_11or24 = twoSEq_3; // J_11 negated in matrix multiplication
-    const float J_12or23 = 2.0f * SEq_4; // J_12 negated in matrix multiplication
-    const float J_13or22 = twoSEq_1;
-    const float J_14or21 = twoSEq_2;
-    const float J_32 = 2.0f * J_14or21; // negated in matrix multiplication
-    const float J_33 = 2.0f * J_11or24; // negated in matrix multiplication
-    
-    // Compute the gradient (matrix multiplication)
-    float SEqHatDot_1 = J_14or21 * f_2 - J_11or24 * f_1;
-    float SEqHatDot_2 = J_12or23 * f_1 + J_13or22 * f_2 - J_32 * f_3;
-    float SEqHatDot_3 = J_12or23 * f_2 - J_33 * f_3 - J_13or22 * f_1;
-    float SEqHatDot_4 = J_14or21 * f_1 + J_11or24 * f_2;
-    
-    // Normalise the gradient
-    norm = sqrt(SEqHatDot_1 * SEqHatDot_1 + SEqHatDot_2 * SEqHatDot_2 + SEqHatDot_3 * SEqHatDot_3 + SEqHatDot_4 * SEqHatDot_4);
-    if (norm == 0.0f) return orientation; // Return unchanged orientation
-    SEqHatDot_1 /= norm;
-    SEqHatDot_2 /= norm;
-    SEqHatDot_3 /= norm;
-    SEqHatDot_4 /= norm;
-    
-    // Compute the quaternion derrivative measured by gyroscopes
-    const float w_x = data.gyroX;
-    const float w_y = data.gyroY;
-    const float w_z = data.gyroZ;
-    const float SEqDot_omega_1 = -halfSEq_2 * w_x - halfSEq_3 * w_y - halfSEq_4 * w_z;
-    const float SEqDot_omega_2 = halfSEq_1 * w_x + halfSEq_3 * w_z - halfSEq_4 * w_y;
-    const float SEqDot_omega_3 = halfSEq_1 * w_y - halfSEq_2 * w_z + halfSEq_4 * w_x;
-    const float SEqDot_omega_4 = halfSEq_1 * w_z + halfSEq_2 * w_y - halfSEq_3 * w_x;
-    
-    // Compute then integrate the estimated quaternion derrivative
-    // const float beta = sqrtf(3.0f / 4.0f) * gyroMeasError;
-    const float beta = 0.8660254038 * gyroMeasureError;
-    SEq_1 += (SEqDot_omega_1 - (beta * SEqHatDot_1)) * deltat;
-    SEq_2 += (SEqDot_omega_2 - (beta * SEqHatDot_2)) * deltat;
-    SEq_3 += (SEqDot_omega_3 - (beta * SEqHatDot_3)) * deltat;
-    SEq_4 += (SEqDot_omega_4 - (beta * SEqHatDot_4)) * deltat;
-    
-    // Normalise quaternion
-    norm = sqrt(SEq_1 * SEq_1 + SEq_2 * SEq_2 + SEq_3 * SEq_3 + SEq_4 * SEq_4);
-    if (norm == 0.0f) return orientation; // Return unchanged orientation
-    SEq_1 /= norm;
-    SEq_2 /= norm;
-    SEq_3 /= norm;
-    SEq_4 /= norm;
-
-    return Quaternion(SEq_1, SEq_2, SEq_3, SEq_4);
+    AttitudeEstimator *selected;
+    switch (estimatorType.getInt()) {
+        case ET_Mahony: selected = &mahony; break;
+        case ET_EKF: selected = &ekf; break;
+        default: selected = &madgwick; break;
+    }
+    if (selected != estimator) {
+        DLOG_I("MPU", "Switching attitude estimator from %s to %s", estimator->getName(), selected->getName());
+        selected->reset(orientation);
+        estimator = selected;
+    }
 }
 
-bool MPU::update()
+bool MPU::update(const MPUSample &sample)
 {
-    const auto nowMicros = micros();
+    const auto nowMicros = sample.micros;
+    selectEstimator();
     if (updateCount == 0) {
         orientation = Quaternion();
+        estimator->reset(orientation);
     } else {
-        MPUData data;
-        if (!readCalibrated(data)) {
+        if (!sample.ok) {
             return false;
         }
+        MPUData data = sample.data;
+        calibrate(data);
+        gyroFilterConfig.configure(gyroFilter, sampleHz);
+        float gyro[3] = { data.gyroX, data.gyroY, data.gyroZ };
+        gyroFilter.apply(gyro);
+        // Block averages are a cheap anti-alias filter for the decimation
+        analyzerSum[0] += gyro[0];
+        analyzerSum[1] += gyro[1];
+        analyzerSum[2] += gyro[2];
+        analyzerCount++;
+        if (analyzerCount >= analyzerDecimation) {
+            const float scale = 1.0f / (float)analyzerCount;
+            const float decimated[3] = { analyzerSum[0] * scale, analyzerSum[1] * scale, analyzerSum[2] * scale };
+            gyroAnalyzerPush(decimated, sampleHz / (float)analyzerDecimation);
+            analyzerCount = 0;
+            analyzerSum[0] = analyzerSum[1] = analyzerSum[2] = 0.0f;
+        }
+        gyroAnalyzerTuneNotches(dynamicNotch, sampleHz);
+        dynamicNotch.apply(gyro);
+        data.gyroX = gyro[0];
+        data.gyroY = gyro[1];
+        data.gyroZ = gyro[2];
+        rates = Vector(gyro[0], gyro[1], gyro[2]);
         const float dt = (nowMicros - lastUpdateMicros) * 1e-6f;
-        orientation = madgwickUpdate(dt, data, orientation, 0.1f);
+        // Only trust the accelerometer as a gravity reference near 1 g
+        const float accelNormSq = data.accelX * data.accelX + data.accelY * data.accelY + data.accelZ * data.accelZ;
+        const float rejectMin = accelRejectMin.getFloat();
+        const float rejectMax = accelRejectMax.getFloat();
+        const bool useAccel = accelNormSq >= rejectMin * rejectMin && accelNormSq <= rejectMax * rejectMax;
+        estimator->update(dt, data, useAccel);
+        orientation = estimator->getOrientation();
     }
     lastUpdateMicros = nowMicros;
     updateCount++;
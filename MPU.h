@@ -1,6 +1,8 @@
 #pragma once
 
+#include "AttitudeEstimator.h"
 #include "ConfigValue.h"
+#include "Filters.h"
 #include "Geometry.h"
 
 struct MPUData {
@@ -16,13 +18,32 @@ struct MPUData {
           gyroX(0.0f), gyroY(0.0f), gyroZ(0.0f) {}
 };
 
+// One raw reading, handed from the sensor task to the flight task
+struct MPUSample {
+    MPUData data;       // Uncalibrated
+    bool ok;
+    uint32_t micros;    // When the read finished
+
+    MPUSample() : ok(false), micros(0) {}
+};
+
+// Keys <name>.scale and <name>.offset; declare with LINEAR_CAL
+struct LinearCalDescriptors {
+    ConfigDescriptor scale;
+    ConfigDescriptor offset;
+};
+
+#define LINEAR_CAL(name, description) LinearCalDescriptors { \
+    ConfigDescriptor::fromFloat(name ".scale", description " scale factor", 1.0f), \
+    ConfigDescriptor::fromFloat(name ".offset", description " offset", 0.0f) }
+
 class LinearCal {
     ConfigValue scale;
     ConfigValue offset;
 public:
-    LinearCal(const String &name, const String &description)
-        : scale(name + ".scale", description + " scale factor", Value::fromFloat(1.0f))
-        , offset(name + ".offset", description + " offset", Value::fromFloat(0.0f))
+    explicit LinearCal(const LinearCalDescriptors &descriptors)
+        : scale(descriptors.scale)
+        , offset(descriptors.offset)
     {}
 
     float apply(float input) const {
@@ -43,12 +64,30 @@ class MPU {
     LinearCal gyroYCal;
     LinearCal gyroZCal;
 
+    ConfigValue estimatorType;
+    ConfigValue accelRejectMin;
+    ConfigValue accelRejectMax;
+    MadgwickEstimator madgwick;
+    MahonyEstimator mahony;
+    EKFEstimator ekf;
+    AttitudeEstimator *estimator;
+
+    FilterConfig gyroFilterConfig;
+    FilterBank<3> gyroFilter;
+    NotchBank<3> dynamicNotch;
+    float sampleHz;
+    uint32_t analyzerDecimation;
+    uint32_t analyzerCount;
+    float analyzerSum[3];
+
     Quaternion orientation;
+    Vector rates;
     
     uint32_t updateCount;
     unsigned long lastUpdateMicros;
-    bool readCalibrated(MPUData &data);
+    void calibrate(MPUData &data);
     void endCalibration();
+    void selectEstimator();
 
 protected:
     virtual bool readUncalibrated(MPUData &data) = 0;
@@ -58,12 +97,35 @@ public:
     virtual ~MPU() {}
     virtual void begin() = 0;
 
-    bool update();
+    // Sensor task: reads the bus and nothing else
+    bool acquire(MPUSample &sample);
+
+    // Flight task: calibrates, filters and runs the attitude estimator on a
+    // sample from acquire()
+    bool update(const MPUSample &sample);
+
+    // Nominal update rate, used to design the gyro filters and to decimate
+    // the samples sent to the gyro analyzer
+    void setSampleRate(float hz);
 
     Quaternion getOrientation() const {
         return orientation;
     }
 
+    // Filtered body rates from the last update in radians per second
+    Vector getRates() const {
+        return rates;
+    }
+
+    // True once the estimator has taken in a real sample
+    bool hasAttitude() const {
+        return updateCount > 1;
+    }
+
+    const AttitudeEstimator &getEstimator() const {
+        return *estimator;
+    }
+
 };
 
 void mpuBeginCalibration();
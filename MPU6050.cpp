@@ -15,6 +15,7 @@ void i2cReset(TwoWire &i2c) {
     i2c.end();
     delay(100);
     i2c.begin();
+    i2c.setClock(MPU6050_I2C_CLOCK_HZ);
 }
 
 bool i2cRequestFrom(TwoWire &i2c, uint8_t address, uint8_t reg, size_t len) {
@@ -54,23 +55,20 @@ bool MPU6050::readUncalibrated(MPUData &data) {
         }
     }
 
-    // Read gyroscope data
-    if (!i2cRequestFrom(i2c, address, MPU6050_GYRO_XOUT_H, 6)) {
-        needsInit = true;
-        return false;
-    }
-    data.gyroX = readGyro(0);
-    data.gyroY = readGyro(1);
-    data.gyroZ = readGyro(2);
-
-    // Read accelerometer data
-    if (!i2cRequestFrom(i2c, address, MPU6050_ACCEL_XOUT_H, 6)) {
+    // Read accelerometer, temperature and gyroscope data in one burst so
+    // the rate loop can run at the IMU rate
+    if (!i2cRequestFrom(i2c, address, MPU6050_ACCEL_XOUT_H, 14)) {
         needsInit = true;
         return false;
     }
     data.accelX = readAccel(0);
     data.accelY = readAccel(1);
     data.accelZ = readAccel(2);
+    i2c.read(); // Temperature
+    i2c.read();
+    data.gyroX = readGyro(0);
+    data.gyroY = readGyro(1);
+    data.gyroZ = readGyro(2);
 
     return true;
 }
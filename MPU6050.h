@@ -5,6 +5,9 @@
 
 #include "MPU.h"
 
+// Fast mode, so a full sensor read fits in a 1 kHz tick
+#define MPU6050_I2C_CLOCK_HZ 400000
+
 class MPU6050 : public MPU {
 private:
     TwoWire &i2c;
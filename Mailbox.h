@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Single-producer, single-consumer mailbox that always holds the latest
+// value. A triple buffer: the producer fills its own slot and swaps it with
+// the shared one, the consumer swaps the shared slot for its own. Neither
+// side ever waits or allocates, and a slow consumer just sees newer values.
+template <typename T>
+class LatestMailbox {
+    // Low two bits index the shared slot, bit 2 marks it as unread
+    static const uint8_t FRESH = 0x4;
+
+    T slots[3];
+    std::atomic<uint8_t> shared;
+    uint8_t writeIndex;
+    uint8_t readIndex;
+    std::atomic<uint32_t> posted;
+    std::atomic<uint32_t> overwritten;
+public:
+    LatestMailbox()
+        : slots()
+        , shared(1)
+        , writeIndex(0)
+        , readIndex(2)
+        , posted(0)
+        , overwritten(0) {}
+
+    // Producer side
+    void post(const T &value) {
+        slots[writeIndex] = value;
+        const uint8_t previous = shared.exchange(writeIndex | FRESH, std::memory_order_acq_rel);
+        if (previous & FRESH) {
+            overwritten.fetch_add(1, std::memory_order_relaxed);
+        }
+        writeIndex = previous & 0x3;
+        posted.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Consumer side. Returns false and leaves value alone if nothing new
+    // was posted since the last take.
+    bool take(T &value) {
+        if (!(shared.load(std::memory_order_relaxed) & FRESH)) {
+            return false;
+        }
+        const uint8_t previous = shared.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & 0x3;
+        value = slots[readIndex];
+        return true;
+    }
+
+    uint32_t getPosted() const {
+        return posted.load(std::memory_order_relaxed);
+    }
+
+    // Values replaced before the consumer took them
+    uint32_t getOverwritten() const {
+        return overwritten.load(std::memory_order_relaxed);
+    }
+};
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+// Fixed-size row-major matrix. Dimensions are template parameters so every
+// loop has a compile-time trip count and unrolls; nothing is heap allocated.
+// All arithmetic is constexpr so constant matrices fold at compile time.
+template <typename T, std::size_t R, std::size_t C>
+struct Matrix {
+    T m[R][C];
+
+    static constexpr std::size_t rows = R;
+    static constexpr std::size_t cols = C;
+
+    static constexpr Matrix zero() {
+        Matrix r{};
+        return r;
+    }
+
+    static constexpr Matrix identity() {
+        static_assert(R == C, "identity requires a square matrix");
+        Matrix r{};
+        for (std::size_t i = 0; i < R; ++i) {
+            r.m[i][i] = T(1);
+        }
+        return r;
+    }
+
+    constexpr T &operator()(std::size_t r, std::size_t c) {
+        return m[r][c];
+    }
+    constexpr const T &operator()(std::size_t r, std::size_t c) const {
+        return m[r][c];
+    }
+
+    // Element access for column vectors
+    constexpr T &operator[](std::size_t i) {
+        static_assert(C == 1, "operator[] requires a column vector");
+        return m[i][0];
+    }
+    constexpr const T &operator[](std::size_t i) const {
+        static_assert(C == 1, "operator[] requires a column vector");
+        return m[i][0];
+    }
+
+    constexpr Matrix<T, C, R> transpose() const {
+        Matrix<T, C, R> r{};
+        for (std::size_t i = 0; i < R; ++i) {
+            for (std::size_t j = 0; j < C; ++j) {
+                r.m[j][i] = m[i][j];
+            }
+        }
+        return r;
+    }
+
+    constexpr Matrix operator+(const Matrix &rhs) const {
+        Matrix r{};
+        for (std::size_t i = 0; i < R; ++i) {
+            for (std::size_t j = 0; j < C; ++j) {
+                r.m[i][j] = m[i][j] + rhs.m[i][j];
+            }
+        }
+        return r;
+    }
+
+    constexpr Matrix operator-(const Matrix &rhs) const {
+        Matrix r{};
+        for (std::size_t i = 0; i < R; ++i) {
+            for (std::size_t j = 0; j < C; ++j) {
+                r.m[i][j] = m[i][j] - rhs.m[i][j];
+            }
+        }
+        return r;
+    }
+
+    constexpr Matrix operator*(T s) const {
+        Matrix r{};
+        for (std::size_t i = 0; i < R; ++i) {
+            for (std::size_t j = 0; j < C; ++j) {
+                r.m[i][j] = m[i][j] * s;
+            }
+        }
+        return r;
+    }
+
+    template <std::size_t K>
+    constexpr Matrix<T, R, K> operator*(const Matrix<T, C, K> &rhs) const {
+        Matrix<T, R, K> r{};
+        for (std::size_t i = 0; i < R; ++i) {
+            for (std::size_t k = 0; k < K; ++k) {
+                T sum = T(0);
+                for (std::size_t j = 0; j < C; ++j) {
+                    sum += m[i][j] * rhs.m[j][k];
+                }
+                r.m[i][k] = sum;
+            }
+        }
+        return r;
+    }
+
+    constexpr Matrix &operator+=(const Matrix &rhs) {
+        for (std::size_t i = 0; i < R; ++i) {
+            for (std::size_t j = 0; j < C; ++j) {
+                m[i][j] += rhs.m[i][j];
+            }
+        }
+        return *this;
+    }
+
+    constexpr Matrix &operator-=(const Matrix &rhs) {
+        for (std::size_t i = 0; i < R; ++i) {
+            for (std::size_t j = 0; j < C; ++j) {
+                m[i][j] -= rhs.m[i][j];
+            }
+        }
+        return *this;
+    }
+
+    constexpr bool operator==(const Matrix &rhs) const {
+        for (std::size_t i = 0; i < R; ++i) {
+            for (std::size_t j = 0; j < C; ++j) {
+                if (m[i][j] != rhs.m[i][j]) return false;
+            }
+        }
+        return true;
+    }
+};
+
+template <typename T, std::size_t N>
+using ColumnVector = Matrix<T, N, 1>;
+
+typedef Matrix<float, 3, 3> Matrix3f;
+typedef Matrix<float, 4, 4> Matrix4f;
+typedef ColumnVector<float, 3> Vector3f;
+typedef ColumnVector<float, 4> Vector4f;
+
+// Closed-form inverses. Return false and leave out untouched when the
+// matrix is singular.
+template <typename T>
+constexpr bool matrixInverse(const Matrix<T, 2, 2> &a, Matrix<T, 2, 2> &out) {
+    const T det = a.m[0][0] * a.m[1][1] - a.m[0][1] * a.m[1][0];
+    if (det == T(0)) return false;
+    const T invDet = T(1) / det;
+    out.m[0][0] = a.m[1][1] * invDet;
+    out.m[0][1] = -a.m[0][1] * invDet;
+    out.m[1][0] = -a.m[1][0] * invDet;
+    out.m[1][1] = a.m[0][0] * invDet;
+    return true;
+}
+
+template <typename T>
+constexpr bool matrixInverse(const Matrix<T, 3, 3> &a, Matrix<T, 3, 3> &out) {
+    const T c00 = a.m[1][1] * a.m[2][2] - a.m[1][2] * a.m[2][1];
+    const T c01 = a.m[1][2] * a.m[2][0] - a.m[1][0] * a.m[2][2];
+    const T c02 = a.m[1][0] * a.m[2][1] - a.m[1][1] * a.m[2][0];
+    const T det = a.m[0][0] * c00 + a.m[0][1] * c01 + a.m[0][2] * c02;
+    if (det == T(0)) return false;
+    const T invDet = T(1) / det;
+    out.m[0][0] = c00 * invDet;
+    out.m[1][0] = c01 * invDet;
+    out.m[2][0] = c02 * invDet;
+    out.m[0][1] = (a.m[0][2] * a.m[2][1] - a.m[0][1] * a.m[2][2]) * invDet;
+    out.m[1][1] = (a.m[0][0] * a.m[2][2] - a.m[0][2] * a.m[2][0]) * invDet;
+    out.m[2][1] = (a.m[0][1] * a.m[2][0] - a.m[0][0] * a.m[2][1]) * invDet;
+    out.m[0][2] = (a.m[0][1] * a.m[1][2] - a.m[0][2] * a.m[1][1]) * invDet;
+    out.m[1][2] = (a.m[0][2] * a.m[1][0] - a.m[0][0] * a.m[1][2]) * invDet;
+    out.m[2][2] = (a.m[0][0] * a.m[1][1] - a.m[0][1] * a.m[1][0]) * invDet;
+    return true;
+}
+
+// Cholesky factorization a = l * l^T of a symmetric positive definite
+// matrix. Only the lower triangle of a is read. Returns false if a is not
+// positive definite.
+template <typename T, std::size_t N>
+bool matrixCholesky(const Matrix<T, N, N> &a, Matrix<T, N, N> &l) {
+    l = Matrix<T, N, N>::zero();
+    for (std::size_t j = 0; j < N; ++j) {
+        T d = a.m[j][j];
+        for (std::size_t k = 0; k < j; ++k) {
+            d -= l.m[j][k] * l.m[j][k];
+        }
+        if (d <= T(0)) return false;
+        const T ljj = std::sqrt(d);
+        l.m[j][j] = ljj;
+        const T invLjj = T(1) / ljj;
+        for (std::size_t i = j + 1; i < N; ++i) {
+            T s = a.m[i][j];
+            for (std::size_t k = 0; k < j; ++k) {
+                s -= l.m[i][k] * l.m[j][k];
+            }
+            l.m[i][j] = s * invLjj;
+        }
+    }
+    return true;
+}
+
+// Solves (l * l^T) x = b given the Cholesky factor l
+template <typename T, std::size_t N, std::size_t K>
+Matrix<T, N, K> matrixCholeskySolve(const Matrix<T, N, N> &l, const Matrix<T, N, K> &b) {
+    Matrix<T, N, K> x = b;
+    for (std::size_t k = 0; k < K; ++k) {
+        // Forward substitution: l y = b
+        for (std::size_t i = 0; i < N; ++i) {
+            T s = x.m[i][k];
+            for (std::size_t j = 0; j < i; ++j) {
+                s -= l.m[i][j] * x.m[j][k];
+            }
+            x.m[i][k] = s / l.m[i][i];
+        }
+        // Back substitution: l^T x = y
+        for (std::size_t i = N; i-- > 0;) {
+            T s = x.m[i][k];
+            for (std::size_t j = i + 1; j < N; ++j) {
+                s -= l.m[j][i] * x.m[j][k];
+            }
+            x.m[i][k] = s / l.m[i][i];
+        }
+    }
+    return x;
+}
+
+// Compile-time checks; these fail the build rather than the flight.
+namespace matrixChecks {
+    constexpr Matrix<int, 2, 3> a = {{{1, 2, 3}, {4, 5, 6}}};
+    constexpr Matrix<int, 3, 2> at = {{{1, 4}, {2, 5}, {3, 6}}};
+    constexpr Matrix<int, 2, 2> aat = {{{14, 32}, {32, 77}}};
+    static_assert(a.transpose() == at, "Matrix transpose");
+    static_assert(a * at == aat, "Matrix multiply");
+    static_assert(Matrix<int, 2, 2>::identity() * aat == aat, "Matrix identity");
+    static_assert((aat - aat) == (Matrix<int, 2, 2>::zero()), "Matrix subtract");
+}
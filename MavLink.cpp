@@ -0,0 +1,471 @@
+#include <cstring>
+
+#include "MavLink.h"
+
+#define MAVLINK_INCOMPAT_SIGNED 0x01
+
+struct MessageInfo {
+    uint32_t id;
+    uint8_t crcExtra;       // Seeds the checksum with the message's layout
+};
+
+static const MessageInfo messageInfos[] = {
+    { MM_Heartbeat,             50 },
+    { MM_SysStatus,             124 },
+    { MM_ParamRequestRead,      214 },
+    { MM_ParamRequestList,      159 },
+    { MM_ParamValue,            220 },
+    { MM_ParamSet,              168 },
+    { MM_AttitudeQuaternion,    246 },
+    { MM_ServoOutputRaw,        222 },
+    { MM_RCChannels,            118 },
+    { MM_CommandLong,           152 },
+    { MM_CommandAck,            143 },
+    { MM_AutopilotVersion,      178 },
+};
+
+static const MessageInfo *findMessageInfo(uint32_t id) {
+    for (const MessageInfo &info : messageInfos) {
+        if (info.id == id) {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+
+uint16_t mavlinkCrc(const uint8_t *data, size_t length, uint16_t crc) {
+    for (size_t i = 0; i < length; ++i) {
+        uint8_t t = data[i] ^ (uint8_t)(crc & 0xFF);
+        t ^= (uint8_t)(t << 4);
+        crc = (crc >> 8) ^ ((uint16_t)t << 8) ^ ((uint16_t)t << 3) ^ (t >> 4);
+    }
+    return crc;
+}
+
+// Fields go out little-endian in the order of the message's wire layout
+// (largest type first), whatever the host's byte order
+class PayloadWriter {
+    uint8_t *out;
+    size_t position;
+public:
+    explicit PayloadWriter(uint8_t *out) : out(out), position(0) {}
+    size_t length() const {
+        return position;
+    }
+    void u8(uint8_t v) {
+        out[position++] = v;
+    }
+    void u16(uint16_t v) {
+        u8((uint8_t)v);
+        u8((uint8_t)(v >> 8));
+    }
+    void u32(uint32_t v) {
+        u16((uint16_t)v);
+        u16((uint16_t)(v >> 16));
+    }
+    void u64(uint64_t v) {
+        u32((uint32_t)v);
+        u32((uint32_t)(v >> 32));
+    }
+    void f32(float v) {
+        uint32_t bits;
+        memcpy(&bits, &v, sizeof(bits));
+        u32(bits);
+    }
+    void chars(const char *s, size_t length) {
+        size_t i = 0;
+        for (; i < length && s[i] != '\0'; ++i) {
+            u8((uint8_t)s[i]);
+        }
+        for (; i < length; ++i) {
+            u8(0);
+        }
+    }
+};
+
+class PayloadReader {
+    const uint8_t *in;
+    size_t position;
+public:
+    explicit PayloadReader(const uint8_t *in) : in(in), position(0) {}
+    uint8_t u8() {
+        return in[position++];
+    }
+    uint16_t u16() {
+        const uint16_t lo = u8();
+        return lo | (uint16_t)(u8() << 8);
+    }
+    uint32_t u32() {
+        const uint32_t lo = u16();
+        return lo | ((uint32_t)u16() << 16);
+    }
+    uint64_t u64() {
+        const uint64_t lo = u32();
+        return lo | ((uint64_t)u32() << 32);
+    }
+    float f32() {
+        const uint32_t bits = u32();
+        float v;
+        memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+    void chars(char *out, size_t length) {
+        for (size_t i = 0; i < length; ++i) {
+            out[i] = (char)u8();
+        }
+    }
+};
+
+size_t MavLinkEncoder::finish(uint8_t *frame, uint32_t messageId, size_t payloadLength) {
+    // v2 drops trailing zero bytes from the payload, keeping at least one
+    while (payloadLength > 1 && frame[MAVLINK_HEADER_LEN + payloadLength - 1] == 0) {
+        payloadLength--;
+    }
+    frame[0] = MAVLINK_STX;
+    frame[1] = (uint8_t)payloadLength;
+    frame[2] = 0;   // Incompatibility flags
+    frame[3] = 0;   // Compatibility flags
+    frame[4] = sequence++;
+    frame[5] = systemId;
+    frame[6] = componentId;
+    frame[7] = (uint8_t)messageId;
+    frame[8] = (uint8_t)(messageId >> 8);
+    frame[9] = (uint8_t)(messageId >> 16);
+    uint16_t crc = mavlinkCrc(frame + 1, MAVLINK_HEADER_LEN - 1 + payloadLength);
+    const uint8_t crcExtra = findMessageInfo(messageId)->crcExtra;
+    crc = mavlinkCrc(&crcExtra, 1, crc);
+    frame[MAVLINK_HEADER_LEN + payloadLength] = (uint8_t)crc;
+    frame[MAVLINK_HEADER_LEN + payloadLength + 1] = (uint8_t)(crc >> 8);
+    return MAVLINK_HEADER_LEN + payloadLength + MAVLINK_CHECKSUM_LEN;
+}
+
+size_t MavLinkEncoder::heartbeat(uint8_t *frame, const MavLinkHeartbeat &m) {
+    PayloadWriter w(frame + MAVLINK_HEADER_LEN);
+    w.u32(m.customMode);
+    w.u8(m.type);
+    w.u8(m.autopilot);
+    w.u8(m.baseMode);
+    w.u8(m.systemStatus);
+    w.u8(3);    // MAVLink version
+    return finish(frame, MM_Heartbeat, w.length());
+}
+
+size_t MavLinkEncoder::sysStatus(uint8_t *frame, const MavLinkSysStatus &m) {
+    PayloadWriter w(frame + MAVLINK_HEADER_LEN);
+    w.u32(m.sensorsPresent);
+    w.u32(m.sensorsEnabled);
+    w.u32(m.sensorsHealth);
+    w.u16(m.load);
+    w.u16(m.voltageBattery);
+    w.u16((uint16_t)m.currentBattery);
+    w.u16(m.dropRateComm);
+    w.u16(m.errorsComm);
+    for (int i = 0; i < 4; ++i) {
+        w.u16(0);   // errors_count1-4
+    }
+    w.u8((uint8_t)m.batteryRemaining);
+    return finish(frame, MM_SysStatus, w.length());
+}
+
+size_t MavLinkEncoder::attitudeQuaternion(uint8_t *frame, const MavLinkAttitudeQuaternion &m) {
+    PayloadWriter w(frame + MAVLINK_HEADER_LEN);
+    w.u32(m.timeBootMillis);
+    w.f32(m.q1);
+    w.f32(m.q2);
+    w.f32(m.q3);
+    w.f32(m.q4);
+    w.f32(m.rollSpeed);
+    w.f32(m.pitchSpeed);
+    w.f32(m.yawSpeed);
+    return finish(frame, MM_AttitudeQuaternion, w.length());
+}
+
+size_t MavLinkEncoder::rcChannels(uint8_t *frame, const MavLinkRCChannels &m) {
+    PayloadWriter w(frame + MAVLINK_HEADER_LEN);
+    w.u32(m.timeBootMillis);
+    for (uint16_t channel : m.channels) {
+        w.u16(channel);
+    }
+    w.u8(m.channelCount);
+    w.u8(m.rssi);
+    return finish(frame, MM_RCChannels, w.length());
+}
+
+size_t MavLinkEncoder::servoOutputRaw(uint8_t *frame, const MavLinkServoOutputRaw &m) {
+    PayloadWriter w(frame + MAVLINK_HEADER_LEN);
+    w.u32(m.timeMicros);
+    for (uint16_t servo : m.servos) {
+        w.u16(servo);
+    }
+    w.u8(m.port);
+    return finish(frame, MM_ServoOutputRaw, w.length());
+}
+
+size_t MavLinkEncoder::paramValue(uint8_t *frame, const MavLinkParamValue &m) {
+    PayloadWriter w(frame + MAVLINK_HEADER_LEN);
+    w.f32(m.value);
+    w.u16(m.count);
+    w.u16(m.index);
+    w.chars(m.id, MAVLINK_PARAM_ID_LEN);
+    w.u8(m.type);
+    return finish(frame, MM_ParamValue, w.length());
+}
+
+size_t MavLinkEncoder::commandAck(uint8_t *frame, const MavLinkCommandAck &m) {
+    PayloadWriter w(frame + MAVLINK_HEADER_LEN);
+    w.u16(m.command);
+    w.u8(m.result);
+    // Extensions
+    w.u8(0);    // progress
+    w.u32(0);   // result_param2
+    w.u8(m.targetSystem);
+    w.u8(m.targetComponent);
+    return finish(frame, MM_CommandAck, w.length());
+}
+
+size_t MavLinkEncoder::autopilotVersion(uint8_t *frame, const MavLinkAutopilotVersion &m) {
+    PayloadWriter w(frame + MAVLINK_HEADER_LEN);
+    w.u64(m.capabilities);
+    w.u64(m.uid);
+    w.u32(m.flightSwVersion);
+    w.u32(0);   // middleware_sw_version
+    w.u32(0);   // os_sw_version
+    w.u32(0);   // board_version
+    w.u16(m.vendorId);
+    w.u16(m.productId);
+    for (int i = 0; i < 3 * 8; ++i) {
+        w.u8(0);    // flight, middleware and os custom versions
+    }
+    return finish(frame, MM_AutopilotVersion, w.length());
+}
+
+size_t MavLinkEncoder::paramRequestRead(uint8_t *frame, const MavLinkParamRequestRead &m) {
+    PayloadWriter w(frame + MAVLINK_HEADER_LEN);
+    w.u16((uint16_t)m.index);
+    w.u8(m.targetSystem);
+    w.u8(m.targetComponent);
+    w.chars(m.id, MAVLINK_PARAM_ID_LEN);
+    return finish(frame, MM_ParamRequestRead, w.length());
+}
+
+size_t MavLinkEncoder::paramRequestList(uint8_t *frame, const MavLinkParamRequestList &m) {
+    PayloadWriter w(frame + MAVLINK_HEADER_LEN);
+    w.u8(m.targetSystem);
+    w.u8(m.targetComponent);
+    return finish(frame, MM_ParamRequestList, w.length());
+}
+
+size_t MavLinkEncoder::paramSet(uint8_t *frame, const MavLinkParamSet &m) {
+    PayloadWriter w(frame + MAVLINK_HEADER_LEN);
+    w.f32(m.value);
+    w.u8(m.targetSystem);
+    w.u8(m.targetComponent);
+    w.chars(m.id, MAVLINK_PARAM_ID_LEN);
+    w.u8(m.type);
+    return finish(frame, MM_ParamSet, w.length());
+}
+
+size_t MavLinkEncoder::commandLong(uint8_t *frame, const MavLinkCommandLong &m) {
+    PayloadWriter w(frame + MAVLINK_HEADER_LEN);
+    for (float param : m.params) {
+        w.f32(param);
+    }
+    w.u16(m.command);
+    w.u8(m.targetSystem);
+    w.u8(m.targetComponent);
+    w.u8(m.confirmation);
+    return finish(frame, MM_CommandLong, w.length());
+}
+
+MavLinkParser::MavLinkParser()
+    : state(PS_Idle), position(0), checksum(0), checksumLow(0), checksumOk(false) {
+    memset(header, 0, sizeof(header));
+    memset(&current, 0, sizeof(current));
+    memset(&stats, 0, sizeof(stats));
+}
+
+bool MavLinkParser::push(uint8_t byte) {
+    switch (state) {
+    case PS_Idle:
+        if (byte == MAVLINK_STX) {
+            header[0] = byte;
+            position = 1;
+            state = PS_Header;
+        }
+        else {
+            stats.skipped++;
+        }
+        return false;
+
+    case PS_Header:
+        header[position++] = byte;
+        if (position == MAVLINK_HEADER_LEN) {
+            current.id = header[7] | ((uint32_t)header[8] << 8) | ((uint32_t)header[9] << 16);
+            current.length = header[1];
+            checksum = mavlinkCrc(header + 1, MAVLINK_HEADER_LEN - 1);
+            position = 0;
+            state = current.length > 0 ? PS_Payload : PS_Checksum;
+        }
+        return false;
+
+    case PS_Payload:
+        current.payload[position++] = byte;
+        checksum = mavlinkCrc(&byte, 1, checksum);
+        if (position == current.length) {
+            position = 0;
+            state = PS_Checksum;
+        }
+        return false;
+
+    case PS_Checksum:
+        if (position == 0) {
+            checksumLow = byte;
+            position = 1;
+            return false;
+        }
+        if (const MessageInfo *info = findMessageInfo(current.id)) {
+            const uint16_t expected = mavlinkCrc(&info->crcExtra, 1, checksum);
+            checksumOk = expected == (checksumLow | (uint16_t)(byte << 8));
+        }
+        else {
+            checksumOk = false;
+        }
+        if (header[2] & MAVLINK_INCOMPAT_SIGNED) {
+            position = 0;
+            state = PS_Signature;
+            return false;
+        }
+        return complete();
+
+    case PS_Signature:
+        if (++position == MAVLINK_SIGNATURE_LEN) {
+            return complete();
+        }
+        return false;
+    }
+    return false;
+}
+
+bool MavLinkParser::complete() {
+    state = PS_Idle;
+    if (findMessageInfo(current.id) == nullptr) {
+        stats.unknown++;
+        return false;
+    }
+    if (!checksumOk) {
+        stats.crcErrors++;
+        return false;
+    }
+    current.sequence = header[4];
+    current.systemId = header[5];
+    current.componentId = header[6];
+    memset(current.payload + current.length, 0, MAVLINK_PAYLOAD_MAX - current.length);
+    stats.received++;
+    return true;
+}
+
+bool mavlinkDecodeHeartbeat(const MavLinkMessage &message, MavLinkHeartbeat &out) {
+    if (message.id != MM_Heartbeat) {
+        return false;
+    }
+    PayloadReader r(message.payload);
+    out.customMode = r.u32();
+    out.type = r.u8();
+    out.autopilot = r.u8();
+    out.baseMode = r.u8();
+    out.systemStatus = r.u8();
+    return true;
+}
+
+bool mavlinkDecodeParamRequestRead(const MavLinkMessage &message, MavLinkParamRequestRead &out) {
+    if (message.id != MM_ParamRequestRead) {
+        return false;
+    }
+    PayloadReader r(message.payload);
+    out.index = (int16_t)r.u16();
+    out.targetSystem = r.u8();
+    out.targetComponent = r.u8();
+    r.chars(out.id, MAVLINK_PARAM_ID_LEN);
+    return true;
+}
+
+bool mavlinkDecodeParamRequestList(const MavLinkMessage &message, MavLinkParamRequestList &out) {
+    if (message.id != MM_ParamRequestList) {
+        return false;
+    }
+    PayloadReader r(message.payload);
+    out.targetSystem = r.u8();
+    out.targetComponent = r.u8();
+    return true;
+}
+
+bool mavlinkDecodeParamSet(const MavLinkMessage &message, MavLinkParamSet &out) {
+    if (message.id != MM_ParamSet) {
+        return false;
+    }
+    PayloadReader r(message.payload);
+    out.value = r.f32();
+    out.targetSystem = r.u8();
+    out.targetComponent = r.u8();
+    r.chars(out.id, MAVLINK_PARAM_ID_LEN);
+    out.type = r.u8();
+    return true;
+}
+
+bool mavlinkDecodeParamValue(const MavLinkMessage &message, MavLinkParamValue &out) {
+    if (message.id != MM_ParamValue) {
+        return false;
+    }
+    PayloadReader r(message.payload);
+    out.value = r.f32();
+    out.count = r.u16();
+    out.index = r.u16();
+    r.chars(out.id, MAVLINK_PARAM_ID_LEN);
+    out.type = r.u8();
+    return true;
+}
+
+bool mavlinkDecodeCommandLong(const MavLinkMessage &message, MavLinkCommandLong &out) {
+    if (message.id != MM_CommandLong) {
+        return false;
+    }
+    PayloadReader r(message.payload);
+    for (float &param : out.params) {
+        param = r.f32();
+    }
+    out.command = r.u16();
+    out.targetSystem = r.u8();
+    out.targetComponent = r.u8();
+    out.confirmation = r.u8();
+    return true;
+}
+
+bool mavlinkDecodeCommandAck(const MavLinkMessage &message, MavLinkCommandAck &out) {
+    if (message.id != MM_CommandAck) {
+        return false;
+    }
+    PayloadReader r(message.payload);
+    out.command = r.u16();
+    out.result = r.u8();
+    r.u8();     // progress
+    r.u32();    // result_param2
+    out.targetSystem = r.u8();
+    out.targetComponent = r.u8();
+    return true;
+}
+
+bool mavlinkDecodeAutopilotVersion(const MavLinkMessage &message, MavLinkAutopilotVersion &out) {
+    if (message.id != MM_AutopilotVersion) {
+        return false;
+    }
+    PayloadReader r(message.payload);
+    out.capabilities = r.u64();
+    out.uid = r.u64();
+    out.flightSwVersion = r.u32();
+    r.u32();    // middleware_sw_version
+    r.u32();    // os_sw_version
+    r.u32();    // board_version
+    out.vendorId = r.u16();
+    out.productId = r.u16();
+    return true;
+}
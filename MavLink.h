@@ -0,0 +1,230 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Minimal MAVLink v2 codec for the handful of common.xml messages Flybot
+// speaks. Encoders write a whole frame into a caller's buffer and the parser
+// takes one byte at a time, so neither allocates. No Arduino dependencies;
+// the transport lives elsewhere.
+//
+// Signed frames are accepted with the signature ignored. MAVLink v1 frames
+// are skipped.
+
+#define MAVLINK_STX 0xFD
+#define MAVLINK_HEADER_LEN 10
+#define MAVLINK_CHECKSUM_LEN 2
+#define MAVLINK_SIGNATURE_LEN 13
+#define MAVLINK_PAYLOAD_MAX 255
+#define MAVLINK_FRAME_MAX (MAVLINK_HEADER_LEN + MAVLINK_PAYLOAD_MAX + MAVLINK_CHECKSUM_LEN + MAVLINK_SIGNATURE_LEN)
+#define MAVLINK_PARAM_ID_LEN 16
+
+enum MavLinkMessageId {
+    MM_Heartbeat            = 0,
+    MM_SysStatus            = 1,
+    MM_ParamRequestRead     = 20,
+    MM_ParamRequestList     = 21,
+    MM_ParamValue           = 22,
+    MM_ParamSet             = 23,
+    MM_AttitudeQuaternion   = 31,
+    MM_ServoOutputRaw       = 36,
+    MM_RCChannels           = 65,
+    MM_CommandLong          = 76,
+    MM_CommandAck           = 77,
+    MM_AutopilotVersion     = 148,
+};
+
+// MAV_PARAM_TYPE
+enum MavLinkParamType {
+    MPT_Int32   = 6,
+    MPT_Real32  = 9,
+};
+
+struct MavLinkHeartbeat {
+    uint32_t customMode;
+    uint8_t type;               // MAV_TYPE
+    uint8_t autopilot;          // MAV_AUTOPILOT
+    uint8_t baseMode;           // MAV_MODE_FLAG bits
+    uint8_t systemStatus;       // MAV_STATE
+};
+
+struct MavLinkSysStatus {
+    uint32_t sensorsPresent;    // MAV_SYS_STATUS_SENSOR bits
+    uint32_t sensorsEnabled;
+    uint32_t sensorsHealth;
+    uint16_t load;              // Tenths of a percent
+    uint16_t voltageBattery;    // mV, UINT16_MAX if unknown
+    int16_t currentBattery;     // 10 mA, -1 if unknown
+    uint16_t dropRateComm;      // Hundredths of a percent
+    uint16_t errorsComm;
+    int8_t batteryRemaining;    // Percent, -1 if unknown
+};
+
+struct MavLinkAttitudeQuaternion {
+    uint32_t timeBootMillis;
+    float q1, q2, q3, q4;       // w, x, y, z
+    float rollSpeed, pitchSpeed, yawSpeed;
+};
+
+#define MAVLINK_RC_CHANNELS 18
+
+struct MavLinkRCChannels {
+    uint32_t timeBootMillis;
+    uint16_t channels[MAVLINK_RC_CHANNELS];    // Microseconds, UINT16_MAX if unused
+    uint8_t channelCount;
+    uint8_t rssi;               // 255 if unknown
+};
+
+#define MAVLINK_SERVO_OUTPUTS 8
+
+struct MavLinkServoOutputRaw {
+    uint32_t timeMicros;
+    uint16_t servos[MAVLINK_SERVO_OUTPUTS];    // Microseconds
+    uint8_t port;
+};
+
+struct MavLinkParamValue {
+    char id[MAVLINK_PARAM_ID_LEN];  // Not terminated when all 16 are used
+    float value;
+    uint8_t type;               // MavLinkParamType
+    uint16_t count;
+    uint16_t index;
+};
+
+struct MavLinkParamRequestRead {
+    uint8_t targetSystem;
+    uint8_t targetComponent;
+    char id[MAVLINK_PARAM_ID_LEN];
+    int16_t index;              // -1 to look up by id
+};
+
+struct MavLinkParamRequestList {
+    uint8_t targetSystem;
+    uint8_t targetComponent;
+};
+
+struct MavLinkParamSet {
+    uint8_t targetSystem;
+    uint8_t targetComponent;
+    char id[MAVLINK_PARAM_ID_LEN];
+    float value;
+    uint8_t type;
+};
+
+#define MAVLINK_COMMAND_PARAMS 7
+
+struct MavLinkCommandLong {
+    float params[MAVLINK_COMMAND_PARAMS];  // param1-7
+    uint16_t command;           // MAV_CMD
+    uint8_t targetSystem;
+    uint8_t targetComponent;
+    uint8_t confirmation;
+};
+
+struct MavLinkCommandAck {
+    uint16_t command;           // MAV_CMD
+    uint8_t result;             // MAV_RESULT
+    uint8_t targetSystem;       // The sender of the command
+    uint8_t targetComponent;
+};
+
+struct MavLinkAutopilotVersion {
+    uint64_t capabilities;      // MAV_PROTOCOL_CAPABILITY bits
+    uint64_t uid;               // 0 if unknown
+    uint32_t flightSwVersion;
+    uint16_t vendorId;
+    uint16_t productId;
+};
+
+// A received message. The payload is zero-filled past the received length,
+// as v2 senders drop trailing zeros.
+struct MavLinkMessage {
+    uint32_t id;
+    uint8_t systemId;
+    uint8_t componentId;
+    uint8_t sequence;
+    uint8_t length;
+    uint8_t payload[MAVLINK_PAYLOAD_MAX];
+};
+
+// CRC-16/MCRF4XX as MAVLink uses it, continuing from crc
+uint16_t mavlinkCrc(const uint8_t *data, size_t length, uint16_t crc = 0xFFFF);
+
+class MavLinkEncoder {
+    uint8_t systemId;
+    uint8_t componentId;
+    uint8_t sequence;
+
+    size_t finish(uint8_t *frame, uint32_t messageId, size_t payloadLength);
+public:
+    MavLinkEncoder(uint8_t systemId, uint8_t componentId)
+        : systemId(systemId), componentId(componentId), sequence(0) {}
+    void setSystemId(uint8_t id) {
+        systemId = id;
+    }
+
+    // Each writes one frame into frame, which must hold MAVLINK_FRAME_MAX
+    // bytes, and returns its length
+    size_t heartbeat(uint8_t *frame, const MavLinkHeartbeat &message);
+    size_t sysStatus(uint8_t *frame, const MavLinkSysStatus &message);
+    size_t attitudeQuaternion(uint8_t *frame, const MavLinkAttitudeQuaternion &message);
+    size_t rcChannels(uint8_t *frame, const MavLinkRCChannels &message);
+    size_t servoOutputRaw(uint8_t *frame, const MavLinkServoOutputRaw &message);
+    size_t paramValue(uint8_t *frame, const MavLinkParamValue &message);
+    size_t commandAck(uint8_t *frame, const MavLinkCommandAck &message);
+    size_t autopilotVersion(uint8_t *frame, const MavLinkAutopilotVersion &message);
+    // The ground station's side, for tools and tests
+    size_t paramRequestRead(uint8_t *frame, const MavLinkParamRequestRead &message);
+    size_t paramRequestList(uint8_t *frame, const MavLinkParamRequestList &message);
+    size_t paramSet(uint8_t *frame, const MavLinkParamSet &message);
+    size_t commandLong(uint8_t *frame, const MavLinkCommandLong &message);
+};
+
+struct MavLinkParserStats {
+    uint32_t received;          // Frames with a good checksum
+    uint32_t crcErrors;
+    uint32_t unknown;           // Frames of messages not in the codec
+    uint32_t skipped;           // Bytes outside any frame
+};
+
+class MavLinkParser {
+    enum ParseState {
+        PS_Idle,
+        PS_Header,
+        PS_Payload,
+        PS_Checksum,
+        PS_Signature,
+    };
+
+    ParseState state;
+    uint8_t header[MAVLINK_HEADER_LEN];
+    size_t position;
+    uint16_t checksum;
+    uint8_t checksumLow;
+    bool checksumOk;
+    MavLinkMessage current;
+    MavLinkParserStats stats;
+
+    bool complete();
+public:
+    MavLinkParser();
+    // Returns true when byte completes a message with a good checksum
+    bool push(uint8_t byte);
+    // The last complete message, valid until the next push
+    const MavLinkMessage &message() const {
+        return current;
+    }
+    const MavLinkParserStats &getStats() const {
+        return stats;
+    }
+};
+
+// Each returns false if the message is not of that type
+bool mavlinkDecodeHeartbeat(const MavLinkMessage &message, MavLinkHeartbeat &out);
+bool mavlinkDecodeParamRequestRead(const MavLinkMessage &message, MavLinkParamRequestRead &out);
+bool mavlinkDecodeParamRequestList(const MavLinkMessage &message, MavLinkParamRequestList &out);
+bool mavlinkDecodeParamSet(const MavLinkMessage &message, MavLinkParamSet &out);
+bool mavlinkDecodeParamValue(const MavLinkMessage &message, MavLinkParamValue &out);
+bool mavlinkDecodeCommandLong(const MavLinkMessage &message, MavLinkCommandLong &out);
+bool mavlinkDecodeCommandAck(const MavLinkMessage &message, MavLinkCommandAck &out);
+bool mavlinkDecodeAutopilotVersion(const MavLinkMessage &message, MavLinkAutopilotVersion &out);
@@ -0,0 +1,382 @@
+#include <Arduino.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "Config.h"
+#include "ConfigValue.h"
+#include "MavLinkService.h"
+#include "Motors.h"
+#include "RadioController.h"
+#include "State.h"
+#include "Tasks.h"
+
+// MAV_COMPONENT
+#define MAVLINK_COMPONENT_AUTOPILOT 1
+
+// MAV_TYPE
+#define MAV_TYPE_GENERIC 0
+#define MAV_TYPE_QUADROTOR 2
+#define MAV_TYPE_HEXAROTOR 13
+#define MAV_TYPE_TRICOPTER 15
+// MAV_AUTOPILOT
+#define MAV_AUTOPILOT_GENERIC 0
+// MAV_MODE_FLAG
+#define MAV_MODE_FLAG_CUSTOM_MODE_ENABLED 0x01
+#define MAV_MODE_FLAG_STABILIZE_ENABLED 0x10
+#define MAV_MODE_FLAG_MANUAL_INPUT_ENABLED 0x40
+#define MAV_MODE_FLAG_SAFETY_ARMED 0x80
+// MAV_STATE
+#define MAV_STATE_STANDBY 3
+#define MAV_STATE_ACTIVE 4
+#define MAV_STATE_CRITICAL 5
+// MAV_SYS_STATUS_SENSOR
+#define MAV_SYS_STATUS_SENSOR_3D_GYRO 0x00000001
+#define MAV_SYS_STATUS_SENSOR_3D_ACCEL 0x00000002
+#define MAV_SYS_STATUS_SENSOR_MOTOR_OUTPUTS 0x00008000
+#define MAV_SYS_STATUS_SENSOR_RC_RECEIVER 0x00010000
+// MAV_PROTOCOL_CAPABILITY
+#define MAV_PROTOCOL_CAPABILITY_MAVLINK2 0x00002000
+#define MAV_PROTOCOL_CAPABILITY_PARAM_ENCODE_C_CAST 0x00020000
+// MAV_CMD
+#define MAV_CMD_REQUEST_MESSAGE 512
+#define MAV_CMD_REQUEST_AUTOPILOT_CAPABILITIES 520
+// MAV_RESULT
+#define MAV_RESULT_ACCEPTED 0
+#define MAV_RESULT_UNSUPPORTED 3
+
+static constexpr ConfigDescriptor mavSystemIdDescriptor = ConfigDescriptor::fromInt("mav.sysid", "MAVLink system id of this vehicle", 1, 1, 255);
+static constexpr ConfigDescriptor mavHeartbeatHzDescriptor = ConfigDescriptor::fromInt("mav.heartbeatHz", "HEARTBEAT rate in Hz, 0 to stop", 1, 0, 50);
+static constexpr ConfigDescriptor mavStatusHzDescriptor = ConfigDescriptor::fromInt("mav.statusHz", "SYS_STATUS rate in Hz, 0 to stop", 1, 0, 50);
+static constexpr ConfigDescriptor mavAttitudeHzDescriptor = ConfigDescriptor::fromInt("mav.attitudeHz", "ATTITUDE_QUATERNION rate in Hz, 0 to stop", 10, 0, 50);
+static constexpr ConfigDescriptor mavRcHzDescriptor = ConfigDescriptor::fromInt("mav.rcHz", "RC_CHANNELS rate in Hz, 0 to stop", 5, 0, 50);
+static constexpr ConfigDescriptor mavServoHzDescriptor = ConfigDescriptor::fromInt("mav.servoHz", "SERVO_OUTPUT_RAW rate in Hz, 0 to stop", 5, 0, 50);
+ConfigValue mavSystemId(mavSystemIdDescriptor);
+ConfigValue mavHeartbeatHz(mavHeartbeatHzDescriptor);
+ConfigValue mavStatusHz(mavStatusHzDescriptor);
+ConfigValue mavAttitudeHz(mavAttitudeHzDescriptor);
+ConfigValue mavRcHz(mavRcHzDescriptor);
+ConfigValue mavServoHz(mavServoHzDescriptor);
+
+typedef size_t (*StreamEncode)(uint8_t *frame);
+
+struct MessageStream {
+    ConfigValue &hz;
+    StreamEncode encode;
+    uint32_t nextMicros;
+};
+
+static MavLinkTransport *transport = nullptr;
+static MavLinkEncoder encoder(1, MAVLINK_COMPONENT_AUTOPILOT);
+static MavLinkParser parser;
+static uint8_t frame[MAVLINK_FRAME_MAX];
+static uint8_t datagram[MAVLINK_DATAGRAM_MAX];
+static uint16_t paramCount = 0;
+// Next parameter to send for PARAM_REQUEST_LIST, nullptr when not listing
+static const ConfigValue *paramListNext = nullptr;
+static uint16_t paramListIndex = 0;
+
+void mavlinkParamId(const char *name, char (&id)[MAVLINK_PARAM_ID_LEN]) {
+    memset(id, 0, MAVLINK_PARAM_ID_LEN);
+    const size_t length = strlen(name);
+    if (length <= MAVLINK_PARAM_ID_LEN) {
+        memcpy(id, name, length);
+        return;
+    }
+    char suffix[6];
+    snprintf(suffix, sizeof(suffix), "_%04x", (unsigned)mavlinkCrc((const uint8_t *)name, length));
+    memcpy(id, name, MAVLINK_PARAM_ID_LEN - 5);
+    memcpy(id + MAVLINK_PARAM_ID_LEN - 5, suffix, 5);
+}
+
+static uint16_t toMicros(float normalized) {
+    return (uint16_t)lroundf(1000.0f + 1000.0f * std::min(std::max(normalized, 0.0f), 1.0f));
+}
+
+static bool isArmed(FlightStatus status) {
+    return status == FS_Flying || status == FS_Disarming || status == FS_DisarmingWaitingForNoInput || status == FS_Failsafe;
+}
+
+static size_t encodeHeartbeat(uint8_t *out) {
+    const State &state = getState();
+    MavLinkHeartbeat m;
+    m.customMode = (uint32_t)state.flightStatus;
+    switch (airframeConfig.numMotors.getInt()) {
+    case 3: m.type = MAV_TYPE_TRICOPTER; break;
+    case 4: m.type = MAV_TYPE_QUADROTOR; break;
+    case 6: m.type = MAV_TYPE_HEXAROTOR; break;
+    default: m.type = MAV_TYPE_GENERIC; break;
+    }
+    m.autopilot = MAV_AUTOPILOT_GENERIC;
+    m.baseMode = MAV_MODE_FLAG_CUSTOM_MODE_ENABLED | MAV_MODE_FLAG_STABILIZE_ENABLED | MAV_MODE_FLAG_MANUAL_INPUT_ENABLED;
+    if (isArmed(state.flightStatus)) {
+        m.baseMode |= MAV_MODE_FLAG_SAFETY_ARMED;
+    }
+    m.systemStatus = state.flightStatus == FS_Failsafe ? MAV_STATE_CRITICAL
+        : isArmed(state.flightStatus) ? MAV_STATE_ACTIVE : MAV_STATE_STANDBY;
+    return encoder.heartbeat(out, m);
+}
+
+static size_t encodeSysStatus(uint8_t *out) {
+    const State &state = getState();
+    TaskStats tasks[TASKS_MAX];
+    const size_t numTasks = tasksGetStats(tasks);
+    float flightCpuPercent = 0.0f;
+    for (size_t i = 0; i < numTasks; ++i) {
+        if (strcmp(tasks[i].name, "flight") == 0) {
+            flightCpuPercent = tasks[i].cpuPercent;
+        }
+    }
+
+    MavLinkSysStatus m;
+    m.sensorsPresent = MAV_SYS_STATUS_SENSOR_3D_GYRO | MAV_SYS_STATUS_SENSOR_3D_ACCEL
+        | MAV_SYS_STATUS_SENSOR_MOTOR_OUTPUTS | MAV_SYS_STATUS_SENSOR_RC_RECEIVER;
+    m.sensorsEnabled = m.sensorsPresent;
+    m.sensorsHealth = 0;
+    if (state.hasHardwareFlag(HF_MPU_OK)) {
+        m.sensorsHealth |= MAV_SYS_STATUS_SENSOR_3D_GYRO | MAV_SYS_STATUS_SENSOR_3D_ACCEL;
+    }
+    if (state.hasHardwareFlag(HF_RC_OK)) {
+        m.sensorsHealth |= MAV_SYS_STATUS_SENSOR_RC_RECEIVER;
+    }
+    if (!motorsIsCut()) {
+        m.sensorsHealth |= MAV_SYS_STATUS_SENSOR_MOTOR_OUTPUTS;
+    }
+    m.load = (uint16_t)lroundf(std::min(std::max(flightCpuPercent, 0.0f), 100.0f) * 10.0f);
+    m.voltageBattery = UINT16_MAX;
+    m.currentBattery = -1;
+    m.dropRateComm = 0;
+    const uint32_t crcErrors = parser.getStats().crcErrors;
+    m.errorsComm = crcErrors > UINT16_MAX ? UINT16_MAX : (uint16_t)crcErrors;
+    m.batteryRemaining = -1;
+    return encoder.sysStatus(out, m);
+}
+
+static size_t encodeAttitude(uint8_t *out) {
+    const State &state = getState();
+    const Quaternion &q = state.orientation;
+    MavLinkAttitudeQuaternion m;
+    m.timeBootMillis = millis();
+    m.q1 = q.w;
+    m.q2 = q.x;
+    m.q3 = q.y;
+    m.q4 = q.z;
+    m.rollSpeed = state.rates.y;
+    m.pitchSpeed = state.rates.x;
+    m.yawSpeed = state.rates.z;
+    return encoder.attitudeQuaternion(out, m);
+}
+
+static size_t encodeRCChannels(uint8_t *out) {
+    const State &state = getState();
+    MavLinkRCChannels m;
+    m.timeBootMillis = millis();
+    for (uint16_t &channel : m.channels) {
+        channel = UINT16_MAX;
+    }
+    m.rssi = UINT8_MAX;
+    m.channelCount = 0;
+    if (state.hasHardwareFlag(HF_RC_OK)) {
+        // Sticks back in SBUS order: roll, pitch, throttle, yaw
+        m.channels[0] = toMicros(0.5f + 0.5f * state.rcRollRadians / rcGetRollMaxRadians());
+        m.channels[1] = toMicros(0.5f + 0.5f * state.rcPitchRadians / rcGetPitchMaxRadians());
+        m.channels[2] = toMicros(state.rcThrottle);
+        m.channels[3] = toMicros(0.5f + 0.5f * state.rcYaw);
+        m.channelCount = 4;
+    }
+    return encoder.rcChannels(out, m);
+}
+
+static size_t encodeServoOutput(uint8_t *out) {
+    const State &state = getState();
+    const float commands[] = {
+        state.motor1Command, state.motor2Command, state.motor3Command,
+        state.motor4Command, state.motor5Command, state.motor6Command,
+    };
+    MavLinkServoOutputRaw m;
+    m.timeMicros = micros();
+    for (size_t i = 0; i < MAVLINK_SERVO_OUTPUTS; ++i) {
+        m.servos[i] = i < sizeof(commands) / sizeof(commands[0]) ? toMicros(commands[i]) : 0;
+    }
+    m.port = 0;
+    return encoder.servoOutputRaw(out, m);
+}
+
+static MessageStream streams[] = {
+    { mavHeartbeatHz, encodeHeartbeat, 0 },
+    { mavStatusHz, encodeSysStatus, 0 },
+    { mavAttitudeHz, encodeAttitude, 0 },
+    { mavRcHz, encodeRCChannels, 0 },
+    { mavServoHz, encodeServoOutput, 0 },
+};
+
+static void sendParam(const ConfigValue &value, uint16_t index) {
+    MavLinkParamValue m;
+    mavlinkParamId(value.getName(), m.id);
+    if (value.isInt()) {
+        m.value = (float)value.getInt();
+        m.type = MPT_Int32;
+    }
+    else {
+        m.value = value.getFloat();
+        m.type = MPT_Real32;
+    }
+    m.count = paramCount;
+    m.index = index;
+    transport->send(frame, encoder.paramValue(frame, m));
+}
+
+// Parameter ids from the ground station may fill all 16 bytes unterminated
+static const ConfigValue *findParam(const char (&id)[MAVLINK_PARAM_ID_LEN], uint16_t &index) {
+    index = 0;
+    for (const ConfigValue *value = configValuesFirst(); value != nullptr; value = value->getNext(), ++index) {
+        char valueId[MAVLINK_PARAM_ID_LEN];
+        mavlinkParamId(value->getName(), valueId);
+        if (memcmp(valueId, id, MAVLINK_PARAM_ID_LEN) == 0) {
+            return value;
+        }
+    }
+    return nullptr;
+}
+
+static const ConfigValue *paramAt(int index) {
+    const ConfigValue *value = configValuesFirst();
+    for (int i = 0; value != nullptr && i < index; ++i) {
+        value = value->getNext();
+    }
+    return index >= 0 ? value : nullptr;
+}
+
+static bool isForUs(uint8_t targetSystem) {
+    return targetSystem == 0 || targetSystem == (uint8_t)mavSystemId.getInt();
+}
+
+// Ground stations read the parameter encoding from here; without the C_CAST
+// bit they would take the int parameters' floats as bytewise copies
+static void sendAutopilotVersion() {
+    MavLinkAutopilotVersion m;
+    m.capabilities = MAV_PROTOCOL_CAPABILITY_MAVLINK2 | MAV_PROTOCOL_CAPABILITY_PARAM_ENCODE_C_CAST;
+    m.uid = 0;
+    m.flightSwVersion = 0;
+    m.vendorId = 0;
+    m.productId = 0;
+    transport->send(frame, encoder.autopilotVersion(frame, m));
+}
+
+static void handleCommand(const MavLinkMessage &message, const MavLinkCommandLong &command) {
+    bool accepted = false;
+    switch (command.command) {
+    case MAV_CMD_REQUEST_AUTOPILOT_CAPABILITIES:
+        accepted = true;
+        break;
+    case MAV_CMD_REQUEST_MESSAGE:
+        accepted = lroundf(command.params[0]) == MM_AutopilotVersion;
+        break;
+    default:
+        break;
+    }
+    MavLinkCommandAck ack;
+    ack.command = command.command;
+    ack.result = accepted ? MAV_RESULT_ACCEPTED : MAV_RESULT_UNSUPPORTED;
+    ack.targetSystem = message.systemId;
+    ack.targetComponent = message.componentId;
+    transport->send(frame, encoder.commandAck(frame, ack));
+    if (accepted) {
+        sendAutopilotVersion();
+    }
+}
+
+static void handleMessage(const MavLinkMessage &message) {
+    switch (message.id) {
+    case MM_ParamRequestList: {
+        MavLinkParamRequestList request;
+        if (mavlinkDecodeParamRequestList(message, request) && isForUs(request.targetSystem)) {
+            paramListNext = configValuesFirst();
+            paramListIndex = 0;
+        }
+        break;
+    }
+    case MM_ParamRequestRead: {
+        MavLinkParamRequestRead request;
+        if (!mavlinkDecodeParamRequestRead(message, request) || !isForUs(request.targetSystem)) {
+            break;
+        }
+        uint16_t index = (uint16_t)request.index;
+        const ConfigValue *value = request.index >= 0 ? paramAt(request.index) : findParam(request.id, index);
+        if (value != nullptr) {
+            sendParam(*value, index);
+        }
+        break;
+    }
+    case MM_CommandLong: {
+        MavLinkCommandLong command;
+        if (mavlinkDecodeCommandLong(message, command) && isForUs(command.targetSystem)
+            && (command.targetComponent == 0 || command.targetComponent == MAVLINK_COMPONENT_AUTOPILOT)) {
+            handleCommand(message, command);
+        }
+        break;
+    }
+    case MM_ParamSet: {
+        MavLinkParamSet request;
+        if (!mavlinkDecodeParamSet(message, request) || !isForUs(request.targetSystem)) {
+            break;
+        }
+        uint16_t index;
+        const ConfigValue *value = findParam(request.id, index);
+        if (value == nullptr || !std::isfinite(request.value)) {
+            break;
+        }
+        const Value newValue = value->isInt()
+            ? Value::fromInt((int32_t)lroundf(request.value))
+            : Value::fromFloat(request.value);
+        configValueSet(value->getName(), newValue);
+        // Echoes the value as stored, after clamping
+        sendParam(*value, index);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void mavlinkBegin(MavLinkTransport &t) {
+    transport = &t;
+    paramCount = (uint16_t)configValuesCount();
+    ESP_LOGI("MAVLink", "MAVLink system %d, %u parameters", (int)mavSystemId.getInt(), (unsigned)paramCount);
+}
+
+void mavlinkPoll(uint32_t nowMicros) {
+    if (transport == nullptr) {
+        return;
+    }
+    encoder.setSystemId((uint8_t)mavSystemId.getInt());
+
+    size_t length;
+    while ((length = transport->receive(datagram, sizeof(datagram))) > 0) {
+        for (size_t i = 0; i < length; ++i) {
+            if (parser.push(datagram[i])) {
+                handleMessage(parser.message());
+            }
+        }
+    }
+
+    for (size_t i = 0; i < MAVLINK_PARAMS_PER_POLL && paramListNext != nullptr; ++i) {
+        sendParam(*paramListNext, paramListIndex++);
+        paramListNext = paramListNext->getNext();
+    }
+
+    for (MessageStream &stream : streams) {
+        const int32_t hz = stream.hz.getInt();
+        if (hz <= 0 || (int32_t)(nowMicros - stream.nextMicros) < 0) {
+            continue;
+        }
+        transport->send(frame, stream.encode(frame));
+        const uint32_t intervalMicros = 1000000u / (uint32_t)hz;
+        stream.nextMicros += intervalMicros;
+        // Restart from now after a stall or a rate change rather than bursting
+        if ((int32_t)(nowMicros - stream.nextMicros) >= 0 || (int32_t)(stream.nextMicros - nowMicros) > (int32_t)intervalMicros) {
+            stream.nextMicros = nowMicros + intervalMicros;
+        }
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "MavLink.h"
+
+// MAVLink for ground stations: HEARTBEAT, SYS_STATUS, ATTITUDE_QUATERNION,
+// RC_CHANNELS and SERVO_OUTPUT_RAW streamed at the mav.*Hz rates, and the
+// config values served as parameters. Runs on the network task over any
+// datagram transport.
+//
+// Parameter ids are config names, or for names longer than 16 characters
+// the first 11, '_' and four hex digits of the name's CRC. Ints travel as
+// C-cast floats, as AUTOPILOT_VERSION declares with
+// MAV_PROTOCOL_CAPABILITY_PARAM_ENCODE_C_CAST. It is sent on
+// MAV_CMD_REQUEST_AUTOPILOT_CAPABILITIES or MAV_CMD_REQUEST_MESSAGE; other
+// commands are acknowledged as unsupported.
+
+// Parameters sent per poll while answering PARAM_REQUEST_LIST
+#define MAVLINK_PARAMS_PER_POLL 8
+#define MAVLINK_DATAGRAM_MAX 512
+
+class MavLinkTransport {
+public:
+    virtual ~MavLinkTransport() {}
+    // Copies the next waiting datagram into buffer, returns 0 if there is none
+    virtual size_t receive(uint8_t *buffer, size_t size) = 0;
+    virtual void send(const uint8_t *frame, size_t length) = 0;
+};
+
+void mavlinkBegin(MavLinkTransport &transport);
+// Network task: handles received messages and sends whatever is due
+void mavlinkPoll(uint32_t nowMicros);
+
+// Writes the parameter id of a config name, zero-padded
+void mavlinkParamId(const char *name, char (&id)[MAVLINK_PARAM_ID_LEN]);
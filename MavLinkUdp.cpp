@@ -0,0 +1,45 @@
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+#include "ConfigValue.h"
+#include "MavLinkService.h"
+#include "MavLinkUdp.h"
+
+static constexpr ConfigDescriptor mavPortDescriptor = ConfigDescriptor::fromInt("mav.port", "UDP port for MAVLink, both ends; takes effect after a reboot", 14550, 1, 65535);
+ConfigValue mavPort(mavPortDescriptor);
+
+class UdpTransport : public MavLinkTransport {
+    WiFiUDP udp;
+    IPAddress remoteIP;
+    uint16_t remotePort;
+public:
+    UdpTransport() : remoteIP(255, 255, 255, 255), remotePort(0) {}
+
+    void begin(uint16_t port) {
+        remotePort = port;
+        udp.begin(port);
+    }
+    size_t receive(uint8_t *buffer, size_t size) override {
+        const int length = udp.parsePacket();
+        if (length <= 0) {
+            return 0;
+        }
+        remoteIP = udp.remoteIP();
+        remotePort = udp.remotePort();
+        // A datagram larger than the buffer is cut short; the parser drops it
+        return (size_t)udp.read(buffer, size);
+    }
+    void send(const uint8_t *frame, size_t length) override {
+        udp.beginPacket(remoteIP, remotePort);
+        udp.write(frame, length);
+        udp.endPacket();
+    }
+};
+
+static UdpTransport transport;
+
+void mavlinkUdpBegin() {
+    transport.begin((uint16_t)mavPort.getInt());
+    mavlinkBegin(transport);
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+// MAVLink over WiFi UDP on mav.port. Frames go to whoever sent the last
+// datagram, or are broadcast until a ground station is heard.
+void mavlinkUdpBegin();
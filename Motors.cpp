@@ -5,29 +5,38 @@
 #include <cmath>
 #include <algorithm>
 #include <Arduino.h>
+#include <EEPROM.h>
+#include <atomic>
 
 #include "Motors.h"
 #include "Config.h" // For MotorConfig
+#include "DeferredLog.h"
+#include "Latency.h"
+#include "RadioController.h"
 #include "State.h"
 
 static const uint32_t pwmFrequency = 50;
 
+static_assert(AIRFRAME_MAX_MOTORS <= MAX_MOTORS, "the mixer must have a row for every airframe motor");
+
 void MotorMixer::updateMotorMix() {
-    const auto motors = airframeConfig.getMotorConfigs();
-    numMotors = motors.size();
+    MotorConfig *motors[AIRFRAME_MAX_MOTORS];
+    numMotors = airframeConfig.getMotorConfigs(motors);
     // Build mixer matrix
     float maxX = 0, maxY = 0;
-    for (const auto m : motors) {
+    for (size_t i = 0; i < numMotors; ++i) {
+        const MotorConfig *m = motors[i];
         if (std::abs(m->x.getFloat()) > maxX) maxX = std::abs(m->x.getFloat());
         if (std::abs(m->y.getFloat()) > maxY) maxY = std::abs(m->y.getFloat());
     }
     if (maxX < 1.0f) maxX = 1.0f; // Prevent division by zero
     if (maxY < 1.0f) maxY = 1.0f; // Prevent division by zero
+    mixerMatrix = Matrix<float, MAX_MOTORS, 4>::zero();
     for (size_t i = 0; i < numMotors; ++i) {
-        mixerMatrix[i].thrust = 1.0f; // All motors contribute equally to thrust
-        mixerMatrix[i].pitch  = motors[i]->y.getFloat() / maxY; // Pitch: y offset (rotation about X)
-        mixerMatrix[i].roll   = -motors[i]->x.getFloat() / maxX; // Roll: x offset (rotation about Y)
-        mixerMatrix[i].yaw    = motors[i]->direction.getInt() < 0 ? -1.0f : 1.0f; // Yaw: motor direction
+        mixerMatrix(i, MA_Thrust) = 1.0f; // All motors contribute equally to thrust
+        mixerMatrix(i, MA_Pitch)  = motors[i]->y.getFloat() / maxY; // Pitch: y offset (rotation about X)
+        mixerMatrix(i, MA_Roll)   = -motors[i]->x.getFloat() / maxX; // Roll: x offset (rotation about Y)
+        mixerMatrix(i, MA_Yaw)    = motors[i]->direction.getInt() < 0 ? -1.0f : 1.0f; // Yaw: motor direction
     }
 }
 
@@ -36,12 +45,14 @@ void MotorMixer::updateMotorMix() {
 void MotorMixer::mix(const MixValues& mixValues) {
     float maxOut = 0.0f;
     if (mixValues.thrust > minimumCommand) {
+        // Only the rows of motors present; a full matrix product would
+        // also compute the zeroed ones
         for (size_t i = 0; i < numMotors; ++i) {
             float newOutput = 0.0f;
-            newOutput += mixerMatrix[i].thrust * mixValues.thrust;
-            newOutput += mixerMatrix[i].pitch  * mixValues.pitch;
-            newOutput += mixerMatrix[i].roll   * mixValues.roll;
-            newOutput += mixerMatrix[i].yaw    * mixValues.yaw;
+            newOutput += mixerMatrix(i, MA_Thrust) * mixValues.thrust;
+            newOutput += mixerMatrix(i, MA_Pitch)  * mixValues.pitch;
+            newOutput += mixerMatrix(i, MA_Roll)   * mixValues.roll;
+            newOutput += mixerMatrix(i, MA_Yaw)    * mixValues.yaw;
             if (newOutput < minimumCommand) newOutput = minimumCommand;
             if (newOutput > maxOut) maxOut = newOutput;
             outputs[i] = newOutput;
@@ -73,7 +84,7 @@ static void hwSetSpeed(uint8_t pin, float speed, bool print) {
     else if (dutyCycle > 1.0f) dutyCycle = 1.0f;
     const uint16_t pwm = int(dutyCycle * 4095.0f + 0.5f);
     if (print) {
-        ESP_LOGI("Motors", "Set pin %2d to speed=%6.3f, pulse width=%5.3f ms (pwm=%4d)", pin, speed, pulseWidth * 1000.0f, pwm);
+        DLOG_I("Motors", "Set pin %2d to speed=%6.3f, pulse width=%5.3f ms (pwm=%4d)", pin, speed, pulseWidth * 1000.0f, pwm);
     }
     ledcWrite(pin, pwm);
 }
@@ -95,11 +106,16 @@ void motorsSetup() {
 }
 
 static unsigned long lastPrintMillis = 0;
+static std::atomic<bool> motorsCutLatched(false);
 
-void motorsSendCommands(float motor1, float motor2, float motor3, float motor4, float motor5, float motor6) {
+static void writeOutputs(float motor1, float motor2, float motor3, float motor4, float motor5, float motor6) {
     const auto now = millis();
     bool shouldPrint = false;
 
+    if (motorsCutLatched.load(std::memory_order_relaxed)) {
+        motor1 = motor2 = motor3 = motor4 = motor5 = motor6 = 0.0f;
+    }
+
     hwSetSpeed(2, motor1, shouldPrint);
     hwSetSpeed(4, motor2, shouldPrint);
     hwSetSpeed(12, motor3, shouldPrint);
@@ -108,3 +124,88 @@ void motorsSendCommands(float motor1, float motor2, float motor3, float motor4,
     hwSetSpeed(15, motor6, shouldPrint);
     stateUpdateMotorCommands(motor1, motor2, motor3, motor4, motor5, motor6);
 }
+
+void motorsSendCommands(float motor1, float motor2, float motor3, float motor4, float motor5, float motor6) {
+    latencyMark(LM_Commanded);
+    writeOutputs(motor1, motor2, motor3, motor4, motor5, motor6);
+    latencyMark(LM_Output);
+}
+
+uint32_t motorsGetPwmPeriodMicros() {
+    return 1000000 / pwmFrequency;
+}
+
+void motorsCut() {
+    motorsCutLatched = true;
+    // Written here as well because the flight task may never run again
+    writeOutputs(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+}
+
+void motorsClearCut() {
+    motorsCutLatched = false;
+}
+
+bool motorsIsCut() {
+    return motorsCutLatched.load(std::memory_order_relaxed);
+}
+
+//
+// ESC calibration. Holding full throttle across two power cycles passes the
+// throttle straight through to the ESCs on the third boot. The mode lives
+// in EEPROM, so this runs on the persistence task; the flight task only
+// reads the atomic flag.
+//
+
+enum CalMotorsMode {
+    CMM_NotCalibrating = 0,
+    CMM_CalibrationRequested = 1,
+    CMM_CalibrationInProgress = 2
+};
+
+static uint8_t calMotorsMode = CMM_NotCalibrating;
+static bool calMotorsModeDetermined = false;
+static std::atomic<bool> calMotorsInProgress(false);
+static unsigned long lastCalMotorsPrintMillis = 0;
+
+void motorsCalibrationUpdate() {
+    if (!calMotorsModeDetermined && rcDidReceiveData()) {
+        calMotorsModeDetermined = true;
+        EEPROM.get(0, calMotorsMode);
+        const bool throttleHigh = rcGetInitialThrottle() > 0.98f;
+        switch (calMotorsMode) {
+        case CMM_NotCalibrating:
+            if (throttleHigh) {
+                calMotorsMode = CMM_CalibrationRequested;
+                EEPROM.put(0, calMotorsMode);
+                EEPROM.commit();
+                Serial.println("Motor calibration requested. Please disconnect power and reconnect.");
+            }
+            break;
+        case CMM_CalibrationRequested:
+            if (throttleHigh) {
+                calMotorsMode = CMM_CalibrationInProgress;
+                EEPROM.put(0, calMotorsMode);
+                EEPROM.commit();
+                Serial.println("Motor calibration in progress. Decrease throttle after ESCs are calibrated.");
+            }
+            break;
+        default:
+            // Calibration is actually complete, reset back to not calibrating
+            calMotorsMode = CMM_NotCalibrating;
+            EEPROM.put(0, calMotorsMode);
+            EEPROM.commit();
+            Serial.println("Motor calibration complete.");
+            break;
+        }
+        calMotorsInProgress = calMotorsMode == CMM_CalibrationInProgress;
+    }
+    const auto now = millis();
+    if (calMotorsModeDetermined && (calMotorsMode != CMM_NotCalibrating) && (now - lastCalMotorsPrintMillis > 1000)) {
+        lastCalMotorsPrintMillis = now;
+        Serial.printf("Motor calibration mode: %d\n", calMotorsMode);
+    }
+}
+
+bool motorsCalibrationInProgress() {
+    return calMotorsInProgress.load(std::memory_order_relaxed);
+}
@@ -2,8 +2,18 @@
 
 #include <cstring>
 
+#include "Matrix.h"
+
 #define MAX_MOTORS 6
 
+// Columns of the mixer matrix
+enum MixAxis {
+    MA_Thrust = 0,
+    MA_Pitch = 1,
+    MA_Roll = 2,
+    MA_Yaw = 3,
+};
+
 struct MixValues {
     float thrust;
     float pitch;
@@ -17,13 +27,13 @@ class MotorMixer {
 private:
     size_t numMotors;
     float minimumCommand;
-    MixValues mixerMatrix[MAX_MOTORS];
+    Matrix<float, MAX_MOTORS, 4> mixerMatrix;
     float outputs[MAX_MOTORS];
 public:
     MotorMixer()
         : numMotors(0)
-        , minimumCommand(0.07f) {
-        std::memset(mixerMatrix, 0, sizeof(mixerMatrix));
+        , minimumCommand(0.07f)
+        , mixerMatrix(Matrix<float, MAX_MOTORS, 4>::zero()) {
         std::memset(outputs, 0, sizeof(outputs));
     }
     size_t getNumMotors() const {
@@ -40,4 +50,18 @@ public:
 };
 
 void motorsSetup();
+// Flight task
 void motorsSendCommands(float motor1, float motor2, float motor3, float motor4, float motor5, float motor6);
+// A new duty cycle reaches the ESC at the start of the next PWM period
+uint32_t motorsGetPwmPeriodMicros();
+
+// Persistence task: reads and advances the ESC calibration mode in EEPROM
+void motorsCalibrationUpdate();
+// While true the throttle goes straight to every ESC instead of the mixer
+bool motorsCalibrationInProgress();
+
+// Watchdog: zeroes every output and keeps them at zero, whatever
+// motorsSendCommands is asked for, until motorsClearCut
+void motorsCut();
+void motorsClearCut();
+bool motorsIsCut();
@@ -1,52 +1,300 @@
 #include "OTA.h"
 #include <Arduino.h>
-#include <ArduinoOTA.h>
-
-void otaSetup(const char *hostName) {
-    // Port defaults to 3232
-    ArduinoOTA.setPort(3232);
-    ArduinoOTA.setHostname(hostName);
-    ArduinoOTA.setPassword("admin");
-
-    // Password can be set with it's md5 value as well
-    // MD5(admin) = 21232f297a57a5a743894a0e4a801fc3
-    // ArduinoOTA.setPasswordHash("21232f297a57a5a743894a0e4a801fc3");
-
-    ArduinoOTA
-        .onStart([]() {
-            String type;
-            if (ArduinoOTA.getCommand() == U_FLASH) {
-                type = "sketch";
-            } else { // U_SPIFFS
-                type = "filesystem";
-            }
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <esp_ota_ops.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/stream_buffer.h>
+#include <mbedtls/pk.h>
+#include <mbedtls/sha256.h>
+
+#include "State.h"
+
+#if __has_include("FirmwareKey.h")
+#include "FirmwareKey.h"
+#endif
+
+static const char *const stateNames[] = {
+    "idle",
+    "receiving",
+    "verifying",
+    "succeeded",
+    "failed",
+};
+static_assert(sizeof(stateNames) / sizeof(stateNames[0]) == OS_Failed + 1, "stateNames must be indexed by OtaState");
+
+static StreamBufferHandle_t buffer = nullptr;
+static std::atomic<OtaState> state(OS_Idle);
+static std::atomic<const char *> error(nullptr);
+static std::atomic<uint32_t> size(0);
+static std::atomic<uint32_t> received(0);
+static std::atomic<uint32_t> written(0);
+static std::atomic<uint32_t> lastDataMillis(0);
+
+// Set by otaStart before the state moves to receiving
+static uint8_t expectedSha256[32];
+static uint8_t signature[OTA_SIGNATURE_MAX];
+static size_t signatureLength = 0;
+
+// Persistence task only, but for opened, which otaStart checks
+static const esp_partition_t *partition = nullptr;
+static esp_ota_handle_t handle = 0;
+static std::atomic<bool> opened(false);
+static mbedtls_sha256_context sha256;
+static uint8_t chunk[OTA_WRITE_CHUNK];
+static uint32_t succeededMillis = 0;
 
-            // NOTE: if updating SPIFFS this would be the place to unmount
-            // SPIFFS using SPIFFS.end()
-            Serial.println("Start updating " + type);
-        })
-        .onEnd([]() { Serial.println("\nEnd"); })
-        .onProgress([](unsigned int progress, unsigned int total) {
-            Serial.printf("Progress: %u%%\r", (progress / (total / 100)));
-        })
-        .onError([](ota_error_t error) {
-            Serial.printf("Error[%u]: ", error);
-            if (error == OTA_AUTH_ERROR) {
-                Serial.println("Auth Failed");
-            } else if (error == OTA_BEGIN_ERROR) {
-                Serial.println("Begin Failed");
-            } else if (error == OTA_CONNECT_ERROR) {
-                Serial.println("Connect Failed");
-            } else if (error == OTA_RECEIVE_ERROR) {
-                Serial.println("Receive Failed");
-            } else if (error == OTA_END_ERROR) {
-                Serial.println("End Failed");
+static size_t parseHex(const char *hex, uint8_t *out, size_t maxLength) {
+    const size_t length = strlen(hex);
+    if (length % 2 != 0 || length / 2 > maxLength) {
+        return 0;
+    }
+    for (size_t i = 0; i < length / 2; ++i) {
+        uint8_t byte = 0;
+        for (size_t j = 0; j < 2; ++j) {
+            const char c = hex[i * 2 + j];
+            byte <<= 4;
+            if (c >= '0' && c <= '9') {
+                byte |= c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                byte |= c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                byte |= c - 'A' + 10;
+            } else {
+                return 0;
             }
-        });
+        }
+        out[i] = byte;
+    }
+    return length / 2;
+}
+
+// Any task; the first reason sticks. otaLoop closes the partition.
+static void fail(const char *reason) {
+    const char *none = nullptr;
+    if (error.compare_exchange_strong(none, reason)) {
+        ESP_LOGE("OTA", "Firmware update failed: %s", reason);
+    }
+    state.store(OS_Failed);
+}
+
+static void closePartition() {
+    if (opened.load()) {
+        esp_ota_abort(handle);
+        mbedtls_sha256_free(&sha256);
+        opened.store(false);
+    }
+}
+
+void otaBegin() {
+    buffer = xStreamBufferCreate(OTA_BUFFER_SIZE, 1);
+    const esp_partition_t *next = esp_ota_get_next_update_partition(nullptr);
+#ifdef FIRMWARE_PUBLIC_KEY_PEM
+    ESP_LOGI("OTA", "Updates go to %s, signed", next ? next->label : "(none)");
+#else
+    ESP_LOGW("OTA", "Updates go to %s; no FirmwareKey.h, so only the SHA-256 is checked", next ? next->label : "(none)");
+#endif
+}
 
-    ArduinoOTA.begin();
+bool otaStart(size_t imageSize, const char *sha256Hex, const char *signatureHex, const char *&reason) {
+    if (getState().flightStatus != FS_Disarmed) {
+        reason = "not disarmed";
+        return false;
+    }
+    const OtaState current = state.load();
+    if (current == OS_Receiving || current == OS_Verifying || current == OS_Succeeded) {
+        reason = "an update is already running";
+        return false;
+    }
+    if (imageSize == 0) {
+        reason = "empty image";
+        return false;
+    }
+    if (sha256Hex == nullptr || parseHex(sha256Hex, expectedSha256, sizeof(expectedSha256)) != sizeof(expectedSha256)) {
+        reason = "missing or malformed SHA-256";
+        return false;
+    }
+#ifdef FIRMWARE_PUBLIC_KEY_PEM
+    signatureLength = signatureHex ? parseHex(signatureHex, signature, sizeof(signature)) : 0;
+    if (signatureLength == 0) {
+        reason = "missing or malformed signature";
+        return false;
+    }
+#else
+    (void)signatureHex;
+    signatureLength = 0;
+#endif
+    // Fails while the last upload's writer or feeder is still winding down
+    if (opened.load() || xStreamBufferReset(buffer) != pdPASS) {
+        reason = "the last update is still closing";
+        return false;
+    }
+    size.store((uint32_t)imageSize);
+    received.store(0);
+    written.store(0);
+    lastDataMillis.store(millis());
+    error.store(nullptr);
+    state.store(OS_Receiving);
+    ESP_LOGI("OTA", "Firmware update started, %u bytes", (unsigned)imageSize);
+    return true;
+}
+
+bool otaFeed(const uint8_t *data, size_t length) {
+    if (state.load() != OS_Receiving) {
+        return false;
+    }
+    if (received.load() + length > size.load()) {
+        fail("more data than announced");
+        return false;
+    }
+    // AsyncTCP cannot be told to hold off, so a writer that makes no room
+    // within the budget fails the upload rather than stalling the web task
+    const uint32_t start = millis();
+    while (length > 0) {
+        const uint32_t waited = millis() - start;
+        if (waited >= OTA_FEED_WAIT_MILLIS) {
+            fail("flash writer stalled");
+            return false;
+        }
+        const uint32_t wait = std::min<uint32_t>(OTA_FEED_WAIT_MILLIS - waited, OTA_FEED_POLL_MILLIS);
+        const size_t sent = xStreamBufferSend(buffer, data, length, pdMS_TO_TICKS(wait));
+        data += sent;
+        length -= sent;
+        received.fetch_add((uint32_t)sent);
+        if (sent > 0) {
+            lastDataMillis.store(millis());
+        }
+        if (state.load() != OS_Receiving) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool verifySignature(const uint8_t *digest) {
+#ifdef FIRMWARE_PUBLIC_KEY_PEM
+    static const char publicKey[] = FIRMWARE_PUBLIC_KEY_PEM;
+    mbedtls_pk_context pk;
+    mbedtls_pk_init(&pk);
+    bool ok = mbedtls_pk_parse_public_key(&pk, (const unsigned char *)publicKey, sizeof(publicKey)) == 0
+        && mbedtls_pk_verify(&pk, MBEDTLS_MD_SHA256, digest, 32, signature, signatureLength) == 0;
+    mbedtls_pk_free(&pk);
+    return ok;
+#else
+    (void)digest;
+    return true;
+#endif
+}
+
+static void receive() {
+    if (getState().flightStatus != FS_Disarmed) {
+        fail("armed during the update");
+        return;
+    }
+    if (!opened.load()) {
+        partition = esp_ota_get_next_update_partition(nullptr);
+        if (partition == nullptr || size.load() > partition->size) {
+            fail("image does not fit the OTA partition");
+            return;
+        }
+        // Sequential writes erase each sector as it is reached rather than
+        // the whole partition up front
+        if (esp_ota_begin(partition, OTA_WITH_SEQUENTIAL_WRITES, &handle) != ESP_OK) {
+            fail("could not open the OTA partition");
+            return;
+        }
+        mbedtls_sha256_init(&sha256);
+        mbedtls_sha256_starts(&sha256, 0);
+        opened.store(true);
+    }
+    const size_t length = xStreamBufferReceive(buffer, chunk, sizeof(chunk), 0);
+    if (length > 0) {
+        mbedtls_sha256_update(&sha256, chunk, length);
+        if (esp_ota_write(handle, chunk, length) != ESP_OK) {
+            fail("flash write failed");
+            return;
+        }
+        written.fetch_add((uint32_t)length);
+    }
+    else if (millis() - lastDataMillis.load() > OTA_STALL_MILLIS) {
+        fail("upload stalled");
+        return;
+    }
+    // Unless the upload failed meanwhile
+    OtaState expected = OS_Receiving;
+    if (written.load() == size.load()) {
+        state.compare_exchange_strong(expected, OS_Verifying);
+    }
+}
+
+static void verify() {
+    uint8_t digest[32];
+    mbedtls_sha256_finish(&sha256, digest);
+    mbedtls_sha256_free(&sha256);
+    if (memcmp(digest, expectedSha256, sizeof(digest)) != 0) {
+        fail("SHA-256 mismatch");
+        return;
+    }
+    if (!verifySignature(digest)) {
+        fail("bad signature");
+        return;
+    }
+    // Checks the image header and its own checksum, and frees the handle
+    opened.store(false);
+    if (esp_ota_end(handle) != ESP_OK) {
+        fail("invalid image");
+        return;
+    }
+    if (getState().flightStatus != FS_Disarmed) {
+        fail("armed during the update");
+        return;
+    }
+    if (esp_ota_set_boot_partition(partition) != ESP_OK) {
+        fail("could not switch partitions");
+        return;
+    }
+    ESP_LOGI("OTA", "Firmware verified, booting %s", partition->label);
+    succeededMillis = millis();
+    OtaState expected = OS_Verifying;
+    state.compare_exchange_strong(expected, OS_Succeeded);
 }
 
 void otaLoop() {
-    ArduinoOTA.handle();
+    switch (state.load()) {
+    case OS_Receiving:
+        receive();
+        break;
+    case OS_Verifying:
+        verify();
+        break;
+    case OS_Succeeded:
+        if (millis() - succeededMillis >= OTA_RESTART_DELAY_MILLIS) {
+            esp_restart();
+        }
+        break;
+    default:
+        break;
+    }
+    // Whichever task failed the update, this one owns the partition
+    if (state.load() == OS_Failed) {
+        closePartition();
+    }
+}
+
+bool otaIsActive() {
+    const OtaState current = state.load();
+    return current == OS_Receiving || current == OS_Verifying || current == OS_Succeeded;
+}
+
+void otaGetStatus(OtaStatus &status) {
+    status.state = state.load();
+    status.size = size.load();
+    status.received = received.load();
+    status.written = written.load();
+    status.error = error.load();
+}
+
+const char *otaStateName(OtaState s) {
+    return stateNames[s];
 }
@@ -1,4 +1,68 @@
 #pragma once
 
-void otaSetup(const char *hostName);
+#include <cstddef>
+#include <cstdint>
+
+// Firmware updates, streamed over HTTP into the inactive OTA partition. The
+// web server's task feeds the upload into a bounded buffer, waiting briefly
+// while it is full; the persistence task writes it out one sector at a time,
+// hashing as it goes, and only switches partitions once the SHA-256, the
+// signature and the image itself check out. Updates are refused, and a
+// running one aborted, unless the vehicle is disarmed.
+//
+// With a FirmwareKey.h defining FIRMWARE_PUBLIC_KEY_PEM (ECDSA P-256), every
+// image must carry a signature of its SHA-256:
+//
+//     openssl dgst -sha256 -sign key.pem -out firmware.sig firmware.bin
+//
+// Without one, only the SHA-256 is checked.
+
+#define OTA_BUFFER_SIZE 16384
+// One flash sector per write
+#define OTA_WRITE_CHUNK 4096
+// Persistence task period while an update is running
+#define OTA_WRITE_INTERVAL_MILLIS 20
+// The upload fails if the writer leaves no room for one callback's data for
+// this long. Kept well under the task watchdog timeout, which watches the
+// web server's task; one sector erase can take a few hundred ms.
+#define OTA_FEED_WAIT_MILLIS 500
+// How often a waiting feed checks whether the update is still running
+#define OTA_FEED_POLL_MILLIS 50
+// Or if no data arrives for this long
+#define OTA_STALL_MILLIS 10000
+// Time for the result to reach clients before the restart
+#define OTA_RESTART_DELAY_MILLIS 1000
+#define OTA_SIGNATURE_MAX 80
+
+enum OtaState {
+    OS_Idle         = 0,
+    OS_Receiving    = 1,
+    OS_Verifying    = 2,
+    OS_Succeeded    = 3,    // Restarting into the new image
+    OS_Failed       = 4,
+};
+
+struct OtaStatus {
+    OtaState state;
+    uint32_t size;
+    uint32_t received;      // Bytes accepted from the upload
+    uint32_t written;       // Bytes written to flash
+    const char *error;      // Why it failed, nullptr otherwise
+};
+
+void otaBegin();
+
+// Web server task. Starts an update of size bytes whose SHA-256 is
+// sha256Hex; signatureHex is the DER signature, if a key is built in.
+// Returns false with a static reason if the update cannot start.
+bool otaStart(size_t size, const char *sha256Hex, const char *signatureHex, const char *&error);
+// Web server task: queues the next part of the image, waiting at most
+// OTA_FEED_WAIT_MILLIS for room. Returns false once the update has failed.
+bool otaFeed(const uint8_t *data, size_t length);
+
+// Persistence task: writes what has arrived, verifies, switches and restarts
 void otaLoop();
+bool otaIsActive();
+
+void otaGetStatus(OtaStatus &status);
+const char *otaStateName(OtaState state);
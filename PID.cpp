@@ -1,23 +1,21 @@
 #include "PID.h"
 
-PID::PID(
-    const String &name, 
-    float defaultKp, float defaultKi, float defaultKd,
-    float defaultDFilter,
-    float defaultILimit, float defaultDLimit, float defaultLimit)
-    : kp(name + ".kp", "Proportional gain", Value::fromFloat(defaultKp))
-    , ki(name + ".ki", "Integral gain", Value::fromFloat(defaultKi))
-    , kd(name + ".kd", "Derivative gain", Value::fromFloat(defaultKd))
-    , dfilter(name + ".dfilter", "Derivative term filter coefficient (0-1)", Value::fromFloat(defaultDFilter))
-    , ilimit(name + ".ilimit", "Integral windup limit", Value::fromFloat(defaultILimit))
-    , dlimit(name + ".dlimit", "Derivative term limit", Value::fromFloat(defaultDLimit))
-    , limit(name + ".limit", "Output limit", Value::fromFloat(defaultLimit))
+PID::PID(const PIDConfigDescriptors &config, FilterConfig *dtermFilterConfig)
+    : kp(config.kp)
+    , ki(config.ki)
+    , kd(config.kd)
+    , dfilter(config.dfilter)
+    , ilimit(config.ilimit)
+    , dlimit(config.dlimit)
+    , limit(config.limit)
     , errorIntegral(0.0f)
     , lastError(0.0f)
     , lastDTerm(0.0f)
     , updateCount(0)
     , lastUpdateMicros(0)
-    , lastOutput(0.0f) {
+    , lastOutput(0.0f)
+    , dtermFilterConfig(dtermFilterConfig)
+    , sampleHz(0.0f) {
 }
 
 PID::~PID() {
@@ -38,7 +36,8 @@ float PID::updateError(float error) {
     }
     lastUpdateMicros = now;
 
-    float dt = deltaMicros * 1e-6f; // Convert to seconds
+    // The nominal period keeps scheduling jitter out of the I and D terms
+    float dt = sampleHz > 0.0f ? 1.0f / sampleHz : deltaMicros * 1e-6f;
 
     // Proportional term
     float pTerm = kp.getFloat() * error;
@@ -54,6 +53,10 @@ float PID::updateError(float error) {
 
     // Derivative term with filtering and limiting
     float rawDTerm = kd.getFloat() * (error - lastError) / dt;
+    if (dtermFilterConfig && sampleHz > 0.0f) {
+        dtermFilterConfig->configure(dtermFilter, sampleHz);
+        dtermFilter.apply(&rawDTerm);
+    }
     float filterCoeff = dfilter.getFloat();
     if (filterCoeff < 0.0f) filterCoeff = 0.0f;
     if (filterCoeff > 1.0f) filterCoeff = 1.0f;
@@ -87,12 +90,8 @@ void PID::resetErrorIntegral() {
     errorIntegral = 0.0f;
 }
 
-TrackingPID::TrackingPID(
-    const String &name, 
-        float defaultKp, float defaultKi, float defaultKd,
-        float defaultDFilter,
-        float defaultILimit, float defaultDLimit, float defaultLimit)
-    : PID(name, defaultKp, defaultKi, defaultKd, defaultDFilter, defaultILimit, defaultDLimit, defaultLimit)
+TrackingPID::TrackingPID(const PIDConfigDescriptors &config)
+    : PID(config)
     , target(0.0f)
     , position(0.0f) {
 }
@@ -1,5 +1,28 @@
 #include <Arduino.h>
 #include "ConfigValue.h"
+#include "Filters.h"
+
+// Flash-resident descriptors for one PID's keys: <name>.kp, <name>.ki,
+// <name>.kd, <name>.dfilter, <name>.ilimit, <name>.dlimit and <name>.limit.
+// Declare with PID_CONFIG so the names are built by the compiler.
+struct PIDConfigDescriptors {
+    ConfigDescriptor kp;
+    ConfigDescriptor ki;
+    ConfigDescriptor kd;
+    ConfigDescriptor dfilter;
+    ConfigDescriptor ilimit;
+    ConfigDescriptor dlimit;
+    ConfigDescriptor limit;
+};
+
+#define PID_CONFIG(name, kp, ki, kd, dfilter, ilimit, dlimit, limit) PIDConfigDescriptors { \
+    ConfigDescriptor::fromFloat(name ".kp", "Proportional gain", kp), \
+    ConfigDescriptor::fromFloat(name ".ki", "Integral gain", ki), \
+    ConfigDescriptor::fromFloat(name ".kd", "Derivative gain", kd), \
+    ConfigDescriptor::fromFloat(name ".dfilter", "Derivative term filter coefficient (0-1)", dfilter, 0.0f, 1.0f), \
+    ConfigDescriptor::fromFloat(name ".ilimit", "Integral windup limit", ilimit, 0.0f), \
+    ConfigDescriptor::fromFloat(name ".dlimit", "Derivative term limit", dlimit, 0.0f), \
+    ConfigDescriptor::fromFloat(name ".limit", "Output limit", limit, 0.0f) }
 
 class PID {
     ConfigValue kp;
@@ -18,13 +41,22 @@ class PID {
 
     float lastOutput;
 
+    FilterConfig *dtermFilterConfig;
+    FilterBank<1> dtermFilter;
+    float sampleHz;
+
 public:
-    PID(const String &name,
-        float defaultKp, float defaultKi, float defaultKd,
-        float defaultDFilter,
-        float defaultILimit, float defaultDLimit, float defaultLimit);
+    // The descriptors must outlive the PID; in practice they are constexpr
+    // globals
+    PID(const PIDConfigDescriptors &config, FilterConfig *dtermFilterConfig = nullptr);
     virtual ~PID();
 
+    // Nominal update rate, used as the time step and to design the D-term
+    // filters. When unset the measured time between updates is used.
+    inline void setSampleRate(float hz) {
+        sampleHz = hz;
+    }
+
     float updateError(float error);
 
     void resetErrorIntegral();
@@ -38,11 +70,7 @@ class TrackingPID : public PID {
     float target;
     float position;
 public:
-    TrackingPID(
-        const String &name, 
-        float defaultKp, float defaultKi, float defaultKd,
-        float defaultDFilter,
-        float defaultILimit, float defaultDLimit, float defaultLimit);
+    TrackingPID(const PIDConfigDescriptors &config);
     virtual ~TrackingPID();
 
     inline float getTarget() const {
@@ -1,25 +1,53 @@
 #include <Arduino.h>
+#include <atomic>
 #include <esp_log.h>
 
 #include "RadioController.h"
 #include "State.h"
 #include "ConfigValue.h"
+#include "DeferredLog.h"
 #include "Geometry.h"
+#include "Latency.h"
+#include "Mailbox.h"
 
 HardwareSerial *serial = 0;
 
 static uint8_t packet[25] = {0};
 static uint8_t packetLen = 0;
 
-ConfigValue rcPitchMaxDegrees("rc.pitch.max", "Maximum pitch angle (degrees)", Value::fromFloat(45.0f));
-ConfigValue rcRollMaxDegrees("rc.roll.max", "Maximum roll angle (degrees)", Value::fromFloat(45.0f));
+static constexpr ConfigDescriptor rcPitchMaxDegreesDescriptor = ConfigDescriptor::fromFloat("rc.pitch.max", "Maximum pitch angle (degrees)", 45.0f, 0.0f, 90.0f);
+ConfigValue rcPitchMaxDegrees(rcPitchMaxDegreesDescriptor);
+static constexpr ConfigDescriptor rcRollMaxDegreesDescriptor = ConfigDescriptor::fromFloat("rc.roll.max", "Maximum roll angle (degrees)", 45.0f, 0.0f, 90.0f);
+ConfigValue rcRollMaxDegrees(rcRollMaxDegreesDescriptor);
+static constexpr ConfigDescriptor rcFailsafeTimeoutMillisDescriptor = ConfigDescriptor::fromInt("rc.failsafe.timeoutMs", "RC is lost when no frame with signal arrives for this long (ms)", 500, 1);
+ConfigValue rcFailsafeTimeoutMillis(rcFailsafeTimeoutMillisDescriptor);
 
-static bool didReceiveData = false;
-static float initialThrottle = 0.0f;
+// Written by the RC task, read by the persistence task
+static std::atomic<bool> didReceiveData(false);
+static std::atomic<float> initialThrottle(0.0f);
+
+// RC task -> flight task
+static LatestMailbox<RCFrame> rcMailbox;
+
+// Flight task only. Ages are in loop time so a stalled loop cannot see a
+// stale frame as fresh.
+static bool hasGoodFrame = false;
+static uint64_t lastGoodFrameLoopMicros = 0;
+static uint32_t frameAgeMicros = UINT32_MAX;
+static float lastGoodThrottle = 0.0f;
+static bool lost = true;
+
+float rcGetPitchMaxRadians() {
+    return rcPitchMaxDegrees.getFloat() * DEG_TO_RAD_F;
+}
+
+float rcGetRollMaxRadians() {
+    return rcRollMaxDegrees.getFloat() * DEG_TO_RAD_F;
+}
 
 bool rcIsArming() {
     const State &state = getState();
-    if (!state.hasHardwareFlag(HF_RC_OK)) {
+    if (lost || !state.hasHardwareFlag(HF_RC_OK)) {
         return false;
     }
     // Serial.printf("T: %.3f, Y: %.3f, P: %.3f, R: %.3f\n", state.rcThrottle, state.rcYaw, state.rcPitchDegrees(), state.rcRollDegrees());
@@ -40,7 +68,7 @@ bool rcIsArming() {
 
 bool rcIsNoInput() {
     const State &state = getState();
-    if (!state.hasHardwareFlag(HF_RC_OK)) {
+    if (lost || !state.hasHardwareFlag(HF_RC_OK)) {
         return false;
     }
     // Serial.printf("T: %.3f, Y: %.3f, P: %.3f, R: %.3f\n", state.rcThrottle, state.rcYaw, state.rcPitchDegrees(), state.rcRollDegrees());
@@ -67,6 +95,7 @@ float rcGetInitialThrottle() {
 }
 
 static void parsePacket() {
+    const uint32_t completedMicros = micros();
     bool failSafe = (packet[23] & 0x08) != 0; // True when no RC signal
     bool hasSignal = !failSafe;
     const auto ch1 = ((packet[2] & 0b00000111) << 8) | packet[1];
@@ -103,16 +132,79 @@ static void parsePacket() {
     const float pitchDegrees = (ch2f * 2.0f - 1.0f) * rcPitchMaxDegrees.getFloat();
     const float rollDegrees = (ch1f * 2.0f - 1.0f) * rcRollMaxDegrees.getFloat();
     if (hasSignal && !didReceiveData) {
-        didReceiveData = true;
         initialThrottle = thr;
-        ESP_LOGI("RadioController", "Received first RC data: initial throttle = %.3f", initialThrottle);
-    }
-    stateUpdateRC(
-        pitchDegrees * DEG_TO_RAD_F,
-        rollDegrees * DEG_TO_RAD_F,
-        yaw,
-        thr,
-        hasSignal);
+        didReceiveData = true;
+        DLOG_I("RadioController", "Received first RC data: initial throttle = %.3f", thr);
+    }
+    RCFrame frame;
+    frame.pitchRadians = pitchDegrees * DEG_TO_RAD_F;
+    frame.rollRadians = rollDegrees * DEG_TO_RAD_F;
+    frame.yaw = yaw;
+    frame.throttle = thr;
+    frame.hasSignal = hasSignal;
+    frame.micros = completedMicros;
+    rcMailbox.post(frame);
+}
+
+uint32_t rcGetFramesPosted() {
+    return rcMailbox.getPosted();
+}
+
+uint32_t rcGetFramesOverwritten() {
+    return rcMailbox.getOverwritten();
+}
+
+bool rcApplyLatestFrame(uint64_t loopMicros) {
+    RCFrame frame;
+    const bool hadGoodFrame = hasGoodFrame;
+    const bool fresh = rcMailbox.take(frame);
+    if (fresh) {
+        latencyBeginFrame(frame.micros);
+        if (frame.hasSignal) {
+            hasGoodFrame = true;
+            lastGoodFrameLoopMicros = loopMicros;
+            lastGoodThrottle = frame.throttle;
+        }
+        stateUpdateRC(
+            frame.pitchRadians,
+            frame.rollRadians,
+            frame.yaw,
+            frame.throttle,
+            frame.hasSignal);
+    }
+
+    if (hasGoodFrame) {
+        const uint64_t age = loopMicros - lastGoodFrameLoopMicros;
+        frameAgeMicros = age < UINT32_MAX ? (uint32_t)age : UINT32_MAX;
+    }
+    const int32_t timeoutMillis = rcFailsafeTimeoutMillis.getInt();
+    const bool wasLost = lost;
+    lost = !hasGoodFrame || frameAgeMicros > (uint32_t)(timeoutMillis > 0 ? timeoutMillis : 0) * 1000;
+    if (lost) {
+        // The last sticks stay in the state but must not be trusted
+        stateSetHardwareFlag(HF_RC_OK, false);
+    }
+    if (lost != wasLost && hadGoodFrame) {
+        if (lost) {
+            DLOG_W("RadioController", "RC lost, no frame with signal for %u ms", (unsigned)(frameAgeMicros / 1000));
+        }
+        else {
+            DLOG_I("RadioController", "RC regained");
+        }
+    }
+    return fresh;
+}
+
+bool rcIsLost() {
+    return lost;
+}
+
+uint32_t rcGetFrameAgeMicros() {
+    return frameAgeMicros;
+}
+
+float rcGetLastGoodThrottle() {
+    return lastGoodThrottle;
 }
 
 void rcBegin() {
@@ -130,7 +222,7 @@ void rcUpdate() {
             }
             else {
                 // Not a start byte, ignore
-                ESP_LOGE("RadioController", "Invalid start byte: 0x%02X", c);
+                DLOG_E("RadioController", "Invalid start byte: 0x%02X", c);
             }
         }
         else {
@@ -155,10 +247,10 @@ void rcUpdate() {
                         }
                     }
                     if (foundStartByte) {
-                        ESP_LOGE("RadioController", "Invalid packet, shifted to new start byte, new length: %d", packetLen);
+                        DLOG_E("RadioController", "Invalid packet, shifted to new start byte, new length: %d", packetLen);
                     }
                     else {
-                        ESP_LOGE("RadioController", "Invalid packet, no new start byte found, resetting packet");
+                        DLOG_E("RadioController", "Invalid packet, no new start byte found, resetting packet");
                         packetLen = 0;
                     }
                 }
@@ -1,12 +1,48 @@
 #pragma once
 
+#include <cstdint>
+
 #include "ConfigValue.h"
 
+struct RCFrame {
+    float pitchRadians;
+    float rollRadians;
+    float yaw;          // -1 to 1
+    float throttle;     // 0 to 1
+    bool hasSignal;
+    uint32_t micros;    // When the last byte of the frame was read
+
+    RCFrame()
+        : pitchRadians(0.0f), rollRadians(0.0f), yaw(0.0f), throttle(0.0f)
+        , hasSignal(false), micros(0) {}
+};
+
 void rcBegin();
+
+// RC task: decodes SBUS and posts complete frames
 void rcUpdate();
 
+// Flight task, once per tick: publishes the newest frame to the state, if
+// there is one, and updates the frame age. loopMicros is loop time from
+// controlLoopGetClockMicros. Returns true if a frame was applied.
+bool rcApplyLatestFrame(uint64_t loopMicros);
+
+// Flight task: no frame with signal for rc.failsafe.timeoutMs of loop time,
+// or none since boot
+bool rcIsLost();
+// Loop time since the last frame with signal
+uint32_t rcGetFrameAgeMicros();
+float rcGetLastGoodThrottle();
+uint32_t rcGetFramesPosted();
+// Frames replaced before the flight task applied them
+uint32_t rcGetFramesOverwritten();
+
 bool rcDidReceiveData();
 float rcGetInitialThrottle();
 
+// Full-stick pitch and roll angles, used to recover normalized sticks
+float rcGetPitchMaxRadians();
+float rcGetRollMaxRadians();
+
 bool rcIsArming();
 bool rcIsNoInput();
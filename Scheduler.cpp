@@ -0,0 +1,50 @@
+#include <Arduino.h>
+
+#include "Scheduler.h"
+
+void Scheduler::runTick() {
+    const uint32_t tickStart = micros();
+    for (size_t i = 0; i < numStages; ++i) {
+        SchedulerStage &stage = stages[i];
+        const uint32_t divisor = stage.divisor > 0 ? stage.divisor : 1;
+        if (!runAll && tick % divisor != 0) {
+            continue;
+        }
+        const uint32_t start = micros();
+        stage.run();
+        const uint32_t elapsed = micros() - start;
+        stage.lastMicros = elapsed;
+        if (elapsed > stage.maxMicros) {
+            stage.maxMicros = elapsed;
+        }
+        stage.avgMicros += 0.01f * ((float)elapsed - stage.avgMicros);
+        stage.runs++;
+    }
+    lastTickMicros = micros() - tickStart;
+    if (lastTickMicros > maxTickMicros) {
+        maxTickMicros = lastTickMicros;
+    }
+    tick++;
+}
+
+void Scheduler::resetStats() {
+    for (size_t i = 0; i < numStages; ++i) {
+        SchedulerStage &stage = stages[i];
+        stage.runs = 0;
+        stage.lastMicros = 0;
+        stage.maxMicros = 0;
+        stage.avgMicros = 0.0f;
+    }
+    overruns = 0;
+    lastTickMicros = 0;
+    maxTickMicros = 0;
+}
+
+float Scheduler::getStageBudgetPercent(size_t index) const {
+    const SchedulerStage &stage = stages[index];
+    if (tickIntervalMicros == 0) {
+        return 0.0f;
+    }
+    const uint32_t divisor = stage.divisor > 0 ? stage.divisor : 1;
+    return 100.0f * stage.avgMicros / ((float)divisor * (float)tickIntervalMicros);
+}
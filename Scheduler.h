@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// One stage of the control tick. A stage runs on every tick whose index is
+// a multiple of its divisor, so stages run at the tick rate / divisor.
+struct SchedulerStage {
+    const char *name;
+    void (*run)();
+    uint32_t divisor;
+
+    uint32_t runs;
+    uint32_t lastMicros;
+    uint32_t maxMicros;
+    float avgMicros;
+
+    SchedulerStage(const char *name, void (*run)(), uint32_t divisor)
+        : name(name), run(run), divisor(divisor)
+        , runs(0), lastMicros(0), maxMicros(0), avgMicros(0.0f) {}
+};
+
+// Statically allocated, fixed-order scheduler. Stages run in table order
+// within a tick.
+class Scheduler {
+    SchedulerStage *stages;
+    size_t numStages;
+    uint32_t tick;
+    uint32_t tickIntervalMicros;
+    uint32_t overruns;
+    uint32_t lastTickMicros;
+    uint32_t maxTickMicros;
+    bool runAll;
+public:
+    Scheduler(SchedulerStage *stages, size_t numStages)
+        : stages(stages), numStages(numStages), tick(0)
+        , tickIntervalMicros(0), overruns(0)
+        , lastTickMicros(0), maxTickMicros(0), runAll(false) {}
+
+    void runTick();
+
+    // Clears the timing statistics of the scheduler and all stages
+    void resetStats();
+
+    // Runs every stage on every tick regardless of divisor, which gives
+    // the worst-case tick cost
+    inline void setRunAll(bool all) {
+        runAll = all;
+    }
+
+    inline void setTickInterval(uint32_t micros) {
+        tickIntervalMicros = micros;
+    }
+    inline uint32_t getTickInterval() const {
+        return tickIntervalMicros;
+    }
+    inline void countOverrun() {
+        overruns++;
+    }
+    inline uint32_t getOverruns() const {
+        return overruns;
+    }
+    inline uint32_t getLastTickMicros() const {
+        return lastTickMicros;
+    }
+    inline uint32_t getMaxTickMicros() const {
+        return maxTickMicros;
+    }
+    inline size_t getNumStages() const {
+        return numStages;
+    }
+    inline const SchedulerStage &getStage(size_t index) const {
+        return stages[index];
+    }
+    inline SchedulerStage &getStage(size_t index) {
+        return stages[index];
+    }
+
+    // Average share of the tick budget used by a stage, in percent
+    float getStageBudgetPercent(size_t index) const;
+};
@@ -18,10 +18,9 @@ void stateSetFlightStatus(FlightStatus status) {
     currentState.flightStatus = status;
 }
 
-void stateUpdateOrientation(float pitchRadians, float rollRadians, float yawRadians, bool ok) {
-    currentState.pitchRadians = pitchRadians;
-    currentState.rollRadians = rollRadians;
-    currentState.yawRadians = yawRadians;
+void stateUpdateOrientation(const Quaternion &orientation, const Vector &rates, bool ok) {
+    currentState.orientation = orientation;
+    currentState.rates = rates;
     stateSetHardwareFlag(HF_MPU_OK, ok);
 }
 
@@ -2,6 +2,8 @@
 
 #include <cstdint>
 
+#include "Geometry.h"
+
 enum FlightStatus {
     FS_Disarmed                     = 0,
     FS_Arming                       = 1,
@@ -9,6 +11,7 @@ enum FlightStatus {
     FS_Flying                       = 3,
     FS_Disarming                    = 4,
     FS_DisarmingWaitingForNoInput   = 5,
+    FS_Failsafe                     = 6,
 };
 
 enum HardwareFlag {
@@ -17,9 +20,10 @@ enum HardwareFlag {
 };
 
 struct State {
-    float pitchRadians;
-    float rollRadians;
-    float yawRadians;
+    Quaternion orientation;
+    // Filtered body rates in radians per second; x is pitch, y is roll and
+    // z is yaw
+    Vector rates;
 
     float rcPitchRadians;
     float rcRollRadians;
@@ -40,7 +44,8 @@ struct State {
     std::uint32_t hardwareFlags;
 
     State()
-        : pitchRadians(0.0f), rollRadians(0.0f), yawRadians(0.0f)
+        : orientation()
+        , rates()
         , rcPitchRadians(0.0f), rcRollRadians(0.0f), rcYaw(0.0f)
         , rcThrottle(0.0f)
         , pitchErrorRadians(0.0f), rollErrorRadians(0.0f)
@@ -53,6 +58,11 @@ struct State {
     bool hasHardwareFlag(HardwareFlag flag) const {
         return (hardwareFlags & static_cast<std::uint32_t>(flag)) != 0;
     }
+    // Euler angles are only for telemetry; the control loop stays in quaternions.
+    // x is pitch, y is roll and z is yaw.
+    Vector orientationEuler() const {
+        return orientation.toEulerAngles();
+    }
     float rcPitchDegrees() const {
         return rcPitchRadians * (180.0f / 3.14159265359f);
     }
@@ -63,7 +73,7 @@ struct State {
 
 const State &getState();
 
-void stateUpdateOrientation(float pitchRadians, float rollRadians, float yawRadians, bool ok);
+void stateUpdateOrientation(const Quaternion &orientation, const Vector &rates, bool ok);
 void stateUpdateRC(float pitch, float roll, float yaw, float throttle, bool ok);
 void stateUpdateControlErrors(float pitchErrorRadians, float rollErrorRadians);
 void stateUpdateMotorCommands(float motor1, float motor2, float motor3, float motor4, float motor5, float motor6);
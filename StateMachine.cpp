@@ -1,133 +1,143 @@
 #include "StateMachine.h"
-#include "State.h"
+#include "Failsafe.h"
 #include "RadioController.h"
 
-class DisarmedState : public StateMachine {
-protected:
-    void beginState() override {
-        stateSetFlightStatus(FS_Disarmed);
-    }
-    void updateState() override;
-public:
-    DisarmedState() : StateMachine("Disarmed") {}
-};
+// Sticks must be held in the arming position this long to arm or disarm
+#define ARM_HOLD_MILLIS 2000
 
-class ArmingState : public StateMachine {
-    unsigned long startMillis;
-protected:
-    void beginState() override {
-        stateSetFlightStatus(FS_Arming);
-        startMillis = millis();
-    }
-    void updateState() override;
-public:
-    ArmingState() : StateMachine("Arming"), startMillis(0) {}
-};
+//
+// Guards
+//
+static bool armingStarted(uint32_t) {
+    return rcIsArming();
+}
 
-class ArmingWaitingForNoInputState : public StateMachine {
-    unsigned long startMillis;
-protected:
-    void beginState() override {
-        stateSetFlightStatus(FS_ArmingWaitingForNoInput);
-        startMillis = millis();
-    }
-    void updateState() override;
-public:
-    ArmingWaitingForNoInputState() : StateMachine("ArmingWaitingForNoInput"), startMillis(0) {}
-};
+static bool armingReleased(uint32_t) {
+    return !rcIsArming();
+}
 
-class FlyingState : public StateMachine {
-protected:
-    void beginState() override {
-        stateSetFlightStatus(FS_Flying);
-    }
-    void updateState() override;
-public:
-    FlyingState() : StateMachine("Flying") {}
-};
+static bool armingHeld(uint32_t millisInState) {
+    return rcIsArming() && millisInState > ARM_HOLD_MILLIS;
+}
 
-class DisarmingState : public StateMachine {
-    unsigned long startMillis;
-protected:
-    void beginState() override {
-        stateSetFlightStatus(FS_Disarming);
-        startMillis = millis();
-    }
-    void updateState() override;
-public:
-    DisarmingState() : StateMachine("Disarming") {}
+static bool noInput(uint32_t) {
+    return rcIsNoInput();
+}
+
+static bool rcLost(uint32_t) {
+    return rcIsLost();
+}
+
+static bool descended(uint32_t millisInState) {
+    return failsafeDescentComplete(millisInState);
+}
+
+// Indexed by FlightStatus
+static constexpr FlightStateInfo states[FLIGHT_STATE_COUNT] = {
+    { FS_Disarmed,                      "Disarmed",                     nullptr },
+    { FS_Arming,                        "Arming",                       nullptr },
+    { FS_ArmingWaitingForNoInput,       "ArmingWaitingForNoInput",      nullptr },
+    { FS_Flying,                        "Flying",                       nullptr },
+    { FS_Disarming,                     "Disarming",                    nullptr },
+    { FS_DisarmingWaitingForNoInput,    "DisarmingWaitingForNoInput",   nullptr },
+    { FS_Failsafe,                      "Failsafe",                     failsafeBegin },
 };
 
-class DisarmingWaitingForNoInputState : public StateMachine {
-    unsigned long startMillis;
-protected:
-    void beginState() override {
-        stateSetFlightStatus(FS_DisarmingWaitingForNoInput);
-        startMillis = millis();
-    }
-    void updateState() override;
-public:
-    DisarmingWaitingForNoInputState() : StateMachine("DisarmingWaitingForNoInput"), startMillis(0) {}
+// Checked in order; the first match wins, so RC loss comes before the
+// stick guards of each state. A failsafe descent always ends disarmed: on
+// its own, or early when the link is back and the pilot gives the disarm
+// sticks (rcIsArming is false while lost), waiting for them to center so
+// they do not re-arm.
+static constexpr FlightTransition transitions[] = {
+    { FS_Disarmed,                      armingStarted,  FS_Arming },
+    { FS_Arming,                        armingReleased, FS_Disarmed },
+    { FS_Arming,                        armingHeld,     FS_ArmingWaitingForNoInput },
+    { FS_ArmingWaitingForNoInput,       rcLost,         FS_Disarmed },
+    { FS_ArmingWaitingForNoInput,       noInput,        FS_Flying },
+    { FS_Flying,                        rcLost,         FS_Failsafe },
+    { FS_Flying,                        armingStarted,  FS_Disarming },
+    { FS_Disarming,                     rcLost,         FS_Failsafe },
+    { FS_Disarming,                     armingReleased, FS_Flying },
+    { FS_Disarming,                     armingHeld,     FS_DisarmingWaitingForNoInput },
+    { FS_DisarmingWaitingForNoInput,    rcLost,         FS_Disarmed },
+    { FS_DisarmingWaitingForNoInput,    noInput,        FS_Disarmed },
+    { FS_Failsafe,                      descended,      FS_Disarmed },
+    { FS_Failsafe,                      armingStarted,  FS_DisarmingWaitingForNoInput },
 };
+static constexpr size_t numTransitions = sizeof(transitions) / sizeof(transitions[0]);
 
-void DisarmedState::updateState() {
-    const auto a = rcIsArming();
-    if (a) {
-        transitionState(new ArmingState());
-    }
+static constexpr bool statesAreIndexed(size_t i) {
+    return i >= FLIGHT_STATE_COUNT || ((size_t)states[i].status == i && statesAreIndexed(i + 1));
 }
+static_assert(statesAreIndexed(0), "states must be indexed by FlightStatus");
 
-void ArmingState::updateState() {
-    const auto arming = rcIsArming();
-    if (arming) {
-        if (millis() - startMillis > 2000) { // 2 seconds debounce
-            transitionState(new ArmingWaitingForNoInputState());
-        }
-    }
-    else {
-        transitionState(new DisarmedState());
-    }
-}
+FlightState flightState;
 
-void ArmingWaitingForNoInputState::updateState() {
-    const auto noInput = rcIsNoInput();
-    if (noInput) {
-        transitionState(new FlyingState());
-    }
+FlightState::FlightState()
+    : status(FS_Disarmed)
+    , enteredMillis(0)
+    , began(false)
+    , ring{}
+    , transitionCount(0) {
 }
 
-void FlyingState::updateState() {
-    const auto arming = rcIsArming();
-    if (arming) {
-        transitionState(new DisarmingState());
-    }
+const char *FlightState::getStateName(FlightStatus status) {
+    const size_t index = (size_t)status;
+    return index < FLIGHT_STATE_COUNT ? states[index].name : "Unknown";
 }
 
-void DisarmingState::updateState() {
-    const auto arming = rcIsArming();
-    if (arming) {
-        if (millis() - startMillis > 2000) { // 2 seconds debounce
-            transitionState(new DisarmingWaitingForNoInputState());
-        }
-    }
-    else {
-        transitionState(new FlyingState());
+void FlightState::enter(FlightStatus newStatus, uint32_t nowMillis) {
+    status = newStatus;
+    enteredMillis = nowMillis;
+    stateSetFlightStatus(newStatus);
+    const FlightAction onEntry = states[(size_t)newStatus].onEntry;
+    if (onEntry) {
+        onEntry();
     }
 }
 
-void DisarmingWaitingForNoInputState::updateState() {
-    const auto noInput = rcIsNoInput();
-    if (noInput) {
-        transitionState(new DisarmedState());
-    }
+void FlightState::record(FlightStatus from, FlightStatus to) {
+    const uint32_t count = transitionCount.load(std::memory_order_relaxed);
+    FlightTransitionRecord &r = ring[count & (FLIGHT_TRANSITION_RING_SIZE - 1)];
+    r.millis = enteredMillis;
+    r.from = (uint8_t)from;
+    r.to = (uint8_t)to;
+    transitionCount.store(count + 1, std::memory_order_release);
 }
 
-FlightState flightState;
-
-void FlightState::beginState() {
-    transitionSubState(new DisarmedState());
+void FlightState::update(uint32_t nowMillis) {
+    if (!began) {
+        began = true;
+        enter(FS_Disarmed, nowMillis);
+        return;
+    }
+    const uint32_t millisInState = nowMillis - enteredMillis;
+    for (size_t i = 0; i < numTransitions; ++i) {
+        const FlightTransition &t = transitions[i];
+        if (t.from != status || !t.guard(millisInState)) {
+            continue;
+        }
+        const FlightStatus from = status;
+        enter(t.to, nowMillis);
+        record(from, t.to);
+        return;
+    }
 }
 
-void FlightState::updateState() {
-    // Everything handled by sub states
+size_t FlightState::copyTransitions(FlightTransitionRecord *out, size_t max) const {
+    for (;;) {
+        const uint32_t before = transitionCount.load(std::memory_order_acquire);
+        size_t n = before < FLIGHT_TRANSITION_RING_SIZE ? before : FLIGHT_TRANSITION_RING_SIZE;
+        if (n > max) {
+            n = max;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = ring[(before - n + i) & (FLIGHT_TRANSITION_RING_SIZE - 1)];
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // Retry if the writer lapped the records we copied
+        if (transitionCount.load(std::memory_order_relaxed) == before) {
+            return n;
+        }
+    }
 }
@@ -1,65 +1,77 @@
 #pragma once
 
 #include <Arduino.h>
-#include <esp_log.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 
-class StateMachine {
-    String name;
-    StateMachine *subState;
-    StateMachine *nextState;
+#include "State.h"
+
+#define FLIGHT_STATE_COUNT 7
+// Must be a power of two
+#define FLIGHT_TRANSITION_RING_SIZE 16
+
+// Guards see how long the machine has been in the current state. Times are
+// loop time, which advances by one period per control tick.
+typedef bool (*FlightGuard)(uint32_t millisInState);
+typedef void (*FlightAction)();
+
+struct FlightTransition {
+    FlightStatus from;
+    FlightGuard guard;
+    FlightStatus to;
+};
+
+struct FlightStateInfo {
+    FlightStatus status;
+    const char *name;
+    FlightAction onEntry;   // Runs after the status is published; may be null
+};
+
+struct FlightTransitionRecord {
+    uint32_t millis;
+    uint8_t from;
+    uint8_t to;
+};
+
+// Statically allocated, table-driven flight state machine. Each update takes
+// at most one transition: the first entry in the transition table whose
+// from state matches and whose guard passes. Transitions are recorded into
+// a fixed ring rather than logged.
+class FlightState {
+    FlightStatus status;
+    uint32_t enteredMillis;
     bool began;
-protected:
-    virtual void beginState() = 0;
-    virtual void updateState() = 0;
 
-    void transitionState(StateMachine *newState) {
-        delete nextState;
-        nextState = newState;
-    }
-    void transitionSubState(StateMachine *newSubState) {
-        ESP_LOGI("StateMachine", "%s transitioning from %s to %s", name.c_str(), subState ? subState->name.c_str() : "None", newSubState ? newSubState->name.c_str() : "None");
-        delete subState;
-        subState = newSubState;
-        if (subState) {
-            subState->beginState();
-        }
-    }
+    FlightTransitionRecord ring[FLIGHT_TRANSITION_RING_SIZE];
+    std::atomic<uint32_t> transitionCount;
+
+    void enter(FlightStatus newStatus, uint32_t nowMillis);
+    void record(FlightStatus from, FlightStatus to);
 public:
-    StateMachine(const String &name)
-        : name(name)
-        , subState(nullptr)
-        , nextState(nullptr)
-        , began(false) {}
-    virtual ~StateMachine() {
-        delete subState;
-        delete nextState;
+    FlightState();
+
+    // nowMillis is loop time from controlLoopGetClockMicros
+    void update(uint32_t nowMillis);
+
+    inline FlightStatus getStatus() const {
+        return status;
+    }
+
+    inline uint32_t getMillisInState(uint32_t nowMillis) const {
+        return nowMillis - enteredMillis;
     }
-    void update() {
-        if (!began) {
-            began = true;
-            beginState();
-        }
-        if (subState) {
-            subState->update();
-            StateMachine *nextSubState = subState->nextState;
-            subState->nextState = nullptr;
-            if (nextSubState) {
-                transitionSubState(nextSubState);
-            }
-        }
-        else {
-            updateState();
-        }
+
+    // Total transitions taken since boot
+    inline uint32_t getTransitionCount() const {
+        return transitionCount.load(std::memory_order_acquire);
     }
-};
 
-class FlightState : public StateMachine {
-protected:
-    void beginState();
-    void updateState();
-public:
-    FlightState() : StateMachine("FlightState") {}
-    ~FlightState() {}
+    // Copies up to max of the most recent transitions, oldest first. Safe
+    // to call from another task.
+    size_t copyTransitions(FlightTransitionRecord *out, size_t max) const;
+
+    static const char *getStateName(FlightStatus status);
 };
 
 extern FlightState flightState;
@@ -0,0 +1,309 @@
+#include <Arduino.h>
+#include <atomic>
+#include <cstring>
+
+#include "Tasks.h"
+#include "AllocTracker.h"
+#include "ConfigValue.h"
+#include "ControlLoop.h"
+#include "DeferredLog.h"
+#include "Mailbox.h"
+#include "MavLinkService.h"
+#include "Motors.h"
+#include "OTA.h"
+#include "RadioController.h"
+#include "State.h"
+#include "Watchdog.h"
+
+void webServerLoop();
+
+#define PERSISTENCE_PERIOD_MILLIS 100
+#define STATS_PERIOD_MILLIS 1000
+
+// Sensor task -> flight task
+struct SensorFrame {
+    MPUSample sample;
+    uint32_t releasedAtMicros;  // When the tick timer fired
+    uint32_t missedTicks;       // Timer periods skipped before this one
+
+    SensorFrame() : releasedAtMicros(0), missedTicks(0) {}
+};
+
+struct TaskSlot {
+    const char *name;
+    TaskFunction_t run;
+    uint32_t stackSize;
+    UBaseType_t priority;
+    BaseType_t core;
+
+    TaskHandle_t handle;
+    // Written by the task itself
+    std::atomic<uint32_t> busyMicros;
+    std::atomic<uint32_t> runs;
+    std::atomic<uint32_t> maxRunMicros;
+    // Written by the persistence task
+    uint32_t lastBusyMicros;
+    uint32_t stackFree;
+    float cpuPercent;
+
+    TaskSlot(const char *name, TaskFunction_t run, uint32_t stackSize, UBaseType_t priority, BaseType_t core)
+        : name(name), run(run), stackSize(stackSize), priority(priority), core(core)
+        , handle(nullptr), busyMicros(0), runs(0), maxRunMicros(0)
+        , lastBusyMicros(0), stackFree(0), cpuPercent(0.0f) {}
+};
+
+static void flightTask(void *);
+static void sensorTask(void *);
+static void rcTask(void *);
+static void networkTask(void *);
+static void persistenceTask(void *);
+static void watchdogTask(void *);
+static void logTask(void *);
+
+enum TaskIndex {
+    TI_Flight = 0,
+    TI_Watchdog,
+    TI_Sensor,
+    TI_RC,
+    TI_Network,
+    TI_Persistence,
+    TI_Log,
+    TI_Count
+};
+
+// Indexed by TaskIndex
+static TaskSlot tasks[] = {
+    TaskSlot("flight", flightTask, 4096, configMAX_PRIORITIES - 1, 0),
+    TaskSlot("watchdog", watchdogTask, 3072, configMAX_PRIORITIES - 1, 1),
+    TaskSlot("sensor", sensorTask, 3072, configMAX_PRIORITIES - 2, 1),
+    TaskSlot("rc", rcTask, 3072, 5, 1),
+    TaskSlot("network", networkTask, 8192, 2, 1),
+    TaskSlot("persistence", persistenceTask, 6144, 1, 1),
+    TaskSlot("log", logTask, 4096, 1, 1),
+};
+static_assert(sizeof(tasks) / sizeof(tasks[0]) == TI_Count, "tasks must be indexed by TaskIndex");
+static_assert(TI_Count <= TASKS_MAX, "too many tasks for TaskStats");
+
+static MPU *taskMPU = nullptr;
+static hw_timer_t *tickTimer = nullptr;
+static uint32_t tickTimerIntervalMicros = 0;
+static volatile uint32_t tickReleasedMicros = 0;
+static std::atomic<uint32_t> tickTimerMissed(0);
+static LatestMailbox<SensorFrame> sensorMailbox;
+
+static void noteRun(TaskSlot &task, uint32_t startMicros) {
+    const uint32_t elapsed = micros() - startMicros;
+    task.busyMicros.fetch_add(elapsed, std::memory_order_relaxed);
+    task.runs.fetch_add(1, std::memory_order_relaxed);
+    if (elapsed > task.maxRunMicros.load(std::memory_order_relaxed)) {
+        task.maxRunMicros.store(elapsed, std::memory_order_relaxed);
+    }
+}
+
+static void IRAM_ATTR onTickTimer() {
+    tickReleasedMicros = micros();
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(tasks[TI_Watchdog].handle, &woken);
+    vTaskNotifyGiveFromISR(tasks[TI_Sensor].handle, &woken);
+    if (woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+// Reads the IMU on each timer interrupt and wakes the flight task
+static void sensorTask(void *) {
+    TaskSlot &self = tasks[TI_Sensor];
+    SensorFrame frame;
+    for (;;) {
+        const uint32_t pending = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        const uint32_t start = micros();
+        frame.releasedAtMicros = tickReleasedMicros;
+        frame.missedTicks = pending > 1 ? pending - 1 : 0;
+        if (frame.missedTicks > 0) {
+            tickTimerMissed.fetch_add(frame.missedTicks, std::memory_order_relaxed);
+        }
+        taskMPU->acquire(frame.sample);
+        sensorMailbox.post(frame);
+        xTaskNotifyGive(tasks[TI_Flight].handle);
+        noteRun(self, start);
+    }
+}
+
+// Runs the control tick on each sample and keeps the tick timer at the
+// configured loop rate
+static void flightTask(void *) {
+    TaskSlot &self = tasks[TI_Flight];
+    SensorFrame frame;
+    uint32_t lastOverwritten = 0;
+    watchdogFlightTaskBegin();
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (!sensorMailbox.take(frame)) {
+            continue;
+        }
+        const uint32_t start = micros();
+        // Samples replaced before we took them are ticks the control loop missed
+        const uint32_t overwritten = sensorMailbox.getOverwritten();
+        const uint32_t dropped = overwritten - lastOverwritten;
+        lastOverwritten = overwritten;
+
+        if (motorsCalibrationInProgress()) {
+            rcApplyLatestFrame(controlLoopGetClockMicros());
+            const float thr = getState().rcThrottle;
+            motorsSendCommands(thr, thr, thr, thr, thr, thr);
+        }
+        else {
+            controlLoopTick(frame.sample, frame.releasedAtMicros, frame.missedTicks + dropped);
+        }
+        if (const uint32_t stallMillis = watchdogTakeInjectedStall()) {
+            DLOG_W("Tasks", "Injected flight loop stall of %u ms", (unsigned)stallMillis);
+            delayMicroseconds(stallMillis * 1000);
+        }
+        watchdogHeartbeat(frame.releasedAtMicros, start, micros());
+
+        const uint32_t interval = controlLoopGetIntervalMicros();
+        if (interval != tickTimerIntervalMicros) {
+            tickTimerIntervalMicros = interval;
+            timerAlarm(tickTimer, interval, true, 0);
+        }
+        noteRun(self, start);
+    }
+}
+
+// Checks the flight task's heartbeat on every timer period. Runs above the
+// sensor task so a stuck bus cannot hide a stalled loop.
+static void watchdogTask(void *) {
+    TaskSlot &self = tasks[TI_Watchdog];
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        const uint32_t start = micros();
+        watchdogCheck(start, tickTimerIntervalMicros);
+        noteRun(self, start);
+    }
+}
+
+static void rcTask(void *) {
+    TaskSlot &self = tasks[TI_RC];
+    for (;;) {
+        const uint32_t start = micros();
+        rcUpdate();
+        noteRun(self, start);
+        vTaskDelay(1);
+    }
+}
+
+static void networkTask(void *) {
+    TaskSlot &self = tasks[TI_Network];
+    for (;;) {
+        const uint32_t start = micros();
+        webServerLoop();
+        mavlinkPoll(micros());
+        noteRun(self, start);
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+}
+
+static void logTask(void *) {
+    TaskSlot &self = tasks[TI_Log];
+    for (;;) {
+        const uint32_t start = micros();
+        deferredLogDrain();
+        noteRun(self, start);
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+}
+
+static void updateTaskStats(uint32_t elapsedMicros) {
+    for (size_t i = 0; i < TI_Count; ++i) {
+        TaskSlot &task = tasks[i];
+        const uint32_t busy = task.busyMicros.load(std::memory_order_relaxed);
+        task.cpuPercent = elapsedMicros > 0 ? 100.0f * (float)(busy - task.lastBusyMicros) / (float)elapsedMicros : 0.0f;
+        task.lastBusyMicros = busy;
+        // A null handle would measure the calling task
+        if (task.handle != nullptr) {
+            task.stackFree = (uint32_t)uxTaskGetStackHighWaterMark(task.handle);
+        }
+    }
+}
+
+// Everything that touches flash
+static void persistenceTask(void *) {
+    TaskSlot &self = tasks[TI_Persistence];
+    uint32_t lastStatsMicros = micros();
+    uint32_t lastStatsMillis = millis();
+    for (;;) {
+        const uint32_t start = micros();
+        motorsCalibrationUpdate();
+        configValuesSaveIfRequested();
+        // Lines logged in flight wait in RAM until the vehicle is disarmed
+        if (getState().flightStatus == FS_Disarmed) {
+            deferredLogFlushFile();
+        }
+        otaLoop();
+        const uint32_t nowMillis = millis();
+        if (nowMillis - lastStatsMillis >= STATS_PERIOD_MILLIS) {
+            lastStatsMillis = nowMillis;
+            allocTrackerSampleHeap();
+            updateTaskStats(start - lastStatsMicros);
+            lastStatsMicros = start;
+        }
+        noteRun(self, start);
+        // A firmware update writes a sector per round
+        vTaskDelay(pdMS_TO_TICKS(otaIsActive() ? OTA_WRITE_INTERVAL_MILLIS : PERSISTENCE_PERIOD_MILLIS));
+    }
+}
+
+static void startTask(TaskSlot &task) {
+    if (xTaskCreatePinnedToCore(task.run, task.name, task.stackSize, nullptr, task.priority, &task.handle, task.core) != pdPASS) {
+        ESP_LOGE("Tasks", "Failed to start task %s", task.name);
+    }
+}
+
+void tasksBegin(MPU &mpu) {
+    taskMPU = &mpu;
+    watchdogBegin();
+    controlLoopBegin(mpu);
+    configValuesDeferSaves(true);
+
+    for (size_t i = 0; i < TI_Count; ++i) {
+        if (i != TI_Network) {
+            startTask(tasks[i]);
+        }
+    }
+
+    // 1 MHz timer so the alarm is the tick interval in microseconds
+    tickTimerIntervalMicros = controlLoopGetIntervalMicros();
+    tickTimer = timerBegin(1000000);
+    timerAttachInterrupt(tickTimer, onTickTimer);
+    timerAlarm(tickTimer, tickTimerIntervalMicros, true, 0);
+    ESP_LOGI("Tasks", "Started %d tasks, tick every %u us", (int)TI_Count - 1, (unsigned)tickTimerIntervalMicros);
+}
+
+void tasksBeginNetwork() {
+    startTask(tasks[TI_Network]);
+}
+
+size_t tasksGetStats(TaskStats *stats) {
+    for (size_t i = 0; i < TI_Count; ++i) {
+        const TaskSlot &task = tasks[i];
+        TaskStats &s = stats[i];
+        std::strncpy(s.name, task.name, sizeof(s.name) - 1);
+        s.name[sizeof(s.name) - 1] = '\0';
+        s.core = task.core;
+        s.priority = task.priority;
+        s.stackSize = task.stackSize;
+        s.stackFree = task.stackFree;
+        s.runs = task.runs.load(std::memory_order_relaxed);
+        s.maxRunMicros = task.maxRunMicros.load(std::memory_order_relaxed);
+        s.cpuPercent = task.cpuPercent;
+    }
+    return TI_Count;
+}
+
+void tasksGetMailboxStats(MailboxStats &stats) {
+    stats.sensorPosted = sensorMailbox.getPosted();
+    stats.sensorOverwritten = sensorMailbox.getOverwritten();
+    stats.tickTimerMissed = tickTimerMissed.load(std::memory_order_relaxed);
+    stats.rcPosted = rcGetFramesPosted();
+    stats.rcOverwritten = rcGetFramesOverwritten();
+}
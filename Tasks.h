@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "MPU.h"
+
+// Firmware tasks (PRD.md). The flight task is the only one of these on
+// core 0 and runs there at the highest priority, but it does not have the
+// core to itself: the network bring-up task runs there until the network
+// is up, and ESP-IDF pins its Wi-Fi driver, esp_timer and ipc0 tasks there.
+// The flight task preempts the bring-up task, but the system tasks and the
+// Wi-Fi interrupts can still delay a tick. Everything else runs on core 1.
+// Tasks only talk through LatestMailbox, atomics and short critical
+// sections.
+//
+//   task         core  priority  does
+//   flight       0     highest   control tick on each sensor sample
+//   watchdog     1     highest   flight heartbeat check on each timer interrupt
+//   sensor       1     highest-1 IMU read on each tick timer interrupt
+//   rc           1     5         SBUS decode
+//   network      1     2         config broadcasts, /events, MAVLink
+//   persistence  1     1         EEPROM, config file, log file, firmware updates, stats
+//   log          1     1         deferred log formatting
+//
+// Also on core 0, not started here:
+//   netboot      0     1         Wi-Fi, mDNS, OTA, web server and MAVLink bring-up
+//                                (Flybot.ino), then deletes itself
+//   wifi, esp_timer, ipc0        ESP-IDF system tasks
+
+#define TASKS_MAX 8
+#define TASK_NAME_LEN 16
+
+struct TaskStats {
+    char name[TASK_NAME_LEN];
+    int32_t core;
+    uint32_t priority;
+    uint32_t stackSize;         // Bytes
+    uint32_t stackFree;         // Least free stack seen, in bytes
+    uint32_t runs;              // Work items handled
+    uint32_t maxRunMicros;      // Longest work item
+    float cpuPercent;           // Share of its core over the last second
+};
+
+struct MailboxStats {
+    uint32_t sensorPosted;
+    uint32_t sensorOverwritten; // Samples the flight task never saw
+    uint32_t tickTimerMissed;   // Timer interrupts the sensor task fell behind on
+    uint32_t rcPosted;
+    uint32_t rcOverwritten;
+};
+
+// Starts the tick timer and all tasks but the network task. Call once
+// everything they use is initialized; the network need not be up yet.
+void tasksBegin(MPU &mpu);
+// Starts the network task, once the web server and MAVLink are up
+void tasksBeginNetwork();
+
+// Fills up to TASKS_MAX entries and returns how many were filled
+size_t tasksGetStats(TaskStats *stats);
+void tasksGetMailboxStats(MailboxStats &stats);
@@ -0,0 +1,119 @@
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <cstdio>
+
+#include "Latency.h"
+#include "State.h"
+#include "Telemetry.h"
+
+struct Subscriber {
+    TelemetrySink *sink;    // nullptr when the slot is free
+    uint32_t intervalMicros;
+    uint32_t nextMicros;
+};
+
+// Slots change on the web server's task and are walked by the network task
+static SemaphoreHandle_t subscribersMutex = nullptr;
+static Subscriber subscribers[TELEMETRY_SUBSCRIBERS_MAX];
+static TelemetryStats stats = {};
+static uint32_t frameId = 0;
+static char frame[TELEMETRY_FRAME_MAX];
+
+size_t telemetryFormatState(char *buffer, size_t size) {
+    const State &state = getState();
+    const Vector euler = state.orientationEuler();
+    const int length = snprintf(buffer, size,
+        "{\"type\":\"state\",\"mr\":%.3f,\"mp\":%.3f,\"my\":%.3f"
+        ",\"rr\":%.3f,\"rp\":%.3f,\"ry\":%.3f,\"rt\":%.3f"
+        ",\"fs\":%d,\"hf\":%u,\"ep\":%.3f,\"er\":%.3f"
+        ",\"m1\":%.3f,\"m2\":%.3f,\"m3\":%.3f,\"m4\":%.3f,\"m5\":%.3f,\"m6\":%.3f"
+        ",\"sl\":%u}",
+        euler.y, euler.x, euler.z,
+        state.rcRollRadians, state.rcPitchRadians, state.rcYaw, state.rcThrottle,
+        (int)state.flightStatus, (unsigned)state.hardwareFlags,
+        state.pitchErrorRadians, state.rollErrorRadians,
+        state.motor1Command, state.motor2Command, state.motor3Command,
+        state.motor4Command, state.motor5Command, state.motor6Command,
+        (unsigned)latencyGetLastMicros());
+    if (length < 0 || size == 0) {
+        return 0;
+    }
+    return (size_t)length < size ? (size_t)length : size - 1;
+}
+
+void telemetryBegin() {
+    subscribersMutex = xSemaphoreCreateMutex();
+}
+
+bool telemetrySubscribe(TelemetrySink *sink, float hz) {
+    if (hz < TELEMETRY_MIN_HZ) {
+        hz = TELEMETRY_MIN_HZ;
+    } else if (hz > TELEMETRY_MAX_HZ) {
+        hz = TELEMETRY_MAX_HZ;
+    }
+    bool subscribed = false;
+    xSemaphoreTake(subscribersMutex, portMAX_DELAY);
+    for (auto &subscriber : subscribers) {
+        if (subscriber.sink == nullptr) {
+            subscriber.sink = sink;
+            subscriber.intervalMicros = (uint32_t)(1000000.0f / hz);
+            subscriber.nextMicros = micros();
+            stats.subscribers++;
+            subscribed = true;
+            break;
+        }
+    }
+    xSemaphoreGive(subscribersMutex);
+    return subscribed;
+}
+
+void telemetryUnsubscribe(TelemetrySink *sink) {
+    xSemaphoreTake(subscribersMutex, portMAX_DELAY);
+    for (auto &subscriber : subscribers) {
+        if (subscriber.sink == sink) {
+            subscriber.sink = nullptr;
+            stats.subscribers--;
+        }
+    }
+    xSemaphoreGive(subscribersMutex);
+}
+
+static bool isDue(const Subscriber &subscriber, uint32_t nowMicros) {
+    return subscriber.sink != nullptr && (int32_t)(nowMicros - subscriber.nextMicros) >= 0;
+}
+
+void telemetryPoll(uint32_t nowMicros) {
+    xSemaphoreTake(subscribersMutex, portMAX_DELAY);
+    size_t length = 0;
+    for (auto &subscriber : subscribers) {
+        if (!isDue(subscriber, nowMicros)) {
+            continue;
+        }
+        if (length == 0) {
+            length = telemetryFormatState(frame, sizeof(frame));
+            frameId++;
+            stats.frames++;
+        }
+        if (subscriber.sink->queued() >= TELEMETRY_QUEUE_MAX) {
+            stats.dropped++;
+        } else if (subscriber.sink->send(frame, length, frameId)) {
+            stats.sent++;
+        } else {
+            stats.dropped++;
+        }
+        // A subscriber that fell a whole interval behind restarts from now
+        // rather than catching up with a burst
+        subscriber.nextMicros += subscriber.intervalMicros;
+        if ((int32_t)(nowMicros - subscriber.nextMicros) >= 0) {
+            subscriber.nextMicros = nowMicros + subscriber.intervalMicros;
+        }
+    }
+    xSemaphoreGive(subscribersMutex);
+}
+
+void telemetryGetStats(TelemetryStats &out) {
+    xSemaphoreTake(subscribersMutex, portMAX_DELAY);
+    out = stats;
+    xSemaphoreGive(subscribersMutex);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// State snapshots streamed to subscribers at their own rates. The network
+// task serializes at most one frame per round, only when some subscriber is
+// due, and hands the same frame to each of them. A subscriber whose
+// transport still holds TELEMETRY_QUEUE_MAX frames skips the round, so a
+// slow client gets fewer, fresher frames instead of a growing backlog.
+
+#define TELEMETRY_SUBSCRIBERS_MAX 4
+// Frames a subscriber may have waiting before new ones are dropped
+#define TELEMETRY_QUEUE_MAX 2
+#define TELEMETRY_MIN_HZ 1.0f
+#define TELEMETRY_MAX_HZ 50.0f
+#define TELEMETRY_DEFAULT_HZ 10.0f
+#define TELEMETRY_FRAME_MAX 384
+
+// A subscriber's transport; its methods are only called on the network task
+// while it is subscribed
+class TelemetrySink {
+public:
+    virtual ~TelemetrySink() {}
+    // Frames handed to send that have not been written out yet
+    virtual size_t queued() const = 0;
+    virtual bool send(const char *frame, size_t length, uint32_t id) = 0;
+};
+
+struct TelemetryStats {
+    uint32_t subscribers;
+    uint32_t frames;        // Snapshots serialized
+    uint32_t sent;          // Frames handed to sinks
+    uint32_t dropped;       // Frames skipped because a sink was full
+};
+
+// Writes the current state as {"type":"state",...} and returns its length,
+// truncated to size - 1
+size_t telemetryFormatState(char *buffer, size_t size);
+
+void telemetryBegin();
+// hz is clamped to TELEMETRY_MIN_HZ..TELEMETRY_MAX_HZ. Fails when every slot
+// is taken. After telemetryUnsubscribe returns the sink is no longer used.
+bool telemetrySubscribe(TelemetrySink *sink, float hz);
+void telemetryUnsubscribe(TelemetrySink *sink);
+// Network task: sends a frame to every subscriber that is due at nowMicros
+void telemetryPoll(uint32_t nowMicros);
+void telemetryGetStats(TelemetryStats &stats);
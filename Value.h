@@ -4,44 +4,44 @@
 
 #include <esp_log.h>
 
+#include "DeferredLog.h"
+
 enum ValueType {
     VT_Int = 0,
     VT_Float = 1,
 };
 
 class Value {
-    ValueType type;
-    union {
+    union Storage {
         std::int32_t intValue;
         float floatValue;
-    } value;
-    inline Value(ValueType type) : type(type) {
-        value.intValue = 0; // Default to zero
-    }
+        constexpr Storage(std::int32_t v) : intValue(v) {}
+        constexpr Storage(float v) : floatValue(v) {}
+    };
+    ValueType type;
+    Storage value;
+    constexpr Value(ValueType type, Storage value) : type(type), value(value) {}
 public:
-    inline static Value fromInt(std::int32_t v) {
-        Value val(VT_Int);
-        val.value.intValue = v;
-        return val;
+    // constexpr so defaults can live in flash-resident descriptor tables
+    constexpr static Value fromInt(std::int32_t v) {
+        return Value(VT_Int, Storage(v));
     }
-    inline static Value fromFloat(float v) {
-        Value val(VT_Float);
-        val.value.floatValue = v;
-        return val;
+    constexpr static Value fromFloat(float v) {
+        return Value(VT_Float, Storage(v));
     }
     inline ValueType getType() const {
         return type;
     }
     inline std::int32_t getInt() const {
         if (type != VT_Int) {
-            ESP_LOGW("Config", "getInt called on non-int value");
+            DLOG_W("Config", "getInt called on non-int value");
             return (std::int32_t)value.floatValue;
         }
         return value.intValue;
     }
     inline float getFloat() const {
         if (type != VT_Float) {
-            ESP_LOGW("Config", "getFloat called on non-float value");
+            DLOG_W("Config", "getFloat called on non-float value");
             return (float)value.intValue;
         }
         return value.floatValue;
@@ -65,7 +65,7 @@ public:
     }
     inline bool operator<(const Value& other) const {
         if (type != other.type) {
-            ESP_LOGW("Config", "Comparison between different types");
+            DLOG_W("Config", "Comparison between different types");
             return getFloat() < other.getFloat();
         }
         if (type == VT_Int) {
@@ -0,0 +1,211 @@
+#include <Arduino.h>
+#include <atomic>
+#include <cstring>
+#include <esp_system.h>
+#include <esp_task_wdt.h>
+
+#include "Watchdog.h"
+#include "ConfigValue.h"
+#include "DeferredLog.h"
+#include "Motors.h"
+#include "State.h"
+
+#define WATCHDOG_MAGIC 0x57444f47
+#define WATCHDOG_MAX_INJECTED_STALL_MILLIS 10000
+
+static constexpr ConfigDescriptor watchdogDeadlineTicksDescriptor = ConfigDescriptor::fromInt("watchdog.deadlineTicks", "Tick periods without a finished tick before it counts as a deadline miss", 3, 1);
+ConfigValue watchdogDeadlineTicks(watchdogDeadlineTicksDescriptor);
+static constexpr ConfigDescriptor watchdogFailsafeMillisDescriptor = ConfigDescriptor::fromInt("watchdog.failsafeMs", "Stall length that triggers watchdog.response (ms)", 50, 1);
+ConfigValue watchdogFailsafeMillis(watchdogFailsafeMillisDescriptor);
+static constexpr ConfigDescriptor watchdogResponseDescriptor = ConfigDescriptor::fromInt("watchdog.response", "Response to a stalled flight loop (0 = log, 1 = hold last output, 2 = cut motors until disarmed)", WR_Cut, WR_Log, WR_Cut);
+ConfigValue watchdogResponse(watchdogResponseDescriptor);
+static constexpr ConfigDescriptor watchdogResetMillisDescriptor = ConfigDescriptor::fromInt("watchdog.resetMs", "Reset the chip if the flight task stops this long (ms)", 1000, 100);
+ConfigValue watchdogResetMillis(watchdogResetMillisDescriptor);
+
+static RTC_NOINIT_ATTR WatchdogPostMortem rtcRecord;
+static WatchdogPostMortem previousRecord;
+static bool hasPreviousRecord = false;
+static int32_t previousResetReason = 0;
+
+// Written by the flight task
+static std::atomic<uint32_t> lastHeartbeatMicros(0);
+static std::atomic<uint32_t> heartbeats(0);
+
+// Written by the watchdog task
+static WatchdogStats stats;
+static uint32_t stallStartMicros = 0;
+static uint32_t stallStartHeartbeats = 0;
+static bool responded = false;
+
+static std::atomic<uint32_t> injectedStallMillis(0);
+static esp_task_wdt_user_handle_t flightWatchdogUser = nullptr;
+
+void watchdogBegin() {
+    previousResetReason = (int32_t)esp_reset_reason();
+    hasPreviousRecord = rtcRecord.magic == WATCHDOG_MAGIC;
+    uint32_t bootCount = 0;
+    if (hasPreviousRecord) {
+        previousRecord = rtcRecord;
+        bootCount = rtcRecord.bootCount + 1;
+        if (previousRecord.stallMicros > 0 || previousRecord.failsafes > 0) {
+            ESP_LOGW("Watchdog", "Previous boot: %u misses, %u failsafes, stalled for %u us at reset (reset reason %d)",
+                (unsigned)previousRecord.misses, (unsigned)previousRecord.failsafes,
+                (unsigned)previousRecord.stallMicros, (int)previousResetReason);
+        }
+    }
+    std::memset(&rtcRecord, 0, sizeof(rtcRecord));
+    rtcRecord.magic = WATCHDOG_MAGIC;
+    rtcRecord.bootCount = bootCount;
+    rtcRecord.lastResponse = -1;
+}
+
+void watchdogFlightTaskBegin() {
+    // The task watchdog's timeout and panic setting belong to the whole
+    // system, so they stay as configured; watchdog.resetMs is enforced by
+    // watchdogCheck instead. Registering still catches a watchdog task
+    // that stops checking.
+    if (esp_task_wdt_add_user("flight", &flightWatchdogUser) != ESP_OK) {
+        flightWatchdogUser = nullptr;
+        ESP_LOGW("Watchdog", "Task watchdog not running, only watchdog.resetMs guards the flight task");
+    }
+}
+
+void watchdogHeartbeat(uint32_t releasedMicros, uint32_t startMicros, uint32_t endMicros) {
+    const uint32_t n = rtcRecord.ticks;
+    WatchdogTickRecord &r = rtcRecord.ring[n % WATCHDOG_POST_MORTEM_TICKS];
+    r.releasedMicros = releasedMicros;
+    r.startDelayMicros = startMicros - releasedMicros;
+    r.tickMicros = endMicros - startMicros;
+    rtcRecord.ticks = n + 1;
+
+    lastHeartbeatMicros.store(endMicros, std::memory_order_relaxed);
+    heartbeats.fetch_add(1, std::memory_order_release);
+    if (flightWatchdogUser) {
+        esp_task_wdt_reset_user(flightWatchdogUser);
+    }
+}
+
+static void applyResponse(int32_t response, uint32_t stallMicros) {
+    stats.failsafes++;
+    rtcRecord.failsafes = stats.failsafes;
+    rtcRecord.lastResponse = response;
+    switch (response) {
+    case WR_Hold:
+        DLOG_E("Watchdog", "Flight loop stalled for %u us, holding last outputs", (unsigned)stallMicros);
+        break;
+    case WR_Cut:
+        motorsCut();
+        DLOG_E("Watchdog", "Flight loop stalled for %u us, motors cut until disarmed", (unsigned)stallMicros);
+        break;
+    default:
+        DLOG_E("Watchdog", "Flight loop stalled for %u us", (unsigned)stallMicros);
+        break;
+    }
+}
+
+void watchdogCheck(uint32_t nowMicros, uint32_t intervalMicros) {
+    const uint32_t beats = heartbeats.load(std::memory_order_acquire);
+    if (beats == 0) {
+        // Nothing to supervise until the first tick
+        return;
+    }
+    const uint32_t last = lastHeartbeatMicros.load(std::memory_order_relaxed);
+    const uint32_t sinceHeartbeat = nowMicros - last;
+
+    if (stats.stalled) {
+        if (beats != stallStartHeartbeats) {
+            // Recovered: the stall lasted until the heartbeat that ended it
+            const uint32_t duration = last - stallStartMicros;
+            stats.stalled = false;
+            stats.lastMissMicros = duration;
+            stats.totalMissMicros += duration;
+            if (duration > stats.maxMissMicros) {
+                stats.maxMissMicros = duration;
+                rtcRecord.maxMissMicros = duration;
+            }
+            rtcRecord.stallMicros = 0;
+            DLOG_W("Watchdog", "Flight loop recovered after %u us", (unsigned)duration);
+        }
+        else {
+            stats.stallMicros = sinceHeartbeat;
+            rtcRecord.stallMicros = sinceHeartbeat;
+            int32_t failsafeMillis = watchdogFailsafeMillis.getInt();
+            if (failsafeMillis < 1) failsafeMillis = 1;
+            if (!responded && sinceHeartbeat >= (uint32_t)failsafeMillis * 1000) {
+                responded = true;
+                applyResponse(watchdogResponse.getInt(), sinceHeartbeat);
+            }
+            int32_t resetMillis = watchdogResetMillis.getInt();
+            if (resetMillis < 100) resetMillis = 100;
+            if (sinceHeartbeat >= (uint32_t)resetMillis * 1000) {
+                // The post-mortem already holds the stall; zero the outputs
+                // before the shutdown handlers run
+                motorsCut();
+                esp_restart();
+            }
+        }
+    }
+    else {
+        int32_t deadlineTicks = watchdogDeadlineTicks.getInt();
+        if (deadlineTicks < 1) deadlineTicks = 1;
+        if (sinceHeartbeat > (uint32_t)deadlineTicks * intervalMicros) {
+            stats.stalled = true;
+            stats.misses++;
+            stats.stallMicros = sinceHeartbeat;
+            rtcRecord.misses = stats.misses;
+            rtcRecord.stallMicros = sinceHeartbeat;
+            stallStartMicros = last;
+            stallStartHeartbeats = beats;
+            responded = false;
+            DLOG_W("Watchdog", "Deadline miss, no tick for %u us", (unsigned)sinceHeartbeat);
+        }
+        else {
+            stats.stallMicros = sinceHeartbeat;
+        }
+    }
+
+    // A cut stays latched until the pilot disarms on a healthy loop
+    if (!stats.stalled && motorsIsCut() && getState().flightStatus == FS_Disarmed) {
+        motorsClearCut();
+        DLOG_I("Watchdog", "Disarmed, motor cut cleared");
+    }
+    stats.motorsCut = motorsIsCut();
+}
+
+void watchdogGetStats(WatchdogStats &out) {
+    out = stats;
+}
+
+bool watchdogGetPreviousPostMortem(WatchdogPostMortem &record, int32_t &resetReason) {
+    resetReason = previousResetReason;
+    if (!hasPreviousRecord) {
+        return false;
+    }
+    record = previousRecord;
+    // Rotate the ring so the oldest tick comes first
+    const uint32_t n = previousRecord.ticks;
+    if (n > WATCHDOG_POST_MORTEM_TICKS) {
+        for (size_t i = 0; i < WATCHDOG_POST_MORTEM_TICKS; ++i) {
+            record.ring[i] = previousRecord.ring[(n + i) % WATCHDOG_POST_MORTEM_TICKS];
+        }
+    }
+    return true;
+}
+
+bool watchdogInjectStall(uint32_t stallMillis) {
+    if (getState().flightStatus != FS_Disarmed) {
+        return false;
+    }
+    if (stallMillis > WATCHDOG_MAX_INJECTED_STALL_MILLIS) {
+        stallMillis = WATCHDOG_MAX_INJECTED_STALL_MILLIS;
+    }
+    injectedStallMillis.store(stallMillis, std::memory_order_relaxed);
+    return true;
+}
+
+uint32_t watchdogTakeInjectedStall() {
+    if (injectedStallMillis.load(std::memory_order_relaxed) == 0) {
+        return 0;
+    }
+    return injectedStallMillis.exchange(0, std::memory_order_relaxed);
+}
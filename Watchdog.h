@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+
+// Flight loop supervisor. The flight task reports a heartbeat after every
+// tick; the watchdog task checks it on every tick timer period. No finished
+// tick for watchdog.deadlineTicks periods is a deadline miss. If the stall
+// lasts past watchdog.failsafeMs the configured response is applied, and
+// past watchdog.resetMs the watchdog task restarts the chip. The last tick
+// timings survive the reset in RTC memory. The flight task is also a user
+// of the system task watchdog, whose configuration is left alone.
+
+#define WATCHDOG_POST_MORTEM_TICKS 32
+
+enum WatchdogResponse {
+    WR_Log      = 0,    // Only record and log the stall
+    WR_Hold     = 1,    // Keep the last motor outputs until the loop recovers
+    WR_Cut      = 2,    // Zero the motors until the vehicle is disarmed
+};
+
+struct WatchdogTickRecord {
+    uint32_t releasedMicros;    // When the tick timer fired
+    uint32_t startDelayMicros;  // From the timer to the start of the tick
+    uint32_t tickMicros;        // Start to end of the tick
+};
+
+struct WatchdogStats {
+    uint32_t misses;            // Deadline misses since boot
+    uint32_t lastMissMicros;    // Duration of the last finished stall
+    uint32_t maxMissMicros;
+    uint32_t totalMissMicros;
+    uint32_t failsafes;         // Stalls that reached watchdog.failsafeMs
+    uint32_t stallMicros;       // Current time since the last heartbeat
+    bool stalled;               // A miss is in progress
+    bool motorsCut;
+};
+
+// Kept in RTC memory across resets
+struct WatchdogPostMortem {
+    uint32_t magic;
+    uint32_t bootCount;
+    uint32_t ticks;             // Heartbeats recorded; the ring holds the last few
+    WatchdogTickRecord ring[WATCHDOG_POST_MORTEM_TICKS];
+    uint32_t misses;
+    uint32_t maxMissMicros;
+    uint32_t failsafes;
+    int32_t lastResponse;       // WatchdogResponse applied last, -1 for none
+    uint32_t stallMicros;       // Stall in progress when last checked
+};
+
+// Reads the previous boot's post-mortem and starts a new one
+void watchdogBegin();
+
+// Flight task: registers it with the system task watchdog
+void watchdogFlightTaskBegin();
+// Flight task: called after every tick
+void watchdogHeartbeat(uint32_t releasedMicros, uint32_t startMicros, uint32_t endMicros);
+
+// Watchdog task: called on every tick timer period. Does not return once
+// the stall reaches watchdog.resetMs.
+void watchdogCheck(uint32_t nowMicros, uint32_t intervalMicros);
+
+void watchdogGetStats(WatchdogStats &stats);
+
+// Returns false if there was no record from the previous boot. Ticks in
+// the ring are oldest first.
+bool watchdogGetPreviousPostMortem(WatchdogPostMortem &record, int32_t &resetReason);
+
+// Fault injection: the flight task busy-waits this long in its next tick.
+// Refused unless disarmed.
+bool watchdogInjectStall(uint32_t stallMillis);
+uint32_t watchdogTakeInjectedStall();
@@ -0,0 +1,415 @@
+// Generated by tools/embed_assets.py from web/. Do not edit.
+#pragma once
+
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+
+struct WebAsset {
+    const char *path;
+    const char *contentType;
+    const uint8_t *gzipData;
+    size_t gzipLength;
+    const char *etag;       // Quoted content hash
+    const char *version;    // The hash alone, as used in ?v=
+};
+
+// flybot.js: 25084 bytes, 19384 minified, 5171 gzipped
+static const uint8_t webAsset_flybot_js[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xcd, 0x3c, 0xed, 0x72, 0xdb, 0x46,
+    0x92, 0xff, 0xf9, 0x14, 0x08, 0xa2, 0x75, 0x40, 0x89, 0xa4, 0x48, 0xea, 0x23, 0x8a, 0x3e, 0xe8,
+    0x8a, 0x65, 0x2b, 0xd6, 0xad, 0x65, 0xbb, 0x24, 0x7b, 0x63, 0x95, 0xcb, 0x65, 0x41, 0xc0, 0x50,
+    0x44, 0x04, 0x02, 0x5c, 0x00, 0xb4, 0xc4, 0x55, 0x58, 0x75, 0xef, 0x70, 0x2f, 0x72, 0xcf, 0x70,
+    0x8f, 0x72, 0x4f, 0x72, 0xdd, 0x3d, 0xdf, 0x00, 0x48, 0xd1, 0xde, 0x64, 0xf7, 0x5c, 0x2e, 0x1b,
+    0x98, 0xe9, 0xee, 0xe9, 0xe9, 0xe9, 0xcf, 0x99, 0x01, 0x63, 0x56, 0x38, 0xc3, 0x78, 0x76, 0x9d,
+    0x16, 0xe7, 0x69, 0x5a, 0x38, 0x47, 0x8e, 0xeb, 0x1e, 0x34, 0x62, 0x68, 0xcc, 0x0b, 0xbf, 0x60,
+    0xf0, 0xfe, 0xd0, 0xc8, 0xd2, 0x38, 0x7e, 0xce, 0x6e, 0x32, 0xc6, 0xf2, 0x7d, 0xa7, 0xdb, 0xe9,
+    0xb6, 0x1a, 0x93, 0xa8, 0x08, 0x46, 0x76, 0xd3, 0xcc, 0xbf, 0xb3, 0x1b, 0x8a, 0x51, 0x96, 0x16,
+    0x45, 0xcc, 0xde, 0xb2, 0x2c, 0x60, 0x49, 0x21, 0x5a, 0xb3, 0xe0, 0xbc, 0x42, 0x2d, 0x0b, 0xde,
+    0x56, 0xe9, 0xf9, 0xd9, 0x98, 0x85, 0xfb, 0xce, 0xd0, 0x8f, 0x73, 0xd6, 0x6a, 0xb0, 0x2c, 0x4b,
+    0xb3, 0x1a, 0x28, 0x6a, 0xaf, 0x52, 0x1c, 0xa7, 0x45, 0x9a, 0xf5, 0x8e, 0xd3, 0xf1, 0xd8, 0x4f,
+    0x42, 0xb3, 0xad, 0x5f, 0xd3, 0xb6, 0x55, 0xd3, 0xb6, 0x5d, 0xd3, 0xb6, 0x53, 0xd3, 0xb6, 0x6b,
+    0xb7, 0xe5, 0x45, 0x14, 0xdc, 0xbe, 0x02, 0xb9, 0x25, 0xc1, 0xec, 0x8c, 0x33, 0xd3, 0x98, 0x73,
+    0x71, 0x06, 0x69, 0x32, 0x8c, 0x6e, 0x48, 0x9e, 0xc9, 0x74, 0x7c, 0x86, 0xc8, 0x08, 0x60, 0x77,
+    0x3f, 0x67, 0x43, 0x7f, 0x1a, 0x17, 0xf9, 0x23, 0x60, 0x17, 0xc1, 0x88, 0x8d, 0x7d, 0x04, 0xb2,
+    0x9a, 0x7f, 0x61, 0x09, 0xcb, 0xfc, 0x22, 0x4a, 0x13, 0xe8, 0xea, 0x1e, 0x34, 0xa0, 0x35, 0x2f,
+    0x9c, 0xcc, 0x0f, 0xfb, 0x21, 0xc3, 0x91, 0x7b, 0x7b, 0x5d, 0x67, 0xd3, 0x39, 0xf3, 0x8b, 0x51,
+    0xe7, 0xed, 0x29, 0x74, 0xc7, 0x7e, 0x9e, 0x3b, 0x27, 0xf1, 0xec, 0x22, 0x0d, 0x6e, 0x81, 0xc8,
+    0x03, 0x47, 0xc8, 0xa6, 0x01, 0x0c, 0xea, 0x35, 0xe1, 0xbd, 0x18, 0x45, 0x79, 0xe7, 0x0e, 0xb9,
+    0x49, 0xa6, 0x71, 0x7c, 0x20, 0xdf, 0x8f, 0xd3, 0x24, 0x61, 0x41, 0xc1, 0x42, 0xe8, 0xa0, 0xf5,
+    0x39, 0x68, 0xcc, 0x61, 0xea, 0x7e, 0x56, 0x94, 0xb1, 0xd8, 0x9d, 0xf3, 0x2b, 0xbb, 0xe6, 0xf4,
+    0xbd, 0xab, 0xbb, 0x7c, 0x7f, 0x73, 0x73, 0xed, 0xc1, 0xd0, 0xb6, 0xdf, 0x7f, 0x77, 0xe2, 0x34,
+    0x20, 0x96, 0x3b, 0xa3, 0x34, 0x2f, 0xe6, 0x9b, 0x77, 0xf9, 0x55, 0x73, 0xd9, 0x40, 0xa2, 0xa7,
+    0x93, 0x26, 0xe9, 0x84, 0xe1, 0x3c, 0x61, 0xc8, 0xa3, 0x81, 0xe0, 0x3d, 0x8d, 0x59, 0x27, 0x4e,
+    0x6f, 0x3c, 0x57, 0x0d, 0x8a, 0x92, 0xe1, 0x24, 0xdc, 0x7a, 0xb2, 0x30, 0x5d, 0x83, 0x6a, 0xce,
+    0x92, 0xd0, 0x73, 0xb9, 0x34, 0x11, 0x61, 0x6e, 0x0e, 0x38, 0x66, 0x79, 0xee, 0xdf, 0xa0, 0x49,
+    0x78, 0xec, 0x0b, 0x68, 0xb4, 0x31, 0x70, 0xe1, 0x84, 0x7e, 0x81, 0x0b, 0xf2, 0x1f, 0x17, 0x6f,
+    0x5e, 0x77, 0x26, 0x7e, 0x96, 0x33, 0x0e, 0xd3, 0xc1, 0x76, 0x20, 0x14, 0x0d, 0x1d, 0x0f, 0x1f,
+    0x3b, 0xc5, 0x6c, 0x02, 0x14, 0x8e, 0xc0, 0xcc, 0xc8, 0xbe, 0x5c, 0x14, 0x18, 0x3d, 0x75, 0x0c,
+    0x2b, 0x03, 0x42, 0x04, 0x3c, 0xce, 0x9c, 0x75, 0xb9, 0x7e, 0x07, 0x02, 0xcc, 0x34, 0x3d, 0x05,
+    0x37, 0xa9, 0xc2, 0x69, 0x7b, 0x54, 0x50, 0xb3, 0x2a, 0x94, 0x65, 0x8e, 0x12, 0x30, 0xcb, 0xea,
+    0x00, 0xdf, 0xd6, 0x0c, 0x9c, 0xd5, 0x0c, 0x5c, 0xb2, 0x7b, 0x05, 0x5a, 0x00, 0x68, 0xaf, 0x0b,
+    0x16, 0x21, 0x01, 0x87, 0x71, 0x74, 0x33, 0x2a, 0x2e, 0xe0, 0x79, 0xaa, 0x08, 0x0e, 0x73, 0xd9,
+    0x3b, 0xf2, 0xb3, 0xf0, 0xce, 0xcf, 0xd8, 0x49, 0xec, 0xdf, 0xa8, 0xee, 0xd1, 0x50, 0x76, 0x57,
+    0x1c, 0x82, 0x04, 0x61, 0x35, 0x2c, 0x95, 0xbd, 0x84, 0x82, 0xad, 0x99, 0xa8, 0xe5, 0x3a, 0x94,
+    0xe8, 0x7a, 0x56, 0x77, 0xbf, 0xdc, 0xdd, 0xb7, 0xba, 0xb7, 0xca, 0xdd, 0x5b, 0x56, 0xf7, 0x76,
+    0xb9, 0x7b, 0xdb, 0xea, 0xde, 0x29, 0x77, 0xef, 0x58, 0xdd, 0xbb, 0xe5, 0xee, 0x5d, 0xd9, 0x6d,
+    0x3b, 0x1f, 0xd9, 0x9f, 0xc7, 0x60, 0xf3, 0x20, 0x77, 0x12, 0x7c, 0x98, 0xf9, 0x77, 0x3f, 0xc7,
+    0xb1, 0x87, 0xaa, 0xdd, 0x60, 0x60, 0x50, 0x4e, 0x8d, 0x62, 0x82, 0x05, 0x91, 0x5a, 0x5a, 0x16,
+    0x75, 0x42, 0x46, 0xbb, 0xef, 0xb8, 0xce, 0x86, 0x18, 0x77, 0x29, 0x8d, 0xb4, 0xf0, 0x2b, 0x34,
+    0xae, 0x4e, 0xa2, 0x6c, 0x8c, 0x4b, 0xea, 0x4c, 0x27, 0x21, 0xc6, 0x96, 0xb5, 0x07, 0xce, 0x21,
+    0x72, 0x3f, 0xdf, 0x97, 0xaf, 0x77, 0x59, 0x54, 0xc0, 0x1c, 0xe6, 0x9b, 0xb2, 0x3b, 0xfa, 0x07,
+    0x9b, 0x3b, 0xd7, 0xb3, 0x02, 0xd6, 0x4d, 0xf4, 0x5d, 0x35, 0x36, 0xc4, 0x88, 0xb4, 0xb2, 0xce,
+    0x53, 0xe7, 0xca, 0xf1, 0x04, 0x38, 0xb5, 0xcc, 0x9b, 0x57, 0x0e, 0xf0, 0xea, 0x36, 0x97, 0x32,
+    0x19, 0x0c, 0xf9, 0x44, 0x55, 0xd7, 0x8d, 0x33, 0xa8, 0xb8, 0x52, 0x04, 0x78, 0x73, 0xfd, 0x1b,
+    0xf8, 0x8b, 0x0e, 0xb8, 0xcb, 0xe8, 0x26, 0xf1, 0x38, 0x44, 0x8b, 0x8b, 0x21, 0x68, 0x92, 0x9f,
+    0x2d, 0x7b, 0x5f, 0x4e, 0x4e, 0x76, 0x1d, 0x8f, 0xfc, 0xe4, 0x86, 0x85, 0x5c, 0xec, 0x4b, 0xf9,
+    0xc9, 0xa7, 0xd7, 0xab, 0xb1, 0x34, 0x64, 0xa0, 0xfa, 0xc7, 0xd4, 0xe1, 0x35, 0xc1, 0xe6, 0x98,
+    0xe4, 0x4b, 0x8c, 0x25, 0x86, 0xb2, 0x1c, 0x58, 0x10, 0xa7, 0x39, 0x33, 0x5c, 0xe6, 0x62, 0x2f,
+    0xbb, 0xc8, 0x99, 0x22, 0x81, 0xb0, 0xe2, 0x18, 0xf9, 0x22, 0xa0, 0x5b, 0xc4, 0x87, 0xe5, 0xfe,
+    0x98, 0x40, 0xb8, 0x1a, 0x71, 0x68, 0xa2, 0x05, 0xe1, 0x03, 0x3d, 0xaf, 0xf0, 0xb0, 0x52, 0x00,
+    0x65, 0xfe, 0x8c, 0xe0, 0xd2, 0xb1, 0xe0, 0x81, 0x80, 0x43, 0x42, 0x7d, 0xe0, 0x93, 0xa6, 0x98,
+    0x38, 0x54, 0x81, 0x8d, 0x07, 0x22, 0x15, 0xe8, 0x70, 0x19, 0x86, 0xd3, 0x24, 0xa0, 0xa5, 0x42,
+    0x3a, 0xc2, 0xa2, 0xbc, 0xa6, 0xf2, 0xe6, 0x81, 0xb6, 0xb1, 0x34, 0x98, 0x8e, 0xd1, 0x91, 0xdf,
+    0xb0, 0xe2, 0x45, 0xcc, 0xf0, 0xf1, 0xd9, 0xec, 0x94, 0x82, 0x04, 0x81, 0xb8, 0xcd, 0xce, 0x17,
+    0x3f, 0xc6, 0x18, 0xa2, 0xc6, 0x53, 0x51, 0x84, 0xd3, 0xc0, 0xa9, 0x8a, 0x67, 0x5a, 0x14, 0x35,
+    0x34, 0x50, 0x44, 0xe7, 0xc7, 0x68, 0xdc, 0x32, 0xb6, 0x88, 0x0e, 0x16, 0x82, 0xb2, 0x5e, 0xc5,
+    0xe7, 0xda, 0x68, 0xba, 0x94, 0x49, 0xe8, 0x76, 0x45, 0xf4, 0xf9, 0x0e, 0x61, 0x9b, 0x4e, 0xc6,
+    0x8a, 0x69, 0x96, 0xc8, 0xdc, 0x20, 0x28, 0xee, 0x01, 0x1d, 0x7b, 0x10, 0x15, 0x04, 0x5d, 0xb0,
+    0xfb, 0xc2, 0x73, 0xfb, 0x84, 0xc5, 0x41, 0xee, 0xa2, 0xb0, 0x18, 0x49, 0x20, 0x7a, 0x91, 0x3d,
+    0x23, 0x86, 0xfe, 0x5b, 0x76, 0xf1, 0x37, 0xee, 0x62, 0x5e, 0xbe, 0x7f, 0xee, 0x01, 0xe9, 0x96,
+    0xd3, 0xa5, 0xbf, 0x84, 0xd5, 0x12, 0xf0, 0xd5, 0x29, 0x29, 0x68, 0xf8, 0x3b, 0x2b, 0x43, 0xab,
+    0xa9, 0x0e, 0x53, 0x8a, 0x25, 0x6e, 0xee, 0x27, 0x79, 0x3b, 0x67, 0x59, 0x34, 0x84, 0x3c, 0x15,
+    0xd0, 0x3a, 0xa2, 0xe3, 0xaa, 0xb7, 0x3b, 0xb9, 0x07, 0x1f, 0x82, 0xaf, 0xf3, 0x2b, 0x35, 0x41,
+    0x9c, 0xdf, 0x3d, 0xac, 0x00, 0x9f, 0xc6, 0xa6, 0xd3, 0x57, 0x3d, 0x33, 0xe8, 0x99, 0x41, 0x8f,
+    0x98, 0x06, 0xef, 0x02, 0x7a, 0x41, 0xcc, 0xfc, 0xec, 0x1c, 0x14, 0xce, 0xab, 0xe7, 0x5e, 0x64,
+    0x55, 0x48, 0x98, 0x52, 0xa9, 0xb1, 0x7f, 0xef, 0x95, 0x78, 0xc6, 0x40, 0xa7, 0x00, 0x67, 0x4b,
+    0x01, 0xc5, 0xa0, 0xb9, 0xff, 0x85, 0xa1, 0x5e, 0xe2, 0x73, 0x91, 0xc1, 0x14, 0x63, 0x54, 0x8c,
+    0x00, 0x24, 0x12, 0xcc, 0x44, 0x33, 0x44, 0x55, 0x6c, 0x6b, 0x57, 0xb3, 0x85, 0x75, 0x99, 0xd3,
+    0xa1, 0xa7, 0xdf, 0xeb, 0x56, 0xc8, 0xb4, 0x91, 0x4e, 0x9b, 0x13, 0x22, 0x9e, 0x28, 0x87, 0x78,
+    0x7b, 0x0f, 0x11, 0xfa, 0x39, 0x25, 0x86, 0x9e, 0x96, 0x41, 0x13, 0xfe, 0xd9, 0xda, 0xb1, 0x00,
+    0xdf, 0x0c, 0x87, 0x39, 0x59, 0x51, 0x4d, 0x02, 0xb2, 0x6e, 0xd3, 0x2a, 0x8f, 0x0c, 0xe2, 0x33,
+    0x48, 0xa8, 0xf1, 0xf3, 0xdb, 0xd9, 0x2f, 0x10, 0x76, 0x23, 0x9e, 0x1e, 0x90, 0xd0, 0x33, 0x06,
+    0xf0, 0xaf, 0xa2, 0x04, 0x64, 0x2f, 0xbb, 0xc4, 0xf4, 0x9d, 0xb6, 0x10, 0xd7, 0x66, 0x1f, 0x5e,
+    0xa5, 0x44, 0x0c, 0x12, 0x1d, 0x3f, 0x04, 0x13, 0x8e, 0xd3, 0xec, 0xa2, 0x48, 0x27, 0x38, 0xa4,
+    0xfb, 0xfd, 0xd6, 0xde, 0xee, 0x4f, 0x27, 0x7b, 0xee, 0x32, 0xb8, 0x1e, 0xc2, 0xfd, 0xb8, 0xfb,
+    0x62, 0xf7, 0xe4, 0xb9, 0x2b, 0x24, 0x36, 0x8c, 0xe2, 0xf8, 0xa2, 0x98, 0xc5, 0xe8, 0x23, 0x0d,
+    0x3c, 0xdd, 0x49, 0x5a, 0x11, 0xdc, 0xb7, 0xb3, 0x7b, 0xe2, 0x65, 0xd6, 0xce, 0x40, 0x5f, 0x33,
+    0x60, 0x29, 0xd3, 0xb2, 0xbd, 0xc9, 0xd2, 0x69, 0x12, 0xae, 0x3e, 0x3d, 0x39, 0x27, 0xa5, 0x89,
+    0x9b, 0x7d, 0xa0, 0x65, 0x53, 0xa9, 0x99, 0xe1, 0xf1, 0xde, 0xde, 0xf1, 0x56, 0xd7, 0x7d, 0x04,
+    0x94, 0x26, 0xf9, 0xd3, 0xde, 0xf6, 0x76, 0x7f, 0xaf, 0x6e, 0x92, 0x36, 0xea, 0xe2, 0x79, 0x9a,
+    0x93, 0x44, 0x65, 0x2d, 0xb2, 0xf4, 0x96, 0x49, 0x22, 0xee, 0xf7, 0x27, 0xf4, 0x47, 0x98, 0x63,
+    0x0c, 0x93, 0xfc, 0x55, 0xf8, 0x0c, 0xa1, 0xdc, 0xd7, 0xec, 0x26, 0x4a, 0xde, 0x82, 0x8a, 0x4a,
+    0x0d, 0x1f, 0xa7, 0x5f, 0xd8, 0xbb, 0x14, 0x46, 0x80, 0xb5, 0x05, 0x43, 0x02, 0xb5, 0x33, 0xf4,
+    0x1c, 0x09, 0xf0, 0xce, 0x8d, 0x6a, 0x27, 0x1f, 0xba, 0x6a, 0x29, 0x20, 0x93, 0x76, 0x49, 0xd3,
+    0x4a, 0xbc, 0xf4, 0x2c, 0x9d, 0xc6, 0xa5, 0x78, 0x45, 0xf5, 0x03, 0x77, 0x0c, 0xeb, 0x50, 0xaa,
+    0xf5, 0x41, 0xed, 0x87, 0x10, 0xc8, 0x3c, 0x8c, 0x1e, 0x11, 0x74, 0xb5, 0x77, 0xba, 0x07, 0xf0,
+    0x70, 0x78, 0xe4, 0xf0, 0x87, 0x0d, 0x78, 0xd0, 0x0e, 0x89, 0xe8, 0x5c, 0xe2, 0x02, 0xe3, 0xda,
+    0xd9, 0x26, 0xb5, 0xee, 0x44, 0x72, 0x38, 0x3f, 0x9e, 0x8c, 0xb0, 0x32, 0xe8, 0x75, 0xba, 0x30,
+    0x5b, 0xe5, 0x08, 0xb0, 0x5c, 0x14, 0x6f, 0x51, 0xe2, 0xf5, 0xd4, 0x9b, 0x7f, 0x9d, 0x7b, 0x35,
+    0x76, 0xd6, 0x76, 0x22, 0xb2, 0xcc, 0x6e, 0xb3, 0x7e, 0x0d, 0xb2, 0x9b, 0x6b, 0xdf, 0xeb, 0xef,
+    0xec, 0xb4, 0x1c, 0xfd, 0x0f, 0x06, 0x1e, 0x3e, 0xfa, 0x86, 0xe3, 0x36, 0xdd, 0xea, 0xf2, 0xaf,
+    0x8e, 0x65, 0xad, 0x20, 0x8a, 0x27, 0xe6, 0xb5, 0x57, 0xe4, 0xfc, 0x05, 0x5c, 0x1d, 0x65, 0x2f,
+    0xdd, 0x26, 0xa4, 0x61, 0x96, 0x6c, 0xf7, 0xed, 0x57, 0x14, 0xf1, 0x4e, 0x75, 0xfd, 0x91, 0x12,
+    0xad, 0x31, 0x97, 0x67, 0x8d, 0x12, 0xd4, 0x43, 0x68, 0x4d, 0xc0, 0xe8, 0x66, 0x33, 0xf2, 0xa0,
+    0xa6, 0xfa, 0x0e, 0xe3, 0x59, 0x84, 0x53, 0xf9, 0x9f, 0xff, 0x76, 0xd1, 0xd4, 0x34, 0x3d, 0x78,
+    0xda, 0x91, 0x34, 0xf1, 0x59, 0x64, 0x4c, 0xe4, 0x6a, 0x59, 0x0e, 0x99, 0x36, 0x57, 0x33, 0x5a,
+    0x44, 0x28, 0xa6, 0x5e, 0xca, 0x68, 0x27, 0x7c, 0x25, 0x4e, 0xa7, 0xfb, 0xe3, 0x8e, 0x1d, 0x83,
+    0xd6, 0x1e, 0x14, 0xe4, 0x3a, 0xcc, 0x76, 0x5e, 0x13, 0x91, 0x00, 0xc0, 0xf4, 0xbc, 0x2a, 0x2e,
+    0xe1, 0xf2, 0x6e, 0xef, 0x18, 0x50, 0x90, 0x95, 0x4c, 0xb0, 0x40, 0x07, 0x3d, 0x2c, 0x57, 0x74,
+    0x06, 0x94, 0x72, 0xce, 0x24, 0x4c, 0xcf, 0xc0, 0x5b, 0x37, 0x87, 0x32, 0x67, 0x72, 0x16, 0x25,
+    0x7c, 0x70, 0x52, 0xb8, 0x61, 0x9c, 0x42, 0xb5, 0x6f, 0x22, 0xb6, 0x9d, 0x5e, 0xaf, 0xdb, 0xa4,
+    0xaa, 0x41, 0x85, 0xb2, 0x5a, 0xcd, 0xe9, 0xca, 0x00, 0x0f, 0x53, 0x35, 0xf5, 0xab, 0x1a, 0x3c,
+    0x95, 0x54, 0x9a, 0x25, 0x13, 0x53, 0xec, 0x08, 0x43, 0xd3, 0xec, 0x6d, 0x38, 0xfd, 0xbe, 0xb4,
+    0xba, 0xbe, 0xb6, 0x3a, 0x00, 0xf8, 0xc0, 0xf1, 0x4c, 0x63, 0x03, 0x68, 0x25, 0x0b, 0x39, 0xd3,
+    0x30, 0xca, 0x0b, 0x39, 0x49, 0xb4, 0xaa, 0x08, 0x26, 0xa6, 0x67, 0xd9, 0xfc, 0x7a, 0xfb, 0x24,
+    0x82, 0xb8, 0x48, 0xff, 0x1e, 0x1b, 0x34, 0x9d, 0x59, 0xc5, 0xf0, 0xb6, 0xc0, 0xda, 0x1e, 0xf1,
+    0xb6, 0x28, 0x39, 0x58, 0x13, 0xdb, 0xc0, 0x78, 0x63, 0x85, 0x9c, 0xa5, 0xc5, 0x40, 0xda, 0x7c,
+    0xef, 0xef, 0xac, 0x64, 0x81, 0xb8, 0xc2, 0x20, 0xb1, 0x49, 0xec, 0xcf, 0x4e, 0x81, 0x63, 0xf0,
+    0x87, 0x77, 0xa3, 0x08, 0xa6, 0xec, 0xa9, 0xc6, 0x43, 0x0e, 0xa8, 0xde, 0x61, 0xa1, 0xb7, 0x76,
+    0xbb, 0x68, 0x85, 0x65, 0xc8, 0x01, 0xf5, 0x58, 0xc0, 0x6d, 0x05, 0x8c, 0x03, 0x61, 0xda, 0x8a,
+    0x79, 0xb0, 0x22, 0x45, 0xf6, 0x2e, 0xb6, 0x5d, 0x14, 0x13, 0xc8, 0x1a, 0x6e, 0x39, 0x59, 0x2d,
+    0x82, 0xb0, 0xa0, 0xe0, 0xbe, 0x76, 0xed, 0x8a, 0xd1, 0x04, 0xdd, 0xde, 0xb1, 0x20, 0x5f, 0x2c,
+    0x01, 0xfd, 0xc9, 0x22, 0xba, 0x0c, 0xb2, 0xb7, 0x65, 0x51, 0xbd, 0x58, 0x0a, 0xbb, 0x67, 0x91,
+    0xbd, 0x58, 0x02, 0xda, 0xef, 0xdb, 0x64, 0x7f, 0x5d, 0x06, 0xfb, 0xa3, 0x45, 0x76, 0x19, 0xe8,
+    0x56, 0xcf, 0x96, 0x01, 0x87, 0xe5, 0x96, 0x84, 0x8d, 0x52, 0x41, 0x49, 0xef, 0x98, 0x9f, 0x4f,
+    0x33, 0x46, 0x2e, 0x18, 0xfb, 0x9a, 0xaa, 0x7c, 0x30, 0x9d, 0x33, 0xf6, 0xb4, 0xb8, 0x59, 0xb7,
+    0x0d, 0x12, 0xe4, 0xf0, 0xb5, 0xdb, 0x6d, 0x2b, 0xff, 0x5c, 0xd2, 0x2b, 0x6d, 0xd1, 0x7f, 0x9a,
+    0x82, 0x29, 0xc7, 0xf3, 0xce, 0xd6, 0xb2, 0x4e, 0x91, 0x9e, 0x44, 0xf7, 0x50, 0xd6, 0x03, 0xa2,
+    0x54, 0x38, 0x0b, 0xf6, 0x22, 0xfa, 0x07, 0xab, 0x91, 0x85, 0xe8, 0x6d, 0x96, 0xa0, 0xa5, 0xe8,
+    0x0c, 0xe4, 0xb2, 0xc0, 0x16, 0xb8, 0x5f, 0xf0, 0x4e, 0x15, 0xf7, 0x4b, 0xe1, 0xc0, 0xa2, 0x8c,
+    0x21, 0xaf, 0x8d, 0x21, 0xcf, 0x94, 0x6a, 0xaf, 0xab, 0xc1, 0x68, 0x44, 0x3f, 0x28, 0xa6, 0x7e,
+    0xfc, 0x0c, 0xf3, 0xc2, 0x28, 0xb9, 0x79, 0x96, 0xde, 0xff, 0x9c, 0xe3, 0x2e, 0x5e, 0xcb, 0xa6,
+    0xb5, 0x01, 0x88, 0xad, 0x55, 0xf0, 0x08, 0xb2, 0x26, 0xf3, 0x2c, 0x25, 0x8d, 0x4a, 0x1b, 0x04,
+    0xc9, 0x96, 0x53, 0xcb, 0x7f, 0x55, 0x23, 0x56, 0x74, 0xc3, 0xbd, 0x3a, 0x27, 0xda, 0x5b, 0xee,
+    0x2f, 0xef, 0xed, 0xb0, 0x65, 0x38, 0x4d, 0x55, 0x4f, 0x56, 0x21, 0xec, 0xfc, 0xf4, 0xeb, 0xab,
+    0x3a, 0x6b, 0x3b, 0xf6, 0xab, 0xeb, 0x3a, 0xb1, 0x49, 0x5b, 0x2a, 0xd8, 0x4a, 0x5b, 0xb7, 0x8f,
+    0x97, 0x6c, 0x16, 0x19, 0x45, 0x5c, 0xec, 0x61, 0xbc, 0x1b, 0x45, 0xc1, 0x6d, 0xc2, 0x28, 0x31,
+    0xd1, 0x55, 0xae, 0xe8, 0x94, 0xa2, 0xd5, 0x49, 0x75, 0xef, 0xc7, 0x9d, 0x12, 0xcc, 0x2f, 0xfe,
+    0xc4, 0x82, 0xd0, 0x49, 0x94, 0xad, 0x1f, 0xc7, 0x27, 0x27, 0xdb, 0x3f, 0xb9, 0xf5, 0x15, 0x47,
+    0x97, 0xfe, 0xd4, 0xac, 0x29, 0x4f, 0x31, 0x79, 0x60, 0x0f, 0xc3, 0x73, 0x56, 0x44, 0x01, 0xa1,
+    0x78, 0x19, 0x1b, 0xc6, 0x2c, 0xe0, 0xbb, 0x67, 0x7c, 0x7f, 0x6a, 0x79, 0x61, 0x02, 0xb5, 0x87,
+    0xc2, 0x58, 0xf7, 0x34, 0xeb, 0x4d, 0x51, 0x92, 0x96, 0xa5, 0x41, 0x55, 0x5b, 0xa5, 0x7c, 0xa9,
+    0x25, 0xa1, 0xf7, 0x83, 0x88, 0xeb, 0x3f, 0x8b, 0xe2, 0xc6, 0x1f, 0x43, 0x51, 0x61, 0xff, 0xab,
+    0xa9, 0xd6, 0x01, 0xaf, 0x3a, 0xd0, 0xb7, 0x50, 0xa5, 0xcd, 0x4d, 0xa9, 0x0c, 0x73, 0x23, 0x4f,
+    0xd5, 0x43, 0x60, 0x2e, 0xde, 0x3b, 0x30, 0x1b, 0x0e, 0xd1, 0x8d, 0x98, 0x0d, 0x32, 0x5b, 0xd5,
+    0xda, 0x67, 0xaa, 0x9e, 0xd0, 0xe6, 0x91, 0x1f, 0xa6, 0x22, 0x5b, 0xfd, 0x20, 0x8e, 0xea, 0x4a,
+    0xcd, 0x97, 0xe5, 0xe6, 0x67, 0xf1, 0x34, 0x93, 0x16, 0xa7, 0x1a, 0xa9, 0xd0, 0xaf, 0x4b, 0xc7,
+    0xfb, 0x56, 0x3e, 0x8e, 0x13, 0x7a, 0x9c, 0x9f, 0x45, 0xc4, 0x9a, 0x6e, 0xd9, 0xb5, 0xcd, 0xff,
+    0x2d, 0xb3, 0xd0, 0x61, 0xad, 0xe2, 0x89, 0xc4, 0x1e, 0xc1, 0xe2, 0xae, 0x52, 0x6b, 0x6b, 0x91,
+    0x0e, 0x7c, 0x8d, 0x24, 0xfe, 0x15, 0xfc, 0x54, 0x0a, 0xd1, 0x30, 0x4b, 0x13, 0x26, 0xf2, 0x0a,
+    0xa3, 0x10, 0xed, 0xef, 0x58, 0x00, 0x1f, 0xac, 0x4d, 0xcf, 0xb6, 0xc6, 0xb2, 0xa0, 0x2e, 0xed,
+    0x0d, 0x50, 0x0b, 0x0c, 0xf7, 0x65, 0x9f, 0xe3, 0x2b, 0xdf, 0x99, 0xe5, 0x54, 0xc5, 0xff, 0x97,
+    0x2d, 0x0d, 0x69, 0x3c, 0xd6, 0x46, 0x79, 0xcb, 0x51, 0xcb, 0x2d, 0x5c, 0xda, 0xa9, 0xad, 0xee,
+    0xe3, 0xca, 0x1c, 0xc0, 0xa5, 0xe8, 0xc3, 0xcf, 0x08, 0xaa, 0x5b, 0x21, 0x2a, 0xeb, 0xea, 0x35,
+    0x55, 0x59, 0x8f, 0xc9, 0xc8, 0xae, 0x99, 0x66, 0x70, 0x3a, 0x18, 0x4b, 0x4d, 0x32, 0xc6, 0x9e,
+    0xe9, 0x22, 0x2a, 0x7b, 0x55, 0x2a, 0x2f, 0xe8, 0x74, 0xa3, 0xc2, 0x53, 0xe5, 0x00, 0x72, 0x11,
+    0xc9, 0x5e, 0x77, 0x11, 0xcd, 0x32, 0x7f, 0xe5, 0x63, 0xca, 0x85, 0x14, 0xfb, 0x55, 0x8a, 0xef,
+    0xc4, 0xa9, 0xab, 0x49, 0xaf, 0x74, 0x12, 0x5b, 0x22, 0xf7, 0x17, 0x49, 0x6d, 0xbb, 0x4a, 0xed,
+    0x84, 0x8e, 0x66, 0x1d, 0x7e, 0x36, 0xcb, 0x49, 0x9a, 0xa7, 0xb5, 0xef, 0xd2, 0x8b, 0x22, 0x83,
+    0x34, 0xcf, 0xab, 0x1e, 0xe4, 0x36, 0x05, 0xd1, 0x9a, 0xe5, 0x78, 0x29, 0x4e, 0x74, 0x1d, 0x3a,
+    0xd2, 0xe5, 0x54, 0xad, 0x53, 0xde, 0x12, 0x59, 0xab, 0x4f, 0xd2, 0x5d, 0xb4, 0x40, 0x9c, 0xdc,
+    0x0d, 0x2b, 0x38, 0xeb, 0xd4, 0x76, 0xc6, 0x8f, 0x87, 0x3c, 0x81, 0xdb, 0xaf, 0x59, 0x88, 0x0b,
+    0x3c, 0x33, 0x75, 0xc4, 0xa1, 0xa9, 0x29, 0x3b, 0xfb, 0x30, 0x55, 0x89, 0xae, 0x4f, 0xa2, 0x73,
+    0xc6, 0xb9, 0x10, 0x5e, 0x9f, 0x96, 0x42, 0xd6, 0x08, 0x27, 0x17, 0x9f, 0x9f, 0x47, 0x39, 0xdd,
+    0x5c, 0x31, 0x6f, 0x60, 0x40, 0xf3, 0xcf, 0xd9, 0x18, 0x26, 0x66, 0x6e, 0x43, 0xaa, 0xc6, 0x5f,
+    0xfd, 0xa8, 0x80, 0xff, 0x4e, 0xd2, 0xec, 0x75, 0x7a, 0x9a, 0x4c, 0xa6, 0x85, 0xd8, 0x38, 0x95,
+    0x50, 0x27, 0xf1, 0x8c, 0xa3, 0x6e, 0x1d, 0x94, 0x87, 0xe1, 0xed, 0xdb, 0x75, 0xed, 0x75, 0x54,
+    0x77, 0x4c, 0xaa, 0x7e, 0x14, 0xe7, 0xfe, 0x10, 0xad, 0x74, 0xd7, 0x38, 0x0e, 0x5b, 0xb8, 0xca,
+    0xb0, 0xb2, 0x78, 0x53, 0xe1, 0x0e, 0x15, 0xde, 0x31, 0x5a, 0x02, 0x1f, 0xca, 0x44, 0x63, 0xde,
+    0xfb, 0x0d, 0x7e, 0xc2, 0xe4, 0xb8, 0xb2, 0x05, 0xcd, 0x5b, 0x00, 0xf1, 0x09, 0x6b, 0x10, 0xfe,
+    0x5e, 0x01, 0xa8, 0xf0, 0x5e, 0xc6, 0xa8, 0x00, 0x18, 0x24, 0xb8, 0xb8, 0x34, 0x06, 0x7f, 0x37,
+    0x00, 0x94, 0x88, 0xca, 0xac, 0x2e, 0x00, 0x5b, 0xc2, 0xcd, 0x62, 0x18, 0x93, 0x21, 0x21, 0x69,
+    0x83, 0x25, 0xd1, 0x02, 0x40, 0x21, 0xbf, 0xf0, 0xa3, 0xfb, 0xde, 0x27, 0xb7, 0x49, 0x7a, 0x97,
+    0xb8, 0x62, 0x33, 0x92, 0x96, 0xeb, 0xe5, 0xc9, 0xe7, 0xb3, 0xb7, 0xef, 0x3f, 0xbf, 0xf9, 0x2b,
+    0xea, 0x8f, 0x73, 0x78, 0xa8, 0x35, 0x0b, 0x7a, 0xce, 0x8f, 0x8d, 0x8e, 0x9e, 0xb1, 0x94, 0xf5,
+    0xa6, 0x35, 0x24, 0x63, 0x12, 0xfb, 0x33, 0x13, 0x3f, 0xa3, 0xbb, 0x46, 0x1f, 0x3f, 0xa9, 0x0a,
+    0x82, 0x4d, 0xd2, 0x0c, 0x75, 0xc5, 0x1b, 0xb6, 0x1c, 0x99, 0x2a, 0xe3, 0x2e, 0x00, 0xe1, 0x39,
+    0x4f, 0x9c, 0x21, 0xe2, 0x12, 0x5e, 0x67, 0x32, 0xcd, 0x47, 0x9e, 0xbb, 0x81, 0x36, 0x93, 0xe8,
+    0x73, 0x76, 0xbb, 0xb7, 0xad, 0x7b, 0x21, 0xa5, 0xe2, 0xd4, 0x3d, 0xc9, 0x75, 0xcb, 0x71, 0xcf,
+    0x8f, 0xf1, 0x5c, 0x42, 0xb7, 0xf3, 0x79, 0x42, 0x07, 0x3c, 0xf0, 0x1e, 0x12, 0x0b, 0x27, 0xf9,
+    0x5b, 0x1a, 0x25, 0x1e, 0x18, 0x9e, 0x5b, 0x39, 0x47, 0xad, 0x33, 0x7a, 0xb5, 0x65, 0x38, 0x1a,
+    0xaa, 0x52, 0xc8, 0x92, 0x09, 0xdf, 0x1e, 0xaa, 0xbb, 0x8b, 0x72, 0x74, 0x64, 0x2e, 0x1c, 0x52,
+    0x92, 0xcb, 0x73, 0x7e, 0xec, 0xbc, 0x4a, 0x73, 0x0c, 0x96, 0xca, 0x80, 0x9e, 0x33, 0xaa, 0x74,
+    0x69, 0xc5, 0xe8, 0xa0, 0xd5, 0x83, 0x01, 0x9f, 0xa8, 0xa5, 0x69, 0x9a, 0xe8, 0xaf, 0xdf, 0x38,
+    0x40, 0xe1, 0x22, 0xba, 0x49, 0xfc, 0xb8, 0x06, 0x81, 0xcf, 0xde, 0xc2, 0x80, 0x26, 0x1a, 0x6a,
+    0x9a, 0x31, 0x85, 0xb0, 0x98, 0x65, 0x69, 0x73, 0x26, 0x05, 0xc3, 0x0e, 0x1f, 0x43, 0xe7, 0xd6,
+    0x65, 0x22, 0x2b, 0x0b, 0x5d, 0x0d, 0xb5, 0x62, 0x07, 0x55, 0x5a, 0xce, 0x05, 0x08, 0xad, 0x98,
+    0xad, 0x3c, 0x99, 0x12, 0x43, 0xa6, 0xa9, 0xae, 0x4c, 0x60, 0x29, 0x5b, 0xda, 0x95, 0x1a, 0x9c,
+    0xc9, 0x4e, 0xb7, 0x72, 0x5a, 0x6d, 0x64, 0x45, 0x4b, 0xcf, 0xab, 0xc3, 0x68, 0xac, 0x0e, 0x7e,
+    0x41, 0x6d, 0xcb, 0xa7, 0xc8, 0x68, 0x7e, 0x63, 0xff, 0xfe, 0xc3, 0xd9, 0x19, 0x8f, 0x14, 0xe2,
+    0xfd, 0x52, 0xbe, 0x5b, 0xbb, 0xe4, 0x3d, 0xb1, 0x3b, 0xce, 0x6f, 0x78, 0x74, 0xd4, 0xc5, 0x40,
+    0x68, 0xde, 0xd8, 0xd0, 0x43, 0xde, 0x32, 0x3c, 0x6b, 0xbe, 0xa2, 0x6b, 0x42, 0x6b, 0x0f, 0x91,
+    0x3e, 0x73, 0xa0, 0x16, 0x3e, 0x14, 0x27, 0xf1, 0x11, 0x41, 0x21, 0x90, 0x75, 0xee, 0xdd, 0x4f,
+    0x16, 0x10, 0x1f, 0xbf, 0x5d, 0x82, 0x9a, 0x21, 0x94, 0xe2, 0x56, 0xed, 0x91, 0xf3, 0x16, 0xe3,
+    0xe0, 0x4a, 0x8e, 0x83, 0x1b, 0xe4, 0x6a, 0x32, 0x26, 0xf8, 0x65, 0x15, 0xfc, 0x92, 0x83, 0xf3,
+    0xb5, 0x14, 0x63, 0x1c, 0xe2, 0xc6, 0x01, 0xee, 0xd4, 0x0a, 0x22, 0xf4, 0xae, 0xd7, 0x4c, 0x07,
+    0x5c, 0xa2, 0x70, 0xee, 0x87, 0x11, 0xdd, 0x20, 0x33, 0x76, 0x1d, 0xd4, 0x61, 0x1f, 0xd4, 0x3d,
+    0x22, 0xf0, 0xee, 0xaa, 0x36, 0xdc, 0xf9, 0x38, 0x3b, 0xa3, 0x9a, 0xa5, 0xb3, 0x0d, 0xf0, 0x9e,
+    0xcc, 0x93, 0xfb, 0xeb, 0x02, 0x1e, 0x4f, 0x3f, 0x38, 0x2f, 0x25, 0xa4, 0x4b, 0x8d, 0xa4, 0xd2,
+    0xe6, 0x32, 0xd6, 0x65, 0x05, 0xcb, 0x54, 0x04, 0x39, 0x7a, 0x4b, 0x91, 0x54, 0xc9, 0x7d, 0x61,
+    0x6c, 0xad, 0x28, 0xa9, 0xf5, 0x5a, 0xa4, 0x4a, 0xb4, 0x53, 0xd2, 0x6f, 0xfe, 0x13, 0xf7, 0x1a,
+    0xcc, 0x6d, 0x12, 0x35, 0xd2, 0x8a, 0x07, 0x12, 0xdd, 0xce, 0x8f, 0xba, 0x16, 0x53, 0x67, 0x5d,
+    0x86, 0xf4, 0xe7, 0x56, 0x46, 0x7f, 0xf5, 0x6d, 0xfa, 0x4b, 0xf4, 0x9e, 0x47, 0x99, 0x56, 0x53,
+    0xad, 0xcb, 0x9d, 0x30, 0xca, 0x78, 0xd1, 0x7a, 0xa5, 0x34, 0xf6, 0x11, 0x7d, 0xaf, 0xd5, 0x76,
+    0xdc, 0xfe, 0x12, 0x8b, 0xb2, 0x01, 0x52, 0xb4, 0x95, 0xbf, 0x5e, 0xf5, 0x6d, 0x94, 0x99, 0x85,
+    0xa2, 0x2f, 0xe3, 0x91, 0x1b, 0xfa, 0x08, 0x52, 0x01, 0xcc, 0xb9, 0x68, 0x46, 0x56, 0x49, 0xad,
+    0x4d, 0xd0, 0x01, 0x6a, 0x90, 0x75, 0x48, 0x29, 0x45, 0x7f, 0x25, 0xeb, 0x4d, 0x2e, 0xf3, 0x96,
+    0x23, 0x44, 0x2c, 0x30, 0xe7, 0xcd, 0x2b, 0x23, 0xca, 0xd6, 0x23, 0x4b, 0x4c, 0x42, 0x6e, 0xd7,
+    0x60, 0xd7, 0x6e, 0x7b, 0xf9, 0x59, 0x20, 0x6c, 0xb7, 0x25, 0x24, 0xd1, 0x32, 0x4d, 0x8b, 0xc8,
+    0xf5, 0xf5, 0x76, 0x64, 0xd3, 0xde, 0x5a, 0xa8, 0x6e, 0xd0, 0xa9, 0x85, 0x1c, 0x38, 0x5d, 0xe7,
+    0x29, 0x96, 0x81, 0x27, 0x5d, 0x17, 0x2f, 0xe4, 0x7d, 0x7f, 0xa2, 0x8a, 0xc1, 0x3f, 0x88, 0x09,
+    0x63, 0xc3, 0x95, 0x56, 0x25, 0xf6, 0xaf, 0x59, 0x8c, 0xe2, 0x38, 0xb3, 0x34, 0xa2, 0x58, 0xbc,
+    0x1d, 0x4f, 0x18, 0xcd, 0x6f, 0x31, 0x04, 0x59, 0x45, 0x10, 0x85, 0x96, 0xd4, 0xba, 0xb6, 0x1a,
+    0xac, 0x73, 0xa7, 0x37, 0xae, 0x85, 0x82, 0x6d, 0xe8, 0xce, 0x45, 0x3b, 0xe6, 0x78, 0x16, 0x2c,
+    0xd9, 0xa6, 0xab, 0x65, 0x52, 0xa0, 0x62, 0x21, 0x8d, 0x5a, 0xc4, 0x02, 0x5b, 0x30, 0x3d, 0xea,
+    0xfb, 0xa7, 0xa6, 0x47, 0x14, 0x8c, 0xe9, 0xa9, 0xd1, 0x6a, 0xe7, 0x67, 0xba, 0xe4, 0x0d, 0xed,
+    0x68, 0xd6, 0x71, 0xe7, 0x4d, 0x63, 0x2e, 0x98, 0xbc, 0x38, 0xe3, 0x31, 0xca, 0x11, 0xbc, 0x75,
+    0x7a, 0x41, 0x57, 0xcb, 0xb3, 0x34, 0x2d, 0xc4, 0x4d, 0x39, 0xfd, 0xb1, 0x02, 0x36, 0x5a, 0x57,
+    0xef, 0xf8, 0x2d, 0xf4, 0x03, 0xfb, 0x7e, 0x64, 0xa3, 0x13, 0xf8, 0xf0, 0xea, 0x89, 0x8b, 0x8a,
+    0xe6, 0xf5, 0x44, 0x6a, 0x92, 0x05, 0x39, 0x21, 0x61, 0xb8, 0xe0, 0x4e, 0x60, 0x1f, 0x72, 0x4d,
+    0x75, 0x49, 0x51, 0x09, 0x7b, 0xc5, 0x3b, 0x77, 0xfa, 0xbe, 0x1c, 0x00, 0xef, 0x75, 0xbb, 0xa2,
+    0x45, 0x5d, 0x9a, 0xdb, 0x55, 0x4d, 0x39, 0xae, 0x88, 0x02, 0x75, 0x01, 0x76, 0x72, 0xef, 0x5a,
+    0x7d, 0x0a, 0xc9, 0xdd, 0x15, 0x9d, 0xc6, 0x45, 0xde, 0x9c, 0x15, 0xa7, 0x49, 0xc1, 0x32, 0x10,
+    0xae, 0x27, 0x6f, 0x76, 0xea, 0xab, 0x85, 0xc0, 0x39, 0x6d, 0x41, 0x74, 0x37, 0x7b, 0x66, 0xa5,
+    0xba, 0x46, 0xcb, 0xf4, 0xfe, 0x34, 0x17, 0x1f, 0x11, 0x28, 0x89, 0x5f, 0x4f, 0xa3, 0x38, 0xe4,
+    0x72, 0x7b, 0x7f, 0x6a, 0xde, 0x34, 0x54, 0xdf, 0x2f, 0x2c, 0xb9, 0x11, 0x29, 0xaf, 0xcd, 0x0b,
+    0xe0, 0x4e, 0x94, 0x24, 0x2c, 0x7b, 0xf9, 0xee, 0xec, 0x15, 0x1a, 0x64, 0xe3, 0x30, 0x8c, 0xbe,
+    0x0c, 0x0e, 0x03, 0x3f, 0xf9, 0xe2, 0xe7, 0x4e, 0x14, 0x1e, 0xb9, 0xb4, 0x75, 0x74, 0x4c, 0xef,
+    0x2e, 0x0f, 0x64, 0x47, 0xee, 0x36, 0x38, 0x08, 0x11, 0xba, 0xf8, 0xcb, 0xe0, 0x70, 0x93, 0xa3,
+    0xc0, 0x03, 0x12, 0x68, 0x1c, 0x72, 0x13, 0x87, 0x00, 0x73, 0xe4, 0xaa, 0x48, 0xe2, 0x0e, 0x5e,
+    0x4f, 0xc7, 0x8e, 0xf8, 0x5c, 0xe2, 0x70, 0x93, 0x40, 0x00, 0x34, 0xa2, 0xca, 0x17, 0x6f, 0xd8,
+    0x12, 0xec, 0x35, 0xcb, 0x5c, 0x1a, 0x59, 0xe3, 0x39, 0x10, 0x93, 0x8f, 0xdc, 0x9e, 0x8b, 0x81,
+    0xfb, 0xc8, 0xdd, 0x75, 0xb9, 0x8e, 0x1e, 0xb9, 0x6b, 0x0f, 0xe5, 0x60, 0x35, 0x77, 0x9d, 0x34,
+    0x09, 0xe8, 0x76, 0xed, 0x91, 0xcb, 0x6f, 0x30, 0x9f, 0x71, 0xb3, 0x24, 0x25, 0xfb, 0x41, 0x01,
+    0xfe, 0xd0, 0x72, 0xe8, 0x96, 0x2a, 0xb7, 0x3c, 0x77, 0xd0, 0x58, 0x14, 0x0e, 0x77, 0x4b, 0xf1,
+    0x4f, 0x2e, 0x0a, 0x80, 0xd0, 0x32, 0x18, 0xe4, 0x61, 0x2d, 0x22, 0x14, 0xac, 0x5c, 0xb6, 0x8f,
+    0xd1, 0x27, 0xbc, 0x78, 0x29, 0x5e, 0xb5, 0xc4, 0xfd, 0xc9, 0x04, 0x2f, 0xb4, 0x8e, 0x00, 0xdb,
+    0x93, 0xbd, 0xe6, 0xb2, 0x07, 0x7e, 0x6c, 0x2e, 0x21, 0xbf, 0x97, 0x26, 0x56, 0xd1, 0x73, 0x41,
+    0xbe, 0x7c, 0xf9, 0xfc, 0xb8, 0xbc, 0x76, 0xa3, 0xad, 0xc1, 0xb1, 0x1f, 0x47, 0xd7, 0xfc, 0x06,
+    0xf2, 0xe1, 0x26, 0xbc, 0x37, 0x0e, 0xaf, 0xa7, 0x45, 0x01, 0x3a, 0x83, 0x37, 0x8b, 0xc1, 0xcc,
+    0x8f, 0xdc, 0xf1, 0x64, 0xfa, 0x0c, 0xdd, 0xba, 0x01, 0xe9, 0x81, 0x00, 0xa8, 0xcd, 0xc1, 0x4a,
+    0xc6, 0x22, 0xc1, 0xb1, 0x49, 0x3c, 0xb5, 0xec, 0x03, 0x17, 0xc0, 0x0c, 0x97, 0xb4, 0xd6, 0x48,
+    0x2b, 0x21, 0xaf, 0x1d, 0x50, 0xde, 0x8e, 0xf6, 0x90, 0x9f, 0xcf, 0x81, 0xe8, 0x62, 0x60, 0xcc,
+    0x0f, 0x8d, 0x31, 0x2b, 0x46, 0x69, 0x08, 0x91, 0xe8, 0xed, 0x9b, 0x8b, 0x77, 0x2e, 0x58, 0x75,
+    0x83, 0xdf, 0x9d, 0xce, 0x58, 0x3e, 0x01, 0x09, 0x31, 0x5d, 0xf0, 0x7e, 0x27, 0x9b, 0x3a, 0xe9,
+    0x2d, 0xbf, 0x78, 0x9c, 0xa5, 0x77, 0x74, 0x91, 0xf8, 0x05, 0x77, 0x19, 0xaf, 0x59, 0x71, 0x97,
+    0x66, 0xb7, 0x8e, 0x42, 0xbd, 0x03, 0xb5, 0x4e, 0xc0, 0x2b, 0xa5, 0xb7, 0xbc, 0x40, 0x15, 0x35,
+    0x84, 0xa2, 0xf3, 0x5b, 0x8e, 0xdc, 0x1d, 0xe8, 0x41, 0xf9, 0x37, 0x23, 0x95, 0xcb, 0xd2, 0x28,
+    0xa8, 0x40, 0x4f, 0xc8, 0x21, 0x9f, 0xc6, 0x42, 0xf4, 0x46, 0xe2, 0x6b, 0x92, 0xf9, 0xca, 0x1e,
+    0x8d, 0x70, 0xd1, 0xa3, 0x95, 0x88, 0x96, 0x5d, 0x5b, 0xa9, 0xc8, 0x91, 0x8e, 0x53, 0x5f, 0x88,
+    0xe6, 0x56, 0xbb, 0xc4, 0xfa, 0x4d, 0x63, 0x6e, 0xda, 0xf7, 0x8b, 0x39, 0xf2, 0xa3, 0x37, 0x8c,
+    0x05, 0x58, 0xfd, 0x1d, 0x63, 0xd1, 0x29, 0x6f, 0x19, 0xd7, 0x5d, 0xd4, 0x35, 0xf1, 0x5b, 0x36,
+    0xc2, 0x0a, 0x7b, 0xd3, 0xb5, 0xf7, 0x96, 0x14, 0x76, 0xa9, 0xf2, 0x7b, 0xf4, 0x5e, 0x73, 0x59,
+    0x6b, 0x51, 0x27, 0xbf, 0xd2, 0x05, 0x98, 0xb6, 0xae, 0x2d, 0x5f, 0x44, 0x04, 0x71, 0x07, 0x81,
+    0x5f, 0x05, 0xaa, 0xc9, 0xac, 0xf1, 0x12, 0x8f, 0x7b, 0x1d, 0x43, 0x50, 0xa4, 0xbc, 0x2b, 0x01,
+    0xce, 0xa9, 0x94, 0x35, 0x17, 0xd7, 0x62, 0xb8, 0xc6, 0xe1, 0xd0, 0x88, 0xa7, 0x61, 0x2d, 0x73,
+    0x8f, 0x78, 0x90, 0xba, 0xfc, 0x5c, 0x90, 0xc3, 0x9c, 0x4c, 0x4d, 0x86, 0x3e, 0x41, 0x7b, 0x15,
+    0xe5, 0x74, 0x6d, 0x15, 0xec, 0x15, 0x9b, 0xdb, 0x46, 0x1c, 0x91, 0x70, 0xd5, 0x40, 0x42, 0x6e,
+    0x9c, 0x27, 0xdb, 0x12, 0x61, 0x40, 0x5e, 0x8a, 0xe6, 0xe0, 0xe8, 0xe1, 0x84, 0xab, 0x2a, 0xfc,
+    0xeb, 0x98, 0xe1, 0xff, 0x19, 0xfe, 0x33, 0x1a, 0x98, 0x51, 0x44, 0x90, 0xb9, 0x77, 0x07, 0x1f,
+    0x64, 0xe8, 0x38, 0xdc, 0x04, 0x18, 0x00, 0x0c, 0x07, 0x0b, 0x63, 0x88, 0xc2, 0x2a, 0x87, 0x0c,
+    0xac, 0x1d, 0x36, 0xa8, 0xd8, 0x78, 0x2c, 0x64, 0x70, 0x12, 0x9d, 0xfb, 0x72, 0xc4, 0x78, 0x92,
+    0x5c, 0xe7, 0x93, 0x83, 0xf1, 0x18, 0xb8, 0x08, 0x17, 0xb2, 0x3b, 0x73, 0x1d, 0xd2, 0x05, 0x70,
+    0xbb, 0x7e, 0x06, 0x3e, 0xb0, 0x1d, 0xb3, 0x61, 0xb1, 0xef, 0xf4, 0xd8, 0xf8, 0xc0, 0x1d, 0x5c,
+    0x7e, 0xfd, 0x44, 0x66, 0x8b, 0x26, 0x32, 0x5b, 0x79, 0x22, 0xb3, 0x47, 0x26, 0xb2, 0xc9, 0xa5,
+    0xbf, 0x78, 0x09, 0x54, 0x91, 0xe7, 0x0e, 0xa0, 0x7c, 0xf8, 0xfa, 0x39, 0x68, 0x7c, 0x1e, 0xd7,
+    0xdb, 0x32, 0xb0, 0xf7, 0x16, 0x4d, 0x4e, 0x63, 0xac, 0x3a, 0x49, 0x85, 0x51, 0x9e, 0xac, 0x35,
+    0xc9, 0x4d, 0xa9, 0x70, 0x3c, 0x69, 0xb9, 0x52, 0x5b, 0x99, 0x3a, 0x66, 0x1b, 0xd6, 0x37, 0x49,
+    0xf3, 0x82, 0x0f, 0xf3, 0x37, 0x24, 0x96, 0xf3, 0x9c, 0x3b, 0x37, 0xb6, 0xa9, 0x44, 0x44, 0xe3,
+    0xbc, 0x7f, 0xe6, 0xdd, 0x35, 0x11, 0xad, 0xd5, 0x18, 0x31, 0x3f, 0x64, 0xf8, 0xcd, 0xe8, 0x83,
+    0xe3, 0x92, 0xbb, 0x4d, 0x8a, 0xf6, 0x3b, 0x90, 0x97, 0x0b, 0x20, 0x10, 0x5e, 0x21, 0x50, 0x53,
+    0x00, 0xd8, 0xc4, 0x68, 0xe4, 0x3a, 0xf3, 0x56, 0xe3, 0x3a, 0x0d, 0x67, 0xfb, 0xfc, 0xc3, 0xc5,
+    0x9c, 0xf6, 0x88, 0xa3, 0xe1, 0x4c, 0x8e, 0x5f, 0x1f, 0x20, 0x4b, 0x11, 0xad, 0x1a, 0xce, 0x28,
+    0x7e, 0xf2, 0x8f, 0xb7, 0xa6, 0x41, 0x80, 0xc7, 0x99, 0x35, 0x01, 0x54, 0x7f, 0xad, 0x65, 0x46,
+    0x4b, 0x6c, 0xad, 0x84, 0xa4, 0xea, 0x62, 0xc0, 0x4a, 0xb4, 0xf8, 0x8a, 0x0a, 0xf7, 0x24, 0x56,
+    0x14, 0xb3, 0x22, 0xfa, 0xfc, 0xf2, 0x24, 0x4e, 0x7d, 0xa3, 0xf8, 0x31, 0xe3, 0xeb, 0x7b, 0xa4,
+    0x86, 0x31, 0x91, 0x56, 0x42, 0xb8, 0x4e, 0x94, 0xa5, 0x26, 0x8a, 0xe3, 0x57, 0xd6, 0xe4, 0xc1,
+    0xa1, 0x11, 0xf6, 0x1d, 0x73, 0xb8, 0xc7, 0x82, 0x39, 0xa7, 0x20, 0x66, 0x10, 0x3a, 0x42, 0x1e,
+    0xc3, 0x69, 0x1c, 0xcf, 0x8c, 0x80, 0x5e, 0x93, 0xe4, 0xac, 0x1c, 0xe2, 0xa7, 0x72, 0x3a, 0xf5,
+    0x45, 0xcb, 0xbc, 0x36, 0xb7, 0x97, 0x1f, 0x1a, 0x5b, 0x39, 0x3e, 0x4c, 0x08, 0x43, 0xbc, 0xf8,
+    0xda, 0x0d, 0xdf, 0xc4, 0x37, 0x65, 0xcd, 0x4e, 0x9e, 0xf2, 0xb2, 0xea, 0x1b, 0x8a, 0x01, 0x81,
+    0x12, 0xea, 0x4f, 0x9b, 0x1f, 0x4b, 0x3f, 0x25, 0x68, 0x27, 0xc2, 0x42, 0x4b, 0x90, 0x6a, 0xcb,
+    0x56, 0xd7, 0x82, 0x28, 0x65, 0xa9, 0xfd, 0x81, 0x10, 0xb8, 0x9c, 0x20, 0xb8, 0xff, 0xbe, 0x74,
+    0xff, 0xe4, 0x29, 0x4a, 0xd4, 0xda, 0xd4, 0xe3, 0x1a, 0x6e, 0xe9, 0xaf, 0x6c, 0x26, 0x1d, 0xce,
+    0x48, 0x7a, 0x58, 0x4c, 0x5a, 0xda, 0x90, 0x3d, 0xdd, 0x24, 0xfb, 0x4e, 0x46, 0x19, 0x88, 0x3b,
+    0x20, 0xad, 0x58, 0x09, 0x52, 0xf0, 0xe2, 0xd8, 0x18, 0x83, 0x73, 0xf4, 0x34, 0xc6, 0x2b, 0x3f,
+    0xeb, 0x17, 0x0d, 0xb6, 0x17, 0x51, 0xfb, 0x18, 0x6b, 0x7c, 0x22, 0x47, 0x5a, 0x9e, 0x9d, 0xbf,
+    0x4f, 0x59, 0x36, 0xbb, 0x60, 0x78, 0xa5, 0x03, 0x95, 0xe2, 0xfb, 0xfa, 0x09, 0x36, 0x17, 0x24,
+    0xd9, 0x12, 0x0c, 0xfa, 0x71, 0xc1, 0x3b, 0xe0, 0x8d, 0x5f, 0xf8, 0xa0, 0x75, 0x14, 0xbb, 0xf5,
+    0xe7, 0xcd, 0x6b, 0x68, 0xbb, 0x8b, 0x57, 0xae, 0xc8, 0xf4, 0x4a, 0xeb, 0xd4, 0xc4, 0xfe, 0xa6,
+    0x5d, 0x98, 0xe7, 0xd1, 0x91, 0x65, 0x3f, 0x4f, 0x45, 0x72, 0x82, 0x59, 0x4a, 0x94, 0xe0, 0x1e,
+    0xa5, 0xba, 0x45, 0x99, 0xcb, 0xaf, 0xdc, 0xcd, 0x8f, 0xde, 0x39, 0xd6, 0xef, 0xbf, 0x53, 0xd5,
+    0x2a, 0x3f, 0x70, 0x4f, 0xf8, 0x57, 0xd9, 0x1c, 0x01, 0x77, 0x59, 0x9d, 0xef, 0x8e, 0xf8, 0x37,
+    0xeb, 0xce, 0x93, 0x27, 0x4e, 0xa9, 0x79, 0x9a, 0xc0, 0x9c, 0x61, 0x9c, 0x10, 0xc6, 0x36, 0xba,
+    0xe8, 0x73, 0x51, 0x3a, 0xdc, 0xfd, 0xdf, 0xff, 0xfc, 0x2f, 0xc7, 0xc5, 0x2f, 0x4c, 0x65, 0xaf,
+    0x7f, 0x5f, 0x4b, 0x4f, 0x34, 0xd7, 0xd1, 0x83, 0x2e, 0xa2, 0x07, 0x42, 0x07, 0xc1, 0x95, 0xb5,
+    0xb4, 0x08, 0x9d, 0x22, 0x2a, 0x62, 0x0a, 0x46, 0x02, 0x23, 0x64, 0x79, 0x90, 0x45, 0x13, 0x32,
+    0x53, 0x98, 0x9c, 0xeb, 0xce, 0xdd, 0x01, 0x8f, 0x37, 0x32, 0x07, 0x08, 0x97, 0x69, 0x98, 0x19,
+    0xd4, 0x3e, 0x7d, 0x1d, 0x8a, 0xb5, 0x3c, 0x1a, 0x75, 0xa0, 0x58, 0xa3, 0xef, 0x53, 0x39, 0x4f,
+    0x90, 0x56, 0x91, 0xb0, 0x0d, 0xb0, 0x4a, 0x0d, 0x28, 0xae, 0xac, 0xd8, 0x41, 0xf3, 0x87, 0xa6,
+    0x4a, 0x56, 0x84, 0x7a, 0xd0, 0xe7, 0xbe, 0xfc, 0x71, 0x0e, 0xdc, 0x28, 0xe5, 0x17, 0x45, 0x21,
+    0x1f, 0x00, 0x53, 0x45, 0x52, 0x5f, 0x5b, 0x67, 0x41, 0xa4, 0x55, 0xe7, 0x66, 0x8f, 0x0b, 0x83,
+    0x56, 0x3e, 0x61, 0xe6, 0x63, 0x68, 0x4f, 0x09, 0x8e, 0x12, 0xc1, 0xa4, 0x1a, 0x4d, 0xb3, 0xf8,
+    0xad, 0x9f, 0xf9, 0x63, 0xf9, 0xc3, 0x05, 0xef, 0xcf, 0x5f, 0x5d, 0x40, 0x81, 0x11, 0x8c, 0x78,
+    0x2b, 0x7a, 0x3f, 0x05, 0x22, 0xf8, 0xf1, 0x5c, 0x20, 0x50, 0x25, 0xa3, 0x9d, 0xd6, 0x67, 0xc1,
+    0xd5, 0x53, 0x3c, 0x06, 0xd5, 0xd8, 0x85, 0x3c, 0x8d, 0x95, 0x1b, 0x55, 0x1e, 0xf4, 0xd5, 0x05,
+    0x73, 0x1e, 0x9b, 0xdd, 0xff, 0xa7, 0x85, 0xea, 0x6a, 0xb1, 0x8d, 0x78, 0xd4, 0x3b, 0x74, 0xa5,
+    0xef, 0x79, 0xcd, 0xc8, 0x67, 0x06, 0x25, 0xda, 0x08, 0xfc, 0x13, 0x62, 0x60, 0xc6, 0xf0, 0x8e,
+    0xe7, 0x92, 0x20, 0x58, 0x1b, 0xa8, 0xea, 0xa3, 0x9b, 0x0e, 0x49, 0x62, 0x9a, 0xda, 0x9b, 0x02,
+    0x39, 0xed, 0xa1, 0xf9, 0x98, 0x5e, 0x79, 0x73, 0x73, 0xd1, 0xd4, 0xcb, 0x5f, 0x77, 0x8b, 0x45,
+    0x90, 0x7b, 0x7b, 0x8b, 0x66, 0x70, 0xd0, 0x58, 0x10, 0xdf, 0xbf, 0x26, 0x99, 0x78, 0x64, 0x07,
+    0xd4, 0xe0, 0xbe, 0xf4, 0x65, 0xbb, 0xca, 0xfa, 0x56, 0x16, 0x99, 0x7d, 0x9e, 0xf7, 0x48, 0x75,
+    0xfc, 0xd1, 0xbd, 0xc7, 0x83, 0x7f, 0x34, 0x36, 0xd7, 0x48, 0xd9, 0x55, 0xb8, 0xf2, 0xef, 0xa3,
+    0xdc, 0x8a, 0x57, 0x91, 0xb8, 0xf3, 0xb2, 0x88, 0x1f, 0x7d, 0x6a, 0xd4, 0x5e, 0x7b, 0x40, 0xec,
+    0xf9, 0x95, 0x5c, 0x44, 0x8e, 0x0a, 0x8e, 0x5e, 0xe1, 0xfa, 0x30, 0xdc, 0x17, 0x19, 0xed, 0xc8,
+    0xe9, 0x73, 0x20, 0x5a, 0x66, 0x7a, 0xea, 0xc8, 0x9d, 0xfa, 0xea, 0xc1, 0x95, 0x24, 0xff, 0x89,
+    0xab, 0xb4, 0xb1, 0x19, 0xa7, 0xaa, 0xf5, 0x65, 0xaa, 0xa6, 0xb7, 0x2a, 0x25, 0x7f, 0x1a, 0xed,
+    0x11, 0x1e, 0x8d, 0xdd, 0x00, 0xe0, 0x53, 0xbd, 0x95, 0x78, 0x35, 0x8e, 0xe3, 0x80, 0xb5, 0x6a,
+    0x26, 0xfa, 0x2d, 0xfa, 0x66, 0xec, 0xe0, 0x9b, 0x9a, 0x2c, 0xae, 0x9d, 0xf0, 0xc0, 0xf2, 0x37,
+    0xa8, 0x52, 0xf8, 0x9d, 0x5a, 0xf9, 0x8b, 0x43, 0x37, 0xa5, 0xdf, 0xaf, 0xa9, 0x2b, 0x7d, 0xc8,
+    0x39, 0xb9, 0xf5, 0xde, 0xb0, 0x4c, 0x57, 0x39, 0x34, 0x51, 0x13, 0xa1, 0x6c, 0x3d, 0xf7, 0x43,
+    0x9b, 0xb3, 0xd3, 0xe6, 0x09, 0x05, 0x04, 0x7d, 0x0a, 0x6e, 0x07, 0x0d, 0x6b, 0x78, 0x2a, 0x22,
+    0x4e, 0x21, 0xb7, 0x79, 0x84, 0x88, 0xfe, 0x55, 0x06, 0x41, 0xa8, 0x6b, 0x5c, 0x5b, 0xf9, 0x56,
+    0x8f, 0x8a, 0xbd, 0x86, 0x07, 0xd5, 0xd9, 0x36, 0x15, 0x47, 0x35, 0x3f, 0x37, 0xa1, 0x59, 0xaf,
+    0x97, 0xda, 0x67, 0x11, 0xcb, 0x91, 0x8f, 0xa7, 0x5f, 0x8e, 0xe8, 0xd7, 0x17, 0x92, 0x20, 0x0d,
+    0xd9, 0xfb, 0xf3, 0x53, 0xfc, 0x7c, 0x06, 0x32, 0x30, 0x98, 0xaa, 0x25, 0xbf, 0xa6, 0xc9, 0xee,
+    0x0a, 0xd5, 0x9f, 0xcc, 0xd6, 0x06, 0xaa, 0x1e, 0xb3, 0x7e, 0xa5, 0xa8, 0xfa, 0xfb, 0x46, 0xd0,
+    0x28, 0xb8, 0xe2, 0xc5, 0xa6, 0xb2, 0x65, 0x60, 0x25, 0x9b, 0x55, 0x09, 0x7d, 0xa4, 0xf6, 0x4e,
+    0xe2, 0x8f, 0x19, 0x56, 0x79, 0xf4, 0x56, 0xa6, 0x5b, 0x07, 0xd3, 0x11, 0x2e, 0x47, 0x78, 0xb0,
+    0x92, 0x7a, 0xd2, 0x61, 0x12, 0x17, 0xfb, 0x85, 0xfa, 0x05, 0xa3, 0x65, 0xee, 0xb7, 0x74, 0x40,
+    0xb2, 0xc4, 0x0a, 0x6a, 0x4e, 0xa5, 0xfe, 0x40, 0x47, 0xfc, 0x7f, 0x67, 0xad, 0xa4, 0xe6, 0xb8,
+    0x4b, 0x00, 0x00,
+};
+
+// style.css: 526 bytes, 407 minified, 285 gzipped
+static const uint8_t webAsset_style_css[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x55, 0x50, 0xcd, 0x4e, 0x84, 0x30,
+    0x10, 0xbe, 0xfb, 0x14, 0x4d, 0xc8, 0x66, 0x35, 0x01, 0xd2, 0xaa, 0x20, 0xdb, 0x9e, 0x3c, 0x7a,
+    0x36, 0x3e, 0x40, 0xa1, 0xd3, 0x32, 0x11, 0x5a, 0xd2, 0x16, 0x65, 0xdd, 0xf0, 0xee, 0x76, 0x0d,
+    0xea, 0xee, 0x61, 0x92, 0x6f, 0x26, 0x33, 0xdf, 0xcf, 0xb4, 0x4e, 0x1d, 0x4f, 0x23, 0xda, 0xa2,
+    0x07, 0x34, 0x7d, 0xe4, 0x8c, 0xd2, 0x8f, 0x5e, 0x8c, 0xd2, 0x1b, 0xb4, 0x9c, 0x8a, 0x49, 0x2a,
+    0x85, 0xd6, 0x24, 0xa4, 0x9d, 0x8d, 0x85, 0x96, 0x23, 0x0e, 0x47, 0xbe, 0x7f, 0x05, 0xe3, 0x80,
+    0xbc, 0xbd, 0xec, 0xf3, 0x67, 0x8f, 0x72, 0xc8, 0x83, 0xb4, 0xa1, 0x08, 0xe0, 0x51, 0x8b, 0x56,
+    0x76, 0xef, 0xc6, 0xbb, 0xd9, 0x2a, 0x3e, 0xa0, 0x05, 0xe9, 0x0b, 0xe3, 0xa5, 0x42, 0xb0, 0xf1,
+    0x96, 0x35, 0x54, 0x81, 0xc9, 0xb3, 0xe6, 0xa9, 0x03, 0x68, 0x09, 0xdd, 0xe5, 0x59, 0xfb, 0x00,
+    0x54, 0x6b, 0x52, 0x9d, 0xb1, 0xa6, 0xba, 0x49, 0x38, 0x39, 0xd8, 0xdd, 0x89, 0xb5, 0x67, 0xa7,
+    0xce, 0x0d, 0xce, 0xf3, 0x8c, 0x55, 0x75, 0xd5, 0x51, 0x11, 0x61, 0x89, 0x45, 0xe8, 0xa5, 0x72,
+    0x9f, 0x9c, 0x92, 0xfb, 0x69, 0x21, 0x4d, 0xaa, 0x8d, 0x41, 0xac, 0x68, 0xa7, 0x39, 0xe6, 0xed,
+    0x1c, 0xa3, 0xb3, 0xa7, 0x1f, 0xb3, 0x01, 0xbf, 0x80, 0xb3, 0x92, 0xc1, 0xf8, 0x1f, 0xa3, 0x7c,
+    0x84, 0x91, 0xd0, 0xb2, 0x49, 0xb3, 0xd6, 0x79, 0x05, 0xbe, 0x38, 0x9b, 0x9b, 0x03, 0xaf, 0xa7,
+    0x65, 0x9b, 0x70, 0x96, 0x68, 0x83, 0x1b, 0x50, 0x91, 0xec, 0x40, 0x3b, 0xa9, 0x0f, 0x7f, 0xef,
+    0x28, 0xab, 0xf3, 0xb5, 0x58, 0x37, 0x95, 0x8b, 0xa8, 0xbf, 0x9b, 0xd7, 0x96, 0xbb, 0xd9, 0x87,
+    0xd4, 0x4e, 0x0e, 0x6d, 0x04, 0x9f, 0xf8, 0x97, 0xeb, 0x00, 0xf5, 0x45, 0x80, 0x4d, 0xdc, 0x3a,
+    0x0b, 0x62, 0xbd, 0xf9, 0x06, 0x71, 0x80, 0x1f, 0x71, 0x97, 0x01, 0x00, 0x00,
+};
+
+// config.html: 496 bytes, 428 minified, 271 gzipped
+static const uint8_t webAsset_config_html[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x85, 0x91, 0x41, 0x53, 0xc3, 0x20,
+    0x10, 0x85, 0xef, 0xfc, 0x0a, 0xe4, 0xa4, 0x87, 0x96, 0x9a, 0xb6, 0x63, 0x3b, 0x42, 0x3c, 0x54,
+    0x7b, 0xd5, 0x19, 0xdb, 0x83, 0x27, 0x87, 0x92, 0xc5, 0x50, 0x69, 0x92, 0x81, 0x35, 0x9a, 0x7f,
+    0x2f, 0x09, 0xe9, 0xd8, 0x9b, 0xa7, 0x65, 0xde, 0x7b, 0xbc, 0xfd, 0x18, 0xc4, 0xd5, 0xe3, 0xf3,
+    0x66, 0xf7, 0xf6, 0xf2, 0x44, 0x4b, 0x3c, 0xb9, 0x9c, 0x88, 0xf3, 0x00, 0x55, 0xc4, 0x71, 0x02,
+    0x54, 0x54, 0x97, 0xca, 0x07, 0x40, 0xc9, 0xf6, 0xbb, 0xed, 0x64, 0xc5, 0xa2, 0x8c, 0x16, 0x1d,
+    0xe4, 0x9b, 0xba, 0x32, 0xf6, 0x83, 0x4e, 0xe8, 0xd6, 0x75, 0x87, 0x1a, 0x05, 0x4f, 0x32, 0x11,
+    0xce, 0x56, 0x9f, 0xd4, 0x83, 0x93, 0x2c, 0x60, 0xe7, 0x20, 0x94, 0x00, 0xc8, 0x28, 0x76, 0x0d,
+    0x48, 0x86, 0xf0, 0x83, 0x5c, 0x87, 0xc0, 0x68, 0xe9, 0xc1, 0x8c, 0x89, 0x69, 0x14, 0x1e, 0x5a,
+    0x39, 0xd3, 0x77, 0xf3, 0xc5, 0xca, 0x80, 0x9e, 0x9b, 0x05, 0xa3, 0x3c, 0x36, 0xf1, 0x91, 0xe3,
+    0x50, 0x17, 0x5d, 0x4f, 0x75, 0x9b, 0x9f, 0x77, 0xc5, 0x23, 0x11, 0x85, 0x6d, 0x7b, 0x35, 0x1b,
+    0x51, 0xbe, 0xbc, 0x42, 0x5b, 0x57, 0xd1, 0xcc, 0x92, 0x49, 0x6d, 0x21, 0x99, 0x1e, 0x3c, 0x96,
+    0x0b, 0x9e, 0xe2, 0x8d, 0x87, 0x41, 0xf7, 0xea, 0xfb, 0xfd, 0xcf, 0x8b, 0x6a, 0xbf, 0x2f, 0x45,
+    0x82, 0xf6, 0xb6, 0xc1, 0x4b, 0xe2, 0xa3, 0x6a, 0x55, 0x52, 0x19, 0x0d, 0x5e, 0x4b, 0x66, 0x06,
+    0x8e, 0xe9, 0xb1, 0xe7, 0x86, 0xf5, 0x0c, 0x8c, 0xc9, 0x0a, 0xb3, 0x5e, 0x2e, 0xfb, 0xae, 0x14,
+    0xfc, 0xaf, 0x27, 0x27, 0xa9, 0x23, 0xb1, 0xbf, 0xa2, 0xf2, 0x78, 0x7d, 0x73, 0x4f, 0x2e, 0xae,
+    0xf3, 0xf1, 0xd9, 0x3c, 0x7d, 0xca, 0x2f, 0x21, 0x3b, 0xf0, 0xd8, 0xac, 0x01, 0x00, 0x00,
+};
+
+// index.html: 574 bytes, 378 minified, 252 gzipped
+static const uint8_t webAsset_index_html[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x85, 0x90, 0x31, 0x53, 0x03, 0x21,
+    0x10, 0x85, 0xfb, 0xfb, 0x15, 0xb8, 0x95, 0x16, 0x1e, 0xd1, 0x24, 0x63, 0x32, 0xc2, 0x59, 0xa8,
+    0x69, 0x75, 0xc6, 0x58, 0x58, 0x12, 0x58, 0x06, 0x22, 0xb9, 0xcb, 0xc0, 0x7a, 0xe3, 0xfd, 0x7b,
+    0xb9, 0x70, 0x3a, 0xe9, 0x6c, 0x58, 0xf6, 0xcd, 0xe3, 0xdb, 0xb7, 0x88, 0x8b, 0xa7, 0x97, 0xc7,
+    0xed, 0xc7, 0xeb, 0x33, 0x73, 0x74, 0x08, 0x4d, 0x25, 0x7e, 0x0b, 0x2a, 0x93, 0xcb, 0x01, 0x49,
+    0x31, 0xed, 0x54, 0x4c, 0x48, 0x12, 0xde, 0xb7, 0x9b, 0xeb, 0x15, 0x64, 0x99, 0x3c, 0x05, 0x6c,
+    0x36, 0x61, 0xd8, 0x75, 0x24, 0x78, 0xe9, 0x2a, 0x11, 0x7c, 0xfb, 0xc9, 0x22, 0x06, 0x09, 0x89,
+    0x86, 0x80, 0xc9, 0x21, 0x12, 0x30, 0x1a, 0x8e, 0x28, 0x81, 0xf0, 0x9b, 0xb8, 0x4e, 0x09, 0x98,
+    0x8b, 0x68, 0x27, 0x47, 0x9d, 0x85, 0x87, 0x5e, 0xce, 0xf4, 0xdd, 0x7c, 0xb1, 0xb2, 0xa8, 0xe7,
+    0x76, 0x01, 0x8c, 0x67, 0x12, 0x9f, 0xc6, 0xef, 0x3a, 0x33, 0x8c, 0x61, 0x6e, 0xfe, 0x66, 0xe5,
+    0x6b, 0x25, 0x8c, 0xef, 0xf3, 0xa9, 0x55, 0xdb, 0xab, 0xc4, 0xbc, 0x91, 0xe0, 0xbe, 0x0c, 0x34,
+    0x82, 0x17, 0x65, 0x7c, 0x5f, 0x1c, 0x49, 0x47, 0x7f, 0xa4, 0xf3, 0x04, 0x7b, 0x95, 0x0d, 0x27,
+    0x15, 0x58, 0x8a, 0x5a, 0x82, 0x3d, 0x71, 0xeb, 0xfd, 0x98, 0x03, 0xd7, 0x33, 0xb4, 0xf6, 0xd6,
+    0xd8, 0xf5, 0x72, 0x39, 0xe2, 0x8a, 0xf1, 0x3f, 0x4e, 0x53, 0x15, 0xc6, 0x1b, 0xa9, 0x48, 0x97,
+    0xa1, 0xd3, 0x8a, 0x7c, 0xd7, 0xd6, 0xae, 0x4b, 0x74, 0x75, 0x5f, 0x9d, 0x51, 0xf8, 0xb4, 0x0d,
+    0x2f, 0x5f, 0xfc, 0x03, 0x50, 0xc5, 0xed, 0xc6, 0x7a, 0x01, 0x00, 0x00,
+};
+
+#define WEB_ASSET_COUNT 4
+
+static const WebAsset webAssets[WEB_ASSET_COUNT] = {
+    { "/flybot.js", "application/javascript", webAsset_flybot_js, sizeof(webAsset_flybot_js), "\"e90eff2df955\"", "e90eff2df955" },
+    { "/style.css", "text/css", webAsset_style_css, sizeof(webAsset_style_css), "\"0c7348fec3f4\"", "0c7348fec3f4" },
+    { "/config", "text/html", webAsset_config_html, sizeof(webAsset_config_html), "\"1e7cef5946f0\"", "1e7cef5946f0" },
+    { "/", "text/html", webAsset_index_html, sizeof(webAsset_index_html), "\"438fe1bf0f0d\"", "438fe1bf0f0d" },
+};
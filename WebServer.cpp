@@ -1,9 +1,27 @@
 #define CONFIG_ASYNC_TCP_RUNNING_CORE 1
 #include <ESPAsyncWebServer.h>
+#include <esp_app_desc.h>
+#include <esp_random.h>
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
 
+#include "AllocTracker.h"
+#include "Boot.h"
 #include "ConfigValue.h"
+#include "ControlLoop.h"
+#include "DeferredLog.h"
+#include "GyroAnalyzer.h"
+#include "History.h"
+#include "Latency.h"
+#include "Motors.h"
+#include "OTA.h"
+#include "StateMachine.h"
+#include "Tasks.h"
+#include "Telemetry.h"
+#include "Watchdog.h"
+#include "WebAssets.h"
 
 #include "State.h"
 
@@ -14,215 +32,241 @@ void mpuBeginCalibration();
 static AsyncWebServer server(80);
 static AsyncWebSocketMessageHandler wsHandler;
 static AsyncWebSocket ws("/ws", wsHandler.eventHandler());
+static AsyncEventSource events("/events");
 
-static const char *cssContent PROGMEM = R"(
-body {
-    min-height: 100vh;
-    margin: 0;
-    padding: 0;
-    font-family: 'Segoe UI', Arial, sans-serif;
-    background: linear-gradient(180deg, #87ceeb 0%, #b3e0ff 50%, #f0f8ff 100%);
-}
-h1 {
-    color: #1565c0;
-    text-shadow: 0 2px 8px #b3e0ff;
+// Prefix of the running image's ELF SHA-256. Anything that only changes
+// with the firmware is cached against it.
+static char buildId[17];
+static char schemaETag[sizeof(buildId) + 2];
+
+#define CONFIG_VALUES_BODY_MAX 4096
+
+// Per-request state of a /firmware upload, in _tempObject. Errors are
+// static strings.
+struct FirmwareUpload {
+    bool accepted;
+    const char *error;
+};
+
+// /config.json is only rebuilt when the config generation moves on. Each
+// response keeps its own reference, so a rebuild never touches a document
+// that is still being sent. The boot nonce keeps ETags from matching across
+// reboots, which restart the generation.
+static std::shared_ptr<const String> configDocument;
+static uint32_t configDocumentGeneration = 0;
+static uint32_t bootNonce = 0;
+static char configETag[24];
+
+// WebSocket clients that sent "config". Ids are written by the socket
+// handlers and read by the network task; 0 is a free slot.
+#define CONFIG_SUBSCRIBERS_MAX 8
+static std::atomic<uint32_t> configSubscribers[CONFIG_SUBSCRIBERS_MAX];
+static uint32_t configBroadcastGeneration = 0;
+
+static bool configSubscribe(uint32_t clientId) {
+    for (auto &slot : configSubscribers) {
+        uint32_t expected = 0;
+        if (slot.load() == clientId || slot.compare_exchange_strong(expected, clientId)) {
+            return true;
+        }
+    }
+    return false;
 }
-input, button {
-    font-size: 1.1em;
-    padding: 0.4em 0.8em;
-    border-radius: 6px;
-    border: 1px solid #90caf9;
-    margin: 0.5em 0;
+
+static void configUnsubscribe(uint32_t clientId) {
+    for (auto &slot : configSubscribers) {
+        uint32_t expected = clientId;
+        slot.compare_exchange_strong(expected, 0);
+    }
 }
-button {
-    background: #90caf9;
-    color: #1565c0;
-    cursor: pointer;
-    box-shadow: 0 2px 6px #b3e0ff;
-    border: none;
+
+// Network task: one frame per round with every value changed since the last,
+// {"type":"cfg","g":<generation>,"c":{"<name>":<value>,...}}
+static void broadcastConfigChanges() {
+    String changes;
+    const uint32_t generation = configValuesChangedSince(configBroadcastGeneration,
+        [&changes](const char *name, const Value &value, uint32_t) {
+            changes += changes.length() == 0 ? "\"" : ",\"";
+            changes += name;
+            changes += "\":";
+            changes += value.toString();
+        });
+    configBroadcastGeneration = generation;
+    if (changes.length() == 0) {
+        return;
+    }
+    const String frame = "{\"type\":\"cfg\",\"g\":" + String((unsigned)generation) + ",\"c\":{" + changes + "}}";
+    for (auto &slot : configSubscribers) {
+        const uint32_t clientId = slot.load();
+        if (clientId != 0) {
+            ws.text(clientId, frame);
+        }
+    }
 }
-)";
-static const size_t cssContentLength = strlen_P(cssContent);
 
-static const char *jsContent PROGMEM = R"(
+// /events clients. Slots are taken and released on the web server's task;
+// the network task only reaches them through the telemetry subscription.
+class EventSourceSink : public TelemetrySink {
+public:
+    AsyncEventSourceClient *client = nullptr;
 
-let state = {
-    rollDegrees: 0.0,
-    pitchDegrees: 0.0,
-    yawDegrees: 0.0,
-    throttlePercent: 0.0,
-    armed: false,
+    size_t queued() const override {
+        return client->packetsWaiting();
+    }
+    bool send(const char *frame, size_t, uint32_t id) override {
+        return client->send(frame, "state", id);
+    }
 };
+static EventSourceSink eventSinks[TELEMETRY_SUBSCRIBERS_MAX];
+// Rate asked for by the connection being accepted, from ?hz=
+static float eventsPendingHz = TELEMETRY_DEFAULT_HZ;
 
-const rad2deg = 180 / Math.PI;
+// Firmware upload progress, at most every OTA_PROGRESS_MILLIS and only
+// when something moved
+#define OTA_PROGRESS_MILLIS 250
+static OtaStatus lastOtaStatus = {};
+static uint32_t lastOtaProgressMillis = 0;
 
-//
-// COMMUNICATIONS
-//
-let ws = new WebSocket('ws://flightcontroller.local/ws');
-let wsConnected = false;
-ws.onopen = function() {
-    console.log("WebSocket connected");
-    wsConnected = true;
-};
-ws.onmessage = function(event) {
-    const data = JSON.parse(event.data);
-    if (data.type === "state") {
-        state.rollDegrees = data.mr * rad2deg;
-        state.pitchDegrees = data.mp * rad2deg;
-        state.yawDegrees = data.my * rad2deg;
-        state.throttlePercent = data.rt * 100.0;
-        state.armed = data.a;
-        drawAll();
-    }
-};
-ws.onclose = function() {
-    wsConnected = false;
-    console.log("WebSocket closed");
-};
-ws.onerror = function(error) {
-    console.log("WebSocket error: " + error);
-};
-function sendCommand() {
-    if (!wsConnected) return;
-    const command = document.getElementById("command").value;
-    ws.send("command " + command);
+static void formatOtaStatus(char *out, size_t size, const OtaStatus &status) {
+    snprintf(out, size, "{\"type\":\"ota\",\"state\":\"%s\",\"size\":%u,\"received\":%u,\"written\":%u,\"error\":%s%s%s}",
+        otaStateName(status.state), (unsigned)status.size, (unsigned)status.received, (unsigned)status.written,
+        status.error ? "\"" : "", status.error ? status.error : "null", status.error ? "\"" : "");
 }
-function getState() {
-    if (!wsConnected) return;
-    ws.send("state");
+
+static void broadcastOtaProgress() {
+    const uint32_t now = millis();
+    if (now - lastOtaProgressMillis < OTA_PROGRESS_MILLIS) {
+        return;
+    }
+    OtaStatus status;
+    otaGetStatus(status);
+    if (status.state == lastOtaStatus.state && status.received == lastOtaStatus.received
+        && status.written == lastOtaStatus.written) {
+        return;
+    }
+    lastOtaStatus = status;
+    lastOtaProgressMillis = now;
+    char message[192];
+    formatOtaStatus(message, sizeof(message), status);
+    ws.textAll(message);
 }
 
-//
-// HUD
-//
-function drawAll() {
-    drawHUD();
+void webServerLoop() {
+    broadcastConfigChanges();
+    broadcastOtaProgress();
+    telemetryPoll(micros());
 }
-function drawHUD() {
-    const $hud = document.getElementById("hud");
-    if (!$hud) return;
-    const ctx = $hud.getContext("2d");
-    const width = $hud.width;
-    const height = $hud.height;
-    ctx.clearRect(0, 0, width, height);
-    ctx.fillStyle = "#ffffff";
-    ctx.fillRect(0, 0, width, height);
-    ctx.fillStyle = "#000000";
-    ctx.font = "16px Arial";
-    ctx.fillText("Roll: " + state.rollDegrees.toFixed(1) + "°", 10, 20);
-    ctx.fillText("Pitch: " + state.pitchDegrees.toFixed(1) + "°", 10, 40);
-    ctx.fillText("Yaw: " + state.yawDegrees.toFixed(1) + "°", 10, 60);
-    ctx.fillText("Throttle: " + state.throttlePercent.toFixed(1) + "%", 10, 80);
-    ctx.fillText("Armed: " + (state.armed ? "Yes" : "No"), 10, 100);
+
+static void updateConfigDocument() {
+    const uint32_t generation = configValuesGetGeneration();
+    if (configDocument && generation == configDocumentGeneration) {
+        return;
+    }
+    auto document = std::make_shared<String>();
+    document->reserve(configValuesCount() * 32 + 2);
+    configValuesWriteJson(*document);
+    configDocument = document;
+    configDocumentGeneration = generation;
+    snprintf(configETag, sizeof(configETag), "\"%08x-%u\"", (unsigned)bootNonce, (unsigned)generation);
 }
 
-function startUI() {
-    // Initial draw
-    drawAll();
-    // Update state at 2Hz
-    setInterval(() => {
-        getState();
-    }, 1000/2);
+// Runs on the deferred log task
+static void wsLogSink(DeferredLogLevel level, const char *line) {
+    if (ws.count() == 0) {
+        return;
+    }
+    String message = "{\"type\":\"log\",\"l\":" + String((int)level) + ",\"m\":\"";
+    for (const char *c = line; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            message += '\\';
+        }
+        if ((unsigned char)*c >= 0x20) {
+            message += *c;
+        }
+    }
+    message += "\"}";
+    ws.textAll(message);
 }
-startUI();
-)";
-static const size_t jsContentLength = strlen_P(jsContent);
 
-static const char *htmlContent PROGMEM = R"(<!DOCTYPE html>
-<html>
-<head>
-    <meta charset="UTF-8">
-    <title>Flybot</title>
-    <link rel="stylesheet" type="text/css" href="style.css" />
-</head>
-<body>
-    <h1>Flybot</h1>
-    <div>
-        <canvas id="hud"></canvas>
-    </div>
-    <!--<div>
-    <input type="text" id="command" placeholder="Send a command">
-    <button onclick='sendCommand()'>Send</button>
-    </div>-->
-    <script type="text/javascript" src="http://192.168.112.2/flybot.js"></script>
-    <script type="text/javascript">
-        flybotStart("flybot.local");
-    </script>
-</body>
-</html>
-)";
-static const size_t htmlContentLength = strlen_P(htmlContent);
+static bool requestMatchesETag(AsyncWebServerRequest *request, const char *etag) {
+    const AsyncWebHeader *header = request->getHeader("If-None-Match");
+    return header != nullptr && strstr(header->value().c_str(), etag) != nullptr;
+}
 
-static const char *configHtmlContent PROGMEM = R"(<!DOCTYPE html>
-<html>
-<head>
-    <meta charset="UTF-8">
-    <title>Config - Flybot</title>
-    <link rel="stylesheet" type="text/css" href="style.css" />
-</head>
-<body>
-    <h1>Flybot</h1>
-    <div>
-        <h2>Configuration</h2>
-        <div id="config"></div>
-        <pre id="raw_config"></pre>
-    </div>
-    <script type="text/javascript" src="http://192.168.112.2/flybot.js"></script>
-    <script type="text/javascript">
-        flybotConfigStart();
-    </script>
-</body>
-</html>
-)";
-static const size_t configHtmlContentLength = strlen_P(configHtmlContent);
+// Sent gzipped straight from flash. Pages refer to scripts and styles with
+// ?v=<hash>, so those can be cached forever; the pages themselves are
+// revalidated by ETag.
+static void sendWebAsset(AsyncWebServerRequest *request, const WebAsset &asset) {
+    const bool versioned = request->arg("v") == asset.version;
+    AsyncWebServerResponse *response;
+    if (requestMatchesETag(request, asset.etag)) {
+        response = request->beginResponse(304);
+    }
+    else {
+        response = request->beginResponse(200, asset.contentType, asset.gzipData, asset.gzipLength);
+        response->addHeader("Content-Encoding", "gzip");
+    }
+    response->addHeader("ETag", asset.etag);
+    response->addHeader("Cache-Control", versioned ? "public, max-age=31536000, immutable" : "no-cache");
+    request->send(response);
+}
 
 void webServerBegin() {
+    esp_app_get_elf_sha256(buildId, sizeof(buildId));
+    snprintf(schemaETag, sizeof(schemaETag), "\"%s\"", buildId);
+    bootNonce = esp_random();
+    configBroadcastGeneration = configValuesGetGeneration();
+    telemetryBegin();
+
     // requestLogger.setEnabled(true);
     // requestLogger.setOutput(Serial);
     // server.addMiddleware(&requestLogger);
     
-    server.on("/", HTTP_GET, [](AsyncWebServerRequest *request) {
-        request->send(200, "text/html", (const uint8_t *)htmlContent, htmlContentLength);
-    });
-    server.on("/style.css", HTTP_GET, [](AsyncWebServerRequest *request) {
-        request->send(200, "text/css", (const uint8_t *)cssContent, cssContentLength);
-    });
-    server.on("/script.js", HTTP_GET, [](AsyncWebServerRequest *request) {
-        request->send(200, "application/javascript", (const uint8_t *)jsContent, jsContentLength);
-    });
-    server.on("/config", HTTP_GET, [](AsyncWebServerRequest *request) {
-        request->send(200, "text/html", (const uint8_t *)configHtmlContent, configHtmlContentLength);
-    });
-    server.on("/config.json", HTTP_GET, [](AsyncWebServerRequest *request) {
-        auto stream = request->beginResponseStream("application/json", 1200);
-        stream->print("{");
-        const char *head = "";
-        configValuesIterate([&](const String &key, const Value &value) {
-            stream->print(head);
-            stream->print("\"");
-            stream->print(key);
-            stream->print("\":");
-            stream->print(value.toString());
-            head = ",";
+    for (const WebAsset &asset : webAssets) {
+        server.on(asset.path, HTTP_GET, [&asset](AsyncWebServerRequest *request) {
+            sendWebAsset(request, asset);
         });
-        stream->print("}");
-        request->send(stream);
+    }
+    server.on("/config.json", HTTP_GET, [](AsyncWebServerRequest *request) {
+        updateConfigDocument();
+        AsyncWebServerResponse *response;
+        if (requestMatchesETag(request, configETag)) {
+            response = request->beginResponse(304);
+        }
+        else {
+            std::shared_ptr<const String> document = configDocument;
+            response = request->beginResponse("application/json", document->length(),
+                [document](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+                    const size_t n = min(maxLen, document->length() - index);
+                    memcpy(buffer, document->c_str() + index, n);
+                    return n;
+                });
+        }
+        response->addHeader("ETag", configETag);
+        response->addHeader("Cache-Control", "no-cache");
+        // The page fetches the schema for this build with it, and ignores
+        // pushed changes it already has
+        response->addHeader("X-Config-Schema", buildId);
+        response->addHeader("X-Config-Generation", String((unsigned)configDocumentGeneration));
+        request->send(response);
     });
-    server.on("/config_defaults.json", HTTP_GET, [](AsyncWebServerRequest *request) {
-        auto stream = request->beginResponseStream("application/json", 1200);
-        stream->print("{");
-        const char *head = "";
-        configDefaultValuesIterate([&](const String &key, const Value &value) {
-            stream->print(head);
-            stream->print("\"");
-            stream->print(key);
-            stream->print("\":");
-            stream->print(value.toString());
-            head = ",";
+    server.on("/config_schema.json", HTTP_GET, [](AsyncWebServerRequest *request) {
+        // Only changes with the firmware, so ?v=<build> may be cached forever
+        const char *cacheControl = request->arg("v") == buildId ? "public, max-age=31536000, immutable" : "no-cache";
+        if (requestMatchesETag(request, schemaETag)) {
+            auto response = request->beginResponse(304);
+            response->addHeader("ETag", schemaETag);
+            response->addHeader("Cache-Control", cacheControl);
+            request->send(response);
+            return;
+        }
+        auto cursor = std::make_shared<ConfigSchemaCursor>();
+        auto response = request->beginChunkedResponse("application/json", [cursor](uint8_t *buffer, size_t maxLen, size_t /*index*/) -> size_t {
+            return configSchemaRead(*cursor, buffer, maxLen);
         });
-        stream->print("}");
-        request->send(stream);
+        response->addHeader("ETag", schemaETag);
+        response->addHeader("Cache-Control", cacheControl);
+        request->send(response);
     });
     server.on("/config_value", HTTP_POST, [](AsyncWebServerRequest *request) {
         const auto key = request->arg("key");
@@ -230,11 +274,342 @@ void webServerBegin() {
         const auto success = configValueSetString(key, valueString);
         request->send(200, "application/json", "{\"success\":" + String(success ? "true" : "false") + "}");
     });
+    // Body is a JSON object of name: number pairs, applied all or nothing
+    // with a single save
+    server.on("/config_values", HTTP_POST, [](AsyncWebServerRequest *request) {
+        const char *body = (const char *)request->_tempObject;
+        if (body == nullptr) {
+            request->send(400, "application/json", "{\"success\":false,\"error\":\"Missing or oversized body\"}");
+            return;
+        }
+        size_t changed = 0;
+        String error;
+        if (!configValuesApplyJson(body, strlen(body), changed, error)) {
+            String message = "{\"success\":false,\"error\":\"";
+            for (const char *c = error.c_str(); *c; ++c) {
+                if (*c == '"' || *c == '\\') {
+                    message += '\\';
+                }
+                message += *c;
+            }
+            message += "\"}";
+            request->send(400, "application/json", message);
+            return;
+        }
+        request->send(200, "application/json", "{\"success\":true,\"changed\":" + String((unsigned)changed)
+            + ",\"generation\":" + String((unsigned)configValuesGetGeneration()) + "}");
+    }, nullptr, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+        if (total > CONFIG_VALUES_BODY_MAX) {
+            return;
+        }
+        if (index == 0) {
+            request->_tempObject = malloc(total + 1);
+        }
+        char *body = (char *)request->_tempObject;
+        if (body != nullptr && index + len <= total) {
+            memcpy(body + index, data, len);
+            body[index + len] = '\0';
+        }
+    });
+    // Raw image body with X-Firmware-SHA256 and, if a key is built in,
+    // X-Firmware-Signature, both hex:
+    //     curl --data-binary @firmware.bin -H "X-Firmware-SHA256: ..." http://flybot.local/firmware
+    // The reply comes once the upload is queued; the rest is on
+    // /firmware.json and the WebSocket.
+    server.on("/firmware", HTTP_POST, [](AsyncWebServerRequest *request) {
+        const FirmwareUpload *upload = (const FirmwareUpload *)request->_tempObject;
+        if (upload == nullptr) {
+            request->send(400, "application/json", "{\"success\":false,\"error\":\"missing body\"}");
+            return;
+        }
+        if (upload->error != nullptr) {
+            request->send(upload->accepted ? 500 : 400, "application/json",
+                String("{\"success\":false,\"error\":\"") + upload->error + "\"}");
+            return;
+        }
+        request->send(202, "application/json", "{\"success\":true}");
+    }, nullptr, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+        if (index == 0) {
+            FirmwareUpload *upload = (FirmwareUpload *)malloc(sizeof(FirmwareUpload));
+            request->_tempObject = upload;
+            if (upload == nullptr) {
+                return;
+            }
+            const AsyncWebHeader *sha256 = request->getHeader("X-Firmware-SHA256");
+            const AsyncWebHeader *signature = request->getHeader("X-Firmware-Signature");
+            upload->error = nullptr;
+            upload->accepted = otaStart(total, sha256 ? sha256->value().c_str() : nullptr,
+                signature ? signature->value().c_str() : nullptr, upload->error);
+        }
+        FirmwareUpload *upload = (FirmwareUpload *)request->_tempObject;
+        if (upload == nullptr || !upload->accepted || upload->error != nullptr) {
+            return;
+        }
+        if (!otaFeed(data, len)) {
+            OtaStatus status;
+            otaGetStatus(status);
+            upload->error = status.error ? status.error : "update failed";
+        }
+    });
+    server.on("/firmware.json", HTTP_GET, [](AsyncWebServerRequest *request) {
+        OtaStatus status;
+        otaGetStatus(status);
+        char json[192];
+        formatOtaStatus(json, sizeof(json), status);
+        request->send(200, "application/json", json);
+    });
     server.on("/config_restore", HTTP_POST, [](AsyncWebServerRequest *request) {
         const auto key = request->arg("key");
         const auto success = configValueRestore(key);
         request->send(200, "application/json", "{\"success\":" + String(success ? "true" : "false") + "}");
     });
+    server.on("/spectrum", HTTP_GET, [](AsyncWebServerRequest *request) {
+        static GyroSpectrum spectrum;
+        if (!gyroAnalyzerGetSpectrum(spectrum)) {
+            request->send(503, "application/json", "{\"error\":\"no spectrum yet\"}");
+            return;
+        }
+        auto stream = request->beginResponseStream("application/json", 3200);
+        stream->printf("{\"binHz\":%g,\"seq\":%u,\"dropped\":%u,\"peaks\":[%g,%g,%g]",
+            spectrum.binHz, (unsigned)spectrum.sequence, (unsigned)spectrum.droppedSamples,
+            spectrum.peakHz[0], spectrum.peakHz[1], spectrum.peakHz[2]);
+        const char *axisNames[3] = { "x", "y", "z" };
+        for (size_t axis = 0; axis < 3; ++axis) {
+            stream->printf(",\"%s\":[", axisNames[axis]);
+            for (size_t k = 0; k < GYRO_FFT_BINS; ++k) {
+                stream->printf(k == 0 ? "%.4f" : ",%.4f", spectrum.magnitude[axis][k]);
+            }
+            stream->print("]");
+        }
+        stream->print("}");
+        request->send(stream);
+    });
+    server.on("/scheduler.json", HTTP_GET, [](AsyncWebServerRequest *request) {
+        const Scheduler &scheduler = controlLoopGetScheduler();
+        auto stream = request->beginResponseStream("application/json", 600);
+        stream->printf("{\"tickHz\":%g,\"overruns\":%u,\"lastTickUs\":%u,\"maxTickUs\":%u,\"stages\":[",
+            controlLoopGetRateHz(), (unsigned)scheduler.getOverruns(),
+            (unsigned)scheduler.getLastTickMicros(), (unsigned)scheduler.getMaxTickMicros());
+        for (size_t i = 0; i < scheduler.getNumStages(); ++i) {
+            const SchedulerStage &stage = scheduler.getStage(i);
+            stream->printf("%s{\"name\":\"%s\",\"divisor\":%u,\"runs\":%u,\"lastUs\":%u,\"avgUs\":%.1f,\"maxUs\":%u,\"budgetPct\":%.2f}",
+                i == 0 ? "" : ",", stage.name, (unsigned)stage.divisor, (unsigned)stage.runs,
+                (unsigned)stage.lastMicros, stage.avgMicros, (unsigned)stage.maxMicros,
+                scheduler.getStageBudgetPercent(i));
+        }
+        stream->print("]}");
+        request->send(stream);
+    });
+    server.on("/tasks.json", HTTP_GET, [](AsyncWebServerRequest *request) {
+        static TaskStats stats[TASKS_MAX];
+        const size_t n = tasksGetStats(stats);
+        MailboxStats mailboxes;
+        tasksGetMailboxStats(mailboxes);
+        auto stream = request->beginResponseStream("application/json", 1000);
+        stream->print("{\"tasks\":[");
+        for (size_t i = 0; i < n; ++i) {
+            const TaskStats &t = stats[i];
+            stream->printf("%s{\"name\":\"%s\",\"core\":%d,\"priority\":%u,\"cpuPct\":%.2f,\"runs\":%u,\"maxRunUs\":%u,\"stackSize\":%u,\"stackFree\":%u}",
+                i == 0 ? "" : ",", t.name, (int)t.core, (unsigned)t.priority, t.cpuPercent,
+                (unsigned)t.runs, (unsigned)t.maxRunMicros, (unsigned)t.stackSize, (unsigned)t.stackFree);
+        }
+        stream->printf("],\"mailboxes\":{\"sensorPosted\":%u,\"sensorOverwritten\":%u,\"tickTimerMissed\":%u,\"rcPosted\":%u,\"rcOverwritten\":%u}}",
+            (unsigned)mailboxes.sensorPosted, (unsigned)mailboxes.sensorOverwritten,
+            (unsigned)mailboxes.tickTimerMissed, (unsigned)mailboxes.rcPosted, (unsigned)mailboxes.rcOverwritten);
+        request->send(stream);
+    });
+    server.on("/boot.json", HTTP_GET, [](AsyncWebServerRequest *request) {
+        BootPhaseTiming phases[BP_Count];
+        bootGetPhases(phases);
+        auto stream = request->beginResponseStream("application/json", 600);
+        stream->print("{\"phases\":[");
+        for (size_t i = 0; i < BP_Count; ++i) {
+            const BootPhaseTiming &p = phases[i];
+            stream->printf("%s{\"name\":\"%s\",\"startUs\":%u,\"endUs\":%u,\"core\":%d}",
+                i == 0 ? "" : ",", p.name, (unsigned)p.startMicros, (unsigned)p.endMicros, (int)p.core);
+        }
+        stream->print("]}");
+        request->send(stream);
+    });
+    // ?fields=pitchRate,pitchRateSetpoint&ms=2000&points=250; each point is
+    // the least and greatest value over its run of samples
+    server.on("/history", HTTP_GET, [](AsyncWebServerRequest *request) {
+        // Handlers run one at a time on the web server's task
+        static uint32_t bucketTimes[HISTORY_BUCKETS_MAX];
+        static float bucketMin[HISTORY_BUCKETS_MAX];
+        static float bucketMax[HISTORY_BUCKETS_MAX];
+        bool selected[HC_Count];
+        const String fields = request->arg("fields");
+        for (size_t c = 0; c < HC_Count; ++c) {
+            selected[c] = fields.length() == 0;
+        }
+        for (int start = 0; start < (int)fields.length();) {
+            int end = fields.indexOf(',', start);
+            if (end < 0) {
+                end = fields.length();
+            }
+            const HistoryChannel channel = historyFindChannel(fields.c_str() + start, end - start);
+            if (channel == HC_Count) {
+                request->send(400, "application/json", "{\"error\":\"unknown field\"}");
+                return;
+            }
+            selected[channel] = true;
+            start = end + 1;
+        }
+        const long windowMillis = request->hasArg("ms") ? request->arg("ms").toInt() : 0;
+        const long points = request->hasArg("points") ? request->arg("points").toInt() : HISTORY_DEFAULT_BUCKETS;
+        HistoryWindow window;
+        historySelect(windowMillis > 0 ? (uint32_t)windowMillis * 1000 : 0, window);
+        const size_t buckets = historyBucketCount(window, (size_t)std::max(1L, std::min(points, (long)HISTORY_BUCKETS_MAX)));
+
+        auto stream = request->beginResponseStream("application/json", 4096);
+        stream->printf("{\"samples\":%u,\"loopHz\":%.0f,\"t\":[", (unsigned)window.count, controlLoopGetRateHz());
+        historyBucketTimes(window, buckets, bucketTimes);
+        for (size_t b = 0; b < buckets; ++b) {
+            stream->printf(b == 0 ? "%u" : ",%u", (unsigned)bucketTimes[b]);
+        }
+        stream->print("],\"fields\":{");
+        bool firstField = true;
+        for (size_t c = 0; c < HC_Count; ++c) {
+            if (!selected[c]) {
+                continue;
+            }
+            historyDecimate(window, (HistoryChannel)c, buckets, bucketMin, bucketMax);
+            stream->printf("%s\"%s\":{\"min\":[", firstField ? "" : ",", historyChannelName((HistoryChannel)c));
+            for (size_t b = 0; b < buckets; ++b) {
+                stream->printf(b == 0 ? "%.5g" : ",%.5g", bucketMin[b]);
+            }
+            stream->print("],\"max\":[");
+            for (size_t b = 0; b < buckets; ++b) {
+                stream->printf(b == 0 ? "%.5g" : ",%.5g", bucketMax[b]);
+            }
+            stream->print("]}");
+            firstField = false;
+        }
+        stream->print("}}");
+        if (!historyIntact(window)) {
+            delete stream;
+            request->send(503, "application/json", "{\"error\":\"history overwritten while reading, retry\"}");
+            return;
+        }
+        request->send(stream);
+    });
+    server.on("/latency.json", HTTP_GET, [](AsyncWebServerRequest *request) {
+        static LatencyStats stats;
+        latencyGetStats(stats);
+        auto stream = request->beginResponseStream("application/json", 800);
+        stream->printf("{\"samples\":%u,\"superseded\":%u,\"window\":%u,\"pwmPeriodUs\":%u,\"segments\":[",
+            (unsigned)stats.samples, (unsigned)stats.superseded, (unsigned)stats.window,
+            (unsigned)motorsGetPwmPeriodMicros());
+        for (size_t i = 0; i < LATENCY_SEGMENTS; ++i) {
+            const LatencySegmentStats &s = stats.segments[i];
+            stream->printf("%s{\"name\":\"%s\",\"p50Us\":%u,\"p99Us\":%u,\"maxUs\":%u,\"lastUs\":%u}",
+                i == 0 ? "" : ",", s.name, (unsigned)s.p50Micros, (unsigned)s.p99Micros,
+                (unsigned)s.maxMicros, (unsigned)s.lastMicros);
+        }
+        stream->print("]}");
+        request->send(stream);
+    });
+    server.on("/watchdog.json", HTTP_GET, [](AsyncWebServerRequest *request) {
+        WatchdogStats stats;
+        watchdogGetStats(stats);
+        static WatchdogPostMortem previous;
+        int32_t resetReason = 0;
+        const bool hasPrevious = watchdogGetPreviousPostMortem(previous, resetReason);
+        auto stream = request->beginResponseStream("application/json", 2000);
+        stream->printf("{\"misses\":%u,\"lastMissUs\":%u,\"maxMissUs\":%u,\"totalMissUs\":%u,\"failsafes\":%u,\"stallUs\":%u,\"stalled\":%s,\"motorsCut\":%s,\"resetReason\":%d",
+            (unsigned)stats.misses, (unsigned)stats.lastMissMicros, (unsigned)stats.maxMissMicros,
+            (unsigned)stats.totalMissMicros, (unsigned)stats.failsafes, (unsigned)stats.stallMicros,
+            stats.stalled ? "true" : "false", stats.motorsCut ? "true" : "false", (int)resetReason);
+        if (hasPrevious) {
+            stream->printf(",\"previous\":{\"bootCount\":%u,\"ticks\":%u,\"misses\":%u,\"maxMissUs\":%u,\"failsafes\":%u,\"lastResponse\":%d,\"stallUs\":%u,\"ring\":[",
+                (unsigned)previous.bootCount, (unsigned)previous.ticks, (unsigned)previous.misses,
+                (unsigned)previous.maxMissMicros, (unsigned)previous.failsafes,
+                (int)previous.lastResponse, (unsigned)previous.stallMicros);
+            const size_t n = std::min<size_t>(previous.ticks, WATCHDOG_POST_MORTEM_TICKS);
+            for (size_t i = 0; i < n; ++i) {
+                const WatchdogTickRecord &r = previous.ring[i];
+                stream->printf("%s[%u,%u,%u]", i == 0 ? "" : ",",
+                    (unsigned)r.releasedMicros, (unsigned)r.startDelayMicros, (unsigned)r.tickMicros);
+            }
+            stream->print("]}");
+        }
+        stream->print("}");
+        request->send(stream);
+    });
+    server.on("/watchdog_inject", HTTP_POST, [](AsyncWebServerRequest *request) {
+        const auto success = watchdogInjectStall((uint32_t)request->arg("ms").toInt());
+        request->send(200, "application/json", "{\"success\":" + String(success ? "true" : "false") + "}");
+    });
+    server.on("/loop_calibrate", HTTP_POST, [](AsyncWebServerRequest *request) {
+        const bool apply = request->arg("apply") == "1";
+        const auto success = controlLoopBeginRateCalibration(apply);
+        request->send(200, "application/json", "{\"success\":" + String(success ? "true" : "false") + "}");
+    });
+    server.on("/loop_calibrate", HTTP_GET, [](AsyncWebServerRequest *request) {
+        const LoopRateCalibration cal = controlLoopGetRateCalibration();
+        auto stream = request->beginResponseStream("application/json", 200);
+        stream->printf("{\"status\":%d,\"ticks\":%u,\"worstTickUs\":%u,\"measuredAtHz\":%g,\"recommendedHz\":%g,\"applied\":%s}",
+            (int)cal.status, (unsigned)cal.ticks, (unsigned)cal.worstTickMicros,
+            cal.measuredAtHz, cal.recommendedHz, cal.applied ? "true" : "false");
+        request->send(stream);
+    });
+    server.on("/flight_transitions.json", HTTP_GET, [](AsyncWebServerRequest *request) {
+        FlightTransitionRecord records[FLIGHT_TRANSITION_RING_SIZE];
+        const size_t n = flightState.copyTransitions(records, FLIGHT_TRANSITION_RING_SIZE);
+        auto stream = request->beginResponseStream("application/json", 1200);
+        stream->printf("{\"count\":%u,\"state\":\"%s\",\"transitions\":[",
+            (unsigned)flightState.getTransitionCount(), FlightState::getStateName(flightState.getStatus()));
+        for (size_t i = 0; i < n; ++i) {
+            stream->printf("%s{\"ms\":%u,\"from\":\"%s\",\"to\":\"%s\"}",
+                i == 0 ? "" : ",", (unsigned)records[i].millis,
+                FlightState::getStateName((FlightStatus)records[i].from),
+                FlightState::getStateName((FlightStatus)records[i].to));
+        }
+        stream->print("]}");
+        request->send(stream);
+    });
+    server.on("/heap.json", HTTP_GET, [](AsyncWebServerRequest *request) {
+        static AllocStats stats;
+        allocTrackerGetStats(stats);
+        auto stream = request->beginResponseStream("application/json", 800);
+        stream->printf("{\"free\":%u,\"minFree\":%u,\"largestBlock\":%u,\"minLargestBlock\":%u,\"tracking\":%s",
+            (unsigned)stats.freeHeap, (unsigned)stats.minFreeHeap,
+            (unsigned)stats.largestFreeBlock, (unsigned)stats.minLargestFreeBlock,
+            stats.tracking ? "true" : "false");
+        if (stats.tracking) {
+            stream->printf(",\"allocations\":%u,\"hotAllocations\":%u,\"hotRegions\":%u,\"hotRegionsWithAllocations\":%u,\"maxPerRegion\":%u,\"lastHotSize\":%u,\"lastHotCaller\":\"0x%08x\",\"tasks\":[",
+                (unsigned)stats.allocations, (unsigned)stats.hotAllocations, (unsigned)stats.hotRegions,
+                (unsigned)stats.hotRegionsWithAllocations, (unsigned)stats.maxHotAllocationsPerRegion,
+                (unsigned)stats.lastHotSize, (unsigned)stats.lastHotCaller);
+            for (size_t i = 0; i < stats.numTasks; ++i) {
+                stream->printf("%s{\"name\":\"%s\",\"allocations\":%u,\"bytes\":%u}",
+                    i == 0 ? "" : ",", stats.tasks[i].name,
+                    (unsigned)stats.tasks[i].allocations, (unsigned)stats.tasks[i].bytes);
+            }
+            stream->print("]");
+        }
+        stream->print("}");
+        request->send(stream);
+    });
+    server.on("/log_stats.json", HTTP_GET, [](AsyncWebServerRequest *request) {
+        DeferredLogStats stats;
+        deferredLogGetStats(stats);
+        auto stream = request->beginResponseStream("application/json", 200);
+        stream->printf("{\"written\":%u,\"dropped\":%u,\"suppressed\":%u,\"filtered\":%u,\"output\":%u,\"highWater\":%u,\"ringSize\":%u,\"fileDropped\":%u}",
+            (unsigned)stats.written, (unsigned)stats.dropped, (unsigned)stats.suppressed,
+            (unsigned)stats.filtered, (unsigned)stats.output, (unsigned)stats.highWater,
+            (unsigned)DEFERRED_LOG_RING_SIZE, (unsigned)stats.fileDropped);
+        request->send(stream);
+    });
+    server.on("/telemetry_stats.json", HTTP_GET, [](AsyncWebServerRequest *request) {
+        TelemetryStats stats;
+        telemetryGetStats(stats);
+        auto stream = request->beginResponseStream("application/json", 200);
+        stream->printf("{\"subscribers\":%u,\"frames\":%u,\"sent\":%u,\"dropped\":%u}",
+            (unsigned)stats.subscribers, (unsigned)stats.frames, (unsigned)stats.sent, (unsigned)stats.dropped);
+        request->send(stream);
+    });
     server.on("/mpu_calibrate", HTTP_POST, [](AsyncWebServerRequest *request) {
         mpuBeginCalibration();
         request->send(200, "application/json", "{\"success\":true}");
@@ -244,32 +619,23 @@ void webServerBegin() {
         server->text(client->id(), "{\"type\":\"hello\"}");
     });
     wsHandler.onDisconnect([](AsyncWebSocket *server, uint32_t clientId) {
+        configUnsubscribe(clientId);
         server->text(clientId, "{\"type\":\"goodbye\"}");
     });
     wsHandler.onError([](AsyncWebSocket *server, AsyncWebSocketClient *client, uint16_t errorCode, const char *reason, size_t len) {
     });
     wsHandler.onMessage([](AsyncWebSocket *server, AsyncWebSocketClient *client, const uint8_t *data, size_t len) {
         if (strncmp((const char *)data, "state", min((size_t)5, len)) == 0) {
-            const State &state = getState();
-            String stateData = "{\"type\":\"state\",\"mr\":" + String(state.rollRadians, 3)
-                + ",\"mp\":" + String(state.pitchRadians, 3)
-                + ",\"my\":" + String(state.yawRadians, 3)
-                + ",\"rr\":" + String(state.rcRollRadians, 3)
-                + ",\"rp\":" + String(state.rcPitchRadians, 3)
-                + ",\"ry\":" + String(state.rcYaw, 3)
-                + ",\"rt\":" + String(state.rcThrottle, 3)
-                + ",\"fs\":" + String(state.flightStatus)
-                + ",\"hf\":" + String(state.hardwareFlags)
-                + ",\"ep\":" + String(state.pitchErrorRadians, 3)
-                + ",\"er\":" + String(state.rollErrorRadians, 3)
-                + ",\"m1\":" + String(state.motor1Command, 3)
-                + ",\"m2\":" + String(state.motor2Command, 3)
-                + ",\"m3\":" + String(state.motor3Command, 3)
-                + ",\"m4\":" + String(state.motor4Command, 3)
-                + ",\"m5\":" + String(state.motor5Command, 3)
-                + ",\"m6\":" + String(state.motor6Command, 3)
-                + "}";
-            server->text(client->id(), stateData);
+            char stateData[TELEMETRY_FRAME_MAX];
+            const size_t length = telemetryFormatState(stateData, sizeof(stateData));
+            server->text(client->id(), stateData, length);
+            return;
+        }
+        if (strncmp((const char *)data, "config", min((size_t)6, len)) == 0) {
+            // Changes from now on are pushed as "cfg" frames
+            const bool subscribed = configSubscribe(client->id());
+            server->text(client->id(), String("{\"type\":\"cfgsub\",\"ok\":") + (subscribed ? "true" : "false")
+                + ",\"g\":" + String((unsigned)configValuesGetGeneration()) + "}");
             return;
         }
         server->text(client->id(), "{\"type\":\"echo\",\"d\":\"" + String((const char *)data, len) + "\"}");
@@ -277,6 +643,35 @@ void webServerBegin() {
     wsHandler.onFragment([](AsyncWebSocket *server, AsyncWebSocketClient *client, const AwsFrameInfo *frameInfo, const uint8_t *data, size_t len) {
     });
 
+    // Server-sent State snapshots: GET /events?hz=<1-50>
+    events.authorizeConnect([](AsyncWebServerRequest *request) {
+        eventsPendingHz = request->hasArg("hz") ? request->arg("hz").toFloat() : TELEMETRY_DEFAULT_HZ;
+        return true;
+    });
+    events.onConnect([](AsyncEventSourceClient *client) {
+        for (auto &sink : eventSinks) {
+            if (sink.client == nullptr) {
+                sink.client = client;
+                if (telemetrySubscribe(&sink, eventsPendingHz)) {
+                    return;
+                }
+                sink.client = nullptr;
+                break;
+            }
+        }
+        client->close();
+    });
+    events.onDisconnect([](AsyncEventSourceClient *client) {
+        for (auto &sink : eventSinks) {
+            if (sink.client == client) {
+                telemetryUnsubscribe(&sink);
+                sink.client = nullptr;
+            }
+        }
+    });
+
     server.addHandler(&ws);
+    server.addHandler(&events);
+    deferredLogAddSink(wsLogSink);
     server.begin();
 }
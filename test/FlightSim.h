@@ -0,0 +1,112 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "ControlLoop.h"
+#include "Host.h"
+#include "MPU.h"
+#include "RadioController.h"
+
+// The flight task on the host: a level, still IMU and an SBUS receiver
+// feeding Serial2, ticked on a frozen clock. Each tick does what the
+// sensor, radio and flight tasks do for one timer period.
+
+struct StillMPU : MPU {
+    void begin() override {}
+    bool readUncalibrated(MPUData &data) override {
+        data = MPUData();
+        data.accelZ = 1.0f;
+        return true;
+    }
+};
+
+// Stick positions in [0, 1], as the receiver sends them
+struct Sticks {
+    float roll = 0.5f;
+    float pitch = 0.5f;
+    float throttle = 0.0f;
+    float yaw = 0.5f;
+};
+
+enum SimReceiver {
+    SR_Off,             // Sends nothing
+    SR_On,              // A frame every 10 ms
+    SR_FailsafeBit,     // Frames with the receiver's own failsafe flag set
+};
+
+// One 25-byte SBUS frame with the four sticks on channels 1-4
+static void simSendFrame(const Sticks &sticks, bool failsafeBit) {
+    uint16_t channels[16] = {};
+    auto encode = [](float v) { return (uint16_t)(172 + v * (1811 - 172) + 0.5f); };
+    channels[0] = encode(sticks.roll);
+    channels[1] = encode(sticks.pitch);
+    channels[2] = encode(sticks.throttle);
+    channels[3] = encode(sticks.yaw);
+    uint8_t frame[25] = {};
+    frame[0] = 0x0F;
+    uint32_t bits = 0;
+    int pending = 0;
+    int out = 1;
+    for (int i = 0; i < 16; ++i) {
+        bits |= (uint32_t)channels[i] << pending;
+        pending += 11;
+        while (pending >= 8) {
+            frame[out++] = bits & 0xFF;
+            bits >>= 8;
+            pending -= 8;
+        }
+    }
+    frame[23] = failsafeBit ? 0x08 : 0x00;
+    for (const uint8_t b : frame) {
+        Serial2.rx.push_back(b);
+    }
+}
+
+struct FlightSim {
+    StillMPU mpu;
+    Sticks sticks;
+    uint32_t now = 0;
+    uint32_t nextFrame = 0;
+    uint32_t ticks = 0;
+
+    // Call once, after any config the test sets
+    void begin() {
+        hostSetMicros(now);
+        rcBegin();
+        controlLoopBegin(mpu);
+    }
+
+    // n ticks at the configured loop rate; missed adds timer periods the
+    // loop slept through before each tick
+    void tick(SimReceiver rx, int n = 1, uint32_t missed = 0) {
+        for (int i = 0; i < n; ++i) {
+            now += controlLoopGetIntervalMicros() * (1 + missed);
+            hostSetMicros(now);
+            if (rx != SR_Off && (int32_t)(now - nextFrame) >= 0) {
+                simSendFrame(sticks, rx == SR_FailsafeBit);
+                nextFrame = now + 10000;
+            }
+            rcUpdate();
+            MPUSample sample;
+            mpu.acquire(sample);
+            controlLoopTick(sample, now, missed);
+            ticks++;
+        }
+    }
+
+    // Arming sticks held past the 2 s timer, then centered. Leaves the
+    // vehicle flying with zero throttle.
+    void arm() {
+        sticks = Sticks();
+        sticks.yaw = 1.0f;
+        sticks.pitch = 1.0f;
+        sticks.roll = 0.0f;
+        tick(SR_On, millisToTicks(2600));
+        sticks = Sticks();
+        tick(SR_On, millisToTicks(200));
+    }
+
+    int millisToTicks(uint32_t millis) const {
+        return (int)(millis * 1000 / controlLoopGetIntervalMicros());
+    }
+};
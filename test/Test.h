@@ -0,0 +1,47 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+// Checks for the host tests. A failed check prints where and carries on;
+// main returns testResult() so make stops on the first failing test.
+
+static int testFailures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        testFailures++; \
+    } \
+} while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) do { \
+    const double checkActual = (actual); \
+    const double checkExpected = (expected); \
+    if (!(std::fabs(checkActual - checkExpected) <= (tolerance))) { \
+        printf("%s:%d: %s = %g, expected %g +/- %g\n", __FILE__, __LINE__, #actual, \
+            checkActual, checkExpected, (double)(tolerance)); \
+        testFailures++; \
+    } \
+} while (0)
+
+static inline int testResult(const char *name) {
+    printf("%s: %s\n", name, testFailures == 0 ? "ok" : "FAILED");
+    return testFailures == 0 ? 0 : 1;
+}
+
+// Keeps a benchmarked result alive without the optimizer seeing through it
+static volatile float benchSink;
+
+// Nanoseconds per call of body(i) over iterations calls. Timings are only
+// printed, never checked: they are for comparing builds on one machine.
+template <typename Body>
+static double benchNanos(long iterations, Body body) {
+    const auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; ++i) {
+        body(i);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (double)iterations;
+}
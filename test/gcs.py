@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+# Independent MAVLink v2 ground station for checking the vehicle's UDP
+# endpoint: its own CRC and its own message layouts from common.xml, so it
+# shares nothing with MavLink.cpp. Against the host stand-in:
+#
+#   build/test_mavlink 14550 10 & python3 gcs.py 14550
+#
+# or against a vehicle: python3 gcs.py 14550 192.168.4.1
+# Exits non-zero when a check fails.
+import collections
+import socket
+import struct
+import sys
+import time
+
+# Message id: (CRC extra, payload layout as sent, largest fields first)
+MESSAGES = {
+    0: (50, '<IBBBBB'),               # HEARTBEAT
+    1: (124, '<IIIHHhHHHHHHb'),       # SYS_STATUS
+    20: (214, '<hBB16s'),             # PARAM_REQUEST_READ
+    21: (159, '<BB'),                 # PARAM_REQUEST_LIST
+    22: (220, '<fHH16sB'),            # PARAM_VALUE
+    23: (168, '<fBB16sB'),            # PARAM_SET
+    31: (246, '<Ifffffff'),           # ATTITUDE_QUATERNION
+    36: (222, '<I8HB'),               # SERVO_OUTPUT_RAW
+    65: (118, '<I18HBB'),             # RC_CHANNELS
+    76: (152, '<7fHBBB'),             # COMMAND_LONG
+    77: (143, '<HBBiBB'),             # COMMAND_ACK, with extensions
+    148: (178, '<QQIIIIHH8s8s8s'),    # AUTOPILOT_VERSION
+}
+PARAM_ENCODE_C_CAST = 0x20000
+MAVLINK2 = 0x2000
+
+failures = 0
+sequence = 0
+
+
+def check(ok, what):
+    global failures
+    print(('ok   ' if ok else 'FAIL ') + what)
+    if not ok:
+        failures += 1
+
+
+def x25(data, crc=0xFFFF):
+    for b in data:
+        t = b ^ (crc & 0xFF)
+        t = (t ^ (t << 4)) & 0xFF
+        crc = ((crc >> 8) ^ (t << 8) ^ (t << 3) ^ (t >> 4)) & 0xFFFF
+    return crc
+
+
+def frame(msgid, *fields):
+    global sequence
+    payload = struct.pack(MESSAGES[msgid][1], *fields)
+    while len(payload) > 1 and payload[-1] == 0:
+        payload = payload[:-1]
+    header = bytes([0xFD, len(payload), 0, 0, sequence & 0xFF, 255, 190,
+                    msgid & 0xFF, (msgid >> 8) & 0xFF, msgid >> 16])
+    sequence += 1
+    crc = x25(bytes([MESSAGES[msgid][0]]), x25(header[1:] + payload))
+    return header + payload + struct.pack('<H', crc)
+
+
+def parse(data):
+    if data[0] != 0xFD:
+        return None
+    length = data[1]
+    msgid = data[7] | data[8] << 8 | data[9] << 16
+    if msgid not in MESSAGES:
+        return None
+    crc = x25(bytes([MESSAGES[msgid][0]]), x25(data[1:10 + length]))
+    if struct.unpack('<H', data[10 + length:12 + length])[0] != crc:
+        raise ValueError('bad checksum on message %d' % msgid)
+    layout = MESSAGES[msgid][1]
+    payload = data[10:10 + length] + bytes(max(0, struct.calcsize(layout) - length))
+    return msgid, struct.unpack(layout, payload[:struct.calcsize(layout)])
+
+
+def receive_for(sock, seconds, until=None):
+    """Messages received for up to seconds, stopping early when until(msgid, fields) is true"""
+    end = time.time() + seconds
+    while time.time() < end:
+        try:
+            data, _ = sock.recvfrom(1024)
+        except socket.timeout:
+            continue
+        message = parse(data)
+        if message is None:
+            continue
+        yield message
+        if until and until(*message):
+            return
+
+
+def param_id(name):
+    return name.encode().ljust(16, b'\0')
+
+
+def main():
+    port = int(sys.argv[1]) if len(sys.argv) > 1 else 14550
+    vehicle = (sys.argv[2] if len(sys.argv) > 2 else '127.0.0.1', port)
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.settimeout(0.2)
+
+    def send(msgid, *fields):
+        sock.sendto(frame(msgid, *fields), vehicle)
+
+    # A ground station heartbeat so the vehicle knows where to send
+    send(0, 0, 6, 8, 0, 0, 3)
+    counts = collections.Counter()
+    last = {}
+    for msgid, fields in receive_for(sock, 2.0):
+        counts[msgid] += 1
+        last[msgid] = fields
+    print('2 s of streams:', dict(sorted(counts.items())))
+    for msgid, name in ((0, 'HEARTBEAT'), (1, 'SYS_STATUS'), (31, 'ATTITUDE_QUATERNION'),
+                        (36, 'SERVO_OUTPUT_RAW'), (65, 'RC_CHANNELS')):
+        check(counts[msgid] > 0, name + ' streamed')
+    if 31 in last:
+        q, rates = last[31][1:5], last[31][5:8]
+        print('attitude q', [round(x, 3) for x in q], 'rates', [round(x, 3) for x in rates])
+        check(abs(sum(x * x for x in q) - 1.0) < 0.05, 'attitude quaternion is normalized')
+
+    # The parameter encoding the vehicle declares
+    send(76, 1.0, 0, 0, 0, 0, 0, 0, 520, 1, 1, 0)
+    acks = []
+    versions = []
+    for msgid, fields in receive_for(sock, 1.0, lambda m, f: m == 148):
+        if msgid == 77 and fields[0] == 520:
+            acks.append(fields)
+        if msgid == 148:
+            versions.append(fields)
+    check(len(acks) == 1 and acks[0][1] == 0, 'REQUEST_AUTOPILOT_CAPABILITIES accepted')
+    check(len(versions) == 1, 'AUTOPILOT_VERSION sent')
+    c_cast = bool(versions and versions[0][0] & PARAM_ENCODE_C_CAST)
+    check(c_cast, 'PARAM_ENCODE_C_CAST declared')
+    check(bool(versions and versions[0][0] & MAVLINK2), 'MAVLINK2 declared')
+    send(76, 245.0, 0, 0, 0, 0, 0, 0, 512, 1, 1, 0)
+    acks = [f for m, f in receive_for(sock, 1.0, lambda m, f: m == 77) if m == 77]
+    check(len(acks) == 1 and acks[0][1] == 3, 'REQUEST_MESSAGE for an unknown message unsupported')
+
+    # The whole parameter list
+    send(21, 1, 1)
+    params = {}
+    total = None
+    for msgid, fields in receive_for(sock, 3.0, lambda m, f: total is not None and len(params) >= total):
+        if msgid == 22:
+            value, total, index, raw_id, kind = fields
+            if not c_cast and kind == 6:
+                value = struct.unpack('<i', struct.pack('<f', value))[0]
+            params[index] = (raw_id.rstrip(b'\0').decode(), value, kind)
+    ids = [p[0] for p in params.values()]
+    print('%d of %s parameters, longest id %d' % (len(params), total, max(map(len, ids), default=0)))
+    check(total is not None and len(params) == total, 'every parameter listed')
+    check(len(set(ids)) == len(ids), 'parameter ids unique')
+
+    def request(msgid, want, *fields):
+        send(msgid, *fields)
+        for m, f in receive_for(sock, 1.0, lambda m, f: m == 22 and f[3].rstrip(b'\0').decode() == want):
+            if m == 22 and f[3].rstrip(b'\0').decode() == want:
+                return f
+        return None
+
+    ints = [p for p in params.values() if p[2] == 6]
+    if ints:
+        name, value, _ = ints[0]
+        echoed = request(23, name, value + 0.4, 1, 1, param_id(name), 6)
+        check(echoed is not None and echoed[0] == value, 'int %s set to %.1f reads back %s' % (name, value + 0.4, echoed and echoed[0]))
+    if params:
+        echoed = request(20, params[0][0], 0, 1, 1, b'')
+        check(echoed is not None and echoed[2] == 0, 'read by index 0')
+    check(request(23, 'mav.rcHz', 1, 7, 1, param_id('mav.rcHz'), 6) is None, 'set for another system ignored')
+
+    print('FAILED' if failures else 'all ok')
+    return 1 if failures else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,102 @@
+#pragma once
+#include <deque>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include "esp_log.h"
+#define PROGMEM
+#define strlen_P strlen
+#define memcpy_P memcpy
+#define IRAM_ATTR
+#define RTC_NOINIT_ATTR
+#define DRAM_ATTR
+#define OUTPUT 1
+#define SERIAL_8E2 0
+#define LEDC_AUTO_CLK 0
+using std::max; using std::min; using std::abs;
+// Every non-empty String owns a heap buffer, as a String built on the
+// device may, rather than fitting std::string's inline buffer, so the
+// allocation tracker sees them
+class String {
+    std::string s;
+    void own() { if (!s.empty() && s.capacity() < 16) s.reserve(16); }
+public:
+    String() {}
+    String(const char *c) : s(c ? c : "") { own(); }
+    String(const char *c, size_t n) : s(c, n) { own(); }
+    String(const std::string &c) : s(c) { own(); }
+    String(char c) : s(1, c) { own(); }
+    String(int v) : s(std::to_string(v)) { own(); }
+    String(unsigned v) : s(std::to_string(v)) { own(); }
+    String(long v) : s(std::to_string(v)) { own(); }
+    String(unsigned long v) : s(std::to_string(v)) { own(); }
+    String(float v, int d = 2) { char b[64]; snprintf(b, 64, "%.*f", d, v); s = b; own(); }
+    String(double v, int d = 2) { char b[64]; snprintf(b, 64, "%.*f", d, v); s = b; own(); }
+    const char *c_str() const { return s.c_str(); }
+    size_t length() const { return s.size(); }
+    int indexOf(char c, unsigned int from = 0) const { size_t i = s.find(c, from); return i == std::string::npos ? -1 : (int)i; }
+    bool reserve(size_t n) { s.reserve(n); return true; }
+    long toInt() const { return atol(s.c_str()); }
+    float toFloat() const { return atof(s.c_str()); }
+    bool isEmpty() const { return s.empty(); }
+    char operator[](size_t i) const { return s[i]; }
+    bool operator==(const String &o) const { return s == o.s; }
+    bool operator==(const char *o) const { return s == o; }
+    bool operator!=(const String &o) const { return s != o.s; }
+    String &operator+=(const String &o) { s += o.s; return *this; }
+    String &operator+=(const char *o) { s += o; return *this; }
+    String &operator+=(char o) { s += o; return *this; }
+    bool concat(const char *c, size_t n) { s.append(c, n); return true; }
+    bool startsWith(const String &p) const { return s.rfind(p.s, 0) == 0; }
+    friend String operator+(const String &a, const String &b) { return String(a.s + b.s); }
+    friend String operator+(const String &a, const char *b) { return String(a.s + b); }
+    friend String operator+(const char *a, const String &b) { return String(a + b.s); }
+};
+struct Print {
+    size_t print(const char *) { return 0; }
+    size_t print(const String &) { return 0; }
+    size_t print(int) { return 0; }
+    size_t print(unsigned) { return 0; }
+    size_t print(long) { return 0; }
+    size_t print(unsigned long) { return 0; }
+    size_t print(float, int = 2) { return 0; }
+    size_t print(char) { return 0; }
+    size_t println(const char * = "") { return 0; }
+    size_t println(const String &) { return 0; }
+    size_t println(int) { return 0; }
+    size_t printf(const char *, ...) __attribute__((format(printf, 2, 3))) { return 0; }
+    size_t write(uint8_t) { return 0; }
+    size_t write(const uint8_t *, size_t n) { return n; }
+};
+struct HardwareSerial : Print {
+    void begin(unsigned long, int = 0, int = -1, int = -1, bool = false) {}
+    std::deque<int> rx;  // Host harnesses feed received bytes here
+    int available() { return (int)rx.size(); }
+    int read() { if (rx.empty()) return -1; int c = rx.front(); rx.pop_front(); return c; }
+    size_t availableForWrite() { return 0; }
+};
+extern HardwareSerial Serial, Serial2;
+unsigned long micros();
+unsigned long millis();
+void delay(unsigned long);
+void delayMicroseconds(unsigned);
+void digitalWrite(uint8_t, uint8_t);
+void pinMode(uint8_t, uint8_t);
+bool ledcAttachChannel(uint8_t, uint32_t, uint8_t, uint8_t);
+bool ledcWrite(uint8_t, uint32_t);
+bool ledcSetClockSource(int);
+bool ledcChangeFrequency(uint8_t, uint32_t, uint8_t);
+#include "esp_system_stub.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+typedef struct hw_timer_s hw_timer_t;
+hw_timer_t *timerBegin(uint32_t frequency);
+void timerAttachInterrupt(hw_timer_t *timer, void (*isr)());
+void timerAlarm(hw_timer_t *timer, uint64_t alarm_value, bool autoreload, uint64_t reload_count);
+void timerStop(hw_timer_t *timer);
+void timerStart(hw_timer_t *timer);
+#define RTC_NOINIT_ATTR
@@ -0,0 +1,4 @@
+#pragma once
+#include <Arduino.h>
+struct EEPROMClass { bool begin(size_t){return true;} template<class T> T& get(int, T& t){return t;} template<class T> const T& put(int, const T& t){return t;} bool commit(){return true;} };
+extern EEPROMClass EEPROM;
@@ -0,0 +1,72 @@
+#pragma once
+#include <Arduino.h>
+#include <functional>
+enum WebRequestMethod { HTTP_GET = 1, HTTP_POST = 2, HTTP_ANY = 3 };
+typedef int WebRequestMethodComposite;
+struct AsyncWebServerResponse { void addHeader(const char*, const char*){} void addHeader(const String&, const String&){} void setCode(int){} };
+struct AsyncResponseStream : AsyncWebServerResponse, Print {};
+struct AsyncWebServerRequest;
+typedef std::function<void(AsyncWebServerRequest*)> ArRequestHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest*, const String&, size_t, uint8_t*, size_t, bool)> ArUploadHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> ArBodyHandlerFunction;
+typedef std::function<size_t(uint8_t*, size_t, size_t)> AwsResponseFiller;
+struct AsyncWebParameter { const String &value() const; const String &name() const; };
+struct AsyncWebHeader { const String &value() const; };
+struct AsyncClient { uint32_t space(); bool canSend(); };
+struct AsyncWebServerRequest {
+    String arg(const char*) const; String arg(const String&) const;
+    bool hasArg(const char*) const; bool hasParam(const char*, bool = false) const;
+    const AsyncWebParameter *getParam(const char*, bool = false) const;
+    bool hasHeader(const char*) const; const AsyncWebHeader *getHeader(const char*) const;
+    String header(const char*) const;
+    void send(int, const char* = "", const String& = String()) {}
+    void send(int, const char*, const uint8_t*, size_t) {}
+    void send(AsyncWebServerResponse*) {}
+    AsyncResponseStream *beginResponseStream(const char*, size_t = 1460);
+    AsyncWebServerResponse *beginResponse(int, const char*, const uint8_t*, size_t);
+    AsyncWebServerResponse *beginResponse(int, const char* = "", const String& = String());
+    AsyncWebServerResponse *beginChunkedResponse(const char*, AwsResponseFiller);
+    AsyncWebServerResponse *beginResponse(const char*, size_t, AwsResponseFiller);
+    void onDisconnect(std::function<void()>);
+    AsyncClient *client();
+    void *_tempObject;
+};
+struct AsyncWebHandler {};
+struct AsyncWebServer {
+    AsyncWebServer(int) {}
+    void on(const char*, WebRequestMethodComposite, ArRequestHandlerFunction) {}
+    void on(const char*, WebRequestMethodComposite, ArRequestHandlerFunction, ArUploadHandlerFunction) {}
+    void on(const char*, WebRequestMethodComposite, ArRequestHandlerFunction, ArUploadHandlerFunction, ArBodyHandlerFunction) {}
+    void addHandler(AsyncWebHandler*) {}
+    void begin() {}
+};
+struct AwsFrameInfo {};
+struct AsyncWebSocketClient { uint32_t id(); bool canSend() const; bool queueIsFull() const; void text(const char*, size_t); void text(const String&); };
+struct AsyncWebSocketMessageBuffer {};
+struct AsyncWebSocket : AsyncWebHandler {
+    typedef std::function<void()> Handler;
+    template<class F> AsyncWebSocket(const char*, F) {}
+    void text(uint32_t, const String&) {}
+    void text(uint32_t, const char*, size_t) {}
+    void textAll(const String&) {}
+    void textAll(const char*, size_t) {}
+    size_t count() const; void cleanupClients(uint16_t = 8);
+    bool availableForWriteAll();
+};
+struct AsyncWebSocketMessageHandler {
+    int eventHandler() { return 0; }
+    void onConnect(std::function<void(AsyncWebSocket*, AsyncWebSocketClient*)>) {}
+    void onDisconnect(std::function<void(AsyncWebSocket*, uint32_t)>) {}
+    void onError(std::function<void(AsyncWebSocket*, AsyncWebSocketClient*, uint16_t, const char*, size_t)>) {}
+    void onMessage(std::function<void(AsyncWebSocket*, AsyncWebSocketClient*, const uint8_t*, size_t)>) {}
+    void onFragment(std::function<void(AsyncWebSocket*, AsyncWebSocketClient*, const AwsFrameInfo*, const uint8_t*, size_t)>) {}
+};
+struct AsyncEventSourceClient { bool send(const char*, const char* = nullptr, uint32_t = 0, uint32_t = 0); size_t packetsWaiting() const; uint32_t lastId() const; void close(); };
+struct AsyncEventSource : AsyncWebHandler {
+    AsyncEventSource(const char*) {}
+    void onConnect(std::function<void(AsyncEventSourceClient*)>) {}
+    void onDisconnect(std::function<void(AsyncEventSourceClient*)>) {}
+    void authorizeConnect(std::function<bool(AsyncWebServerRequest*)>) {}
+    void send(const char*, const char* = nullptr, uint32_t = 0, uint32_t = 0) {}
+    size_t count() const;
+};
@@ -0,0 +1,3 @@
+#pragma once
+struct MDNSResponder { bool begin(const char*){return true;} void addService(const char*,const char*,int){} };
+extern MDNSResponder MDNS;
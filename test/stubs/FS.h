@@ -0,0 +1,10 @@
+#pragma once
+#include <Arduino.h>
+#define FILE_WRITE "w"
+#define FILE_READ "r"
+#define FILE_APPEND "a"
+namespace fs {
+struct File : Print { operator bool() const { return true; } bool isDirectory(){return false;} int available(){return 0;} int read(){return -1;} void close(){} File openNextFile(){return File();} const char *name(){return "";} const char *path(){return "";} size_t size(){return 0;} size_t read(uint8_t*,size_t){return 0;} };
+struct FS { File open(const char*, const char* = FILE_READ){return File();} bool exists(const char*){return false;} bool remove(const char*){return true;} bool rename(const char*,const char*){return true;} };
+}
+using fs::File;
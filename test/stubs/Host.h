@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+#include "esp_system.h"
+
+// Knobs the host tests turn on the stubs
+
+// Freezes micros() and millis() at this time until hostUseRealTime()
+void hostSetMicros(uint32_t micros);
+void hostUseRealTime();
+
+// What esp_reset_reason() reports
+extern esp_reset_reason_t hostResetReason;
+// Calls to esp_restart(), which returns on the host
+extern int hostRestarts;
+// Task watchdog feeds, by task or by user
+extern int hostTaskWdtResets;
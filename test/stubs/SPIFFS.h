@@ -0,0 +1,4 @@
+#pragma once
+#include "FS.h"
+struct SPIFFSFS : fs::FS { bool begin(bool=false){return true;} };
+extern SPIFFSFS SPIFFS;
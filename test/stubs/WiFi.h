@@ -0,0 +1,6 @@
+#pragma once
+#include <Arduino.h>
+struct IPAddress { IPAddress(int=0,int=0,int=0,int=0){} String toString() const {return "";} };
+#define WIFI_AP 2
+struct WiFiClass { void mode(int){} bool softAPConfig(IPAddress,IPAddress,IPAddress){return true;} bool softAP(const char*){return true;} IPAddress softAPIP(){return {};} IPAddress softAPBroadcastIP(){return {};} IPAddress softAPNetworkID(){return {};} IPAddress softAPSubnetMask(){return {};} };
+extern WiFiClass WiFi;
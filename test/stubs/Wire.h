@@ -0,0 +1,4 @@
+#pragma once
+#include <Arduino.h>
+struct TwoWire { void begin(int=-1,int=-1,uint32_t=0){} void end(){} void setClock(uint32_t){} void beginTransmission(uint8_t){} size_t write(uint8_t){return 1;} uint8_t endTransmission(bool=true){return 0;} size_t requestFrom(uint8_t, size_t, bool){return 0;} int read(){return 0;} };
+extern TwoWire Wire;
@@ -0,0 +1,10 @@
+#pragma once
+#include <cstdio>
+// Formatted into a stack buffer and dropped, so the arguments are evaluated
+// as on the device and anything they allocate is counted
+#define ESP_LOG_HOST(fmt, ...) do { char hostLogLine[256]; snprintf(hostLogLine, sizeof(hostLogLine), fmt, ##__VA_ARGS__); (void)hostLogLine; } while (0)
+#define ESP_LOGE(tag, fmt, ...) ESP_LOG_HOST(fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) ESP_LOG_HOST(fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) ESP_LOG_HOST(fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) ESP_LOG_HOST(fmt, ##__VA_ARGS__)
+#define ESP_LOGV(tag, fmt, ...) ESP_LOG_HOST(fmt, ##__VA_ARGS__)
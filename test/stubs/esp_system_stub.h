@@ -0,0 +1,4 @@
+#pragma once
+#include <cstdint>
+struct EspClass { uint32_t getFreeHeap(); uint32_t getMaxAllocHeap(); uint32_t getMinFreeHeap(); uint32_t getCycleCount(); void restart(); const char *getSketchMD5(); };
+extern EspClass ESP;
@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdint>
+#include "freertos/FreeRTOS.h"
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+typedef struct esp_task_wdt_user_handle_s *esp_task_wdt_user_handle_t;
+esp_err_t esp_task_wdt_add(TaskHandle_t);
+esp_err_t esp_task_wdt_reset(void);
+esp_err_t esp_task_wdt_add_user(const char *user_name, esp_task_wdt_user_handle_t *user_handle_ret);
+esp_err_t esp_task_wdt_reset_user(esp_task_wdt_user_handle_t user_handle);
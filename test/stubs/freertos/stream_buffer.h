@@ -0,0 +1,8 @@
+#pragma once
+#include <cstddef>
+#include "FreeRTOS.h"
+typedef void *StreamBufferHandle_t;
+StreamBufferHandle_t xStreamBufferCreate(size_t, size_t);
+size_t xStreamBufferSend(StreamBufferHandle_t, const void *, size_t, TickType_t);
+size_t xStreamBufferReceive(StreamBufferHandle_t, void *, size_t, TickType_t);
+BaseType_t xStreamBufferReset(StreamBufferHandle_t);
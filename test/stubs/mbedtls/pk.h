@@ -0,0 +1,8 @@
+#pragma once
+#include <cstddef>
+typedef enum { MBEDTLS_MD_NONE = 0, MBEDTLS_MD_SHA256 = 9 } mbedtls_md_type_t;
+typedef struct { void *key; } mbedtls_pk_context;
+void mbedtls_pk_init(mbedtls_pk_context *);
+void mbedtls_pk_free(mbedtls_pk_context *);
+int mbedtls_pk_parse_public_key(mbedtls_pk_context *, const unsigned char *, size_t);
+int mbedtls_pk_verify(mbedtls_pk_context *, mbedtls_md_type_t, const unsigned char *, size_t, const unsigned char *, size_t);
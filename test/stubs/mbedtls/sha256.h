@@ -0,0 +1,8 @@
+#pragma once
+#include <cstddef>
+typedef struct { unsigned char opaque[128]; } mbedtls_sha256_context;
+void mbedtls_sha256_init(mbedtls_sha256_context *);
+void mbedtls_sha256_free(mbedtls_sha256_context *);
+int mbedtls_sha256_starts(mbedtls_sha256_context *, int);
+int mbedtls_sha256_update(mbedtls_sha256_context *, const unsigned char *, size_t);
+int mbedtls_sha256_finish(mbedtls_sha256_context *, unsigned char *);
@@ -0,0 +1,115 @@
+// Host stand-ins for the Arduino core, FreeRTOS and ESP-IDF calls the
+// firmware makes. Tasks are never started: tests call the task bodies' work
+// functions themselves.
+#include <Arduino.h>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+
+#include <EEPROM.h>
+#include <ESPmDNS.h>
+#include <SPIFFS.h>
+#include <WiFi.h>
+#include <Wire.h>
+#include <esp_app_desc.h>
+#include <esp_random.h>
+#include <esp_system.h>
+#include <esp_task_wdt.h>
+
+#include "Host.h"
+
+HardwareSerial Serial, Serial2;
+SPIFFSFS SPIFFS;
+EEPROMClass EEPROM;
+MDNSResponder MDNS;
+WiFiClass WiFi;
+TwoWire Wire;
+EspClass ESP;
+
+static const auto startTime = std::chrono::steady_clock::now();
+static bool frozen = false;
+static uint32_t frozenMicros = 0;
+
+void hostSetMicros(uint32_t micros) {
+    frozen = true;
+    frozenMicros = micros;
+}
+
+void hostUseRealTime() {
+    frozen = false;
+}
+
+unsigned long micros() {
+    if (frozen) {
+        return frozenMicros;
+    }
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+unsigned long millis() { return micros() / 1000; }
+void delay(unsigned long) {}
+void delayMicroseconds(unsigned) {}
+void digitalWrite(uint8_t, uint8_t) {}
+void pinMode(uint8_t, uint8_t) {}
+bool ledcAttachChannel(uint8_t, uint32_t, uint8_t, uint8_t) { return true; }
+bool ledcWrite(uint8_t, uint32_t) { return true; }
+bool ledcSetClockSource(int) { return true; }
+bool ledcChangeFrequency(uint8_t, uint32_t, uint8_t) { return true; }
+
+uint32_t EspClass::getFreeHeap() { return 0; }
+uint32_t EspClass::getMaxAllocHeap() { return 0; }
+uint32_t EspClass::getMinFreeHeap() { return 0; }
+uint32_t EspClass::getCycleCount() { return micros() * 240; }
+void EspClass::restart() {}
+const char *EspClass::getSketchMD5() { return ""; }
+
+hw_timer_t *timerBegin(uint32_t) { return nullptr; }
+void timerAttachInterrupt(hw_timer_t *, void (*)()) {}
+void timerAlarm(hw_timer_t *, uint64_t, bool, uint64_t) {}
+void timerStop(hw_timer_t *) {}
+void timerStart(hw_timer_t *) {}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t, const char *, uint32_t, void *, UBaseType_t, TaskHandle_t *handle, BaseType_t) {
+    if (handle) {
+        *handle = nullptr;
+    }
+    return pdPASS;
+}
+void vTaskDelay(TickType_t) {}
+void vTaskDelayUntil(TickType_t *, TickType_t) {}
+BaseType_t xTaskDelayUntil(TickType_t *, TickType_t) { return pdTRUE; }
+TickType_t xTaskGetTickCount() { return (TickType_t)millis(); }
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t) { return 0; }
+TaskHandle_t xTaskGetCurrentTaskHandle() { return (TaskHandle_t)1; }
+void vTaskDelete(TaskHandle_t) {}
+BaseType_t xPortGetCoreID() { return 0; }
+uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) { return 0; }
+void vTaskNotifyGiveFromISR(TaskHandle_t, BaseType_t *) {}
+BaseType_t xTaskNotifyGive(TaskHandle_t) { return pdPASS; }
+const char *pcTaskGetName(TaskHandle_t) { return "host"; }
+
+SemaphoreHandle_t xSemaphoreCreateMutex() { return new std::mutex; }
+BaseType_t xSemaphoreTake(SemaphoreHandle_t m, TickType_t) { static_cast<std::mutex *>(m)->lock(); return pdTRUE; }
+BaseType_t xSemaphoreGive(SemaphoreHandle_t m) { static_cast<std::mutex *>(m)->unlock(); return pdTRUE; }
+
+esp_reset_reason_t hostResetReason = ESP_RST_POWERON;
+int hostRestarts = 0;
+int hostTaskWdtResets = 0;
+esp_reset_reason_t esp_reset_reason() { return hostResetReason; }
+void esp_restart() { hostRestarts++; }
+esp_err_t esp_task_wdt_add(TaskHandle_t) { return ESP_OK; }
+esp_err_t esp_task_wdt_reset() { hostTaskWdtResets++; return ESP_OK; }
+esp_err_t esp_task_wdt_add_user(const char *, esp_task_wdt_user_handle_t *handle) {
+    static int user;
+    *handle = (esp_task_wdt_user_handle_t)&user;
+    return ESP_OK;
+}
+esp_err_t esp_task_wdt_reset_user(esp_task_wdt_user_handle_t) { hostTaskWdtResets++; return ESP_OK; }
+
+int esp_app_get_elf_sha256(char *dst, size_t size) {
+    const char *hash = "0123456789abcdef0123456789abcdef";
+    const size_t n = size - 1 < 32 ? size - 1 : 32;
+    memcpy(dst, hash, n);
+    dst[n] = '\0';
+    return (int)n;
+}
+uint32_t esp_random() { return 0x12345678; }
@@ -0,0 +1,62 @@
+// The control loop built with ALLOC_TRACKING=1: every stage runs through
+// arming, flight with stick input, a failsafe descent and loop rate
+// calibrations, one applied, and no tick may allocate
+#include "AllocTracker.h"
+#include "Config.h"
+#include "ConfigValue.h"
+#include "FlightSim.h"
+#include "State.h"
+#include "Test.h"
+
+static_assert(ALLOC_TRACKING, "build with -DALLOC_TRACKING=1");
+
+AirframeConfig airframeConfig;
+
+int main() {
+    configValueSetString("control.loopHz", "1000");
+    // As on the device, where only the persistence task writes the file
+    configValuesDeferSaves(true);
+    FlightSim sim;
+    sim.begin();
+
+    sim.tick(SR_On, 500);
+    sim.arm();
+    CHECK(getState().flightStatus == FS_Flying);
+    sim.sticks.throttle = 0.5f;
+    for (int i = 0; i < 20; ++i) {
+        sim.sticks.roll = 0.5f + 0.4f * ((i % 4) - 1.5f) / 1.5f;
+        sim.sticks.pitch = 0.5f - 0.3f * ((i % 3) - 1.0f);
+        sim.tick(SR_On, 100);
+    }
+    sim.tick(SR_Off, 6000);
+    CHECK(getState().flightStatus == FS_Disarmed);
+    sim.tick(SR_On, 500);
+    CHECK(controlLoopBeginRateCalibration(false));
+    sim.tick(SR_On, 3000);
+    CHECK(controlLoopGetRateCalibration().status == LRC_Done);
+    // Applying the result sets control.loopHz from the flight task
+    CHECK(controlLoopBeginRateCalibration(true));
+    sim.tick(SR_On, 3000);
+    const LoopRateCalibration applied = controlLoopGetRateCalibration();
+    CHECK(applied.status == LRC_Done);
+    CHECK(applied.applied);
+    sim.tick(SR_On, 500);
+    CHECK_NEAR(controlLoopGetRateHz(), applied.recommendedHz, 1.0);
+
+    AllocStats stats;
+    allocTrackerGetStats(stats);
+    printf("%u ticks: %u hot regions, %u allocations in them (last %u bytes), %u elsewhere\n",
+        sim.ticks, stats.hotRegions, stats.hotAllocations, stats.lastHotSize, stats.allocations - stats.hotAllocations);
+    CHECK(stats.tracking);
+    CHECK(stats.hotRegions == sim.ticks);
+    CHECK(stats.hotAllocations == 0);
+
+    // The tracker sees an allocation inside a region
+    allocHotBegin();
+    delete new int(0);
+    allocHotEnd();
+    allocTrackerGetStats(stats);
+    CHECK(stats.hotAllocations == 1);
+
+    return testResult("alloc");
+}
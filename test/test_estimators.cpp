@@ -0,0 +1,150 @@
+// Attitude estimators on a simulated IMU: 1 kHz for 60 s of tumbling with a
+// constant gyro bias and white noise on both sensors. Each filter must pull
+// in from a wrong start, then hold tilt; the EKF must also find the bias.
+#include <random>
+#include <vector>
+
+#include "AttitudeEstimator.h"
+#include "MPU.h"
+#include "Test.h"
+
+static constexpr float RATE_HZ = 1000.0f;
+static constexpr float DT = 1.0f / RATE_HZ;
+static constexpr int SAMPLES = 60 * (int)RATE_HZ;
+static constexpr float BIAS_X = 0.02f, BIAS_Y = -0.015f, BIAS_Z = 0.01f;
+
+// Gravity seen in the body frame at orientation q
+static Vector bodyGravity(const Quaternion &q) {
+    return Vector(
+        2.0f * (q.x * q.z - q.w * q.y),
+        2.0f * (q.w * q.x + q.y * q.z),
+        q.w * q.w - q.x * q.x - q.y * q.y + q.z * q.z);
+}
+
+// Angle between the two gravity directions: the error in pitch and roll,
+// blind to heading, which no accelerometer-only filter can observe. atan2
+// rather than acos, which would read the quaternions' 1e-5 norm error as
+// a third of a degree.
+static float tiltError(const Quaternion &estimate, const Quaternion &truth) {
+    const Vector a = bodyGravity(estimate);
+    const Vector b = bodyGravity(truth);
+    const float cx = a.y * b.z - a.z * b.y;
+    const float cy = a.z * b.x - a.x * b.z;
+    const float cz = a.x * b.y - a.y * b.x;
+    const float dot = a.x * b.x + a.y * b.y + a.z * b.z;
+    return atan2f(sqrtf(cx * cx + cy * cy + cz * cz), dot) * RAD_TO_DEG_F;
+}
+
+struct Flight {
+    std::vector<MPUData> samples;
+    std::vector<Quaternion> truths;
+};
+
+static Flight simulate() {
+    std::mt19937 rng(29);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    Flight flight;
+    flight.samples.resize(SAMPLES);
+    flight.truths.resize(SAMPLES);
+    Quaternion truth;
+    for (int i = 0; i < SAMPLES; ++i) {
+        const float t = i * DT;
+        const float wx = 0.5f * sinf(t * 1.3f);
+        const float wy = 0.4f * cosf(t * 0.7f);
+        const float wz = 0.2f;
+        truth = truth * Quaternion(1.0f, 0.5f * wx * DT, 0.5f * wy * DT, 0.5f * wz * DT);
+        truth.normalize();
+        MPUData &d = flight.samples[i];
+        d.gyroX = wx + BIAS_X + 0.01f * noise(rng);
+        d.gyroY = wy + BIAS_Y + 0.01f * noise(rng);
+        d.gyroZ = wz + BIAS_Z + 0.01f * noise(rng);
+        const Vector g = bodyGravity(truth);
+        d.accelX = g.x + 0.02f * noise(rng);
+        d.accelY = g.y + 0.02f * noise(rng);
+        d.accelZ = g.z + 0.02f * noise(rng);
+        flight.truths[i] = truth;
+    }
+    return flight;
+}
+
+struct Run {
+    float convergedSeconds; // First time the tilt error falls under 2 degrees
+    double meanDeg;         // Over the second half
+    float maxDeg;           // Over the second half
+    double nanosPerSample;
+};
+
+static Run fly(AttitudeEstimator &estimator, const Flight &flight, const Quaternion &start) {
+    Run run = { -1.0f, 0.0, 0.0f, 0.0 };
+    estimator.reset(start);
+    for (int i = 0; i < SAMPLES; ++i) {
+        estimator.update(DT, flight.samples[i], true);
+        const float error = tiltError(estimator.getOrientation(), flight.truths[i]);
+        if (run.convergedSeconds < 0.0f && error < 2.0f) {
+            run.convergedSeconds = i * DT;
+        }
+        if (i >= SAMPLES / 2) {
+            run.meanDeg += error;
+            run.maxDeg = std::max(run.maxDeg, error);
+        }
+    }
+    run.meanDeg /= SAMPLES / 2;
+
+    // Timed again without the error bookkeeping
+    estimator.reset(start);
+    run.nanosPerSample = benchNanos(SAMPLES, [&](long i) {
+        estimator.update(DT, flight.samples[i], true);
+    });
+    return run;
+}
+
+int main() {
+    const Flight flight = simulate();
+    // 20 degrees off in pitch and roll at power-up
+    const Quaternion wrongStart = Quaternion::fromEulerXY(20.0f * DEG_TO_RAD_F, -20.0f * DEG_TO_RAD_F);
+
+    MadgwickEstimator madgwick;
+    MahonyEstimator mahony;
+    EKFEstimator ekf;
+    AttitudeEstimator *estimators[] = { &madgwick, &mahony, &ekf };
+    // Limits sit above what each filter reaches with its default gains
+    const float maxConverge[] = { 5.0f, 5.0f, 1.0f };
+    const double maxMean[] = { 0.5, 0.25, 0.2 };
+    const float maxPeak[] = { 1.0f, 0.5f, 0.5f };
+
+    for (int e = 0; e < 3; ++e) {
+        AttitudeEstimator &estimator = *estimators[e];
+        const Run run = fly(estimator, flight, wrongStart);
+        printf("%-9s cost %4d  %6.1f ns/sample  converged %.2f s  tilt mean %.2f deg max %.2f deg\n",
+            estimator.getName(), estimator.getCost(), run.nanosPerSample, run.convergedSeconds, run.meanDeg, run.maxDeg);
+        CHECK(run.convergedSeconds >= 0.0f && run.convergedSeconds < maxConverge[e]);
+        CHECK(run.meanDeg < maxMean[e]);
+        CHECK(run.maxDeg < maxPeak[e]);
+    }
+    // getCost() orders the filters the way the loop budget sees them
+    CHECK(mahony.getCost() < madgwick.getCost());
+    CHECK(madgwick.getCost() < ekf.getCost());
+
+    // The EKF's bias states settle on the simulated gyro offset
+    const Vector bias = ekf.getGyroBias();
+    printf("EKF bias %.4f %.4f %.4f rad/s, simulated %.4f %.4f %.4f\n", bias.x, bias.y, bias.z, BIAS_X, BIAS_Y, BIAS_Z);
+    CHECK_NEAR(bias.x, BIAS_X, 0.005);
+    CHECK_NEAR(bias.y, BIAS_Y, 0.005);
+    CHECK_NEAR(bias.z, BIAS_Z, 0.005);
+
+    // With the accelerometer rejected every filter integrates the gyro
+    // alone: one second at a known rate lands on the integrated rotation
+    for (AttitudeEstimator *estimator : estimators) {
+        estimator->reset(Quaternion());
+        MPUData d;
+        d.gyroX = 0.3f;
+        d.accelZ = 5.0f; // Nonsense that must be ignored
+        for (int i = 0; i < (int)RATE_HZ; ++i) {
+            estimator->update(DT, d, false);
+        }
+        const Quaternion q = estimator->getOrientation();
+        CHECK_NEAR(2.0f * atan2f(q.x, q.w), 0.3, 0.3 * 0.01);
+    }
+
+    return testResult("estimators");
+}
@@ -0,0 +1,150 @@
+// RC loss end to end: a simulated SBUS receiver feeding the radio task,
+// the frame timeout and the receiver's own failsafe bit entering the
+// failsafe, the throttle curve of the descent, the descent ending disarmed,
+// and what the pilot can do once the link comes back
+#include <cmath>
+
+#include "Config.h"
+#include "ConfigValue.h"
+#include "FlightSim.h"
+#include "State.h"
+#include "Test.h"
+
+AirframeConfig airframeConfig;
+
+static FlightStatus status() {
+    return getState().flightStatus;
+}
+
+int main() {
+    configValueSetString("control.loopHz", "1000");
+    configValueSetString("rc.failsafe.descentMs", "5000");
+    configValueSetString("rc.failsafe.curve", "2");
+    FlightSim sim;
+    sim.begin();
+
+    // No receiver yet: lost, and the arming sticks cannot be read
+    sim.tick(SR_Off, 100);
+    CHECK(rcIsLost());
+    CHECK(status() == FS_Disarmed);
+
+    // The receiver goes silent in flight: nothing happens until
+    // rc.failsafe.timeoutMs after the last frame
+    sim.tick(SR_On, 100);
+    sim.arm();
+    CHECK(status() == FS_Flying);
+    sim.sticks.throttle = 0.6f;
+    sim.tick(SR_On, 100);
+    CHECK(!rcIsLost());
+    CHECK(rcGetFrameAgeMicros() <= 10000);
+    const float flyingMotor = getState().motor1Command;
+    sim.tick(SR_Off, 480);
+    CHECK(status() == FS_Flying);
+    sim.tick(SR_Off, 30);
+    CHECK(status() == FS_Failsafe);
+    CHECK(rcIsLost());
+    CHECK_NEAR(rcGetLastGoodThrottle(), 0.6f, 1e-3);
+
+    // The descent starts from the last good throttle and follows
+    // 1 - x^rc.failsafe.curve over rc.failsafe.descentMs. Motor 1 carries
+    // a steady controller output on top, measured at entry.
+    const uint32_t descentMillis = 5000;
+    const float curve = 2.0f;
+    const float entryMotor = getState().motor1Command;
+    CHECK_NEAR(entryMotor, flyingMotor, 0.01);
+    const float offset = entryMotor - 0.6f;
+    float previous = entryMotor;
+    double worstCurve = 0.0;
+    for (int step = 1; step < 10; ++step) {
+        sim.tick(SR_Off, sim.millisToTicks(descentMillis / 10));
+        CHECK(status() == FS_Failsafe);
+        const float x = (float)(step * (descentMillis / 10)) / (float)descentMillis;
+        const float expected = 0.6f * (1.0f - std::pow(x, curve));
+        const float motor = getState().motor1Command;
+        worstCurve = std::max(worstCurve, (double)std::fabs(motor - offset - expected));
+        CHECK(motor < previous);
+        previous = motor;
+    }
+    CHECK(worstCurve < 0.005);
+
+    // ...and ends disarmed with the motors stopped
+    sim.tick(SR_Off, sim.millisToTicks(descentMillis / 10) + 10);
+    CHECK(status() == FS_Disarmed);
+    CHECK(getState().motor1Command == 0.0f);
+
+    // The link coming back does not re-arm
+    sim.sticks = Sticks();
+    sim.tick(SR_On, 500);
+    CHECK(!rcIsLost());
+    CHECK(status() == FS_Disarmed);
+
+    // The receiver's own failsafe bit counts as no frame
+    sim.arm();
+    sim.sticks.throttle = 0.5f;
+    sim.tick(SR_On, 100);
+    sim.tick(SR_FailsafeBit, 480);
+    CHECK(status() == FS_Flying);
+    sim.tick(SR_FailsafeBit, 30);
+    CHECK(status() == FS_Failsafe);
+    sim.tick(SR_FailsafeBit, sim.millisToTicks(descentMillis) + 10);
+    CHECK(status() == FS_Disarmed);
+
+    // A dropout shorter than the timeout is ridden through
+    sim.sticks = Sticks();
+    sim.tick(SR_On, 100);
+    sim.arm();
+    sim.tick(SR_Off, 300);
+    sim.tick(SR_On, 100);
+    CHECK(status() == FS_Flying);
+    CHECK(!rcIsLost());
+
+    // Link recovery mid-descent: the descent carries on under good frames,
+    // and the disarm sticks end it at once. The vehicle stays disarmed
+    // once the sticks center.
+    sim.sticks.throttle = 0.5f;
+    sim.tick(SR_On, 100);
+    sim.tick(SR_Off, 600);
+    CHECK(status() == FS_Failsafe);
+    sim.sticks = Sticks();
+    sim.tick(SR_On, 500);
+    CHECK(!rcIsLost());
+    CHECK(status() == FS_Failsafe);
+    CHECK(getState().motor1Command > 0.0f);
+    sim.sticks.yaw = 1.0f;
+    sim.sticks.pitch = 1.0f;
+    sim.sticks.roll = 0.0f;
+    sim.tick(SR_On, 20);
+    CHECK(status() == FS_DisarmingWaitingForNoInput);
+    CHECK(getState().motor1Command == 0.0f);
+    sim.tick(SR_On, 3000);
+    CHECK(status() == FS_DisarmingWaitingForNoInput);
+    sim.sticks = Sticks();
+    sim.tick(SR_On, 20);
+    CHECK(status() == FS_Disarmed);
+    sim.tick(SR_On, 3000);
+    CHECK(status() == FS_Disarmed);
+
+    // Frame ages are loop time, so a stalled loop times out even though
+    // each tick sees only a few periods pass
+    sim.arm();
+    CHECK(status() == FS_Flying);
+    sim.tick(SR_Off, 60, 9);
+    CHECK(status() == FS_Failsafe);
+
+    // Losing the link while arming aborts the arm
+    sim.tick(SR_Off, sim.millisToTicks(descentMillis) + 10);
+    CHECK(status() == FS_Disarmed);
+    sim.tick(SR_On, 100);
+    sim.sticks.yaw = 1.0f;
+    sim.sticks.pitch = 1.0f;
+    sim.sticks.roll = 0.0f;
+    sim.tick(SR_On, 1000);
+    CHECK(status() == FS_Arming);
+    sim.tick(SR_Off, 2000);
+    CHECK(status() == FS_Disarmed);
+
+    printf("descent from 0.6 over %d ms, curve %.1f: motor within %.4f of the curve\n",
+        (int)descentMillis, curve, worstCurve);
+
+    return testResult("failsafe");
+}
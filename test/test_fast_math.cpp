@@ -0,0 +1,96 @@
+// FastMath.h: every function swept against double-precision libm, checked
+// against the error bound documented next to it, and timed against the
+// single-precision libm call it replaces
+#include <initializer_list>
+
+#include "FastMath.h"
+#include "Test.h"
+
+static_assert(FAST_MATH, "this test measures the approximations");
+
+static constexpr int STEPS = 2000000;
+
+// Largest absolute error of f against reference over [lo, hi]
+template <typename F, typename R>
+static double sweep(double lo, double hi, F f, R reference) {
+    double worst = 0.0;
+    for (int i = 0; i <= STEPS; ++i) {
+        const float x = (float)(lo + (hi - lo) * i / STEPS);
+        worst = std::max(worst, std::fabs((double)f(x) - reference((double)x)));
+    }
+    return worst;
+}
+
+// Same, relative to the reference
+template <typename F, typename R>
+static double sweepRelative(double lo, double hi, F f, R reference) {
+    double worst = 0.0;
+    for (int i = 0; i <= STEPS; ++i) {
+        const float x = (float)(lo + (hi - lo) * i / STEPS);
+        const double r = reference((double)x);
+        worst = std::max(worst, std::fabs((double)f(x) - r) / std::fabs(r));
+    }
+    return worst;
+}
+
+int main() {
+    const double sin2Pi = sweep(-2.0 * M_PI, 2.0 * M_PI, fastSin, [](double x) { return std::sin(x); });
+    const double sin100 = sweep(-100.0, 100.0, fastSin, [](double x) { return std::sin(x); });
+    const double cos2Pi = sweep(-2.0 * M_PI, 2.0 * M_PI, fastCos, [](double x) { return std::cos(x); });
+    const double rsqrt = sweepRelative(1e-6, 1e6, fastRsqrt, [](double x) { return 1.0 / std::sqrt(x); });
+    const double rsqrtUnit = sweepRelative(0.25, 4.0, fastRsqrt, [](double x) { return 1.0 / std::sqrt(x); });
+    const double sqrtRel = sweepRelative(1e-6, 1e6, fastSqrt, [](double x) { return std::sqrt(x); });
+    const double asin = sweep(-1.0, 1.0, fastAsin, [](double x) { return std::asin(x); });
+
+    // atan2 around circles of several radii, so every octant and both
+    // branch cuts are crossed
+    double atan2 = 0.0;
+    for (const double radius : { 1e-3, 1.0, 1e3 }) {
+        for (int i = 0; i <= STEPS; ++i) {
+            const double a = -M_PI + 2.0 * M_PI * i / STEPS;
+            const float y = (float)(radius * std::sin(a));
+            const float x = (float)(radius * std::cos(a));
+            atan2 = std::max(atan2, std::fabs((double)fastAtan2(y, x) - std::atan2((double)y, (double)x)));
+        }
+    }
+
+    printf("max error: sin %.2e (2pi) %.2e (100), cos %.2e, atan2 %.2e, asin %.2e, rsqrt %.2e rel, sqrt %.2e rel\n",
+        sin2Pi, sin100, cos2Pi, atan2, asin, rsqrt, sqrtRel);
+    // The bounds in FastMath.h
+    CHECK(sin2Pi < 4e-6);
+    CHECK(sin100 < 6e-6);
+    CHECK(cos2Pi < 4e-6);
+    CHECK(atan2 < 2e-6);
+    CHECK(asin < 4e-6);
+    CHECK(rsqrt < 5e-6);
+    CHECK(rsqrtUnit < 5e-6);
+    CHECK(sqrtRel < 5e-6);
+
+    // Edges the callers rely on
+    CHECK(fastSqrt(0.0f) == 0.0f);
+    CHECK(fastSqrt(-1.0f) == 0.0f);
+    CHECK(fastAsin(1.5f) == HALF_PI_F);
+    CHECK(fastAsin(-1.5f) == -HALF_PI_F);
+    CHECK(fastAtan2(0.0f, 0.0f) == 0.0f);
+    CHECK_NEAR(fastAtan2(0.0f, -1.0f), M_PI, 1e-6);
+
+    // Inputs spread over the ranges the estimators see
+    static float inputs[4096];
+    for (int i = 0; i < 4096; ++i) {
+        inputs[i] = -3.0f + 6.0f * (float)i / 4096.0f;
+    }
+    const long n = 20000000;
+    auto at = [](long i) { return inputs[i & 4095]; };
+    const double sinFast = benchNanos(n, [&](long i) { benchSink = fastSin(at(i)); });
+    const double sinLibm = benchNanos(n, [&](long i) { benchSink = std::sin(at(i)); });
+    const double atan2Fast = benchNanos(n, [&](long i) { benchSink = fastAtan2(at(i), at(i + 7)); });
+    const double atan2Libm = benchNanos(n, [&](long i) { benchSink = std::atan2(at(i), at(i + 7)); });
+    const double asinFast = benchNanos(n, [&](long i) { benchSink = fastAsin(at(i) * 0.33f); });
+    const double asinLibm = benchNanos(n, [&](long i) { benchSink = std::asin(at(i) * 0.33f); });
+    const double rsqrtFast = benchNanos(n, [&](long i) { benchSink = fastRsqrt(at(i) + 3.5f); });
+    const double rsqrtLibm = benchNanos(n, [&](long i) { benchSink = 1.0f / std::sqrt(at(i) + 3.5f); });
+    printf("ns/call fast vs libm: sin %.1f/%.1f, atan2 %.1f/%.1f, asin %.1f/%.1f, rsqrt %.1f/%.1f\n",
+        sinFast, sinLibm, atan2Fast, atan2Libm, asinFast, asinLibm, rsqrtFast, rsqrtLibm);
+
+    return testResult("fast_math");
+}
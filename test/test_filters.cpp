@@ -0,0 +1,157 @@
+// Filters: the designed stages' frequency response, pinned at the points the
+// config documents, and FilterBank's time-domain output against it
+#include <complex>
+
+#include "Filters.h"
+#include "Test.h"
+
+// Gain of the designed cascade at hz, from the coefficients
+static double responseDb(const FilterParams &p, double hz) {
+    BiquadCoefficients stages[MAX_FILTER_STAGES];
+    const size_t n = filterBuildStages(p, stages);
+    const std::complex<double> z = std::polar(1.0, -2.0 * M_PI * hz / p.sampleHz);
+    std::complex<double> h = 1.0;
+    for (size_t i = 0; i < n; ++i) {
+        const BiquadCoefficients &c = stages[i];
+        h *= ((double)c.b0 + (double)c.b1 * z + (double)c.b2 * z * z) / (1.0 + (double)c.a1 * z + (double)c.a2 * z * z);
+    }
+    return 20.0 * std::log10(std::abs(h));
+}
+
+// Gain of a FilterBank built from p on a sine at hz, once settled. The
+// amplitude is fitted over whole periods so it does not depend on where
+// the samples land on the wave.
+static double measuredDb(const FilterParams &p, double hz) {
+    BiquadCoefficients stages[MAX_FILTER_STAGES];
+    const size_t n = filterBuildStages(p, stages);
+    FilterBank<1> bank;
+    for (size_t i = 0; i < n; ++i) {
+        bank.addStage(stages[i]);
+    }
+    const int settle = (int)p.sampleHz;
+    const int measure = (int)p.sampleHz;
+    double re = 0.0, im = 0.0;
+    for (int i = 0; i < settle + measure; ++i) {
+        const double phase = 2.0 * M_PI * hz * i / p.sampleHz;
+        float x = (float)std::sin(phase);
+        bank.apply(&x);
+        if (i >= settle) {
+            re += x * std::sin(phase);
+            im += x * std::cos(phase);
+        }
+    }
+    return 20.0 * std::log10(2.0 * std::sqrt(re * re + im * im) / measure);
+}
+
+static FilterParams lowPass(int type, float cutoffHz, float sampleHz) {
+    FilterParams p;
+    p.sampleHz = sampleHz;
+    p.lpfType = type;
+    p.lpfHz = cutoffHz;
+    return p;
+}
+
+int main() {
+    const double minus3 = 20.0 * std::log10(std::sqrt(0.5));
+
+    // Every low-pass type is -3 dB at its cutoff across the loop rates and
+    // cutoffs in use, up to fs/5 where the analog PT2 shortcut fell apart
+    const float rates[] = { 1000.0f, 2000.0f, 4000.0f, 8000.0f };
+    const float cutoffs[] = { 20.0f, 40.0f, 100.0f, 200.0f };
+    double worstCutoff = 0.0;
+    for (const float fs : rates) {
+        for (const float fc : cutoffs) {
+            for (const int type : { LPT_PT1, LPT_PT2, LPT_Biquad }) {
+                const double db = responseDb(lowPass(type, fc, fs), fc);
+                worstCutoff = std::max(worstCutoff, std::fabs(db - minus3));
+                CHECK_NEAR(db, minus3, 0.002);
+            }
+        }
+    }
+
+    // Shape around the cutoff: unity at DC, and an octave above it the
+    // PT1 falls slower than the PT2, which falls slower than the biquad
+    for (const int type : { LPT_PT1, LPT_PT2, LPT_Biquad }) {
+        CHECK_NEAR(responseDb(lowPass(type, 100.0f, 1000.0f), 0.0), 0.0, 1e-4);
+    }
+    const double pt1Octave = responseDb(lowPass(LPT_PT1, 100.0f, 1000.0f), 200.0);
+    const double pt2Octave = responseDb(lowPass(LPT_PT2, 100.0f, 1000.0f), 200.0);
+    const double biquadOctave = responseDb(lowPass(LPT_Biquad, 100.0f, 1000.0f), 200.0);
+    CHECK(pt1Octave > pt2Octave);
+    CHECK(pt2Octave > biquadOctave);
+    CHECK(biquadOctave < -12.0);
+
+    // Off and zero cutoff build no stages
+    BiquadCoefficients stages[MAX_FILTER_STAGES];
+    CHECK(filterBuildStages(lowPass(LPT_Off, 100.0f, 1000.0f), stages) == 0);
+    CHECK(filterBuildStages(lowPass(LPT_PT1, 0.0f, 1000.0f), stages) == 0);
+
+    // Notch: deep at the center, flat an octave away, and a notch at or
+    // above 0.45 fs is dropped rather than moved
+    FilterParams notch;
+    notch.sampleHz = 1000.0f;
+    notch.lpfType = LPT_Off;
+    notch.notch1Hz = 200.0f;
+    notch.notch1Q = 3.0f;
+    const double notchCenter = responseDb(notch, 200.0);
+    const double notchOctave = responseDb(notch, 100.0);
+    CHECK(notchCenter < -60.0);
+    CHECK(notchOctave > -0.3);
+    notch.notch2Hz = 450.0f;
+    notch.notch2Q = 3.0f;
+    CHECK(filterBuildStages(notch, stages) == 1);
+
+    // The bank realizes the designed response: PT2 with two notches, the
+    // full four stages, measured on sines
+    FilterParams full = lowPass(LPT_PT2, 100.0f, 1000.0f);
+    full.notch1Hz = 200.0f;
+    full.notch1Q = 3.0f;
+    full.notch2Hz = 150.0f;
+    full.notch2Q = 3.0f;
+    CHECK(filterBuildStages(full, stages) == 4);
+    double worstBank = 0.0;
+    for (const double hz : { 10.0, 50.0, 100.0, 120.0, 250.0, 300.0 }) {
+        worstBank = std::max(worstBank, std::fabs(measuredDb(full, hz) - responseDb(full, hz)));
+    }
+    CHECK(worstBank < 0.01);
+
+    // A retuned NotchBank, whose trig is the fast approximation, still
+    // notches its center
+    NotchBank<1> dynamic;
+    dynamic.setCenter(0, 180.0f, 3.0f, 1000.0f);
+    double re = 0.0, im = 0.0;
+    for (int i = 0; i < 2000; ++i) {
+        const double phase = 2.0 * M_PI * 180.0 * i / 1000.0;
+        float x = (float)std::sin(phase);
+        dynamic.apply(&x);
+        if (i >= 1000) {
+            re += x * std::sin(phase);
+            im += x * std::cos(phase);
+        }
+    }
+    const double dynamicCenter = 20.0 * std::log10(2.0 * std::sqrt(re * re + im * im) / 1000.0);
+    CHECK(dynamicCenter < -40.0);
+
+    printf("-3 dB at cutoff within %.4f dB; octave above 100 Hz: PT1 %.1f, PT2 %.1f, biquad %.1f dB\n",
+        worstCutoff, pt1Octave, pt2Octave, biquadOctave);
+    printf("notch 200 Hz Q3: %.0f dB at center, %.2f dB at 100 Hz; bank vs design %.4f dB; dynamic notch %.0f dB\n",
+        notchCenter, notchOctave, worstBank, dynamicCenter);
+
+    // The gyro path at its heaviest: four stages on three axes
+    FilterBank<3> gyro;
+    const size_t n = filterBuildStages(full, stages);
+    for (size_t i = 0; i < n; ++i) {
+        gyro.addStage(stages[i]);
+    }
+    float values[3] = { 1.0f, 2.0f, 3.0f };
+    const double bankNs = benchNanos(10000000, [&](long i) {
+        values[0] += 0.1f;
+        values[1] -= 0.1f;
+        values[2] += 0.01f;
+        gyro.apply(values);
+        benchSink = values[0];
+    });
+    printf("%zu stages x 3 axes: %.1f ns/sample\n", n, bankNs);
+
+    return testResult("filters");
+}
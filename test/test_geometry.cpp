@@ -0,0 +1,106 @@
+// Attitude error: the rotation-vector path the control tick uses against the
+// Euler round trip it replaced
+#include <random>
+
+#include "Geometry.h"
+#include "Test.h"
+
+static constexpr float DEG = DEG_TO_RAD_F;
+
+// The pre-rotation-vector tick: yaw * pitch * roll from three
+// fromEulerAngles calls, error reduced with toEulerAngles
+static Vector eulerError(const Quaternion &current, float pitch, float roll) {
+    const Quaternion qYaw;
+    const Quaternion qPitch = Quaternion::fromEulerAngles(Vector(pitch, 0.0f, 0.0f));
+    const Quaternion qRoll = Quaternion::fromEulerAngles(Vector(0.0f, roll, 0.0f));
+    const Quaternion target = qYaw * qPitch * qRoll;
+    return (current * target.inverse()).toEulerAngles();
+}
+
+static Vector rotationVectorError(const Quaternion &current, float pitch, float roll) {
+    const Quaternion target = Quaternion::fromEulerXY(pitch, roll);
+    return (current * target.inverse()).toRotationVector();
+}
+
+int main() {
+    std::mt19937 rng(26);
+    std::uniform_real_distribution<float> full(-PI_F, PI_F);
+    std::uniform_real_distribution<float> small(-5.0f * DEG, 5.0f * DEG);
+
+    // fromEulerXY is the product it replaces, at any angle
+    float worstProduct = 0.0f;
+    for (int i = 0; i < 100000; ++i) {
+        const float x = full(rng);
+        const float y = full(rng);
+        const Quaternion a = Quaternion::fromEulerXY(x, y);
+        const Quaternion b = Quaternion::fromEulerAngles(Vector(x, 0.0f, 0.0f)) * Quaternion::fromEulerAngles(Vector(0.0f, y, 0.0f));
+        worstProduct = std::max(worstProduct, std::max(std::max(fabsf(a.w - b.w), fabsf(a.x - b.x)), std::max(fabsf(a.y - b.y), fabsf(a.z - b.z))));
+    }
+    CHECK(worstProduct < 2e-5f);
+
+    // A rotation of angle about a unit axis comes back as axis * angle from
+    // either sign of the quaternion. The tolerance is fastAtan2's error
+    // doubled plus fastSqrt's relative error at pi.
+    for (int i = 0; i < 100000; ++i) {
+        Vector axis(full(rng), full(rng), full(rng));
+        axis.normalize();
+        const float angle = full(rng) * 0.999f;
+        const float s = sinf(angle * 0.5f);
+        const float c = cosf(angle * 0.5f);
+        const Vector r = Quaternion(c, axis.x * s, axis.y * s, axis.z * s).toRotationVector();
+        CHECK_NEAR(r.x, axis.x * angle, 5e-5);
+        CHECK_NEAR(r.y, axis.y * angle, 5e-5);
+        CHECK_NEAR(r.z, axis.z * angle, 5e-5);
+        const Vector flipped = Quaternion(-c, -axis.x * s, -axis.y * s, -axis.z * s).toRotationVector();
+        CHECK_NEAR(flipped.x, r.x, 5e-5);
+    }
+    CHECK_NEAR(Quaternion().toRotationVector().x, 0.0, 0.0);
+
+    // The two differ only in second-order terms. With the vehicle level in
+    // yaw that stays near 0.001 rad over +/-5 degrees; a 5 degree yaw couples
+    // into pitch and roll by about half the product of the angles.
+    float worstLevel = 0.0f;
+    float worstYawed = 0.0f;
+    for (int i = 0; i < 100000; ++i) {
+        const float pitch = small(rng);
+        const float roll = small(rng);
+        const Quaternion level = Quaternion::fromEulerAngles(Vector(small(rng), small(rng), 0.0f));
+        const Quaternion yawed = Quaternion::fromEulerAngles(Vector(small(rng), small(rng), small(rng)));
+        const Vector a = eulerError(level, pitch, roll);
+        const Vector b = rotationVectorError(level, pitch, roll);
+        worstLevel = std::max(worstLevel, std::max(fabsf(a.x - b.x), fabsf(a.y - b.y)));
+        const Vector c = eulerError(yawed, pitch, roll);
+        const Vector d = rotationVectorError(yawed, pitch, roll);
+        worstYawed = std::max(worstYawed, std::max(fabsf(c.x - d.x), fabsf(c.y - d.y)));
+    }
+    printf("fromEulerXY vs product: %.2e; rotation vector vs Euler within 5 deg: %.5f rad level, %.5f rad with yaw\n",
+        worstProduct, worstLevel, worstYawed);
+    CHECK(worstLevel < 0.0015f);
+    CHECK(worstYawed < 0.5f * (10.0f * DEG) * (5.0f * DEG) * 1.1f);
+
+    // Both paths on the same inputs; the table is built first so the timing
+    // is only the attitude math
+    const int inputs = 1024;
+    static Quaternion currents[inputs];
+    static float pitches[inputs];
+    static float rolls[inputs];
+    for (int i = 0; i < inputs; ++i) {
+        currents[i] = Quaternion::fromEulerAngles(Vector(small(rng), small(rng), small(rng)));
+        pitches[i] = small(rng);
+        rolls[i] = small(rng);
+    }
+    const long iterations = 2000000;
+    const double eulerNs = benchNanos(iterations, [](long i) {
+        const int k = (int)(i & (inputs - 1));
+        const Vector e = eulerError(currents[k], pitches[k], rolls[k]);
+        benchSink = e.x + e.y;
+    });
+    const double rotationNs = benchNanos(iterations, [](long i) {
+        const int k = (int)(i & (inputs - 1));
+        const Vector e = rotationVectorError(currents[k], pitches[k], rolls[k]);
+        benchSink = e.x + e.y;
+    });
+    printf("attitude error: Euler %.1f ns, rotation vector %.1f ns\n", eulerNs, rotationNs);
+
+    return testResult("geometry");
+}
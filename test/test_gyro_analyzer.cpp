@@ -0,0 +1,142 @@
+// GyroAnalyzer on synthetic tones: the real FFT against a direct DFT, its
+// amplitude scaling through the Hann window, and findPeak's interpolated
+// frequency. The analyzer task never runs on the host, so the source is
+// included here and the ring is drained by hand.
+#include "../GyroAnalyzer.cpp"
+
+#include <random>
+
+#include "Test.h"
+
+static constexpr float SAMPLE_HZ = 1000.0f;
+static constexpr float BIN_HZ = SAMPLE_HZ / GYRO_FFT_SIZE;
+
+// Fills work[] with a Hann-windowed tone the way analyze() does
+static void windowedTone(float amplitude, float hz, float phase) {
+    for (size_t n = 0; n < GYRO_FFT_SIZE; ++n) {
+        work[n] = amplitude * sinf(TWO_PI_F * hz * n / SAMPLE_HZ + phase) * window[n];
+    }
+}
+
+int main() {
+    gyroAnalyzerBegin();
+
+    // The split real FFT equals a direct DFT of the same input, scaled by
+    // 4/N: 2/N for a one-sided amplitude, doubled for the window's gain
+    float input[GYRO_FFT_SIZE];
+    for (size_t n = 0; n < GYRO_FFT_SIZE; ++n) {
+        input[n] = sinf(n * 0.3f) + 0.5f * cosf(n * 1.1f) + 0.1f * (float)(n % 7);
+        work[n] = input[n];
+    }
+    float magnitude[GYRO_FFT_BINS];
+    realFFTMagnitude(magnitude);
+    double worstDft = 0.0;
+    for (size_t k = 0; k < GYRO_FFT_BINS; ++k) {
+        double re = 0.0, im = 0.0;
+        for (size_t n = 0; n < GYRO_FFT_SIZE; ++n) {
+            re += input[n] * std::cos(2.0 * M_PI * k * n / GYRO_FFT_SIZE);
+            im -= input[n] * std::sin(2.0 * M_PI * k * n / GYRO_FFT_SIZE);
+        }
+        worstDft = std::max(worstDft, std::fabs(std::sqrt(re * re + im * im) * 4.0 / GYRO_FFT_SIZE - magnitude[k]));
+    }
+    CHECK(worstDft < 1e-4);
+
+    // A windowed tone on a bin center reads as its amplitude in rad/s;
+    // between bins the Hann scalloping loss is at most 1.42 dB
+    double worstCentered = 0.0;
+    float worstScallop = 1.0f;
+    for (size_t bin = 10; bin < GYRO_FFT_BINS - 10; bin += 7) {
+        for (const float phase : { 0.0f, 0.7f, 2.0f }) {
+            windowedTone(0.5f, bin * BIN_HZ, phase);
+            realFFTMagnitude(magnitude);
+            worstCentered = std::max(worstCentered, std::fabs(magnitude[bin] / 0.5 - 1.0));
+            windowedTone(0.5f, (bin + 0.5f) * BIN_HZ, phase);
+            realFFTMagnitude(magnitude);
+            worstScallop = std::min(worstScallop, std::max(magnitude[bin], magnitude[bin + 1]) / 0.5f);
+        }
+    }
+    CHECK(worstCentered < 1e-3);
+    CHECK(worstScallop > 0.84f && worstScallop < 0.86f);
+
+    // findPeak over every tenth of a bin across the tracked band. Parabolic
+    // interpolation on Hann magnitudes is biased toward the nearest bin
+    // center, by about a twentieth of a bin.
+    double worstPeak = 0.0;
+    const float minHz = dynNotchMinHz.getFloat();
+    const float maxHz = dynNotchMaxHz.getFloat();
+    for (float hz = minHz + 2.0f * BIN_HZ; hz < maxHz - 2.0f * BIN_HZ; hz += 0.1f * BIN_HZ) {
+        windowedTone(0.3f, hz, 1.0f);
+        realFFTMagnitude(magnitude);
+        const float peak = findPeak(magnitude, BIN_HZ);
+        worstPeak = std::max(worstPeak, (double)std::fabs(peak - hz));
+    }
+    CHECK(worstPeak < 0.1 * BIN_HZ);
+
+    // A tone below the band leaves only its skirt at the band edge, which
+    // is not a peak; nor is noise with nothing clear of the floor
+    for (const float hz : { 20.0f, 40.0f, 60.0f, minHz - BIN_HZ }) {
+        windowedTone(0.3f, hz, 0.0f);
+        realFFTMagnitude(magnitude);
+        CHECK(findPeak(magnitude, BIN_HZ) == 0.0f);
+    }
+    std::mt19937 rng(31);
+    std::normal_distribution<float> noise(0.0f, 0.1f);
+    for (size_t n = 0; n < GYRO_FFT_SIZE; ++n) {
+        work[n] = noise(rng) * window[n];
+    }
+    realFFTMagnitude(magnitude);
+    CHECK(findPeak(magnitude, BIN_HZ) == 0.0f);
+
+    // End to end through the ring: a tone on x, a different one on y and
+    // noise on z, pushed from the control path and drained by the analyzer
+    const float xHz = 211.7f;
+    const float yHz = 150.0f;
+    for (int i = 0; i < 4 * GYRO_FFT_SIZE; ++i) {
+        const float t = i / SAMPLE_HZ;
+        const float gyro[3] = { 0.3f * sinf(TWO_PI_F * xHz * t) + noise(rng) * 0.1f, 0.2f * sinf(TWO_PI_F * yHz * t), noise(rng) * 0.1f };
+        gyroAnalyzerPush(gyro, SAMPLE_HZ);
+        drainRing();
+    }
+    GyroSpectrum spectrum;
+    CHECK(gyroAnalyzerGetSpectrum(spectrum));
+    CHECK_NEAR(spectrum.binHz, BIN_HZ, 1e-6);
+    CHECK_NEAR(spectrum.peakHz[0], xHz, 0.1 * BIN_HZ);
+    CHECK_NEAR(spectrum.peakHz[1], yHz, 0.1 * BIN_HZ);
+    CHECK(spectrum.peakHz[2] == 0.0f);
+    CHECK(spectrum.droppedSamples == 0);
+    // One analysis every half window
+    CHECK(spectrum.sequence == 4 * GYRO_FFT_SIZE / (GYRO_FFT_SIZE / 2));
+
+    // The control path never waits: a full ring drops and counts
+    for (int i = 0; i < GYRO_RING_SIZE + 10; ++i) {
+        const float gyro[3] = { 0.0f, 0.0f, 0.0f };
+        gyroAnalyzerPush(gyro, SAMPLE_HZ);
+    }
+    drainRing();
+    CHECK(gyroAnalyzerGetSpectrum(spectrum));
+    CHECK(spectrum.droppedSamples == 10);
+
+    // Enabled notches slew from the first target toward the peak
+    dynNotchEnabled.setValue(Value::fromInt(1));
+    for (size_t axis = 0; axis < 3; ++axis) {
+        peakTargetHz[axis].store(axis == 0 ? xHz : 0.0f);
+    }
+    NotchBank<3> notches;
+    gyroAnalyzerTuneNotches(notches, SAMPLE_HZ);
+    CHECK_NEAR(notches.getCenter(0), xHz, 1e-3);
+    peakTargetHz[0].store(xHz + 10.0f);
+    gyroAnalyzerTuneNotches(notches, SAMPLE_HZ);
+    CHECK_NEAR(notches.getCenter(0), xHz + 10.0f * dynNotchSlew.getFloat(), 1e-3);
+    CHECK(notches.getCenter(1) == 0.0f);
+    dynNotchEnabled.setValue(Value::fromInt(0));
+    gyroAnalyzerTuneNotches(notches, SAMPLE_HZ);
+    CHECK(notches.getCenter(0) == 0.0f);
+
+    printf("FFT vs DFT %.1e; centered amplitude %.1e, worst scalloping %.3f; peak error %.3f Hz (bin %.2f Hz)\n",
+        worstDft, worstCentered, worstScallop, worstPeak, BIN_HZ);
+
+    const double analyzeNs = benchNanos(2000, [](long) { analyze(SAMPLE_HZ); });
+    printf("analyze, 3 axes of %d points: %.1f us\n", GYRO_FFT_SIZE, analyzeNs / 1000.0);
+
+    return testResult("gyro_analyzer");
+}
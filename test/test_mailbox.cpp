@@ -0,0 +1,91 @@
+// LatestMailbox: take before and after posts, overwritten counting, and a
+// producer thread posting at full speed against a consumer that checks
+// every value it takes is whole and newer than the last
+#include <thread>
+
+#include "Mailbox.h"
+#include "Test.h"
+
+// Large enough that a torn copy would show
+struct Frame {
+    uint32_t words[32];
+};
+
+static void fill(Frame &frame, uint32_t value) {
+    for (uint32_t &word : frame.words) {
+        word = value;
+    }
+}
+
+static bool whole(const Frame &frame) {
+    for (uint32_t word : frame.words) {
+        if (word != frame.words[0]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    // Nothing to take until something is posted, and each value only once
+    LatestMailbox<Frame> mailbox;
+    Frame frame;
+    fill(frame, 7);
+    CHECK(!mailbox.take(frame));
+    CHECK(frame.words[0] == 7);
+    fill(frame, 1);
+    mailbox.post(frame);
+    fill(frame, 0);
+    CHECK(mailbox.take(frame));
+    CHECK(frame.words[0] == 1);
+    CHECK(!mailbox.take(frame));
+
+    // Only the latest of several posts is taken; the rest count as overwritten
+    for (uint32_t i = 2; i <= 5; ++i) {
+        fill(frame, i);
+        mailbox.post(frame);
+    }
+    CHECK(mailbox.take(frame));
+    CHECK(frame.words[0] == 5);
+    CHECK(mailbox.getPosted() == 5);
+    CHECK(mailbox.getOverwritten() == 3);
+
+    // Concurrent: every post is either taken or overwritten
+    LatestMailbox<Frame> shared;
+    const uint32_t posts = 5000000;
+    std::thread producer([&shared, posts] {
+        Frame out;
+        for (uint32_t i = 1; i <= posts; ++i) {
+            fill(out, i);
+            shared.post(out);
+            // Hands over often, so the two interleave even on one core
+            if ((i & 15) == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    uint32_t last = 0;
+    uint32_t takes = 0;
+    uint32_t torn = 0;
+    uint32_t backwards = 0;
+    Frame in;
+    while (last < posts) {
+        if (!shared.take(in)) {
+            std::this_thread::yield();
+            continue;
+        }
+        takes++;
+        torn += whole(in) ? 0 : 1;
+        backwards += in.words[0] <= last ? 1 : 0;
+        last = in.words[0];
+    }
+    producer.join();
+    CHECK(torn == 0);
+    CHECK(backwards == 0);
+    CHECK(shared.getPosted() == posts);
+    CHECK(takes + shared.getOverwritten() == posts);
+    printf("%u posts of %zu bytes: %u taken, %u overwritten\n",
+        posts, sizeof(Frame), takes, shared.getOverwritten());
+
+    return testResult("mailbox");
+}
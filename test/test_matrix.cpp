@@ -0,0 +1,177 @@
+// Matrix.h: closed-form inverses and Cholesky against round trips, the
+// singular and indefinite inputs they must reject, and the full mixer
+// product timed against the per-motor loop MotorMixer uses
+#include <random>
+
+#include "Matrix.h"
+#include "Test.h"
+
+template <typename T, std::size_t R, std::size_t C>
+static double maxAbsDiff(const Matrix<T, R, C> &a, const Matrix<T, R, C> &b) {
+    double worst = 0.0;
+    for (std::size_t i = 0; i < R; ++i) {
+        for (std::size_t j = 0; j < C; ++j) {
+            worst = std::max(worst, std::fabs((double)a.m[i][j] - (double)b.m[i][j]));
+        }
+    }
+    return worst;
+}
+
+// Diagonally dominant, so well conditioned whatever the random entries
+template <std::size_t N>
+static Matrix<float, N, N> randomWellConditioned(std::mt19937 &rng) {
+    std::uniform_real_distribution<float> entry(-1.0f, 1.0f);
+    Matrix<float, N, N> a{};
+    for (std::size_t i = 0; i < N; ++i) {
+        for (std::size_t j = 0; j < N; ++j) {
+            a.m[i][j] = entry(rng);
+        }
+        a.m[i][i] += (float)N * (entry(rng) < 0.0f ? -1.0f : 1.0f);
+    }
+    return a;
+}
+
+// b * b^T + n * I: symmetric positive definite
+template <std::size_t N>
+static Matrix<float, N, N> randomPositiveDefinite(std::mt19937 &rng) {
+    const Matrix<float, N, N> b = randomWellConditioned<N>(rng);
+    return b * b.transpose() + Matrix<float, N, N>::identity() * (float)N;
+}
+
+// The two mixing bodies, out of line so neither is folded into the
+// benchmark loop
+__attribute__((noinline)) static void mixMatrix(const Matrix<float, 6, 4> &mixer, std::size_t numMotors, const Vector4f &command, float *outputs) {
+    const auto mixed = mixer * command;
+    for (std::size_t i = 0; i < numMotors; ++i) {
+        outputs[i] = mixed[i];
+    }
+}
+
+__attribute__((noinline)) static void mixRows(const Matrix<float, 6, 4> &mixer, std::size_t numMotors, const Vector4f &command, float *outputs) {
+    for (std::size_t i = 0; i < numMotors; ++i) {
+        float out = 0.0f;
+        out += mixer(i, 0) * command[0];
+        out += mixer(i, 1) * command[1];
+        out += mixer(i, 2) * command[2];
+        out += mixer(i, 3) * command[3];
+        outputs[i] = out;
+    }
+}
+
+int main() {
+    std::mt19937 rng(28);
+    std::uniform_real_distribution<float> entry(-1.0f, 1.0f);
+
+    // Inverses round-trip to the identity from both sides
+    double worstInverse = 0.0;
+    for (int i = 0; i < 10000; ++i) {
+        const Matrix<float, 2, 2> a2 = randomWellConditioned<2>(rng);
+        Matrix<float, 2, 2> inv2{};
+        CHECK(matrixInverse(a2, inv2));
+        worstInverse = std::max(worstInverse, maxAbsDiff(a2 * inv2, Matrix<float, 2, 2>::identity()));
+        worstInverse = std::max(worstInverse, maxAbsDiff(inv2 * a2, Matrix<float, 2, 2>::identity()));
+
+        const Matrix3f a3 = randomWellConditioned<3>(rng);
+        Matrix3f inv3{};
+        CHECK(matrixInverse(a3, inv3));
+        worstInverse = std::max(worstInverse, maxAbsDiff(a3 * inv3, Matrix3f::identity()));
+        worstInverse = std::max(worstInverse, maxAbsDiff(inv3 * a3, Matrix3f::identity()));
+    }
+    CHECK(worstInverse < 1e-6);
+
+    // Singular inputs are refused and the output is left alone
+    const Matrix<float, 2, 2> singular2 = {{{1.0f, 2.0f}, {2.0f, 4.0f}}};
+    Matrix<float, 2, 2> untouched2 = Matrix<float, 2, 2>::identity();
+    CHECK(!matrixInverse(singular2, untouched2));
+    CHECK(untouched2 == (Matrix<float, 2, 2>::identity()));
+    const Matrix3f singular3 = {{{1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}, {5.0f, 7.0f, 9.0f}}};
+    Matrix3f untouched3 = Matrix3f::identity();
+    CHECK(!matrixInverse(singular3, untouched3));
+    CHECK(untouched3 == Matrix3f::identity());
+    CHECK(!matrixInverse(Matrix3f::zero(), untouched3));
+
+    // Cholesky: l is lower triangular with a positive diagonal, l * l^T
+    // reproduces a, and the solve returns x for b = a * x
+    double worstFactor = 0.0;
+    double worstSolve = 0.0;
+    for (int i = 0; i < 10000; ++i) {
+        const Matrix4f a = randomPositiveDefinite<4>(rng);
+        Matrix4f l;
+        CHECK(matrixCholesky(a, l));
+        for (std::size_t r = 0; r < 4; ++r) {
+            CHECK(l.m[r][r] > 0.0f);
+            for (std::size_t c = r + 1; c < 4; ++c) {
+                CHECK(l.m[r][c] == 0.0f);
+            }
+        }
+        worstFactor = std::max(worstFactor, maxAbsDiff(l * l.transpose(), a) / 16.0);
+
+        Matrix<float, 4, 2> x;
+        for (std::size_t r = 0; r < 4; ++r) {
+            x.m[r][0] = entry(rng);
+            x.m[r][1] = entry(rng);
+        }
+        worstSolve = std::max(worstSolve, maxAbsDiff(matrixCholeskySolve(l, a * x), x));
+    }
+    printf("residual: inverse %.2e, Cholesky l*l^T %.2e (relative to the diagonal), solve %.2e\n",
+        worstInverse, worstFactor, worstSolve);
+    CHECK(worstFactor < 3e-7);
+    CHECK(worstSolve < 1e-5);
+
+    // Only the lower triangle is read
+    {
+        Matrix3f a = randomPositiveDefinite<3>(rng);
+        Matrix3f l;
+        Matrix3f lUpperGarbage;
+        CHECK(matrixCholesky(a, l));
+        a.m[0][1] = a.m[0][2] = a.m[1][2] = 1e9f;
+        CHECK(matrixCholesky(a, lUpperGarbage));
+        CHECK(l == lUpperGarbage);
+    }
+
+    // Not positive definite: indefinite, semidefinite and negative diagonal
+    Matrix3f l;
+    const Matrix3f indefinite = {{{1.0f, 2.0f, 0.0f}, {2.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}}};
+    CHECK(!matrixCholesky(indefinite, l));
+    const Matrix3f semidefinite = {{{1.0f, 1.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}}};
+    CHECK(!matrixCholesky(semidefinite, l));
+    CHECK(!matrixCholesky(Matrix3f::identity() * -1.0f, l));
+    CHECK(!matrixCholesky(Matrix3f::zero(), l));
+
+    // Mixer: a quad in the fixed six-row table through the matrix product,
+    // against the per-row loop over the motors present. Both agree.
+    const std::size_t numMotors = 4;
+    Matrix<float, 6, 4> mixer = Matrix<float, 6, 4>::zero();
+    const float quad[4][4] = { { 1, 1, -1, 1 }, { 1, 1, 1, -1 }, { 1, -1, 1, 1 }, { 1, -1, -1, -1 } };
+    for (std::size_t i = 0; i < numMotors; ++i) {
+        for (std::size_t j = 0; j < 4; ++j) {
+            mixer(i, j) = quad[i][j];
+        }
+    }
+    static Vector4f commands[1024];
+    for (auto &c : commands) {
+        c[0] = 0.5f + 0.5f * entry(rng);
+        c[1] = 0.2f * entry(rng);
+        c[2] = 0.2f * entry(rng);
+        c[3] = 0.2f * entry(rng);
+    }
+    static float outputs[6];
+    float expected[6];
+    mixMatrix(mixer, numMotors, commands[0], expected);
+    mixRows(mixer, numMotors, commands[0], outputs);
+    for (std::size_t i = 0; i < numMotors; ++i) {
+        CHECK_NEAR(outputs[i], expected[i], 1e-6);
+    }
+    const long iterations = 20000000;
+    const double matrixNs = benchNanos(iterations, [&](long i) {
+        mixMatrix(mixer, numMotors, commands[i & 1023], outputs);
+        benchSink = outputs[0];
+    });
+    const double rowNs = benchNanos(iterations, [&](long i) {
+        mixRows(mixer, numMotors, commands[i & 1023], outputs);
+        benchSink = outputs[0];
+    });
+    printf("quad mix: 6x4 matrix product %.1f ns, per-row loop %.1f ns\n", matrixNs, rowNs);
+
+    return testResult("matrix");
+}
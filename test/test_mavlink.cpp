@@ -0,0 +1,319 @@
+// MAVLink service over a Linux UDP socket, standing in for MavLinkUdp's
+// WiFiUDP transport, with an in-process ground station on another socket:
+// the streams and their rates, the parameter protocol with C-cast ints,
+// AUTOPILOT_VERSION on request, command acks, and no heap use while
+// polling.
+//
+// `build/test_mavlink <port> [seconds]` instead serves on 127.0.0.1:<port>
+// in real time for gcs.py, an independent ground station.
+#include <arpa/inet.h>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <new>
+#include <unistd.h>
+
+#include "Config.h"
+#include "ConfigValue.h"
+#include "Host.h"
+#include "MavLinkService.h"
+#include "State.h"
+#include "Tasks.h"
+#include "Test.h"
+
+AirframeConfig airframeConfig;
+
+size_t tasksGetStats(TaskStats *) {
+    return 0;
+}
+
+static bool countingAllocations = false;
+static long allocations = 0;
+
+void *operator new(size_t size) {
+    if (countingAllocations) {
+        allocations++;
+    }
+    void *p = std::malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+// Out of line so GCC does not see free() paired with this new
+__attribute__((noinline)) void operator delete(void *p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+static int udpSocket(uint16_t port, sockaddr_in &address) {
+    const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    if (fd < 0 || bind(fd, (sockaddr *)&address, length) != 0 || getsockname(fd, (sockaddr *)&address, &length) != 0) {
+        perror("udp socket");
+        exit(1);
+    }
+    return fd;
+}
+
+// As UdpTransport, but sends nothing until a ground station is heard
+// rather than broadcasting
+class SocketTransport : public MavLinkTransport {
+    int fd;
+    sockaddr_in peer;
+    bool heard;
+public:
+    sockaddr_in address;
+
+    explicit SocketTransport(uint16_t port) : heard(false) {
+        fd = udpSocket(port, address);
+        memset(&peer, 0, sizeof(peer));
+    }
+    size_t receive(uint8_t *buffer, size_t size) override {
+        socklen_t length = sizeof(peer);
+        const ssize_t received = recvfrom(fd, buffer, size, MSG_DONTWAIT, (sockaddr *)&peer, &length);
+        if (received <= 0) {
+            return 0;
+        }
+        heard = true;
+        return (size_t)received;
+    }
+    void send(const uint8_t *frame, size_t length) override {
+        if (heard) {
+            sendto(fd, frame, length, 0, (sockaddr *)&peer, sizeof(peer));
+        }
+    }
+};
+
+#define GCS_SYSTEM 255
+#define GCS_COMPONENT 190
+
+struct GroundStation {
+    int fd;
+    sockaddr_in address;
+    sockaddr_in vehicle;
+    MavLinkEncoder encoder;
+    MavLinkParser parser;
+    uint8_t frame[MAVLINK_FRAME_MAX];
+    std::map<uint32_t, int> counts;
+
+    explicit GroundStation(const sockaddr_in &vehicle) : vehicle(vehicle), encoder(GCS_SYSTEM, GCS_COMPONENT) {
+        fd = udpSocket(0, address);
+    }
+    void send(size_t length) {
+        sendto(fd, frame, length, 0, (const sockaddr *)&vehicle, sizeof(vehicle));
+    }
+    // The next message waiting, counted by id
+    bool receive(MavLinkMessage &out) {
+        uint8_t datagram[MAVLINK_DATAGRAM_MAX];
+        ssize_t length;
+        while ((length = recv(fd, datagram, sizeof(datagram), MSG_DONTWAIT)) > 0) {
+            for (ssize_t i = 0; i < length; ++i) {
+                if (parser.push(datagram[i])) {
+                    out = parser.message();
+                    counts[out.id]++;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+    void drain() {
+        MavLinkMessage message;
+        while (receive(message)) {
+        }
+    }
+};
+
+static uint32_t now = 1000000;
+
+// Polls every 10 ms for millis, as the network task does, counting the
+// allocations made by the polls
+static void run(uint32_t millis, GroundStation &gcs) {
+    for (uint32_t i = 0; i < millis / 10; ++i) {
+        now += 10000;
+        hostSetMicros(now);
+        countingAllocations = true;
+        mavlinkPoll(now);
+        countingAllocations = false;
+        gcs.drain();
+    }
+}
+
+// One poll, then the first message of id that came back
+static bool exchange(GroundStation &gcs, size_t length, uint32_t id, MavLinkMessage &out) {
+    gcs.send(length);
+    now += 10000;
+    hostSetMicros(now);
+    mavlinkPoll(now);
+    while (gcs.receive(out)) {
+        if (out.id == id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static MavLinkCommandLong command(uint16_t id, float param1, uint8_t targetSystem) {
+    MavLinkCommandLong c;
+    memset(&c, 0, sizeof(c));
+    c.command = id;
+    c.params[0] = param1;
+    c.targetSystem = targetSystem;
+    c.targetComponent = 1;
+    return c;
+}
+
+static void fakeFlight() {
+    stateSetHardwareFlag(HF_MPU_OK, true);
+    stateUpdateOrientation(Quaternion(0.5f, 0.5f, -0.5f, 0.5f), Vector(0.4f, -0.5f, 0.6f), true);
+    stateUpdateRC(0.1f, -0.1f, 0.5f, 0.25f, true);
+    stateUpdateMotorCommands(0.1f, 0.2f, 0.3f, 0.4f, 0.0f, 0.0f);
+}
+
+static int serve(uint16_t port, int seconds) {
+    hostUseRealTime();
+    fakeFlight();
+    SocketTransport transport(port);
+    mavlinkBegin(transport);
+    const uint32_t start = micros();
+    while (micros() - start < (uint32_t)seconds * 1000000u) {
+        mavlinkPoll(micros());
+        usleep(10000);
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) {
+        return serve((uint16_t)atoi(argv[1]), argc > 2 ? atoi(argv[2]) : 10);
+    }
+
+    hostSetMicros(now);
+    fakeFlight();
+    SocketTransport transport(0);
+    mavlinkBegin(transport);
+    GroundStation gcs(transport.address);
+    MavLinkMessage message;
+
+    // Nothing goes out until the ground station is heard
+    run(1000, gcs);
+    CHECK(gcs.counts.empty());
+    MavLinkHeartbeat heartbeat;
+    memset(&heartbeat, 0, sizeof(heartbeat));
+    heartbeat.type = 6;     // MAV_TYPE_GCS
+    heartbeat.autopilot = 8;
+    gcs.send(gcs.encoder.heartbeat(gcs.frame, heartbeat));
+
+    // Streams at their default rates, without allocating
+    run(2000, gcs);
+    CHECK(allocations == 0);
+    CHECK_NEAR(gcs.counts[MM_Heartbeat], 2, 1);
+    CHECK_NEAR(gcs.counts[MM_SysStatus], 2, 1);
+    CHECK_NEAR(gcs.counts[MM_AttitudeQuaternion], 20, 1);
+    CHECK_NEAR(gcs.counts[MM_RCChannels], 10, 1);
+    CHECK_NEAR(gcs.counts[MM_ServoOutputRaw], 10, 1);
+    CHECK(gcs.parser.getStats().crcErrors == 0);
+
+    const std::map<uint32_t, int> streamed = gcs.counts;
+
+    // ATTITUDE_QUATERNION carries the filtered body rates
+    configValueSetString("mav.attitudeHz", "50");
+    bool gotAttitude = false;
+    for (int i = 0; i < 10 && !gotAttitude; ++i) {
+        gotAttitude = exchange(gcs, gcs.encoder.heartbeat(gcs.frame, heartbeat), MM_AttitudeQuaternion, message);
+    }
+    CHECK(gotAttitude);
+    float attitude[7];
+    memcpy(attitude, message.payload + 4, sizeof(float) * 7);
+    CHECK_NEAR(attitude[0], 0.5f, 1e-6);
+    CHECK_NEAR(attitude[2], -0.5f, 1e-6);
+    CHECK_NEAR(attitude[4], -0.5f, 1e-6);    // rollspeed
+    CHECK_NEAR(attitude[5], 0.4f, 1e-6);     // pitchspeed
+    CHECK_NEAR(attitude[6], 0.6f, 1e-6);     // yawspeed
+
+    // AUTOPILOT_VERSION declares C-cast parameters, on either request
+    MavLinkCommandLong request = command(520, 1.0f, 1);
+    MavLinkAutopilotVersion version;
+    CHECK(exchange(gcs, gcs.encoder.commandLong(gcs.frame, request), MM_AutopilotVersion, message));
+    CHECK(mavlinkDecodeAutopilotVersion(message, version));
+    CHECK((version.capabilities & 0x20000) != 0);   // PARAM_ENCODE_C_CAST
+    CHECK((version.capabilities & 0x2000) != 0);    // MAVLINK2
+    CHECK(gcs.counts[MM_CommandAck] == 1);
+    request = command(512, (float)MM_AutopilotVersion, 0);
+    MavLinkCommandAck ack;
+    CHECK(exchange(gcs, gcs.encoder.commandLong(gcs.frame, request), MM_CommandAck, message));
+    CHECK(mavlinkDecodeCommandAck(message, ack));
+    CHECK(ack.command == 512);
+    CHECK(ack.result == 0);
+    CHECK(ack.targetSystem == GCS_SYSTEM);
+    CHECK(ack.targetComponent == GCS_COMPONENT);
+    run(20, gcs);
+    CHECK(gcs.counts[MM_AutopilotVersion] == 2);
+
+    // Other commands and other messages are unsupported; commands for
+    // another system get no answer
+    for (const MavLinkCommandLong &c : { command(512, 33.0f, 1), command(400, 1.0f, 1) }) {
+        CHECK(exchange(gcs, gcs.encoder.commandLong(gcs.frame, c), MM_CommandAck, message));
+        CHECK(mavlinkDecodeCommandAck(message, ack));
+        CHECK(ack.command == c.command);
+        CHECK(ack.result == 3);
+    }
+    const int acksBefore = gcs.counts[MM_CommandAck];
+    request = command(520, 1.0f, 7);
+    CHECK(!exchange(gcs, gcs.encoder.commandLong(gcs.frame, request), MM_CommandAck, message));
+    CHECK(gcs.counts[MM_CommandAck] == acksBefore);
+    CHECK(gcs.counts[MM_AutopilotVersion] == 2);
+
+    // The whole list, each index once, ints as their value in a float
+    MavLinkParamRequestList list = { 1, 1 };
+    gcs.send(gcs.encoder.paramRequestList(gcs.frame, list));
+    std::map<uint16_t, MavLinkParamValue> params;
+    uint16_t total = 0;
+    for (int i = 0; i < 200; ++i) {
+        now += 10000;
+        hostSetMicros(now);
+        mavlinkPoll(now);
+        while (gcs.receive(message)) {
+            MavLinkParamValue value;
+            if (mavlinkDecodeParamValue(message, value)) {
+                params[value.index] = value;
+                total = value.count;
+            }
+        }
+    }
+    CHECK(total == configValuesCount());
+    CHECK(params.size() == total);
+    bool foundHeartbeatHz = false;
+    for (const auto &entry : params) {
+        const MavLinkParamValue &value = entry.second;
+        if (strncmp(value.id, "mav.heartbeatHz", MAVLINK_PARAM_ID_LEN) == 0) {
+            foundHeartbeatHz = true;
+            CHECK(value.type == MPT_Int32);
+            CHECK(value.value == 1.0f);
+        }
+    }
+    CHECK(foundHeartbeatHz);
+
+    // Setting an int rounds the float, and the echo is the stored value
+    MavLinkParamSet set;
+    memset(&set, 0, sizeof(set));
+    set.targetSystem = 1;
+    set.targetComponent = 1;
+    strncpy(set.id, "mav.rcHz", MAVLINK_PARAM_ID_LEN);
+    set.value = 7.6f;
+    set.type = MPT_Int32;
+    MavLinkParamValue echoed;
+    CHECK(exchange(gcs, gcs.encoder.paramSet(gcs.frame, set), MM_ParamValue, message));
+    CHECK(mavlinkDecodeParamValue(message, echoed));
+    CHECK(echoed.value == 8.0f);
+    CHECK(echoed.type == MPT_Int32);
+
+    printf("streams over 2 s: %d heartbeat, %d status, %d attitude, %d rc, %d servo; %u parameters; %ld allocations polling\n",
+        streamed.at(MM_Heartbeat), streamed.at(MM_SysStatus), streamed.at(MM_AttitudeQuaternion),
+        streamed.at(MM_RCChannels), streamed.at(MM_ServoOutputRaw), (unsigned)total, allocations);
+
+    return testResult("mavlink");
+}
@@ -0,0 +1,251 @@
+// Flight state machine: every row of the transition table, the row priority
+// within a state, the transition ring, and no heap use along the way. The
+// radio and failsafe guards are replaced by flags the test sets.
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "Failsafe.h"
+#include "RadioController.h"
+#include "StateMachine.h"
+#include "Test.h"
+
+static bool sticksArming = false;
+static bool sticksNoInput = true;
+static bool linkLost = false;
+static bool descentDone = false;
+static int failsafeBegins = 0;
+
+// As in RadioController, the sticks read nothing while the link is lost
+bool rcIsArming() { return sticksArming && !linkLost; }
+bool rcIsNoInput() { return sticksNoInput; }
+bool rcIsLost() { return linkLost; }
+void failsafeBegin() { failsafeBegins++; }
+bool failsafeDescentComplete(uint32_t) { return descentDone; }
+
+// ARM_HOLD_MILLIS in StateMachine.cpp
+static constexpr uint32_t HOLD_MILLIS = 2000;
+
+static long allocations = 0;
+
+void *operator new(size_t size) {
+    allocations++;
+    void *p = std::malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+// Out of line so GCC does not see free() paired with this new
+__attribute__((noinline)) void operator delete(void *p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+// One machine per scenario, on its own loop clock
+struct Flight {
+    FlightState machine;
+    uint32_t now = 1000;
+
+    Flight() {
+        sticksArming = false;
+        sticksNoInput = true;
+        linkLost = false;
+        descentDone = false;
+        machine.update(now);
+    }
+
+    FlightStatus tick(uint32_t millis = 1) {
+        now += millis;
+        machine.update(now);
+        return machine.getStatus();
+    }
+
+    // Sticks to the arming position, held past the timer, then centered
+    void arm() {
+        sticksArming = true;
+        sticksNoInput = false;
+        tick();
+        tick(HOLD_MILLIS + 1);
+        sticksArming = false;
+        sticksNoInput = true;
+        tick();
+    }
+};
+
+int main() {
+    const long allocationsBefore = allocations;
+
+    // The first update enters Disarmed without recording a transition
+    {
+        Flight f;
+        CHECK(f.machine.getStatus() == FS_Disarmed);
+        CHECK(getState().flightStatus == FS_Disarmed);
+        CHECK(f.machine.getTransitionCount() == 0);
+    }
+
+    // Arm, fly and disarm: Disarmed -> Arming -> ArmingWaitingForNoInput ->
+    // Flying -> Disarming -> DisarmingWaitingForNoInput -> Disarmed
+    {
+        Flight f;
+        sticksArming = true;
+        sticksNoInput = false;
+        CHECK(f.tick() == FS_Arming);
+        // The hold is strictly longer than the timer, counted from entry
+        CHECK(f.tick(HOLD_MILLIS) == FS_Arming);
+        CHECK(f.tick() == FS_ArmingWaitingForNoInput);
+        // Still on the sticks: waits
+        CHECK(f.tick(5000) == FS_ArmingWaitingForNoInput);
+        sticksArming = false;
+        CHECK(f.tick() == FS_ArmingWaitingForNoInput);
+        sticksNoInput = true;
+        CHECK(f.tick() == FS_Flying);
+        CHECK(getState().flightStatus == FS_Flying);
+
+        sticksArming = true;
+        sticksNoInput = false;
+        CHECK(f.tick() == FS_Disarming);
+        CHECK(f.tick(HOLD_MILLIS) == FS_Disarming);
+        CHECK(f.tick() == FS_DisarmingWaitingForNoInput);
+        sticksArming = false;
+        CHECK(f.tick() == FS_DisarmingWaitingForNoInput);
+        sticksNoInput = true;
+        CHECK(f.tick() == FS_Disarmed);
+        CHECK(f.machine.getTransitionCount() == 6);
+
+        // The ring holds them oldest first, stamped with the entry time
+        FlightTransitionRecord records[FLIGHT_TRANSITION_RING_SIZE];
+        CHECK(f.machine.copyTransitions(records, FLIGHT_TRANSITION_RING_SIZE) == 6);
+        const FlightStatus path[] = { FS_Disarmed, FS_Arming, FS_ArmingWaitingForNoInput, FS_Flying,
+            FS_Disarming, FS_DisarmingWaitingForNoInput, FS_Disarmed };
+        for (size_t i = 0; i < 6; ++i) {
+            CHECK(records[i].from == path[i]);
+            CHECK(records[i].to == path[i + 1]);
+        }
+        CHECK(records[5].millis == f.now);
+        CHECK(f.machine.copyTransitions(records, 2) == 2);
+        CHECK(records[1].to == FS_Disarmed);
+    }
+
+    // Arming: releasing the sticks before the timer aborts
+    {
+        Flight f;
+        sticksArming = true;
+        sticksNoInput = false;
+        CHECK(f.tick() == FS_Arming);
+        sticksArming = false;
+        CHECK(f.tick(HOLD_MILLIS + 1) == FS_Disarmed);
+    }
+
+    // ArmingWaitingForNoInput: losing the link never lets it fly
+    {
+        Flight f;
+        sticksArming = true;
+        sticksNoInput = false;
+        f.tick();
+        CHECK(f.tick(HOLD_MILLIS + 1) == FS_ArmingWaitingForNoInput);
+        linkLost = true;
+        sticksArming = false;
+        sticksNoInput = true;
+        // rcLost comes before noInput
+        CHECK(f.tick() == FS_Disarmed);
+    }
+
+    // Flying: link loss enters the failsafe, which runs its entry action
+    // and disarms once the descent completes
+    {
+        Flight f;
+        f.arm();
+        CHECK(f.machine.getStatus() == FS_Flying);
+        const int beginsBefore = failsafeBegins;
+        linkLost = true;
+        // Sticks held in the disarm position read as nothing while lost
+        sticksArming = true;
+        CHECK(f.tick() == FS_Failsafe);
+        CHECK(getState().flightStatus == FS_Failsafe);
+        CHECK(failsafeBegins == beginsBefore + 1);
+        CHECK(f.tick(10000) == FS_Failsafe);
+        descentDone = true;
+        CHECK(f.tick() == FS_Disarmed);
+        CHECK(failsafeBegins == beginsBefore + 1);
+    }
+
+    // Failsafe: with the link back the pilot disarms at once with the
+    // sticks, which must then center before the vehicle can re-arm
+    {
+        Flight f;
+        f.arm();
+        linkLost = true;
+        CHECK(f.tick() == FS_Failsafe);
+        CHECK(f.tick(1000) == FS_Failsafe);
+        linkLost = false;
+        CHECK(f.tick(1000) == FS_Failsafe);
+        sticksArming = true;
+        sticksNoInput = false;
+        CHECK(f.tick() == FS_DisarmingWaitingForNoInput);
+        CHECK(f.tick(HOLD_MILLIS + 1) == FS_DisarmingWaitingForNoInput);
+        sticksArming = false;
+        sticksNoInput = true;
+        CHECK(f.tick() == FS_Disarmed);
+    }
+
+    // Disarming: releasing the sticks before the timer keeps flying
+    {
+        Flight f;
+        f.arm();
+        sticksArming = true;
+        sticksNoInput = false;
+        CHECK(f.tick() == FS_Disarming);
+        sticksArming = false;
+        CHECK(f.tick(HOLD_MILLIS + 1) == FS_Flying);
+    }
+
+    // Disarming: link loss mid-disarm is still a failsafe, not a drop
+    {
+        Flight f;
+        f.arm();
+        sticksArming = true;
+        sticksNoInput = false;
+        CHECK(f.tick() == FS_Disarming);
+        linkLost = true;
+        CHECK(f.tick() == FS_Failsafe);
+    }
+
+    // DisarmingWaitingForNoInput: link loss completes the disarm
+    {
+        Flight f;
+        f.arm();
+        sticksArming = true;
+        sticksNoInput = false;
+        f.tick();
+        CHECK(f.tick(HOLD_MILLIS + 1) == FS_DisarmingWaitingForNoInput);
+        linkLost = true;
+        CHECK(f.tick() == FS_Disarmed);
+    }
+
+    // The ring keeps the latest transitions once it wraps
+    {
+        Flight f;
+        for (int i = 0; i < 10; ++i) {
+            sticksArming = true;
+            f.tick();
+            sticksArming = false;
+            f.tick();
+        }
+        CHECK(f.machine.getTransitionCount() == 20);
+        FlightTransitionRecord records[FLIGHT_TRANSITION_RING_SIZE + 4];
+        CHECK(f.machine.copyTransitions(records, FLIGHT_TRANSITION_RING_SIZE + 4) == FLIGHT_TRANSITION_RING_SIZE);
+        CHECK(records[FLIGHT_TRANSITION_RING_SIZE - 1].to == FS_Disarmed);
+        CHECK(records[FLIGHT_TRANSITION_RING_SIZE - 1].millis == f.now);
+        for (size_t i = 1; i < FLIGHT_TRANSITION_RING_SIZE; ++i) {
+            CHECK(records[i].millis > records[i - 1].millis);
+        }
+    }
+
+    CHECK(allocations == allocationsBefore);
+    // The counter is live
+    delete new int(0);
+    CHECK(allocations == allocationsBefore + 1);
+    CHECK(strcmp(FlightState::getStateName(FS_Failsafe), "Failsafe") == 0);
+    CHECK(strcmp(FlightState::getStateName((FlightStatus)FLIGHT_STATE_COUNT), "Unknown") == 0);
+
+    return testResult("state_machine");
+}
@@ -0,0 +1,132 @@
+// Telemetry streaming on a frozen clock with fake transports: each
+// subscriber's rate, the rate clamps, drops while a transport is full, the
+// slot limit, and one snapshot per round shared by every subscriber due
+#include <cstring>
+#include <string>
+
+#include "Config.h"
+#include "Host.h"
+#include "State.h"
+#include "Telemetry.h"
+#include "Test.h"
+
+AirframeConfig airframeConfig;
+
+// Records what it is sent; full reports a transport that is not draining
+struct FakeSink : TelemetrySink {
+    size_t backlog = 0;
+    bool full = false;
+    uint32_t frames = 0;
+    uint32_t lastId = 0;
+    std::string last;
+
+    size_t queued() const override {
+        return full ? TELEMETRY_QUEUE_MAX : backlog;
+    }
+
+    bool send(const char *frame, size_t length, uint32_t id) override {
+        frames++;
+        lastId = id;
+        last.assign(frame, length);
+        return true;
+    }
+};
+
+static uint32_t now = 1000000;
+
+// Polls every millisecond for millis
+static void run(uint32_t millis) {
+    for (uint32_t i = 0; i < millis; ++i) {
+        now += 1000;
+        hostSetMicros(now);
+        telemetryPoll(now);
+    }
+}
+
+int main() {
+    hostSetMicros(now);
+    telemetryBegin();
+
+    // Each subscriber gets its own rate; out-of-range rates are clamped
+    FakeSink slow, fast, tooFast, tooSlow;
+    CHECK(telemetrySubscribe(&slow, 5.0f));
+    CHECK(telemetrySubscribe(&fast, 25.0f));
+    CHECK(telemetrySubscribe(&tooFast, 1000.0f));
+    CHECK(telemetrySubscribe(&tooSlow, 0.01f));
+    run(10000);
+    CHECK_NEAR(slow.frames, 50, 1);
+    CHECK_NEAR(fast.frames, 250, 1);
+    CHECK_NEAR(tooFast.frames, 10 * TELEMETRY_MAX_HZ, 1);
+    CHECK_NEAR(tooSlow.frames, 10 * TELEMETRY_MIN_HZ, 1);
+
+    // A fifth subscriber is refused until a slot frees
+    FakeSink fifth;
+    TelemetryStats stats;
+    telemetryGetStats(stats);
+    CHECK(stats.subscribers == TELEMETRY_SUBSCRIBERS_MAX);
+    CHECK(!telemetrySubscribe(&fifth, 10.0f));
+    telemetryUnsubscribe(&tooSlow);
+    CHECK(telemetrySubscribe(&fifth, 10.0f));
+    telemetryUnsubscribe(&fifth);
+    telemetryUnsubscribe(&tooFast);
+    telemetryGetStats(stats);
+    CHECK(stats.subscribers == 2);
+
+    // One snapshot per round: subscribers due together get the same frame,
+    // and rounds where nobody is due serialize nothing
+    const uint32_t framesBefore = stats.frames;
+    const uint32_t sentBefore = stats.sent;
+    run(2000);
+    telemetryGetStats(stats);
+    CHECK(stats.frames - framesBefore == 50);
+    CHECK(stats.sent - sentBefore == 60);
+    CHECK(slow.lastId == fast.lastId);
+    CHECK(slow.last == fast.last);
+    CHECK(slow.last.compare(0, 15, "{\"type\":\"state\"") == 0);
+    CHECK(slow.last.back() == '}');
+
+    // The frame carries the state as of the round
+    stateUpdateRC(0.0f, 0.0f, 0.0f, 0.75f, true);
+    run(200);
+    CHECK(fast.last.find("\"rt\":0.750") != std::string::npos);
+
+    // A full transport skips rounds, counted as drops, and gets no
+    // backlog: once it drains it is back at its rate with the latest frame
+    telemetryGetStats(stats);
+    const uint32_t droppedBefore = stats.dropped;
+    const uint32_t fastBefore = fast.frames;
+    fast.full = true;
+    run(1000);
+    telemetryGetStats(stats);
+    CHECK(fast.frames == fastBefore);
+    CHECK(stats.dropped - droppedBefore == 25);
+    fast.full = false;
+    fast.backlog = TELEMETRY_QUEUE_MAX - 1;
+    run(1000);
+    CHECK(fast.frames - fastBefore == 25);
+    CHECK(fast.lastId == slow.lastId);
+
+    // A poll that comes late does not burst to catch up
+    const uint32_t slowBefore = slow.frames;
+    now += 3000000;
+    run(1);
+    CHECK(slow.frames == slowBefore + 1);
+    run(150);
+    CHECK(slow.frames == slowBefore + 1);
+    run(100);
+    CHECK(slow.frames == slowBefore + 2);
+
+    // Unsubscribed sinks are not called again
+    telemetryUnsubscribe(&slow);
+    telemetryUnsubscribe(&fast);
+    const uint32_t fastAfter = fast.frames;
+    run(1000);
+    CHECK(fast.frames == fastAfter);
+    telemetryGetStats(stats);
+    CHECK(stats.subscribers == 0);
+
+    printf("%u snapshots, %u sent, %u dropped; a snapshot is %zu bytes\n",
+        stats.frames, stats.sent, stats.dropped, slow.last.size());
+
+    return testResult("telemetry");
+}
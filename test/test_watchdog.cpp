@@ -0,0 +1,158 @@
+// Flight loop watchdog on simulated time: deadline misses, each response,
+// the cut latch, the restart at watchdog.resetMs and the post-mortem that
+// survives it
+#include "Config.h"
+#include "ConfigValue.h"
+#include "Host.h"
+#include "Motors.h"
+#include "State.h"
+#include "Test.h"
+#include "Watchdog.h"
+
+AirframeConfig airframeConfig;
+
+static constexpr uint32_t INTERVAL = 1000;
+static uint32_t now = 0;
+
+// One healthy tick: released at the period start, 100 us late, 400 us long
+static void healthyTick() {
+    now += INTERVAL;
+    watchdogHeartbeat(now - INTERVAL, now - 900, now - 500);
+    watchdogCheck(now, INTERVAL);
+}
+
+// The flight task stops; the watchdog task keeps checking every period
+static void stalledTicks(uint32_t periods) {
+    for (uint32_t i = 0; i < periods; ++i) {
+        now += INTERVAL;
+        watchdogCheck(now, INTERVAL);
+    }
+}
+
+// healthy periods, a stall of stalled periods, then one tick that ends it
+static void run(uint32_t healthy, uint32_t stalled) {
+    for (uint32_t i = 0; i < healthy; ++i) {
+        healthyTick();
+    }
+    stalledTicks(stalled);
+    healthyTick();
+}
+
+int main() {
+    hostResetReason = ESP_RST_POWERON;
+    watchdogBegin();
+    WatchdogPostMortem record;
+    int32_t resetReason;
+    CHECK(!watchdogGetPreviousPostMortem(record, resetReason));
+    watchdogFlightTaskBegin();
+
+    // Heartbeats feed the system task watchdog
+    const int feedsBefore = hostTaskWdtResets;
+    run(100, 0);
+    CHECK(hostTaskWdtResets == feedsBefore + 101);
+
+    // Nothing is supervised before the first heartbeat, and a stall shorter
+    // than watchdog.deadlineTicks is not a miss
+    WatchdogStats stats;
+    run(100, 2);
+    watchdogGetStats(stats);
+    CHECK(stats.misses == 0);
+    CHECK(!stats.stalled);
+
+    // Log: a stall past watchdog.failsafeMs is counted and its length kept
+    configValueSetString("watchdog.response", "0");
+    run(100, 80);
+    watchdogGetStats(stats);
+    CHECK(stats.misses == 1);
+    CHECK(stats.failsafes == 1);
+    CHECK(!stats.motorsCut);
+    CHECK(stats.lastMissMicros >= 80 * INTERVAL);
+
+    // A miss that recovers before watchdog.failsafeMs takes no action
+    run(100, 20);
+    watchdogGetStats(stats);
+    CHECK(stats.misses == 2);
+    CHECK(stats.failsafes == 1);
+    CHECK(stats.maxMissMicros >= 80 * INTERVAL);
+    CHECK(stats.totalMissMicros >= 100 * INTERVAL);
+
+    // Hold: the motors keep their last outputs through the stall
+    configValueSetString("watchdog.response", "1");
+    stateSetFlightStatus(FS_Flying);
+    motorsSendCommands(0.5f, 0.5f, 0.5f, 0.5f, 0.0f, 0.0f);
+    run(100, 80);
+    watchdogGetStats(stats);
+    CHECK(stats.failsafes == 2);
+    CHECK(!stats.motorsCut);
+    CHECK(getState().motor1Command == 0.5f);
+
+    // Cut: zero outputs, latched while still flying
+    configValueSetString("watchdog.response", "2");
+    run(100, 80);
+    watchdogGetStats(stats);
+    CHECK(stats.failsafes == 3);
+    CHECK(stats.motorsCut);
+    CHECK(getState().motor1Command == 0.0f);
+    motorsSendCommands(0.6f, 0.6f, 0.6f, 0.6f, 0.0f, 0.0f);
+    CHECK(getState().motor1Command == 0.0f);
+    run(100, 0);
+    watchdogGetStats(stats);
+    CHECK(stats.motorsCut);
+
+    // Disarming on a healthy loop clears the latch
+    stateSetFlightStatus(FS_Disarmed);
+    run(5, 0);
+    watchdogGetStats(stats);
+    CHECK(!stats.motorsCut);
+    motorsSendCommands(0.1f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+    CHECK(getState().motor1Command == 0.1f);
+    CHECK(hostRestarts == 0);
+
+    // A stall reaching watchdog.resetMs restarts the chip from the watchdog
+    // task, with the outputs zeroed first. One period short does not.
+    configValueSetString("watchdog.response", "0");
+    configValueSetString("watchdog.resetMs", "200");
+    stateSetFlightStatus(FS_Flying);
+    motorsSendCommands(0.5f, 0.5f, 0.5f, 0.5f, 0.0f, 0.0f);
+    for (int i = 0; i < 40; ++i) {
+        healthyTick();
+    }
+    stalledTicks(199);
+    CHECK(hostRestarts == 0);
+    CHECK(getState().motor1Command == 0.5f);
+    stalledTicks(1);
+    CHECK(hostRestarts == 1);
+    CHECK(getState().motor1Command == 0.0f);
+
+    // The next boot finds the post-mortem: the stall in progress, the
+    // counters, the last response and the last ticks oldest first
+    hostResetReason = ESP_RST_SW;
+    watchdogBegin();
+    CHECK(watchdogGetPreviousPostMortem(record, resetReason));
+    CHECK(resetReason == ESP_RST_SW);
+    CHECK(record.stallMicros >= 200 * INTERVAL);
+    CHECK(record.misses == 5);
+    CHECK(record.failsafes == 4);
+    CHECK(record.lastResponse == WR_Log);
+    CHECK(record.ticks > WATCHDOG_POST_MORTEM_TICKS);
+    CHECK(record.bootCount == 0);
+    for (size_t i = 0; i < WATCHDOG_POST_MORTEM_TICKS; ++i) {
+        CHECK(record.ring[i].startDelayMicros == 100);
+        CHECK(record.ring[i].tickMicros == 400);
+        if (i > 0) {
+            CHECK(record.ring[i].releasedMicros == record.ring[i - 1].releasedMicros + INTERVAL);
+        }
+    }
+    printf("post-mortem: %u ticks, %u misses, %u failsafes, stalled %u us, response %d, reset reason %d\n",
+        (unsigned)record.ticks, (unsigned)record.misses, (unsigned)record.failsafes,
+        (unsigned)record.stallMicros, (int)record.lastResponse, (int)resetReason);
+
+    // Fault injection is refused unless disarmed and taken once
+    CHECK(!watchdogInjectStall(100));
+    stateSetFlightStatus(FS_Disarmed);
+    CHECK(watchdogInjectStall(100));
+    CHECK(watchdogTakeInjectedStall() == 100);
+    CHECK(watchdogTakeInjectedStall() == 0);
+
+    return testResult("watchdog");
+}
@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+"""Generates WebAssets.h from the files in web/.
+
+Each asset is lightly minified, gzip-compressed and written as a byte array
+with its length, content type and a content hash. HTML pages may refer to
+other assets as {{name}}, which is replaced with that asset's hash so the
+URL changes whenever the asset does.
+
+Run from the repository root after changing anything in web/:
+
+    python3 tools/embed_assets.py
+"""
+
+import gzip
+import hashlib
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+WEB_DIR = os.path.join(ROOT, "web")
+OUTPUT = os.path.join(ROOT, "WebAssets.h")
+
+CONTENT_TYPES = {
+    ".html": "text/html",
+    ".css": "text/css",
+    ".js": "application/javascript",
+}
+
+# Pages are served at these paths; everything else at /<file name>
+ROUTES = {
+    "index.html": "/",
+    "config.html": "/config",
+}
+
+HASH_LENGTH = 12
+
+
+def minify_js(text):
+    # Whole-line comments, indentation and blank lines only: anything
+    # cleverer needs a real tokenizer, and gzip takes most of the rest
+    lines = []
+    for line in text.splitlines():
+        stripped = line.strip()
+        if not stripped or stripped.startswith("//"):
+            continue
+        lines.append(stripped)
+    return "\n".join(lines) + "\n"
+
+
+def minify_css(text):
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    text = re.sub(r"\s+", " ", text)
+    text = re.sub(r"\s*([{};:,])\s*", r"\1", text)
+    return text.strip() + "\n"
+
+
+def minify_html(text):
+    text = re.sub(r"<!--.*?-->", "", text, flags=re.S)
+    lines = [line.strip() for line in text.splitlines()]
+    return "\n".join(line for line in lines if line) + "\n"
+
+
+MINIFIERS = {
+    ".html": minify_html,
+    ".css": minify_css,
+    ".js": minify_js,
+}
+
+
+def identifier(name):
+    return "webAsset_" + re.sub(r"[^A-Za-z0-9]", "_", name)
+
+
+def main():
+    names = sorted(n for n in os.listdir(WEB_DIR) if os.path.splitext(n)[1] in CONTENT_TYPES)
+    # Pages last, so the hashes they refer to are known
+    names.sort(key=lambda n: n.endswith(".html"))
+
+    hashes = {}
+    assets = []
+    for name in names:
+        ext = os.path.splitext(name)[1]
+        with open(os.path.join(WEB_DIR, name), encoding="utf-8") as f:
+            text = f.read()
+        if ext == ".html":
+            def substitute(match):
+                ref = match.group(1)
+                if ref not in hashes:
+                    sys.exit(f"{name}: unknown asset {{{{{ref}}}}}")
+                return hashes[ref]
+            text = re.sub(r"\{\{([^}]+)\}\}", substitute, text)
+        minified = MINIFIERS[ext](text).encode("utf-8")
+        # mtime=0 keeps the output identical between runs
+        compressed = gzip.compress(minified, compresslevel=9, mtime=0)
+        digest = hashlib.sha256(minified).hexdigest()[:HASH_LENGTH]
+        hashes[name] = digest
+        assets.append((name, ext, len(text.encode("utf-8")), minified, compressed, digest))
+
+    out = []
+    out.append("// Generated by tools/embed_assets.py from web/. Do not edit.")
+    out.append("#pragma once")
+    out.append("")
+    out.append("#include <Arduino.h>")
+    out.append("#include <cstddef>")
+    out.append("#include <cstdint>")
+    out.append("")
+    out.append("struct WebAsset {")
+    out.append("    const char *path;")
+    out.append("    const char *contentType;")
+    out.append("    const uint8_t *gzipData;")
+    out.append("    size_t gzipLength;")
+    out.append("    const char *etag;       // Quoted content hash")
+    out.append("    const char *version;    // The hash alone, as used in ?v=")
+    out.append("};")
+    out.append("")
+    for name, ext, source_length, minified, compressed, digest in assets:
+        out.append(f"// {name}: {source_length} bytes, {len(minified)} minified, {len(compressed)} gzipped")
+        out.append(f"static const uint8_t {identifier(name)}[] PROGMEM = {{")
+        for i in range(0, len(compressed), 16):
+            chunk = compressed[i:i + 16]
+            out.append("    " + ", ".join(f"0x{b:02x}" for b in chunk) + ",")
+        out.append("};")
+        out.append("")
+    out.append(f"#define WEB_ASSET_COUNT {len(assets)}")
+    out.append("")
+    out.append("static const WebAsset webAssets[WEB_ASSET_COUNT] = {")
+    for name, ext, source_length, minified, compressed, digest in assets:
+        path = ROUTES.get(name, "/" + name)
+        out.append(f'    {{ "{path}", "{CONTENT_TYPES[ext]}", {identifier(name)}, sizeof({identifier(name)}), "\\"{digest}\\"", "{digest}" }},')
+    out.append("};")
+    out.append("")
+
+    with open(OUTPUT, "w", encoding="utf-8", newline="\n") as f:
+        f.write("\n".join(out))
+
+    for name, ext, source_length, minified, compressed, digest in assets:
+        print(f"{name:14} {source_length:6} -> {len(minified):6} minified -> {len(compressed):6} gzipped  {digest}")
+
+
+if __name__ == "__main__":
+    main()
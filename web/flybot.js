@@ -15,7 +15,8 @@ let state = {
     motor3Command: 0.0,
     motor4Command: 0.0,
     motor5Command: 0.0,
-    motor6Command: 0.0
+    motor6Command: 0.0,
+    stickLatencyMs: 0.0
 };
 
 let config = {
@@ -24,6 +25,11 @@ let config = {
 let configDefaults = {
     numMotors: 0
 };
+// From config_schema.json: name -> { type, default, min, max, description }
+let configSchema = {};
+// Generation of the values in config; pushed changes at or below it are
+// already applied
+let configGeneration = 0;
 
 const rad2deg = 180 / Math.PI;
 
@@ -36,11 +42,13 @@ class FlySocket {
         this.wsConnected = false;
     }
     start() {
-        this.ws = new WebSocket(`ws://${flybotRoot}/ws`);
+        this.ws = new WebSocket(`ws://${flybotRoot || location.host}/ws`);
         this.wsConnected = false;
         this.ws.onopen = () => {
             console.log("WebSocket connected");
             this.wsConnected = true;
+            // Ask for config changes to be pushed
+            this.ws.send("config");
         };
         this.ws.onmessage = (event) => {
             const data = JSON.parse(event.data);
@@ -61,8 +69,29 @@ class FlySocket {
                 state.motor4Command = data.m4;
                 state.motor5Command = data.m5;
                 state.motor6Command = data.m6;
+                state.stickLatencyMs = data.sl / 1000.0;
                 drawAll();
             }
+            else if (data.type === "log") {
+                console.log("Flybot: " + data.m);
+            }
+            else if (data.type === "ota") {
+                console.log(`Firmware update ${data.state}: ${data.written}/${data.size} bytes written`
+                    + (data.error ? ` (${data.error})` : ""));
+            }
+            else if (data.type === "cfg") {
+                if (data.g > configGeneration) {
+                    Object.assign(config, data.c);
+                    configGeneration = data.g;
+                    configChanged();
+                }
+            }
+            else if (data.type === "cfgsub") {
+                // Changes between our fetch and subscribing were not pushed
+                if (data.g > configGeneration) {
+                    fetchConfig().then(configChanged);
+                }
+            }
         };
         this.ws.onclose = () => {
             this.wsConnected = false;
@@ -309,6 +338,7 @@ function drawHUD(ctx, x, y, width, height) {
     ctx.fillText("Flight Status: " + flightStatusToString(state.flightStatus), 10, 160);
     ctx.fillText("Hardware Flags: " + hardwareFlagsToString(state.hardwareFlags), 10, 180);
     ctx.fillText("Error: " + getFlightErrorMessage(), 10, 200);
+    ctx.fillText("Stick Latency: " + state.stickLatencyMs.toFixed(2) + " ms", 10, 220);
 }
 
 const FS_Disarmed = 0;
@@ -317,6 +347,7 @@ const FS_ArmingWaitingForNoInput = 2;
 const FS_Flying = 3;
 const FS_Disarming = 4;
 const FS_DisarmingWaitingForNoInput = 5;
+const FS_Failsafe = 6;
 
 function flightStatusToString(status) {
     switch (status) {
@@ -332,6 +363,8 @@ function flightStatusToString(status) {
             return "Disarming";
         case FS_DisarmingWaitingForNoInput:
             return "DisarmingWaitingForNoInput";
+        case FS_Failsafe:
+            return "Failsafe";
         default:
             return "Unknown";
     }
@@ -357,6 +390,9 @@ function hardwareFlagsToString(flags) {
 
 function getFlightErrorMessage() {
     const hf = state.hardwareFlags;
+    if (state.flightStatus === FS_Failsafe) {
+        return "RC Lost - Failsafe Descent";
+    }
     // Is there a hardware failure?
     if (!(hf & HF_RC_OK)) {
         return "NO RC Signal";
@@ -442,14 +478,9 @@ function flybotStart(root) {
     flybotRoot = root;
     flySocket.start();
     // Get config
-    fetch("config.json")
-    .then(response => response.json())
-    .then(data => {
-        console.log("Config data:", data);
-        config = data;
-    })
+    fetchConfig()
     .catch(error => {
-        console.error("Error fetching config.json:", error);
+        console.error("Error fetching config:", error);
     });
 
     // Initial draw
@@ -553,23 +584,27 @@ function buildMotorConfigUI(motorId) {
     return $motorUI;
 }
 
-function updateMotorConfig(key, value) {
-    config[key] = parseFloat(value);
-    console.log("Updating motor config", {key, value});
-    const urlParams = new URLSearchParams();
-    urlParams.append("key", key);
-    urlParams.append("value", value);
-    const url = "config_value?" + urlParams.toString();
-    fetch(url, {
+// Sends { key: number, ... } as one change: all keys apply or none do, and
+// the device saves once
+function postConfigValues(values) {
+    return fetch("config_values", {
         method: "POST",
-        body: ""
+        headers: { "Content-Type": "application/json" },
+        body: JSON.stringify(values)
     })
-    .then(response => {
-        if (!response.ok) {
-            throw new Error("Network response was not ok");
+    .then(response => response.json())
+    .then(data => {
+        if (!data.success) {
+            throw new Error(data.error);
         }
-        return response.json();
-    })
+        return data;
+    });
+}
+
+function updateMotorConfig(key, value) {
+    config[key] = parseFloat(value);
+    console.log("Updating motor config", {key, value});
+    postConfigValues({ [key]: config[key] })
     .then(data => {
         console.log("Config updated successfully:", data);
         updateConfigUI();
@@ -591,6 +626,7 @@ function buildConfigDefaultsUI() {
     <th>Key</th>
     <th style="text-align: right;">Value</th>
     <th style="text-align: right;">Default Value</th>
+    <th>Range</th>
     <th>Restore</th>
     </tr>
     </table>
@@ -600,10 +636,14 @@ function buildConfigDefaultsUI() {
     keys.forEach(key => {
         const $row = document.createElement("tr");
         const display = configDefaults[key] === config[key] ? "none" : "inline";
+        const schema = configSchema[key] || {};
+        const range = (schema.min !== null && schema.min !== undefined ? schema.min : "") + " – "
+            + (schema.max !== null && schema.max !== undefined ? schema.max : "");
         $row.innerHTML = `
-        <td>${key}</td>
+        <td title="${schema.description || ""}">${key}</td>
         <td style="text-align: right;">${config[key]}</td>
         <td style="text-align: right;">${configDefaults[key]}</td>
+        <td>${schema.type || ""} ${range}</td>
         <td><button onclick="restoreConfig('${key}')" style="display: ${display};">Restore</button></td>
         `;
         $table.appendChild($row);
@@ -627,53 +667,93 @@ function restoreConfig(key) {
     })
     .then(data => {
         console.log("Config updated successfully:", data);
-        updateConfigDefaultsUI();
+        // Connected pages get the change pushed
+        if (!flySocket.wsConnected) {
+            updateConfigDefaultsUI();
+        }
     })
     .catch(error => {
         console.error("Error updating config:", error);
     });
 }
 
-function updateConfigDefaultsUI() {
-    // Delete old UI
+function removeConfigDefaultsUI() {
     const $defaults = document.getElementById("config-defaults");
     if ($defaults) {
         $defaults.remove();
     }
-    fetch("config.json")
-    .then(response => response.json())
-    .then(data => {
-        console.log("Config data:", data);
-        config = data;
+}
+
+function updateConfigDefaultsUI() {
+    fetchConfig()
+    .then(() => {
+        removeConfigDefaultsUI();
         buildConfigDefaultsUI();
     })
     .catch(error => {
-        console.error("Error fetching config.json:", error);
+        console.error("Error fetching config:", error);
     });
 }
 
-function flybotConfigStart() {
-    fetch("config.json")
-    .then(response => response.json())
+// Refreshes whatever config UI is on the page after config changed
+function configChanged() {
+    if (!document.getElementById("config-defaults")) {
+        return;
+    }
+    for (let i = 1; i <= 6; i++) {
+        ["x", "y", "direction"].forEach(axis => {
+            const $input = document.getElementById(`motor${i}-${axis}`);
+            if ($input && document.activeElement !== $input) {
+                $input.value = config[`motor${i}.${axis}`];
+            }
+        });
+    }
+    const $numMotors = document.getElementById("numMotors");
+    if ($numMotors && document.activeElement !== $numMotors) {
+        $numMotors.value = config.numMotors;
+    }
+    updateConfigUI();
+    removeConfigDefaultsUI();
+    buildConfigDefaultsUI();
+}
+
+// Fetches the live values, then the schema for the build that served them.
+// The schema URL carries the build, so the browser keeps it until the
+// firmware changes.
+function fetchConfig() {
+    let schemaVersion = "";
+    let generation = 0;
+    return fetch("config.json")
+    .then(response => {
+        schemaVersion = response.headers.get("X-Config-Schema") || "";
+        generation = parseInt(response.headers.get("X-Config-Generation") || "0");
+        return response.json();
+    })
     .then(data => {
         console.log("Config data:", data);
         config = data;
-        buildConfigUI();
-        // const configElement = document.getElementById("raw_config");
-        // configElement.textContent = JSON.stringify(data, null, 2);
+        configGeneration = generation;
+        return fetch("config_schema.json?v=" + encodeURIComponent(schemaVersion));
     })
-    .catch(error => {
-        console.error("Error fetching config.json:", error);
+    .then(response => response.json())
+    .then(schema => {
+        configSchema = {};
+        configDefaults = {};
+        schema.values.forEach(entry => {
+            configSchema[entry.name] = entry;
+            configDefaults[entry.name] = entry.default;
+        });
     });
+}
 
-    fetch("config_defaults.json")
-    .then(response => response.json())
-    .then(data => {
-        console.log("Config default data:", data);
-        configDefaults = data;
+function flybotConfigStart() {
+    fetchConfig()
+    .then(() => {
+        buildConfigUI();
         buildConfigDefaultsUI();
+        flySocket.start();
     })
     .catch(error => {
-        console.error("Error fetching config_defaults.json:", error);
+        console.error("Error fetching config:", error);
     });
 }